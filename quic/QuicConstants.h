@@ -150,7 +150,8 @@ BETTER_ENUM(
     CLIENT_SHUTDOWN,
     INVALID_SRC_PORT,
     UNKNOWN_CID_VERSION,
-    CANNOT_FORWARD_DATA)
+    CANNOT_FORWARD_DATA,
+    WORKER_RING_FULL)
 
 BETTER_ENUM(
     TransportKnobParamId,
@@ -404,6 +405,9 @@ QuicBatchingMode getQuicBatchingMode(uint32_t val);
 // by BATCHING_MODE_GSO
 constexpr uint32_t kDefaultQuicMaxBatchSize = 16;
 
+// Spare output buffers used by zerocopy writes.
+constexpr uint32_t kDefaultZeroCopyWriteBuffers = 8;
+
 // rfc6298:
 constexpr int kRttAlpha = 8;
 constexpr int kRttBeta = 4;
@@ -438,6 +442,8 @@ constexpr std::chrono::microseconds kDefaultPacingTickInterval{1000};
 // triggering the pacing callbacks. For pacing to work accurately, this should
 // be reasonably smaller than kDefaultPacingTickInterval.
 constexpr std::chrono::microseconds kDefaultPacingTimerResolution{100};
+// Default span of the bursts written at once when pacing with SO_TXTIME.
+constexpr std::chrono::microseconds kDefaultTxTimePacingHorizon{4000};
 // Fraction of RTT that is used to limit how long a write function can loop
 constexpr DurationRep kDefaultWriteLimitRttFraction = 25;
 
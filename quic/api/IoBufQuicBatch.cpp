@@ -45,6 +45,23 @@ bool IOBufQuicBatch::write(
   return true;
 }
 
+void IOBufQuicBatch::protectHeaderOnFlush(
+    const PacketNumberCipher& headerCipher,
+    const PendingHeaderProtection& header) {
+  DCHECK(!headerCipher_ || headerCipher_ == &headerCipher);
+  headerCipher_ = &headerCipher;
+  pendingHeaders_.push_back(header);
+}
+
+void IOBufQuicBatch::protectPendingHeaders() {
+  if (pendingHeaders_.empty()) {
+    return;
+  }
+  headerCipher_->encryptHeaders(folly::Range<PendingHeaderProtection*>(
+      pendingHeaders_.data(), pendingHeaders_.size()));
+  pendingHeaders_.clear();
+}
+
 bool IOBufQuicBatch::flush() {
   bool ret = flushInternal();
   reset();
@@ -52,6 +69,18 @@ bool IOBufQuicBatch::flush() {
   return ret;
 }
 
+void IOBufQuicBatch::setTxTime(std::chrono::microseconds txTime) {
+  if (txTime == txTime_) {
+    return;
+  }
+  if (!batchWriter_->empty()) {
+    // continue even if we get an error here, like write() does
+    flush();
+  }
+  batchWriter_->setTxTime(txTime);
+  txTime_ = txTime;
+}
+
 void IOBufQuicBatch::reset() {
   batchWriter_->reset();
 }
@@ -61,6 +90,9 @@ bool IOBufQuicBatch::isRetriableError(int err) {
 }
 
 bool IOBufQuicBatch::flushInternal() {
+  // This also covers a packet that write() has not appended yet, which is
+  // fine as its payload is already encrypted.
+  protectPendingHeaders();
   if (batchWriter_->empty()) {
     return true;
   }
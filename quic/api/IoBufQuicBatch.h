@@ -9,6 +9,8 @@
 #include <quic/QuicException.h>
 #include <quic/api/QuicBatchWriter.h>
 #include <quic/client/state/ClientStateMachine.h>
+#include <quic/codec/PacketNumberCipher.h>
+#include <quic/common/SmallCollections.h>
 #include <quic/state/QuicTransportStatsCallback.h>
 
 namespace quic {
@@ -34,6 +36,23 @@ class IOBufQuicBatch {
 
   bool flush();
 
+  /**
+   * Sets the SO_TXTIME departure time, relative to the write, of the packets
+   * written from now on. A GSO batch leaves as a whole, so this flushes the
+   * packets batched so far if their departure time is different.
+   */
+  void setTxTime(std::chrono::microseconds txTime);
+
+  /**
+   * Protects the header of the packet that is about to be written when the
+   * batch is flushed, together with the headers of the other packets in the
+   * batch. Must be called before write() for the packet, since write() may
+   * flush and move the packet.
+   */
+  void protectHeaderOnFlush(
+      const PacketNumberCipher& headerCipher,
+      const PendingHeaderProtection& header);
+
   FOLLY_ALWAYS_INLINE uint64_t getPktSent() const {
     return result_.packetsSent;
   }
@@ -49,6 +68,8 @@ class IOBufQuicBatch {
  private:
   void reset();
 
+  void protectPendingHeaders();
+
   // flushes the internal buffers
   bool flushInternal();
 
@@ -64,6 +85,9 @@ class IOBufQuicBatch {
   QuicClientConnectionState::HappyEyeballsState* happyEyeballsState_;
   BufQuicBatchResult result_;
   int lastRetryableErrno_{};
+  std::chrono::microseconds txTime_{0us};
+  const PacketNumberCipher* headerCipher_{nullptr};
+  SmallVec<PendingHeaderProtection, kDefaultQuicMaxBatchSize> pendingHeaders_;
 };
 
 } // namespace quic
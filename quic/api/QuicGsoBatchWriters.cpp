@@ -7,6 +7,7 @@
 
 #include <quic/api/QuicGsoBatchWriters.h>
 #include <quic/common/BufAccessor.h>
+#include <quic/common/ZeroCopyBufferRing.h>
 #include <quic/common/udpsocket/QuicAsyncUDPSocket.h>
 
 namespace {
@@ -14,6 +15,35 @@ namespace {
 // that's a few bytes larger than the original packet. If the original packet is
 // a full packet, then the new packet will be larger than a full packet.
 constexpr size_t kPacketSizeViolationTolerance = 10;
+
+bool shouldWriteZeroCopy(
+    const quic::QuicConnectionStateBase& conn,
+    const quic::QuicAsyncUDPSocket& sock) {
+  return conn.zeroCopyBufferRing && conn.zeroCopyBufferRing->hasFreeBuffer() &&
+      sock.getZeroCopy();
+}
+
+/**
+ * After a successful zerocopy write the kernel still references the sent
+ * bytes, so the BufAccessor's buffer is parked in the ring and replaced with a
+ * free one. The residue bytes that were not part of the write are carried
+ * over to the start of the new buffer.
+ */
+void swapZeroCopyBuffer(
+    quic::QuicConnectionStateBase& conn,
+    const uint8_t* residue,
+    size_t residueLen,
+    uint32_t numSends) {
+  auto freeBuf = conn.zeroCopyBufferRing->acquire();
+  CHECK(freeBuf);
+  if (residueLen) {
+    memcpy(freeBuf->writableData(), residue, residueLen);
+    freeBuf->append(residueLen);
+  }
+  auto sentBuf = conn.bufAccessor->obtain();
+  conn.bufAccessor->release(std::move(freeBuf));
+  conn.zeroCopyBufferRing->onSent(std::move(sentBuf), numSends);
+}
 } // namespace
 
 namespace quic {
@@ -131,7 +161,8 @@ bool GSOInplacePacketBatchWriter::append(
  * Write the buffer owned by conn_.bufAccessor to the sock, until
  * lastPacketEnd_. After write, everything in the buffer after lastPacketEnd_
  * will be moved to the beginning of the buffer, and buffer will be returned to
- * conn_.bufAccessor.
+ * conn_.bufAccessor. If the write used MSG_ZEROCOPY, the written buffer goes to
+ * conn_.zeroCopyBufferRing instead and conn_.bufAccessor gets a free one.
  */
 ssize_t GSOInplacePacketBatchWriter::write(
     QuicAsyncUDPSocket& sock,
@@ -158,12 +189,17 @@ ssize_t GSOInplacePacketBatchWriter::write(
   // Even though it's called writeGSO, it can handle individual writes by
   // setting gsoVal = 0.
   int gsoVal = numPackets_ > 1 ? static_cast<int>(prevSize_) : 0;
-  auto options =
-      QuicAsyncUDPSocket::WriteOptions(gsoVal, false /*zerocopyVal*/);
+  bool zeroCopy = shouldWriteZeroCopy(conn_, sock);
+  auto options = QuicAsyncUDPSocket::WriteOptions(gsoVal, zeroCopy);
   options.txTime = txTime_;
   iovec vec[kNumIovecBufferChains];
   size_t iovec_len = fillIovec(buf, vec);
   auto bytesWritten = sock.writeGSO(address, vec, iovec_len, options);
+  if (zeroCopy && bytesWritten >= 0) {
+    swapZeroCopyBuffer(conn_, lastPacketEnd_, diffToEnd, 1);
+    reset();
+    return bytesWritten;
+  }
   /**
    * If there is one more bytes after lastPacketEnd_, that means there is a
    * packet we choose not to write in this batch (e.g., it has a size larger
@@ -398,14 +434,25 @@ ssize_t SendmmsgGSOInplacePacketBatchWriter::write(
   CHECK_GT(buffers_.size(), 0);
 
   int ret = 0;
+  // Number of messages the kernel accepted, which is what the zerocopy send
+  // counter advances by.
+  uint32_t numSent = 0;
+  bool zeroCopy = shouldWriteZeroCopy(conn_, sock);
+  for (auto& options : indexToOptions_) {
+    options.zerocopy = zeroCopy;
+  }
 
   if (buffers_.size() == 1) {
-    ret = (currBufs_ > 1) ? sock.writeGSO(
-                                indexToAddr_[0],
-                                buffers_[0].data(),
-                                buffers_[0].size(),
-                                indexToOptions_[0])
-                          : sock.write(indexToAddr_[0], buffers_[0].data(), 1);
+    // write() has no WriteOptions, so zerocopy writes always go through
+    // writeGSO, which handles a single packet with a gso of 0.
+    ret = (currBufs_ > 1 || zeroCopy)
+        ? sock.writeGSO(
+              indexToAddr_[0],
+              buffers_[0].data(),
+              buffers_[0].size(),
+              indexToOptions_[0])
+        : sock.write(indexToAddr_[0], buffers_[0].data(), 1);
+    numSent = ret >= 0 ? 1 : 0;
   } else {
     std::array<iovec, kMaxIovecs> iovecs{};
     std::array<size_t, kMaxIovecs> messageSizes{};
@@ -426,6 +473,7 @@ ssize_t SendmmsgGSOInplacePacketBatchWriter::write(
         &messageSizes[0],
         buffers_.size(),
         indexToOptions_.data());
+    numSent = ret > 0 ? ret : 0;
 
     if (ret > 0) {
       if (static_cast<size_t>(ret) == buffers_.size()) {
@@ -443,6 +491,11 @@ ssize_t SendmmsgGSOInplacePacketBatchWriter::write(
   // wrote some data to the shared buffer.
   uint32_t diffToEnd = conn_.bufAccessor->tail() - lastPacketEnd_;
 
+  if (zeroCopy && numSent > 0) {
+    swapZeroCopyBuffer(conn_, lastPacketEnd_, diffToEnd, numSent);
+    return ret;
+  }
+
   auto& buf = conn_.bufAccessor->buf();
   if (diffToEnd == 0) {
     buf->clear();
@@ -395,7 +395,10 @@ class QuicSocketLite {
    * };
    */
 
-  using PeekIterator = CircularDeque<StreamBuffer>::const_iterator;
+  // A random access iterator over the buffered segments of the stream. It
+  // used to be CircularDeque<StreamBuffer>::const_iterator, so code that
+  // spelled that type out has to use PeekIterator instead.
+  using PeekIterator = ChunkedDeque<StreamBuffer>::const_iterator;
   class PeekCallback {
    public:
     virtual ~PeekCallback() = default;
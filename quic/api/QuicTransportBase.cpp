@@ -768,6 +768,7 @@ void QuicTransportBase::detachEventBase() {
   cancelTimeout(&pathValidationTimeout_);
   cancelTimeout(&idleTimeout_);
   cancelTimeout(&keepaliveTimeout_);
+  cancelTimeout(&compactionTimeout_);
   cancelTimeout(&drainTimeout_);
   readLooper_->detachEventBase();
   peekLooper_->detachEventBase();
@@ -58,6 +58,7 @@ QuicTransportBaseLite::QuicTransportBaseLite(
       excessWriteTimeout_(this),
       idleTimeout_(this),
       keepaliveTimeout_(this),
+      compactionTimeout_(this),
       ackTimeout_(this),
       pathValidationTimeout_(this),
       drainTimeout_(this),
@@ -88,6 +89,7 @@ void QuicTransportBaseLite::onNetworkData(
     }
   };
   try {
+    maybeRehydrateConnection();
     conn_->lossState.totalBytesRecvd += networkData.getTotalData();
     auto originalAckVersion = currentAckStateVersion(*conn_);
 
@@ -125,6 +127,20 @@ void QuicTransportBaseLite::onNetworkData(
     }
 
     auto packets = std::move(networkData).movePackets();
+    if (packets.size() > 1 && conn_->readCodec) {
+      // Computes the header protection masks of the batch, e.g. the segments
+      // of one GRO read, at once rather than while parsing each packet.
+      auto dstConnIdSize = conn_->nodeType == QuicNodeType::Client &&
+              conn_->clientConnectionId
+          ? conn_->clientConnectionId->size()
+          : kDefaultConnectionIdSize;
+      conn_->readCodec->computeHeaderMasks(packets, dstConnIdSize);
+    }
+    SCOPE_EXIT {
+      if (conn_->readCodec) {
+        conn_->readCodec->clearHeaderMasks();
+      }
+    };
     for (auto& packet : packets) {
       auto res = onReadData(peer, std::move(packet));
       if (res.hasError()) {
@@ -1173,6 +1189,9 @@ void QuicTransportBaseLite::pacedWriteDataToSocket() {
   SCOPE_EXIT {
     self->maybeStopWriteLooperAndArmSocketWritableEvent();
   };
+  if (writeLooper_->isInPacingTimeout()) {
+    QUIC_STATS(conn_->statsCallback, onPacerTimerFired);
+  }
 
   if (!isConnectionPaced(*conn_)) {
     // Not paced and connection is still open, normal write. Even if pacing is
@@ -1208,6 +1227,7 @@ void QuicTransportBaseLite::pacedWriteDataToSocket() {
 
 void QuicTransportBaseLite::writeSocketData() {
   if (socket_) {
+    maybeRehydrateConnection();
     ++(conn_->writeCount); // incremented on each write (or write attempt)
 
     // record current number of sent packets to detect delta
@@ -1436,6 +1456,7 @@ void QuicTransportBaseLite::closeImpl(
   cancelTimeout(&pathValidationTimeout_);
   cancelTimeout(&idleTimeout_);
   cancelTimeout(&keepaliveTimeout_);
+  cancelTimeout(&compactionTimeout_);
   cancelTimeout(&pingTimeout_);
   cancelTimeout(&excessWriteTimeout_);
 
@@ -1486,6 +1507,7 @@ void QuicTransportBaseLite::closeImpl(
 
   // We don't need no congestion control.
   conn_->congestionController = nullptr;
+  conn_->compactedCongestionState.reset();
 
   sendCloseImmediately = sendCloseImmediately && !isReset && !isAbandon;
   if (sendCloseImmediately) {
@@ -2183,6 +2205,24 @@ void QuicTransportBaseLite::keepaliveTimeoutExpired() noexcept {
   updateWriteLooper(true);
 }
 
+void QuicTransportBaseLite::compactionTimeoutExpired() noexcept {
+  if (closeState_ != CloseState::OPEN || conn_->compactedCongestionState) {
+    return;
+  }
+  if (!canCompactConnection()) {
+    // Try again after another idle period.
+    scheduleTimeout(
+        &compactionTimeout_,
+        conn_->transportSettings.compactIdleConnectionAfter);
+    return;
+  }
+  VLOG(10) << __func__ << " " << *this;
+  compactIdleConnection(*conn_);
+  if (conn_->qLogger) {
+    conn_->qLogger->addTransportStateUpdate(kConnectionCompacted);
+  }
+}
+
 void QuicTransportBaseLite::ackTimeoutExpired() noexcept {
   CHECK_NE(closeState_, CloseState::CLOSED);
   VLOG(10) << __func__ << " " << *this;
@@ -2326,7 +2366,7 @@ void QuicTransportBaseLite::scheduleTimeout(
     QuicTimerCallback* callback,
     std::chrono::milliseconds timeout) {
   if (evb_) {
-    evb_->scheduleTimeout(callback, timeout);
+    connTimer_.scheduleTimeout(*evb_, callback, timeout);
   }
 }
 
@@ -2401,7 +2441,14 @@ QuicConnectionStats QuicTransportBaseLite::getConnectionsStats() const {
     connStats.cwnd_bytes = conn_->congestionController->getCongestionWindow();
     connStats.congestionController = conn_->congestionController->type();
     conn_->congestionController->getStats(connStats.congestionControllerStats);
-  }
+  } else if (conn_->compactedCongestionState) {
+    connStats.cwnd_bytes =
+        conn_->compactedCongestionState->congestionWindowBytes;
+    connStats.congestionController = conn_->compactedCongestionState->type;
+  }
+  connStats.compacted = conn_->compactedCongestionState.has_value();
+  connStats.bytesBeforeCompaction = conn_->bytesBeforeCompaction;
+  connStats.bytesAfterCompaction = conn_->bytesAfterCompaction;
   connStats.ptoCount = conn_->lossState.ptoCount;
   connStats.srtt = conn_->lossState.srtt;
   connStats.mrtt = conn_->lossState.mrtt;
@@ -2787,6 +2834,11 @@ void QuicTransportBaseLite::setIdleTimer() {
   if (closeState_ == CloseState::CLOSED) {
     return;
   }
+  if (conn_->transportSettings.compactIdleConnectionAfter > 0ms) {
+    scheduleTimeout(
+        &compactionTimeout_,
+        conn_->transportSettings.compactIdleConnectionAfter);
+  }
   cancelTimeout(&idleTimeout_);
   cancelTimeout(&keepaliveTimeout_);
   auto localIdleTimeout = conn_->transportSettings.idleTimeout;
@@ -2807,6 +2859,55 @@ void QuicTransportBaseLite::setIdleTimer() {
   }
 }
 
+bool QuicTransportBaseLite::canCompactConnection() {
+  // Compact established connections only, the handshake sets the congestion
+  // controller up.
+  return conn_->congestionController && conn_->oneRttWriteCipher &&
+      conn_->outstandings.packets.empty() &&
+      !conn_->outstandingPathValidation &&
+      shouldWriteData(*conn_) == WriteDataReason::NO_WRITE &&
+      !isLossTimeoutScheduled() && !isTimeoutScheduled(&ackTimeout_) &&
+      !isTimeoutScheduled(&pathValidationTimeout_);
+}
+
+void QuicTransportBaseLite::maybeRehydrateConnection() {
+  if (!conn_->compactedCongestionState) {
+    return;
+  }
+  auto compacted = *conn_->compactedCongestionState;
+  conn_->compactedCongestionState.reset();
+  // Seed the new controller with the window it had when it was compacted, the
+  // same way ServerCongestionControllerFactory seeds it from the bandwidth
+  // cache, but only for this controller.
+  auto& transportSettings = conn_->transportSettings;
+  auto initCwndInMss = transportSettings.initCwndInMss;
+  SCOPE_EXIT {
+    transportSettings.initCwndInMss = initCwndInMss;
+  };
+  transportSettings.initCwndInMss = std::clamp(
+      compacted.congestionWindowBytes / conn_->udpSendPacketLen,
+      transportSettings.minCwndInMss,
+      std::max(transportSettings.minCwndInMss, transportSettings.maxCwndInMss));
+  CHECK(conn_->congestionControllerFactory);
+  conn_->congestionController =
+      conn_->congestionControllerFactory->makeCongestionController(
+          *conn_, compacted.type);
+  if (conn_->pacer) {
+    conn_->pacer->reset();
+    // Spread the restored window over an RTT rather than bursting it.
+    if (conn_->lossState.srtt > 0us) {
+      conn_->pacer->refreshPacingRate(
+          conn_->congestionController
+              ? conn_->congestionController->getCongestionWindow()
+              : compacted.congestionWindowBytes,
+          conn_->lossState.srtt);
+    }
+  }
+  if (conn_->qLogger) {
+    conn_->qLogger->addTransportStateUpdate(kConnectionRehydrated);
+  }
+}
+
 void QuicTransportBaseLite::setTransportSettings(
     TransportSettings transportSettings) {
   if (conn_->nodeType == QuicNodeType::Client) {
@@ -2819,6 +2920,11 @@ void QuicTransportBaseLite::setTransportSettings(
       // Create generic buf for in-place batch writer.
       createBufAccessor(
           conn_->udpSendPacketLen * transportSettings.maxBatchSize);
+      if (transportSettings.enableZeroCopyWrites) {
+        createZeroCopyBufferRing(
+            conn_->udpSendPacketLen * transportSettings.maxBatchSize,
+            transportSettings.zeroCopyWriteBuffers);
+      }
     }
   }
 
@@ -2897,6 +3003,7 @@ void QuicTransportBaseLite::setTransportSettings(
 
 void QuicTransportBaseLite::setCongestionControl(CongestionControlType type) {
   DCHECK(conn_);
+  maybeRehydrateConnection();
   if (!conn_->congestionController ||
       type != conn_->congestionController->type()) {
     CHECK(conn_->congestionControllerFactory);
@@ -3324,6 +3431,9 @@ void QuicTransportBaseLite::updateCongestionControlSettings(
       transportSettings.pacingTickInterval;
   conn_->transportSettings.pacingTimerResolution =
       transportSettings.pacingTimerResolution;
+  conn_->transportSettings.txTimePacing = transportSettings.txTimePacing;
+  conn_->transportSettings.txTimePacingHorizon =
+      transportSettings.txTimePacingHorizon;
   conn_->transportSettings.minBurstPackets = transportSettings.minBurstPackets;
   conn_->transportSettings.copaDeltaParam = transportSettings.copaDeltaParam;
   conn_->transportSettings.copaUseRttStanding =
@@ -10,6 +10,7 @@
 #include <quic/api/QuicSocketLite.h>
 #include <quic/api/QuicTransportFunctions.h>
 #include <quic/common/FunctionLooper.h>
+#include <quic/common/events/CoalescedQuicTimer.h>
 
 namespace quic {
 
@@ -340,6 +341,25 @@ class QuicTransportBaseLite : virtual public QuicSocketLite,
     QuicTransportBaseLite* transport_;
   };
 
+  class CompactionTimeout : public QuicTimerCallback {
+   public:
+    ~CompactionTimeout() override = default;
+
+    explicit CompactionTimeout(QuicTransportBaseLite* transport)
+        : transport_(transport) {}
+
+    void timeoutExpired() noexcept override {
+      transport_->compactionTimeoutExpired();
+    }
+
+    void callbackCanceled() noexcept override {
+      // Nothing to free once the connection is going away.
+    }
+
+   private:
+    QuicTransportBaseLite* transport_;
+  };
+
   class AckTimeout : public QuicTimerCallback {
    public:
     ~AckTimeout() override = default;
@@ -479,6 +499,14 @@ class QuicTransportBaseLite : virtual public QuicSocketLite,
    */
   virtual void createBufAccessor(size_t /* capacity */) {}
 
+  /*
+   * Creates the spare buffers used by in-place batch writers for zerocopy
+   * writes, if the socket supports zerocopy.
+   */
+  virtual void createZeroCopyBufferRing(
+      size_t /* capacity */,
+      size_t /* numBuffers */) {}
+
   TransportInfo getTransportInfo() const override;
 
   const folly::SocketAddress& getLocalAddress() const override;
@@ -682,6 +710,7 @@ class QuicTransportBaseLite : virtual public QuicSocketLite,
   void lossTimeoutExpired() noexcept;
   void idleTimeoutExpired(bool drain) noexcept;
   void keepaliveTimeoutExpired() noexcept;
+  void compactionTimeoutExpired() noexcept;
   void ackTimeoutExpired() noexcept;
   void pathValidationTimeoutExpired() noexcept;
   void drainTimeoutExpired() noexcept;
@@ -740,6 +769,18 @@ class QuicTransportBaseLite : virtual public QuicSocketLite,
 
   void setIdleTimer();
   void scheduleAckTimeout();
+
+  /**
+   * Whether the connection has nothing in flight or pending that needs the
+   * state compactIdleConnection() frees.
+   */
+  bool canCompactConnection();
+
+  /**
+   * Recreates the congestion controller of a compacted connection. Called
+   * before the connection processes a packet in either direction.
+   */
+  void maybeRehydrateConnection();
   void schedulePathValidationTimeout();
 
   void resetConnectionCallbacks() {
@@ -824,10 +865,14 @@ class QuicTransportBaseLite : virtual public QuicSocketLite,
   ByteEventMap deliveryCallbacks_;
   ByteEventMap txCallbacks_;
 
+  // The timeouts below share one entry in the event base's timer wheel. It is
+  // declared first so that it outlives them.
+  CoalescedQuicTimer connTimer_;
   LossTimeout lossTimeout_;
   ExcessWriteTimeout excessWriteTimeout_;
   IdleTimeout idleTimeout_;
   KeepaliveTimeout keepaliveTimeout_;
+  CompactionTimeout compactionTimeout_;
   AckTimeout ackTimeout_;
   PathValidationTimeout pathValidationTimeout_;
   DrainTimeout drainTimeout_;
@@ -298,14 +298,16 @@ DataPathResult continuousMemoryBuildScheduleEncrypt(
   // Include header back.
   packetBuf->prepend(headerLen);
 
+  // The header is protected with the rest of the batch when it is flushed.
   HeaderForm headerForm = packet->packet.header.getHeaderForm();
-  encryptPacketHeader(
-      headerForm,
-      packetBuf->writableData(),
-      headerLen,
-      packetBuf->data() + headerLen,
-      packetBuf->length() - headerLen,
-      headerCipher);
+  ioBufBatch.protectHeaderOnFlush(
+      headerCipher,
+      makePendingHeaderProtection(
+          headerForm,
+          packetBuf->writableData(),
+          headerLen,
+          packetBuf->data() + headerLen,
+          packetBuf->length() - headerLen));
   CHECK(!packetBuf->isChained());
   auto encodedSize = packetBuf->length();
   auto encodedBodySize = encodedSize - headerLen;
@@ -377,14 +379,16 @@ DataPathResult iobufChainBasedBuildScheduleEncrypt(
   headerCursor.pull(packetBuf->writableData(), headerLen);
   packetBuf->append(headerLen + bodyLen + aead.getCipherOverhead());
 
+  // The header is protected with the rest of the batch when it is flushed.
   HeaderForm headerForm = packet->packet.header.getHeaderForm();
-  encryptPacketHeader(
-      headerForm,
-      packetBuf->writableData(),
-      headerLen,
-      packetBuf->data() + headerLen,
-      packetBuf->length() - headerLen,
-      headerCipher);
+  ioBufBatch.protectHeaderOnFlush(
+      headerCipher,
+      makePendingHeaderProtection(
+          headerForm,
+          packetBuf->writableData(),
+          headerLen,
+          packetBuf->data() + headerLen,
+          packetBuf->length() - headerLen));
   auto encodedSize = packetBuf->computeChainDataLength();
   auto encodedBodySize = encodedSize - headerLen;
   if (encodedSize > connection.udpSendPacketLen) {
@@ -413,6 +417,35 @@ void handleRetransmissionBufMetaWritten(
     bool frameFin,
     const decltype(stream.lossBufMetas)::iterator lossBufMetaIter);
 
+uint64_t updateAndGetWritePacketLimit(
+    QuicConnectionStateBase& conn,
+    const QuicAsyncUDPSocket& sock) {
+  if (!isConnectionPaced(conn)) {
+    return conn.transportSettings.writeConnectionDataPacketsLimit;
+  }
+  // Each GSO batch carries a single departure time, so this needs GSO
+  // batching, which is only known to be supported after the first write.
+  if (conn.transportSettings.txTimePacing &&
+      conn.transportSettings.batchingMode ==
+          QuicBatchingMode::BATCHING_MODE_GSO &&
+      conn.gsoSupported.value_or(false) && sock.getTxTime()) {
+    conn.txTimeSchedule = conn.pacer->updateAndGetTxTimeSchedule(
+        Clock::now(), conn.transportSettings.txTimePacingHorizon);
+    return conn.txTimeSchedule->packetLimit();
+  }
+  return conn.pacer->updateAndGetWriteBatchSize(Clock::now());
+}
+
+void finishTxTimeSchedule(QuicConnectionStateBase& conn) {
+  if (!conn.txTimeSchedule) {
+    return;
+  }
+  if (conn.pacer) {
+    conn.pacer->onTxTimeScheduleWritten(*conn.txTimeSchedule);
+  }
+  conn.txTimeSchedule.reset();
+}
+
 bool writeLoopTimeLimit(
     TimePoint loopBeginTime,
     const QuicConnectionStateBase& connection) {
@@ -437,11 +470,7 @@ void handleNewStreamDataWritten(
   // this needs to be fixed:
   stream.currentWriteOffset += frameFin ? 1 : 0;
   CHECK(stream.retransmissionBuffer
-            .emplace(
-                std::piecewise_construct,
-                std::forward_as_tuple(originalOffset),
-                std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-                    std::move(bufWritten), originalOffset, frameFin)))
+            .emplace(std::move(bufWritten), originalOffset, frameFin)
             .second);
 }
 
@@ -479,21 +508,13 @@ void handleRetransmissionWritten(
     ChainedByteRangeHead bufWritten(std::move(lossBufferIter->data));
     stream.lossBuffer.erase(lossBufferIter);
     CHECK(stream.retransmissionBuffer
-              .emplace(
-                  std::piecewise_construct,
-                  std::forward_as_tuple(frameOffset),
-                  std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-                      std::move(bufWritten), frameOffset, frameFin)))
+              .emplace(std::move(bufWritten), frameOffset, frameFin)
               .second);
   } else {
     lossBufferIter->offset += frameLen;
     ChainedByteRangeHead bufWritten(lossBufferIter->data.splitAtMost(frameLen));
     CHECK(stream.retransmissionBuffer
-              .emplace(
-                  std::piecewise_construct,
-                  std::forward_as_tuple(frameOffset),
-                  std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-                      std::move(bufWritten), frameOffset, frameFin)))
+              .emplace(std::move(bufWritten), frameOffset, frameFin)
               .second);
   }
 }
@@ -1400,32 +1421,44 @@ void writeShortClose(
       headerCipher);
 }
 
-void encryptPacketHeader(
+PendingHeaderProtection makePendingHeaderProtection(
     HeaderForm headerForm,
     uint8_t* header,
     size_t headerLen,
     const uint8_t* encryptedBody,
-    size_t bodyLen,
-    const PacketNumberCipher& headerCipher) {
-  // Header encryption.
+    size_t bodyLen) {
+  PendingHeaderProtection pending;
   auto packetNumberLength = parsePacketNumberLength(*header);
-  Sample sample;
   size_t sampleBytesToUse = kMaxPacketNumEncodingSize - packetNumberLength;
   // If there were less than 4 bytes in the packet number, some of the payload
   // bytes will also be skipped during sampling.
-  CHECK_GE(bodyLen, sampleBytesToUse + sample.size());
+  CHECK_GE(bodyLen, sampleBytesToUse + pending.sample.size());
   encryptedBody += sampleBytesToUse;
-  memcpy(sample.data(), encryptedBody, sample.size());
+  memcpy(pending.sample.data(), encryptedBody, pending.sample.size());
 
-  folly::MutableByteRange initialByteRange(header, 1);
-  folly::MutableByteRange packetNumByteRange(
+  pending.initialByte = folly::MutableByteRange(header, 1);
+  pending.packetNumberBytes = folly::MutableByteRange(
       header + headerLen - packetNumberLength, packetNumberLength);
+  pending.longHeader = headerForm == HeaderForm::Long;
+  return pending;
+}
+
+void encryptPacketHeader(
+    HeaderForm headerForm,
+    uint8_t* header,
+    size_t headerLen,
+    const uint8_t* encryptedBody,
+    size_t bodyLen,
+    const PacketNumberCipher& headerCipher) {
+  // Header encryption.
+  auto pending = makePendingHeaderProtection(
+      headerForm, header, headerLen, encryptedBody, bodyLen);
   if (headerForm == HeaderForm::Short) {
     headerCipher.encryptShortHeader(
-        sample, initialByteRange, packetNumByteRange);
+        pending.sample, pending.initialByte, pending.packetNumberBytes);
   } else {
     headerCipher.encryptLongHeader(
-        sample, initialByteRange, packetNumByteRange);
+        pending.sample, pending.initialByte, pending.packetNumberBytes);
   }
 }
 
@@ -1610,6 +1643,12 @@ WriteQuicDataResult writeConnectionDataToSocket(
       writableBytes -= cipherOverhead;
     }
 
+    auto txTimeSchedule = connection.txTimeSchedule.get_pointer();
+    if (txTimeSchedule) {
+      ioBufBatch.setTxTime(
+          txTimeSchedule->departureOffset(txTimeSchedule->packetsScheduled));
+    }
+
     const auto& dataPlaneFunc =
         connection.transportSettings.dataPathType == DataPathType::ChainedMemory
         ? iobufChainBasedBuildScheduleEncrypt
@@ -1633,6 +1672,9 @@ WriteQuicDataResult writeConnectionDataToSocket(
       updateErrnoCount(connection, ioBufBatch);
       return {ioBufBatch.getPktSent(), 0, bytesWritten};
     }
+    if (txTimeSchedule) {
+      txTimeSchedule->packetsScheduled++;
+    }
     // If we build a packet, we updateConnection(), even if write might have
     // been failed. Because if it builds, a lot of states need to be updated no
     // matter the write result. We are basically treating this case as if we
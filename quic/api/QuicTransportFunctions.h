@@ -146,6 +146,22 @@ uint64_t writeZeroRttDataToSocket(
     QuicVersion version,
     uint64_t packetLimit);
 
+/**
+ * How many packets the next write may send. For a paced connection this asks
+ * the pacer, and if the write can be paced with SO_TXTIME, it also sets
+ * conn.txTimeSchedule, which the caller must clear with
+ * finishTxTimeSchedule() after the write.
+ */
+uint64_t updateAndGetWritePacketLimit(
+    QuicConnectionStateBase& conn,
+    const QuicAsyncUDPSocket& sock);
+
+/**
+ * Tells the pacer how much of conn.txTimeSchedule the write used, and clears
+ * it.
+ */
+void finishTxTimeSchedule(QuicConnectionStateBase& conn);
+
 /**
  * Whether we should and can write data.
  *
@@ -259,6 +275,18 @@ void writeShortClose(
     const Aead& aead,
     const PacketNumberCipher& headerCipher);
 
+/**
+ * Takes the sample for protecting the packet header from the encryptedBody,
+ * and the header bytes that protecting it changes. It will verify whether or
+ * not there are enough bytes to sample via a CHECK.
+ */
+PendingHeaderProtection makePendingHeaderProtection(
+    HeaderForm headerForm,
+    uint8_t* header,
+    size_t headerLen,
+    const uint8_t* encryptedBody,
+    size_t bodyLen);
+
 /**
  * Encrypts the packet header for the header type.
  * This will overwrite the header with the encrypted header form. It will verify
@@ -8,11 +8,13 @@
 #include <quic/api/IoBufQuicBatch.h>
 
 #include <gtest/gtest.h>
+#include <quic/api/QuicTransportFunctions.h>
 #include <quic/client/state/ClientStateMachine.h>
 #include <quic/common/events/FollyQuicEventBase.h>
 #include <quic/common/test/TestUtils.h>
 #include <quic/common/udpsocket/FollyQuicAsyncUDPSocket.h>
 #include <quic/fizz/client/handshake/FizzClientQuicHandshakeContext.h>
+#include <quic/handshake/test/Mocks.h>
 
 constexpr const auto kNumLoops = 64;
 constexpr const auto kMaxBufs = 10;
@@ -60,4 +62,54 @@ TEST(QuicBatch, TestBatchingNoFlush) {
 TEST(QuicBatch, TestBatching) {
   RunTest(kMaxBufs);
 }
+
+TEST(QuicBatch, TestHeadersProtectedOnFlush) {
+  folly::EventBase evb;
+  std::shared_ptr<FollyQuicEventBase> qEvb =
+      std::make_shared<FollyQuicEventBase>(&evb);
+  FollyQuicAsyncUDPSocket sock(qEvb);
+  folly::SocketAddress peerAddress{"127.0.0.1", 1234};
+  QuicClientConnectionState conn(
+      FizzClientQuicHandshakeContext::Builder().build());
+  IOBufQuicBatch ioBufBatch(
+      BatchWriterPtr(new test::TestPacketBatchWriter(kMaxBufs)),
+      sock,
+      peerAddress,
+      conn.statsCallback,
+      nullptr /* happyEyeballsState */);
+  test::MockPacketNumberCipher headerCipher;
+  HeaderProtectionMask mask;
+  mask.fill(0xff);
+  EXPECT_CALL(headerCipher, mask(::testing::_))
+      .Times(kMaxBufs - 1)
+      .WillRepeatedly(::testing::Return(mask));
+
+  // Short header with a one byte packet number, and the body to sample.
+  constexpr size_t kHeaderLen = 2;
+  std::vector<std::array<uint8_t, 32>> packets(kMaxBufs - 1);
+  for (auto& packet : packets) {
+    packet.fill(0);
+    packet[0] = ShortHeader::kFixedBitMask;
+    ioBufBatch.protectHeaderOnFlush(
+        headerCipher,
+        makePendingHeaderProtection(
+            HeaderForm::Short,
+            packet.data(),
+            kHeaderLen,
+            packet.data() + kHeaderLen,
+            packet.size() - kHeaderLen));
+    CHECK(ioBufBatch.write(nullptr, packet.size()));
+  }
+  // The batch is not full yet.
+  for (const auto& packet : packets) {
+    EXPECT_EQ(packet[0], ShortHeader::kFixedBitMask);
+    EXPECT_EQ(packet[1], 0);
+  }
+  CHECK(ioBufBatch.flush());
+  for (const auto& packet : packets) {
+    EXPECT_EQ(
+        packet[0], ShortHeader::kFixedBitMask | ShortHeader::kTypeBitsMask);
+    EXPECT_EQ(packet[1], 0xff);
+  }
+}
 } // namespace quic::testing
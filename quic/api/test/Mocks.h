@@ -279,6 +279,7 @@ class MockQuicTransport : public QuicServerTransport {
     onNetworkData(peer, networkData);
   }
   MOCK_METHOD(void, setBufAccessor, (BufAccessor*));
+  MOCK_METHOD(void, setZeroCopyBufferRing, (ZeroCopyBufferRing*));
 
   MOCK_METHOD(void, addPacketProcessor, (std::shared_ptr<PacketProcessor>));
 };
@@ -1200,6 +1200,168 @@ TEST_F(QuicBatchWriterTest, InplaceWriterBufResidueCheck) {
   EXPECT_EQ(0, rawBuf->headroom());
 }
 
+TEST_F(QuicBatchWriterTest, InplaceWriterZeroCopySwapsBuffer) {
+  folly::EventBase evb;
+  std::shared_ptr<FollyQuicEventBase> qEvb =
+      std::make_shared<FollyQuicEventBase>(&evb);
+  quic::test::MockAsyncUDPSocket sock(qEvb);
+  EXPECT_CALL(sock, getZeroCopy()).WillRepeatedly(Return(true));
+  gsoSupported_ = true;
+
+  uint32_t batchSize = 20;
+  auto bufAccessor =
+      std::make_unique<BufAccessor>(conn_.udpSendPacketLen * batchSize);
+  conn_.bufAccessor = bufAccessor.get();
+  ZeroCopyBufferRing ring(conn_.udpSendPacketLen * batchSize, 2);
+  conn_.zeroCopyBufferRing = &ring;
+  auto batchWriter = quic::BatchWriterFactory::makeBatchWriter(
+      quic::QuicBatchingMode::BATCHING_MODE_GSO,
+      batchSize,
+      false, /* enable backpressure */
+      DataPathType::ContinuousMemory,
+      conn_,
+      gsoSupported_);
+  for (size_t i = 0; i < 5; i++) {
+    bufAccessor->append(700);
+    ASSERT_FALSE(
+        batchWriter->append(nullptr, 700, folly::SocketAddress(), nullptr));
+  }
+  // A bigger packet is left in the buffer after the batch.
+  memset(bufAccessor->writableTail(), 'x', 1000);
+  bufAccessor->append(1000);
+  EXPECT_TRUE(batchWriter->needsFlush(1000));
+  const auto* sentData = bufAccessor->data();
+
+  EXPECT_CALL(sock, writeGSO(_, _, _, _))
+      .Times(1)
+      .WillOnce(Invoke([&](const auto& /* addr */,
+                           const struct iovec* vec,
+                           size_t,
+                           QuicAsyncUDPSocket::WriteOptions options) {
+        EXPECT_EQ(sentData, vec[0].iov_base);
+        EXPECT_EQ(5 * 700, vec[0].iov_len);
+        EXPECT_TRUE(options.zerocopy);
+        return 700 * 5;
+      }));
+  EXPECT_EQ(5 * 700, batchWriter->write(sock, folly::SocketAddress()));
+
+  // The sent buffer is held until the kernel completes the send, and the
+  // residue moved to a free buffer.
+  EXPECT_EQ(1, ring.numBuffersInFlight());
+  EXPECT_EQ(1, ring.numFreeBuffers());
+  EXPECT_NE(sentData, bufAccessor->data());
+  EXPECT_EQ(1000, bufAccessor->length());
+  EXPECT_EQ(0, bufAccessor->headroom());
+  EXPECT_EQ(std::string(1000, 'x'), bufAccessor->buf()->to<std::string>());
+
+  ring.onCompletion(0, 0, false /* copied */);
+  EXPECT_EQ(0, ring.numBuffersInFlight());
+  EXPECT_EQ(2, ring.numFreeBuffers());
+}
+
+TEST_F(QuicBatchWriterTest, InplaceWriterZeroCopyFallsBackToCopy) {
+  folly::EventBase evb;
+  std::shared_ptr<FollyQuicEventBase> qEvb =
+      std::make_shared<FollyQuicEventBase>(&evb);
+  quic::test::MockAsyncUDPSocket sock(qEvb);
+  EXPECT_CALL(sock, getZeroCopy()).WillRepeatedly(Return(true));
+  gsoSupported_ = true;
+
+  uint32_t batchSize = 20;
+  auto bufAccessor =
+      std::make_unique<BufAccessor>(conn_.udpSendPacketLen * batchSize);
+  conn_.bufAccessor = bufAccessor.get();
+  ZeroCopyBufferRing ring(conn_.udpSendPacketLen * batchSize, 1);
+  conn_.zeroCopyBufferRing = &ring;
+  auto batchWriter = quic::BatchWriterFactory::makeBatchWriter(
+      quic::QuicBatchingMode::BATCHING_MODE_GSO,
+      batchSize,
+      false, /* enable backpressure */
+      DataPathType::ContinuousMemory,
+      conn_,
+      gsoSupported_);
+
+  std::vector<bool> zeroCopyWrites;
+  EXPECT_CALL(sock, writeGSO(_, _, _, _))
+      .Times(3)
+      .WillRepeatedly(Invoke([&](const auto& /* addr */,
+                                 const struct iovec* vec,
+                                 size_t,
+                                 QuicAsyncUDPSocket::WriteOptions options) {
+        zeroCopyWrites.push_back(options.zerocopy);
+        return vec[0].iov_len;
+      }));
+  auto writeOnePacket = [&]() {
+    bufAccessor->append(1000);
+    ASSERT_FALSE(
+        batchWriter->append(nullptr, 1000, folly::SocketAddress(), nullptr));
+    EXPECT_EQ(1000, batchWriter->write(sock, folly::SocketAddress()));
+    EXPECT_EQ(0, bufAccessor->length());
+  };
+
+  writeOnePacket();
+  // The only spare buffer is in flight, so this write copies.
+  writeOnePacket();
+  ring.onCompletion(0, 0, true /* copied */);
+  writeOnePacket();
+  EXPECT_THAT(zeroCopyWrites, ElementsAre(true, false, true));
+  EXPECT_EQ(1, ring.numCopiedSends());
+}
+
+TEST_F(QuicBatchWriterTest, TestBatchingSendmmsgGSOInplaceZeroCopy) {
+  gsoSupported_ = true;
+  size_t batchSize = 5;
+  std::vector<size_t> packetSizes = {100, 100, 100, 70, 100};
+
+  folly::EventBase evb;
+  std::shared_ptr<FollyQuicEventBase> qEvb =
+      std::make_shared<FollyQuicEventBase>(&evb);
+  quic::test::MockAsyncUDPSocket sock(qEvb);
+  EXPECT_CALL(sock, getZeroCopy()).WillRepeatedly(Return(true));
+
+  auto bufAccessor =
+      std::make_unique<BufAccessor>(conn_.udpSendPacketLen * batchSize);
+  conn_.bufAccessor = bufAccessor.get();
+  ZeroCopyBufferRing ring(conn_.udpSendPacketLen * batchSize, 2);
+  conn_.zeroCopyBufferRing = &ring;
+
+  auto batchWriter = quic::BatchWriterFactory::makeBatchWriter(
+      quic::QuicBatchingMode::BATCHING_MODE_SENDMMSG_GSO,
+      batchSize,
+      false, /* enable backpressure */
+      DataPathType::ContinuousMemory,
+      conn_,
+      gsoSupported_);
+  for (auto packetSize : packetSizes) {
+    bufAccessor->append(packetSize);
+    batchWriter->append(nullptr, packetSize, folly::SocketAddress(), nullptr);
+  }
+  const auto* sentData = bufAccessor->data();
+
+  EXPECT_CALL(sock, writemGSO(_, _, _, _, _))
+      .Times(1)
+      .WillOnce(
+          Invoke([&](folly::Range<folly::SocketAddress const*> /* addrs */,
+                     iovec* /* iov */,
+                     size_t* /* numIovecsInBuffer */,
+                     size_t count,
+                     const QuicAsyncUDPSocket::WriteOptions* options) {
+            EXPECT_EQ(count, 2);
+            EXPECT_TRUE(options[0].zerocopy);
+            EXPECT_TRUE(options[1].zerocopy);
+            return 2;
+          }));
+  batchWriter->write(sock, folly::SocketAddress());
+  EXPECT_NE(sentData, bufAccessor->data());
+  EXPECT_TRUE(bufAccessor->buf()->empty());
+
+  // Both messages have to complete before the buffer is reused.
+  ring.onCompletion(0, 0, false /* copied */);
+  EXPECT_EQ(1, ring.numBuffersInFlight());
+  ring.onCompletion(1, 1, false /* copied */);
+  EXPECT_EQ(0, ring.numBuffersInFlight());
+}
+
 class SinglePacketInplaceBatchWriterTest : public ::testing::Test {
  public:
   SinglePacketInplaceBatchWriterTest()
@@ -927,9 +927,7 @@ TEST_F(QuicPacketSchedulerTest, CloneSchedulerHasHandshakeDataAndAcks) {
   Buf cryptoBuf = folly::IOBuf::copyBuffer("test");
   ChainedByteRangeHead cryptoRch(cryptoBuf);
   getCryptoStream(*conn.cryptoState, EncryptionLevel::Handshake)
-      ->retransmissionBuffer.emplace(
-          0,
-          std::make_unique<WriteStreamBuffer>(std::move(cryptoRch), 0, false));
+      ->retransmissionBuffer.emplace(std::move(cryptoRch), 0, false);
   conn.outstandings.packets.back().packet.frames.push_back(
       WriteCryptoFrame(0, 4));
 
@@ -1891,10 +1889,11 @@ TEST_F(QuicPacketSchedulerTest, WriteLossWithoutFlowControl) {
   EXPECT_EQ(0, getSendConnFlowControlBytesWire(conn));
   EXPECT_EQ(0, stream->pendingWrites.chainLength());
   EXPECT_EQ(1, stream->retransmissionBuffer.size());
-  EXPECT_EQ(1000, stream->retransmissionBuffer[0]->data.chainLength());
+  EXPECT_EQ(1000, stream->retransmissionBuffer.at(0)->data.chainLength());
 
   // Move the bytes to loss buffer:
-  stream->lossBuffer.emplace_back(std::move(*stream->retransmissionBuffer[0]));
+  stream->lossBuffer.emplace_back(
+      std::move(*stream->retransmissionBuffer.at(0)));
   stream->retransmissionBuffer.clear();
   conn.streamManager->updateWritableStreams(*stream);
   EXPECT_TRUE(scheduler.hasPendingData());
@@ -1919,7 +1918,7 @@ TEST_F(QuicPacketSchedulerTest, WriteLossWithoutFlowControl) {
   EXPECT_EQ(0, getSendConnFlowControlBytesWire(conn));
   EXPECT_TRUE(stream->lossBuffer.empty());
   EXPECT_EQ(1, stream->retransmissionBuffer.size());
-  EXPECT_EQ(1000, stream->retransmissionBuffer[0]->data.chainLength());
+  EXPECT_EQ(1000, stream->retransmissionBuffer.at(0)->data.chainLength());
 }
 
 TEST_F(QuicPacketSchedulerTest, WriteLossWithoutFlowControlIgnoreDSR) {
@@ -1963,7 +1962,7 @@ TEST_F(QuicPacketSchedulerTest, WriteLossWithoutFlowControlIgnoreDSR) {
   EXPECT_EQ(0, getSendConnFlowControlBytesWire(conn));
   EXPECT_EQ(0, stream->pendingWrites.chainLength());
   EXPECT_EQ(1, stream->retransmissionBuffer.size());
-  EXPECT_EQ(1000, stream->retransmissionBuffer[0]->data.chainLength());
+  EXPECT_EQ(1000, stream->retransmissionBuffer.at(0)->data.chainLength());
 
   EXPECT_FALSE(scheduler.hasPendingData());
 }
@@ -2003,10 +2002,11 @@ TEST_F(QuicPacketSchedulerTest, WriteLossWithoutFlowControlSequential) {
   EXPECT_EQ(0, getSendConnFlowControlBytesWire(conn));
   EXPECT_EQ(0, stream->pendingWrites.chainLength());
   EXPECT_EQ(1, stream->retransmissionBuffer.size());
-  EXPECT_EQ(1000, stream->retransmissionBuffer[0]->data.chainLength());
+  EXPECT_EQ(1000, stream->retransmissionBuffer.at(0)->data.chainLength());
 
   // Move the bytes to loss buffer:
-  stream->lossBuffer.emplace_back(std::move(*stream->retransmissionBuffer[0]));
+  stream->lossBuffer.emplace_back(
+      std::move(*stream->retransmissionBuffer.at(0)));
   stream->retransmissionBuffer.clear();
   conn.streamManager->updateWritableStreams(*stream);
   EXPECT_TRUE(scheduler.hasPendingData());
@@ -2031,7 +2031,7 @@ TEST_F(QuicPacketSchedulerTest, WriteLossWithoutFlowControlSequential) {
   EXPECT_EQ(0, getSendConnFlowControlBytesWire(conn));
   EXPECT_TRUE(stream->lossBuffer.empty());
   EXPECT_EQ(1, stream->retransmissionBuffer.size());
-  EXPECT_EQ(1000, stream->retransmissionBuffer[0]->data.chainLength());
+  EXPECT_EQ(1000, stream->retransmissionBuffer.at(0)->data.chainLength());
 }
 
 TEST_F(QuicPacketSchedulerTest, RunOutFlowControlDuringStreamWrite) {
@@ -2076,14 +2076,14 @@ TEST_F(QuicPacketSchedulerTest, RunOutFlowControlDuringStreamWrite) {
   EXPECT_EQ(0, getSendConnFlowControlBytesWire(conn));
   EXPECT_EQ(0, stream1->pendingWrites.chainLength());
   EXPECT_EQ(1, stream1->retransmissionBuffer.size());
-  EXPECT_EQ(1000, stream1->retransmissionBuffer[0]->data.chainLength());
+  EXPECT_EQ(1000, stream1->retransmissionBuffer.at(0)->data.chainLength());
 
   auto& writeStreamFrame2 = *packet1.frames[1].asWriteStreamFrame();
   EXPECT_EQ(streamId2, writeStreamFrame2.streamId);
   EXPECT_EQ(200, writeStreamFrame2.len);
   EXPECT_TRUE(stream2->lossBuffer.empty());
   EXPECT_EQ(1, stream2->retransmissionBuffer.size());
-  EXPECT_EQ(200, stream2->retransmissionBuffer[0]->data.chainLength());
+  EXPECT_EQ(200, stream2->retransmissionBuffer.at(0)->data.chainLength());
 }
 
 TEST_F(QuicPacketSchedulerTest, WritingFINFromBufWithBufMetaFirst) {
@@ -2923,7 +2923,7 @@ TEST_F(QuicTransportFunctionsTest, NothingWritten) {
 }
 
 const QuicWriteFrame& getFirstFrameInOutstandingPackets(
-    const std::deque<OutstandingPacketWrapper>& outstandingPackets,
+    const OutstandingPacketList& outstandingPackets,
     QuicWriteFrame::Type frameType) {
   for (const auto& packet : outstandingPackets) {
     for (const auto& frame : packet.packet.frames) {
@@ -4478,6 +4478,106 @@ TEST_F(QuicTransportFunctionsTest, WriteWithInplaceBuilderGSOMultiplePackets) {
   EXPECT_EQ(0, bufPtr->headroom());
 }
 
+TEST_F(QuicTransportFunctionsTest, WriteWithTxTimeSchedule) {
+  auto conn = createConn();
+  conn->transportSettings.dataPathType = DataPathType::ContinuousMemory;
+  auto bufAccessor = std::make_unique<BufAccessor>(conn->udpSendPacketLen * 16);
+  conn->bufAccessor = bufAccessor.get();
+  conn->transportSettings.batchingMode = QuicBatchingMode::BATCHING_MODE_GSO;
+  TxTimeSchedule schedule;
+  schedule.firstBurstSize = 2;
+  schedule.burstSize = 2;
+  schedule.numLaterBursts = 2;
+  schedule.interval = 1000us;
+  conn->txTimeSchedule = schedule;
+  EventBase evb;
+  std::shared_ptr<FollyQuicEventBase> qEvb =
+      std::make_shared<FollyQuicEventBase>(&evb);
+  quic::test::MockAsyncUDPSocket mockSock(qEvb);
+  EXPECT_CALL(mockSock, getGSO()).WillRepeatedly(Return(true));
+  auto stream = conn->streamManager->createNextBidirectionalStream().value();
+  auto buf = buildRandomInputData(conn->udpSendPacketLen * 10);
+  writeDataToQuicStream(*stream, buf->clone(), true);
+  // One GSO batch per burst, each stamped with its departure time.
+  std::vector<std::chrono::microseconds> txTimes;
+  EXPECT_CALL(mockSock, writeGSO(_, _, _, _))
+      .Times(3)
+      .WillRepeatedly(Invoke([&](const folly::SocketAddress&,
+                                 const struct iovec* vec,
+                                 size_t iovec_len,
+                                 QuicAsyncUDPSocket::WriteOptions options) {
+        EXPECT_GT(options.gso, 0);
+        txTimes.push_back(options.txTime);
+        return getTotalIovecLen(vec, iovec_len);
+      }));
+  auto res = writeQuicDataToSocket(
+      mockSock,
+      *conn,
+      *conn->clientConnectionId,
+      *conn->serverConnectionId,
+      *aead,
+      *headerCipher,
+      getVersion(*conn),
+      schedule.packetLimit());
+  EXPECT_EQ(6, res.packetsWritten);
+  EXPECT_EQ(
+      std::vector<std::chrono::microseconds>({0us, 1000us, 2000us}), txTimes);
+  EXPECT_EQ(6, conn->txTimeSchedule->packetsScheduled);
+}
+
+TEST_F(QuicTransportFunctionsTest, UpdateAndGetWritePacketLimit) {
+  auto conn = createConn();
+  EventBase evb;
+  std::shared_ptr<FollyQuicEventBase> qEvb =
+      std::make_shared<FollyQuicEventBase>(&evb);
+  NiceMock<quic::test::MockAsyncUDPSocket> mockSock(qEvb);
+  EXPECT_EQ(
+      conn->transportSettings.writeConnectionDataPacketsLimit,
+      updateAndGetWritePacketLimit(*conn, mockSock));
+
+  auto mockPacer = std::make_unique<NiceMock<MockPacer>>();
+  auto rawPacer = mockPacer.get();
+  conn->pacer = std::move(mockPacer);
+  conn->transportSettings.pacingEnabled = true;
+  conn->canBePaced = true;
+  ON_CALL(*rawPacer, updateAndGetWriteBatchSize(_)).WillByDefault(Return(5));
+  EXPECT_EQ(5, updateAndGetWritePacketLimit(*conn, mockSock));
+
+  // SO_TXTIME pacing needs GSO batching and a socket that accepted SO_TXTIME.
+  conn->transportSettings.txTimePacing = true;
+  conn->transportSettings.batchingMode = QuicBatchingMode::BATCHING_MODE_GSO;
+  conn->gsoSupported = true;
+  EXPECT_CALL(*rawPacer, updateAndGetTxTimeSchedule(_, _)).Times(0);
+  EXPECT_EQ(5, updateAndGetWritePacketLimit(*conn, mockSock));
+  EXPECT_FALSE(conn->txTimeSchedule.has_value());
+
+  ON_CALL(mockSock, getTxTime()).WillByDefault(Return(true));
+  TxTimeSchedule schedule;
+  schedule.firstBurstSize = 5;
+  schedule.burstSize = 5;
+  schedule.numLaterBursts = 3;
+  schedule.interval = 1000us;
+  EXPECT_CALL(
+      *rawPacer,
+      updateAndGetTxTimeSchedule(
+          _, conn->transportSettings.txTimePacingHorizon))
+      .WillOnce(Return(schedule));
+  EXPECT_EQ(20, updateAndGetWritePacketLimit(*conn, mockSock));
+  ASSERT_TRUE(conn->txTimeSchedule.has_value());
+  EXPECT_EQ(1000us, conn->txTimeSchedule->interval);
+
+  // The pacer learns how much of the schedule the write used.
+  conn->txTimeSchedule->packetsScheduled = 7;
+  EXPECT_CALL(
+      *rawPacer,
+      onTxTimeScheduleWritten(
+          testing::Field(&TxTimeSchedule::packetsScheduled, 7)));
+  finishTxTimeSchedule(*conn);
+  EXPECT_FALSE(conn->txTimeSchedule.has_value());
+  EXPECT_CALL(*rawPacer, onTxTimeScheduleWritten(_)).Times(0);
+  finishTxTimeSchedule(*conn);
+}
+
 TEST_F(QuicTransportFunctionsTest, WriteProbingWithInplaceBuilder) {
   auto conn = createConn();
   conn->transportSettings.dataPathType = DataPathType::ContinuousMemory;
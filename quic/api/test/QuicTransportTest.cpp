@@ -3481,10 +3481,7 @@ TEST_F(QuicTransportTest, InvokeDeliveryCallbacksRetxBuffer) {
   streamState->retransmissionBuffer.clear();
   auto retxBufferData = folly::IOBuf::copyBuffer("But i'm not delivered yet");
   streamState->retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(51),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(retxBufferData), 51, false)));
+      ChainedByteRangeHead(retxBufferData), 51, false);
 
   folly::SocketAddress addr;
   NetworkData emptyData;
@@ -3531,10 +3528,7 @@ TEST_F(QuicTransportTest, InvokeDeliveryCallbacksLossAndRetxBuffer) {
   streamState->lossBuffer.clear();
   auto retxBufferData = folly::IOBuf::copyBuffer("But i'm not delivered yet");
   streamState->retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(51),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(retxBufferData), 51, false)));
+      ChainedByteRangeHead(retxBufferData), 51, false);
   auto lossBufferData = folly::IOBuf::copyBuffer("And I'm lost");
   ChainedByteRangeHead lossBufferRch(lossBufferData);
   streamState->lossBuffer.emplace_back(std::move(lossBufferRch), 31, false);
@@ -4709,6 +4703,69 @@ TEST_F(QuicTransportTest, IdleTimeoutPeerDisabled) {
       1000);
 }
 
+TEST_F(QuicTransportTest, CompactIdleConnection) {
+  auto& conn = transport_->getConnectionState();
+  transport_->setCongestionControllerFactory(
+      std::make_shared<DefaultCongestionControllerFactory>());
+  // Stands in for a window grown past the initial one.
+  auto initCwndInMss = conn.transportSettings.initCwndInMss;
+  conn.transportSettings.initCwndInMss = 2 * initCwndInMss;
+  transport_->setCongestionControl(CongestionControlType::Cubic);
+  conn.transportSettings.initCwndInMss = initCwndInMss;
+  auto cwndBytes = conn.congestionController->getCongestionWindow();
+  EXPECT_EQ(cwndBytes, 2 * initCwndInMss * conn.udpSendPacketLen);
+  conn.transportSettings.compactIdleConnectionAfter = 10s;
+  transport_->setIdleTimerNow();
+  ASSERT_TRUE(transport_->compactionTimeout().isTimerCallbackScheduled());
+
+  transport_->compactionTimeout().timeoutExpired();
+  EXPECT_EQ(conn.congestionController, nullptr);
+  auto stats = transport_->getConnectionsStats();
+  EXPECT_TRUE(stats.compacted);
+  EXPECT_EQ(stats.congestionController, CongestionControlType::Cubic);
+  EXPECT_EQ(stats.cwnd_bytes, cwndBytes);
+  EXPECT_LT(stats.bytesAfterCompaction, stats.bytesBeforeCompaction);
+
+  // Receiving a packet brings the congestion controller back, with the window
+  // it had.
+  transport_->onNetworkData(
+      SocketAddress("::1", 10000),
+      NetworkData(ReceivedUdpPacket(IOBuf::copyBuffer("fake data"))));
+  ASSERT_NE(conn.congestionController, nullptr);
+  EXPECT_EQ(conn.congestionController->type(), CongestionControlType::Cubic);
+  EXPECT_EQ(conn.congestionController->getCongestionWindow(), cwndBytes);
+  EXPECT_EQ(conn.transportSettings.initCwndInMss, initCwndInMss);
+  EXPECT_FALSE(transport_->getConnectionsStats().compacted);
+
+  // And so does sending one.
+  transport_->compactionTimeout().timeoutExpired();
+  EXPECT_EQ(conn.congestionController, nullptr);
+  auto streamId = transport_->createBidirectionalStream().value();
+  EXPECT_CALL(*socket_, write(_, _, _))
+      .WillOnce(testing::WithArgs<1, 2>(Invoke(getTotalIovecLen)));
+  transport_->writeChain(streamId, buildRandomInputData(100), false);
+  loopForWrites();
+  ASSERT_NE(conn.congestionController, nullptr);
+  EXPECT_EQ(conn.congestionController->type(), CongestionControlType::Cubic);
+}
+
+TEST_F(QuicTransportTest, NoCompactionWithDataInFlight) {
+  auto& conn = transport_->getConnectionState();
+  conn.transportSettings.compactIdleConnectionAfter = 10s;
+  auto streamId = transport_->createBidirectionalStream().value();
+  EXPECT_CALL(*socket_, write(_, _, _))
+      .WillOnce(testing::WithArgs<1, 2>(Invoke(getTotalIovecLen)));
+  transport_->writeChain(streamId, buildRandomInputData(100), false);
+  loopForWrites();
+  ASSERT_FALSE(conn.outstandings.packets.empty());
+
+  transport_->compactionTimeout().timeoutExpired();
+  EXPECT_NE(conn.congestionController, nullptr);
+  EXPECT_FALSE(transport_->getConnectionsStats().compacted);
+  // It tries again after another idle period.
+  EXPECT_TRUE(transport_->compactionTimeout().isTimerCallbackScheduled());
+}
+
 TEST_F(QuicTransportTest, PacedWriteNoDataToWrite) {
   ASSERT_EQ(
       WriteDataReason::NO_WRITE,
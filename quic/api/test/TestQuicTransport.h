@@ -154,6 +154,10 @@ class TestQuicTransport
     return keepaliveTimeout_;
   }
 
+  auto& compactionTimeout() {
+    return compactionTimeout_;
+  }
+
   CloseState closeState() {
     return closeState_;
   }
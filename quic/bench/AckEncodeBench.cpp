@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/Benchmark.h>
+#include <gflags/gflags.h>
+#include <quic/codec/QuicPacketBuilder.h>
+#include <quic/codec/QuicWriteCodec.h>
+#include <quic/common/BufAccessor.h>
+#include <quic/common/test/TestUtils.h>
+
+/**
+ * Compares the two-pass ACK encoder used by writeAckFrame with the previous
+ * encoder, which sized and wrote the ACK one QUIC integer at a time. Each ACK
+ * has blocks of 100 packets separated by 50 missing packets, so the gaps and
+ * lengths need two byte encodings.
+ */
+
+using namespace quic;
+using namespace quic::test;
+
+namespace {
+
+WriteAckFrameState makeAckState(size_t numRanges) {
+  WriteAckFrameState ackState;
+  PacketNum start = 1000;
+  for (size_t i = 0; i < numRanges; i++) {
+    ackState.acks.insert(start, start + 99);
+    start += 150;
+  }
+  return ackState;
+}
+
+/*
+ * The previous encoder, kept here as the baseline. Only handles plain ACK
+ * frames.
+ */
+void writeAckFramePerInteger(
+    const WriteAckFrameMetaData& ackFrameMetaData,
+    PacketBuilderInterface& builder) {
+  const auto& acks = ackFrameMetaData.ackState.acks;
+  auto spaceLeft = builder.remainingSpaceInPkt();
+  auto largestAckedPacket = acks.back().end;
+  auto firstAckBlockLength = largestAckedPacket - acks.back().start;
+  QuicInteger largestAckedPacketInt(largestAckedPacket);
+  QuicInteger firstAckBlockLengthInt(firstAckBlockLength);
+  uint64_t encodedAckDelay = ackFrameMetaData.ackDelay.count();
+  encodedAckDelay = encodedAckDelay >> ackFrameMetaData.ackDelayExponent;
+  QuicInteger ackDelayInt(encodedAckDelay);
+  QuicInteger minAdditionalAckBlockCount(0);
+  QuicInteger encodedintFrameType(static_cast<uint8_t>(FrameType::ACK));
+  uint64_t headerSize = encodedintFrameType.getSize() +
+      largestAckedPacketInt.getSize() + ackDelayInt.getSize() +
+      minAdditionalAckBlockCount.getSize() + firstAckBlockLengthInt.getSize();
+  CHECK_GE(spaceLeft, headerSize);
+  WriteAckFrame ackFrame;
+  ackFrame.ackBlocks.reserve(spaceLeft / 4);
+  spaceLeft -= headerSize;
+  ackFrame.ackBlocks.push_back(acks.back());
+
+  PacketNum currentSeqNum = acks.crbegin()->start;
+  size_t numAdditionalAckBlocks = 0;
+  size_t previousNumAckBlocks = 0;
+  for (auto blockItr = acks.crbegin() + 1; blockItr != acks.crend();
+       ++blockItr) {
+    const auto& currBlock = *blockItr;
+    PacketNum gap = currentSeqNum - currBlock.end - 2;
+    PacketNum currBlockLen = currBlock.end - currBlock.start;
+    size_t additionalSize = getQuicIntegerSizeThrows(gap) +
+        getQuicIntegerSizeThrows(currBlockLen) +
+        (getQuicIntegerSizeThrows(numAdditionalAckBlocks + 1) -
+         getQuicIntegerSizeThrows(previousNumAckBlocks));
+    if (spaceLeft < additionalSize) {
+      break;
+    }
+    numAdditionalAckBlocks++;
+    spaceLeft -= additionalSize;
+    previousNumAckBlocks = numAdditionalAckBlocks;
+    currentSeqNum = currBlock.start;
+    ackFrame.ackBlocks.emplace_back(currBlock.start, currBlock.end);
+  }
+
+  builder.write(encodedintFrameType);
+  builder.write(largestAckedPacketInt);
+  builder.write(ackDelayInt);
+  builder.write(QuicInteger(numAdditionalAckBlocks));
+  builder.write(firstAckBlockLengthInt);
+  currentSeqNum = acks.back().start;
+  for (auto it = ackFrame.ackBlocks.cbegin() + 1;
+       it != ackFrame.ackBlocks.cend();
+       ++it) {
+    builder.write(QuicInteger(currentSeqNum - it->end - 2));
+    builder.write(QuicInteger(it->end - it->start));
+    currentSeqNum = it->start;
+  }
+  ackFrame.ackDelay = ackFrameMetaData.ackDelay;
+  builder.appendFrame(std::move(ackFrame));
+}
+
+template <typename WriteFn>
+void ackEncodeBench(size_t iters, size_t numRanges, WriteFn writeFn) {
+  folly::BenchmarkSuspender suspender;
+  auto ackState = makeAckState(numRanges);
+  WriteAckFrameMetaData ackMeta{
+      ackState, 25000us, kDefaultAckDelayExponent, Clock::now()};
+  BufAccessor bufAccessor(kDefaultMaxUDPPayload);
+  ShortHeader header(ProtectionType::KeyPhaseZero, getTestConnectionId(), 0);
+  suspender.dismiss();
+  for (size_t i = 0; i < iters; i++) {
+    {
+      InplaceQuicPacketBuilder builder(
+          bufAccessor, kDefaultMaxUDPPayload, header, 0 /* largestAcked */);
+      writeFn(ackMeta, builder);
+    }
+    bufAccessor.buf()->clear();
+  }
+}
+
+void perIntegerBench(size_t iters, size_t numRanges) {
+  ackEncodeBench(iters, numRanges, writeAckFramePerInteger);
+}
+
+void twoPassBench(size_t iters, size_t numRanges) {
+  ackEncodeBench(iters, numRanges, [](const auto& ackMeta, auto& builder) {
+    CHECK(writeAckFrame(ackMeta, builder).has_value());
+  });
+}
+
+} // namespace
+
+BENCHMARK_PARAM(perIntegerBench, 1)
+BENCHMARK_RELATIVE_PARAM(twoPassBench, 1)
+BENCHMARK_PARAM(perIntegerBench, 8)
+BENCHMARK_RELATIVE_PARAM(twoPassBench, 8)
+BENCHMARK_PARAM(perIntegerBench, 32)
+BENCHMARK_RELATIVE_PARAM(twoPassBench, 32)
+BENCHMARK_PARAM(perIntegerBench, 64)
+BENCHMARK_RELATIVE_PARAM(twoPassBench, 64)
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/bench/BenchUtils.h>
+
+#include <quic/codec/QuicPacketBuilder.h>
+#include <quic/codec/QuicWriteCodec.h>
+#include <quic/common/test/TestUtils.h>
+#include <quic/fizz/server/handshake/FizzServerQuicHandshakeContext.h>
+#include <quic/state/QuicStreamFunctions.h>
+
+namespace quic::test {
+
+namespace {
+
+ssize_t iovecLength(const struct iovec* vec, size_t iovec_len) {
+  ssize_t total = 0;
+  for (size_t i = 0; i < iovec_len; i++) {
+    total += vec[i].iov_len;
+  }
+  return total;
+}
+
+} // namespace
+
+ssize_t DiscardingUDPSocket::write(
+    const folly::SocketAddress& /* address */,
+    const struct iovec* vec,
+    size_t iovec_len) {
+  auto written = iovecLength(vec, iovec_len);
+  bytesWritten_ += written;
+  return written;
+}
+
+ssize_t DiscardingUDPSocket::writeGSO(
+    const folly::SocketAddress& /* address */,
+    const struct iovec* vec,
+    size_t iovec_len,
+    WriteOptions /* options */) {
+  auto written = iovecLength(vec, iovec_len);
+  bytesWritten_ += written;
+  return written;
+}
+
+std::unique_ptr<QuicServerConnectionState> makeBenchConnection(
+    const BenchConnectionParams& params) {
+  auto conn = std::make_unique<QuicServerConnectionState>(
+      FizzServerQuicHandshakeContext::Builder().build());
+  conn->serverConnectionId = getTestConnectionId(0);
+  conn->clientConnectionId = getTestConnectionId(1);
+  conn->version = QuicVersion::MVFST;
+  conn->flowControlState.peerAdvertisedInitialMaxStreamOffsetBidiLocal =
+      kMaxVarInt;
+  conn->flowControlState.peerAdvertisedInitialMaxStreamOffsetBidiRemote =
+      kMaxVarInt;
+  conn->flowControlState.peerAdvertisedInitialMaxStreamOffsetUni = kMaxVarInt;
+  conn->flowControlState.peerAdvertisedMaxOffset = kMaxVarInt;
+  conn->streamManager->setMaxLocalBidirectionalStreams(kMaxMaxStreams);
+  conn->streamManager->setMaxLocalUnidirectionalStreams(kMaxMaxStreams);
+
+  addOutstandingPackets(*conn, params.numOutstandingPackets);
+
+  for (size_t i = 0; i < params.numStreams; i++) {
+    auto stream = conn->streamManager->createNextBidirectionalStream();
+    CHECK(stream.hasValue());
+    if (params.bytesPerStream > 0) {
+      auto buf = folly::IOBuf::create(params.bytesPerStream);
+      buf->append(params.bytesPerStream);
+      std::memset(buf->writableData(), 'a', params.bytesPerStream);
+      writeDataToQuicStream(**stream, std::move(buf), false /* eof */);
+    }
+  }
+  return conn;
+}
+
+void addOutstandingPackets(QuicServerConnectionState& conn, size_t count) {
+  auto& packets = conn.outstandings.packets;
+  PacketNum nextPacketNum = packets.empty()
+      ? 0
+      : packets.back().packet.header.getPacketSequenceNum() + 1;
+  auto sentTime = Clock::now();
+  for (size_t i = 0; i < count; i++) {
+    auto packetNum = nextPacketNum++;
+    auto regularPacket = createNewPacket(packetNum, PacketNumberSpace::AppData);
+    regularPacket.frames.emplace_back(WriteStreamFrame(0, packetNum, 1, false));
+    conn.outstandings.packetCount[PacketNumberSpace::AppData]++;
+    packets.emplace_back(
+        std::move(regularPacket),
+        sentTime,
+        1,
+        0,
+        packetNum,
+        packetNum + 1,
+        LossState(),
+        0,
+        OutstandingPacketMetadata::DetailsPerStream());
+  }
+  conn.ackStates.appDataAckState.nextPacketNum = nextPacketNum;
+}
+
+ReadAckFrame makeReadAckFrame(
+    PacketNum firstPacketNum,
+    size_t numPackets,
+    size_t numBlocks,
+    size_t gapSize) {
+  CHECK_GT(numBlocks, 0);
+  CHECK_GE(numPackets, numBlocks);
+  ReadAckFrame ackFrame;
+  auto blockSize = numPackets / numBlocks;
+  auto blockEnd = firstPacketNum + numBlocks * (blockSize + gapSize) - gapSize;
+  ackFrame.largestAcked = blockEnd - 1;
+  for (size_t i = 0; i < numBlocks; i++) {
+    ackFrame.ackBlocks.emplace_back(blockEnd - blockSize, blockEnd - 1);
+    blockEnd -= blockSize + gapSize;
+  }
+  return ackFrame;
+}
+
+std::unique_ptr<folly::IOBuf> makePacketBody(
+    size_t numAckBlocks,
+    size_t streamDataLen) {
+  RegularQuicPacketBuilder builder(
+      kDefaultUDPSendPacketLen,
+      ShortHeader(ProtectionType::KeyPhaseZero, getTestConnectionId(), 0),
+      0 /* largestAcked */);
+  builder.encodePacketHeader();
+  if (numAckBlocks > 0) {
+    // Blocks of two packets separated by single packet gaps.
+    WriteAckFrameState ackState;
+    for (PacketNum i = 0; i < numAckBlocks; i++) {
+      ackState.acks.insert(i * 3, i * 3 + 1);
+    }
+    WriteAckFrameMetaData ackMeta{
+        ackState, 0us, kDefaultAckDelayExponent, Clock::now()};
+    CHECK(writeAckFrame(ackMeta, builder).has_value());
+  }
+  if (streamDataLen > 0) {
+    auto data = folly::IOBuf::create(streamDataLen);
+    data->append(streamDataLen);
+    std::memset(data->writableData(), 'a', streamDataLen);
+    auto dataLen = *writeStreamFrameHeader(
+        builder,
+        0 /* id */,
+        0 /* offset */,
+        streamDataLen,
+        streamDataLen,
+        false /* fin */,
+        none /* skipLenHint */);
+    CHECK(dataLen.has_value());
+    writeStreamFrameData(builder, ChainedByteRangeHead(data), *dataLen);
+  }
+  auto packet = std::move(builder).buildPacket();
+  return packet.body.clone();
+}
+
+} // namespace quic::test
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <quic/codec/Types.h>
+#include <quic/common/udpsocket/FollyQuicAsyncUDPSocket.h>
+#include <quic/server/state/ServerStateMachine.h>
+
+namespace quic::test {
+
+/**
+ * A UDP socket that accepts every write without touching the network, so the
+ * write path can be measured without syscall noise.
+ */
+class DiscardingUDPSocket : public FollyQuicAsyncUDPSocket {
+ public:
+  explicit DiscardingUDPSocket(std::shared_ptr<FollyQuicEventBase> evb)
+      : FollyQuicAsyncUDPSocket(std::move(evb)) {}
+
+  ssize_t write(
+      const folly::SocketAddress& address,
+      const struct iovec* vec,
+      size_t iovec_len) override;
+
+  ssize_t writeGSO(
+      const folly::SocketAddress& address,
+      const struct iovec* vec,
+      size_t iovec_len,
+      WriteOptions options) override;
+
+  int getGSO() override {
+    return 0;
+  }
+
+  [[nodiscard]] uint64_t bytesWritten() const {
+    return bytesWritten_;
+  }
+
+ private:
+  uint64_t bytesWritten_{0};
+};
+
+/**
+ * Shape of the synthetic connection state the benchmarks operate on.
+ */
+struct BenchConnectionParams {
+  // Number of ack-eliciting AppData packets outstanding.
+  size_t numOutstandingPackets{0};
+  // Number of open bidirectional streams.
+  size_t numStreams{0};
+  // Bytes of pending write data queued on each stream.
+  size_t bytesPerStream{0};
+};
+
+/**
+ * Builds a server connection state that is past the handshake, with flow
+ * control windows large enough that they never limit the benchmarks.
+ */
+std::unique_ptr<QuicServerConnectionState> makeBenchConnection(
+    const BenchConnectionParams& params);
+
+/**
+ * Appends count ack-eliciting AppData packets, each carrying a single stream
+ * frame, to the connection's outstanding packets.
+ */
+void addOutstandingPackets(QuicServerConnectionState& conn, size_t count);
+
+/**
+ * Builds an ACK for numPackets packets starting at firstPacketNum, split into
+ * numBlocks blocks separated by gapSize unacked packets. The blocks are in
+ * descending order like they are on the wire.
+ */
+ReadAckFrame makeReadAckFrame(
+    PacketNum firstPacketNum,
+    size_t numPackets,
+    size_t numBlocks,
+    size_t gapSize);
+
+/**
+ * Builds the cleartext body of a short header packet. When numAckBlocks is
+ * non-zero the body starts with an ACK frame with that many blocks, and when
+ * streamDataLen is non-zero it carries a stream frame of that length.
+ */
+std::unique_ptr<folly::IOBuf> makePacketBody(
+    size_t numAckBlocks,
+    size_t streamDataLen);
+
+} // namespace quic::test
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/container/F14Map.h>
+#include <folly/io/Cursor.h>
+#include <gflags/gflags.h>
+#include <quic/codec/Decode.h>
+#include <quic/codec/DefaultConnectionIdAlgo.h>
+
+#include <array>
+#include <cstring>
+
+/**
+ * Compares how QuicServerWorker finds the transport for a short header packet
+ * on the regular path (parse the header into a ConnectionId, decode it and
+ * look it up by ConnectionId) with the fixed-length path (decode the id in
+ * place and look it up by its bytes loaded as one integer). One iteration
+ * routes one packet, so iters/s is the packets per second routed on a core.
+ */
+
+using namespace quic;
+
+namespace {
+
+constexpr uint8_t kWorkerId = 42;
+constexpr uint8_t kProcessId = 1;
+constexpr size_t kNumPackets = 4096;
+
+uint64_t fixedLengthConnIdKey(const uint8_t* data) {
+  uint64_t key;
+  memcpy(&key, data, sizeof(key));
+  return key;
+}
+
+/**
+ * Short header packets for numConns connections of one worker, in a random
+ * order, and the maps from their connection ids to a stand-in transport.
+ */
+class RoutingFixture {
+ public:
+  explicit RoutingFixture(size_t numConns) {
+    DefaultConnectionIdAlgo connIdAlgo;
+    std::vector<ConnectionId> connIds;
+    for (size_t i = 0; i < numConns; i++) {
+      auto connId = *connIdAlgo.encodeConnectionId(ServerConnectionIdParams(
+          ConnectionIdVersion::V1, 0x1234, kProcessId, kWorkerId));
+      connIds.push_back(connId);
+      byConnId_.emplace(connId, &transports_[i % transports_.size()]);
+      byKey_.emplace(
+          fixedLengthConnIdKey(connId.data()),
+          &transports_[i % transports_.size()]);
+    }
+    for (size_t i = 0; i < kNumPackets; i++) {
+      const auto& connId = connIds[folly::Random::rand32(connIds.size())];
+      // Initial byte, dst conn id, then a packet number and payload.
+      auto packet = folly::IOBuf::create(kDefaultUDPSendPacketLen);
+      packet->append(kDefaultUDPSendPacketLen);
+      memset(packet->writableData(), 0, packet->length());
+      packet->writableData()[0] = ShortHeader::kFixedBitMask;
+      memcpy(packet->writableData() + 1, connId.data(), connId.size());
+      packets_.push_back(std::move(packet));
+    }
+  }
+
+  int* routeByConnId(const folly::IOBuf& packet) {
+    folly::io::Cursor cursor(&packet);
+    auto initialByte = cursor.readBE<uint8_t>();
+    auto shortHeader = parseShortHeaderInvariants(initialByte, cursor);
+    if (!shortHeader) {
+      return nullptr;
+    }
+    const auto& dstConnId = shortHeader->destinationConnId;
+    if (!connIdAlgo_.canParse(dstConnId)) {
+      return nullptr;
+    }
+    auto params = connIdAlgo_.parseConnectionId(dstConnId);
+    if (params.hasError() || params->workerId != kWorkerId) {
+      return nullptr;
+    }
+    auto it = byConnId_.find(dstConnId);
+    return it == byConnId_.end() ? nullptr : it->second;
+  }
+
+  int* routeByKey(const folly::IOBuf& packet) {
+    if (packet.length() < 1 + kDefaultConnectionIdSize) {
+      return nullptr;
+    }
+    const uint8_t* connIdData = packet.data() + 1;
+    auto params = DefaultConnectionIdAlgo::parseConnectionIdDefault(
+        connIdData, kDefaultConnectionIdSize);
+    if (params.hasError() || params->workerId != kWorkerId ||
+        params->processId != kProcessId) {
+      return nullptr;
+    }
+    auto it = byKey_.find(fixedLengthConnIdKey(connIdData));
+    return it == byKey_.end() ? nullptr : it->second;
+  }
+
+  const std::vector<std::unique_ptr<folly::IOBuf>>& packets() const {
+    return packets_;
+  }
+
+ private:
+  DefaultConnectionIdAlgo connIdAlgo_;
+  std::array<int, 64> transports_{};
+  folly::F14FastMap<ConnectionId, int*, ConnectionIdHash> byConnId_;
+  folly::F14FastMap<uint64_t, int*> byKey_;
+  std::vector<std::unique_ptr<folly::IOBuf>> packets_;
+};
+
+template <typename RouteFn>
+void routingBench(size_t iters, size_t numConns, RouteFn routeFn) {
+  folly::BenchmarkSuspender suspender;
+  RoutingFixture fixture(numConns);
+  const auto& packets = fixture.packets();
+  suspender.dismiss();
+  for (size_t i = 0; i < iters; i++) {
+    auto transport = routeFn(fixture, *packets[i % packets.size()]);
+    CHECK(transport);
+    folly::doNotOptimizeAway(transport);
+  }
+}
+
+void connIdRoutingBench(size_t iters, size_t numConns) {
+  routingBench(iters, numConns, [](auto& fixture, const auto& packet) {
+    return fixture.routeByConnId(packet);
+  });
+}
+
+void fixedLengthRoutingBench(size_t iters, size_t numConns) {
+  routingBench(iters, numConns, [](auto& fixture, const auto& packet) {
+    return fixture.routeByKey(packet);
+  });
+}
+
+} // namespace
+
+BENCHMARK_PARAM(connIdRoutingBench, 100)
+BENCHMARK_RELATIVE_PARAM(fixedLengthRoutingBench, 100)
+BENCHMARK_PARAM(connIdRoutingBench, 10000)
+BENCHMARK_RELATIVE_PARAM(fixedLengthRoutingBench, 10000)
+BENCHMARK_PARAM(connIdRoutingBench, 1000000)
+BENCHMARK_RELATIVE_PARAM(fixedLengthRoutingBench, 1000000)
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+#include <folly/Benchmark.h>
+#include <folly/io/async/EventBase.h>
+#include <gflags/gflags.h>
+#include <quic/api/QuicTransportFunctions.h>
+#include <quic/bench/BenchUtils.h>
+#include <quic/codec/Decode.h>
+#include <quic/common/events/FollyQuicEventBase.h>
+#include <quic/fizz/handshake/FizzCryptoFactory.h>
+#include <quic/loss/QuicLossFunctions.h>
+#include <quic/state/AckHandlers.h>
+
+/**
+ * Microbenchmarks for the per-packet hot paths of a connection. Each
+ * benchmark reports ns/op from folly::Benchmark and an allocs/op counter.
+ *
+ * The allocation counter is maintained by the global operator new below, so
+ * it only sees allocations made through new. Buffers that folly::IOBuf
+ * allocates with malloc directly are not counted.
+ */
+
+DEFINE_uint64(
+    outstanding_packets,
+    10000,
+    "Outstanding packets in the ACK and loss detection benchmarks");
+DEFINE_uint64(
+    acked_packets,
+    64,
+    "Packets acknowledged by each ACK in the processAckFrame benchmark");
+DEFINE_uint64(ack_blocks, 16, "ACK blocks per ACK frame");
+DEFINE_uint64(num_streams, 16, "Streams with pending data when writing");
+DEFINE_uint64(stream_bytes, 16 * 1024, "Pending bytes per stream when writing");
+DEFINE_uint64(
+    write_packet_limit,
+    quic::kDefaultWriteConnectionDataPacketLimit,
+    "Packet limit passed to writeQuicDataToSocket");
+DEFINE_uint64(stream_frame_bytes, 1000, "Stream frame payload when decoding");
+
+namespace {
+
+std::atomic<uint64_t> gAllocations{0};
+
+} // namespace
+
+void* operator new(std::size_t size) {
+  gAllocations.fetch_add(1, std::memory_order_relaxed);
+  if (auto* p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t /* size */) noexcept {
+  std::free(p);
+}
+
+using namespace quic;
+using namespace quic::test;
+
+namespace {
+
+/**
+ * Samples the allocation counter around the measured part of a benchmark and
+ * reports the per-iteration average.
+ */
+class AllocationCounter {
+ public:
+  void start() {
+    start_ = gAllocations.load(std::memory_order_relaxed);
+  }
+
+  void stop() {
+    total_ += gAllocations.load(std::memory_order_relaxed) - start_;
+  }
+
+  void report(folly::UserCounters& counters, size_t iters) const {
+    counters["allocs/op"] = folly::UserMetric(
+        iters ? static_cast<double>(total_) / iters : 0,
+        folly::UserMetric::Type::METRIC);
+  }
+
+ private:
+  uint64_t start_{0};
+  uint64_t total_{0};
+};
+
+TimePoint sentTimeOf(const OutstandingPacketWrapper& packet) {
+  return packet.metadata.time;
+}
+
+void processAckFrameBench(folly::UserCounters& counters, size_t iters) {
+  folly::BenchmarkSuspender suspender;
+  AllocationCounter allocs;
+  auto conn = makeBenchConnection(
+      {.numOutstandingPackets = FLAGS_outstanding_packets});
+  conn->congestionController = nullptr;
+  for (size_t i = 0; i < iters; i++) {
+    // ACK the oldest packets, then replace them so that every iteration sees
+    // the same amount of outstanding state.
+    auto firstPacketNum =
+        conn->outstandings.packets.front().packet.header.getPacketSequenceNum();
+    auto ackFrame = makeReadAckFrame(
+        firstPacketNum, FLAGS_acked_packets, FLAGS_ack_blocks, 0);
+    auto ackTime = sentTimeOf(conn->outstandings.packets.back());
+    suspender.dismiss();
+    allocs.start();
+    processAckFrame(
+        *conn,
+        PacketNumberSpace::AppData,
+        ackFrame,
+        [](const auto&) {},
+        [](const auto&, const auto&) {},
+        [](auto&, auto&, bool) {},
+        ackTime);
+    allocs.stop();
+    suspender.rehire();
+    addOutstandingPackets(*conn, FLAGS_acked_packets);
+  }
+  allocs.report(counters, iters);
+}
+
+void detectLossPacketsBench(folly::UserCounters& counters, size_t iters) {
+  folly::BenchmarkSuspender suspender;
+  AllocationCounter allocs;
+  auto conn = makeBenchConnection(
+      {.numOutstandingPackets = FLAGS_outstanding_packets});
+  conn->congestionController = nullptr;
+  // Nothing is declared lost, so each iteration walks the whole outstanding
+  // list, which is the worst case for loss detection.
+  conn->lossState.reorderingThreshold = std::numeric_limits<uint32_t>::max();
+  conn->lossState.srtt = 1s;
+  conn->lossState.lrtt = 1s;
+  auto& ackState = conn->ackStates.appDataAckState;
+  ackState.largestAckedByPeer =
+      conn->outstandings.packets.back().packet.header.getPacketSequenceNum();
+  auto lossTime = sentTimeOf(conn->outstandings.packets.back());
+  suspender.dismiss();
+  allocs.start();
+  for (size_t i = 0; i < iters; i++) {
+    auto lossEvent = detectLossPackets(
+        *conn,
+        ackState,
+        [](auto&, auto&, bool) {},
+        lossTime,
+        PacketNumberSpace::AppData);
+    folly::doNotOptimizeAway(lossEvent);
+  }
+  allocs.stop();
+  suspender.rehire();
+  allocs.report(counters, iters);
+}
+
+void writeQuicDataToSocketBench(folly::UserCounters& counters, size_t iters) {
+  folly::BenchmarkSuspender suspender;
+  AllocationCounter allocs;
+  folly::EventBase evb;
+  auto qEvb = std::make_shared<FollyQuicEventBase>(&evb);
+  DiscardingUDPSocket sock(qEvb);
+  FizzCryptoFactory cryptoFactory;
+  auto aead = cryptoFactory.getServerInitialCipher(
+      getTestConnectionId(1), QuicVersion::MVFST);
+  auto headerCipher = cryptoFactory.makeServerInitialHeaderCipher(
+      getTestConnectionId(1), QuicVersion::MVFST);
+  size_t packetsWritten = 0;
+  for (size_t i = 0; i < iters; i++) {
+    // Start from a fresh connection so that the outstanding packet list and
+    // stream write buffers do not grow across iterations.
+    auto conn = makeBenchConnection(
+        {.numStreams = FLAGS_num_streams,
+         .bytesPerStream = FLAGS_stream_bytes});
+    suspender.dismiss();
+    allocs.start();
+    auto result = writeQuicDataToSocket(
+        sock,
+        *conn,
+        *conn->serverConnectionId,
+        *conn->clientConnectionId,
+        *aead,
+        *headerCipher,
+        QuicVersion::MVFST,
+        FLAGS_write_packet_limit);
+    allocs.stop();
+    suspender.rehire();
+    packetsWritten += result.packetsWritten;
+  }
+  CHECK_GT(packetsWritten, 0);
+  allocs.report(counters, iters);
+}
+
+void parseFrameBench(
+    folly::UserCounters& counters,
+    size_t iters,
+    size_t numAckBlocks,
+    size_t streamDataLen) {
+  folly::BenchmarkSuspender suspender;
+  AllocationCounter allocs;
+  auto body = makePacketBody(numAckBlocks, streamDataLen);
+  PacketHeader header(
+      ShortHeader(ProtectionType::KeyPhaseZero, getTestConnectionId()));
+  CodecParameters params(kDefaultAckDelayExponent, QuicVersion::MVFST);
+  for (size_t i = 0; i < iters; i++) {
+    BufQueue queue(body->clone());
+    suspender.dismiss();
+    allocs.start();
+    auto frame = parseFrame(queue, header, params);
+    folly::doNotOptimizeAway(frame);
+    allocs.stop();
+    suspender.rehire();
+  }
+  allocs.report(counters, iters);
+}
+
+void decodeRegularPacketBench(
+    folly::UserCounters& counters,
+    size_t iters,
+    size_t numAckBlocks,
+    size_t streamDataLen) {
+  folly::BenchmarkSuspender suspender;
+  AllocationCounter allocs;
+  auto body = makePacketBody(numAckBlocks, streamDataLen);
+  CodecParameters params(kDefaultAckDelayExponent, QuicVersion::MVFST);
+  for (size_t i = 0; i < iters; i++) {
+    auto data = body->clone();
+    PacketHeader header(
+        ShortHeader(ProtectionType::KeyPhaseZero, getTestConnectionId()));
+    suspender.dismiss();
+    allocs.start();
+    auto packet =
+        decodeRegularPacket(std::move(header), params, std::move(data));
+    folly::doNotOptimizeAway(packet);
+    allocs.stop();
+    suspender.rehire();
+  }
+  allocs.report(counters, iters);
+}
+
+} // namespace
+
+BENCHMARK_COUNTERS(processAckFrame, counters, iters) {
+  processAckFrameBench(counters, iters);
+}
+
+BENCHMARK_COUNTERS(detectLossPackets, counters, iters) {
+  detectLossPacketsBench(counters, iters);
+}
+
+BENCHMARK_COUNTERS(writeQuicDataToSocket, counters, iters) {
+  writeQuicDataToSocketBench(counters, iters);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_COUNTERS(parseFrameAck, counters, iters) {
+  parseFrameBench(counters, iters, FLAGS_ack_blocks, 0);
+}
+
+BENCHMARK_COUNTERS(parseFrameStream, counters, iters) {
+  parseFrameBench(counters, iters, 0, FLAGS_stream_frame_bytes);
+}
+
+BENCHMARK_COUNTERS(decodeRegularPacket, counters, iters) {
+  decodeRegularPacketBench(
+      counters, iters, FLAGS_ack_blocks, FLAGS_stream_frame_bytes);
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <ctime>
+
+#include <folly/Benchmark.h>
+#include <folly/io/async/EventBase.h>
+#include <folly/portability/Sockets.h>
+#include <gflags/gflags.h>
+#include <quic/api/QuicBatchWriterFactory.h>
+#include <quic/bench/BenchUtils.h>
+#include <quic/common/BufAccessor.h>
+#include <quic/common/ZeroCopyBufferRing.h>
+#include <quic/common/events/FollyQuicEventBase.h>
+
+#ifdef FOLLY_HAVE_MSG_ERRQUEUE
+#include <linux/errqueue.h>
+#endif
+
+/**
+ * Compares the CPU cost per byte of GSO writes from the ContinuousMemory data
+ * path with and without MSG_ZEROCOPY, sending to a socket on loopback.
+ *
+ * Loopback delivery makes the kernel copy zerocopy payloads anyway, and it
+ * reports every completion as copied, so on loopback this mostly measures the
+ * overhead zerocopy adds: pinning pages, building the completion and reading
+ * the error queue. Run it against a real NIC to see the savings.
+ */
+
+DEFINE_uint64(zc_packet_size, 1200, "Size of each packet in a GSO write");
+DEFINE_uint64(zc_packets_per_write, 50, "Packets per GSO write");
+DEFINE_uint64(zc_ring_buffers, 8, "Spare buffers for zerocopy writes");
+
+using namespace quic;
+using namespace quic::test;
+
+namespace {
+
+uint64_t threadCpuNanos() {
+  struct timespec ts;
+  ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * A UDP socket on loopback that the benchmark sends to. Its receive queue is
+ * drained outside of the measured section.
+ */
+class LoopbackReceiver {
+ public:
+  LoopbackReceiver() {
+    fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    CHECK_GE(fd_, 0);
+    int rcvBuf = 64 * 1024 * 1024;
+    ::setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &rcvBuf, sizeof(rcvBuf));
+    folly::SocketAddress bindAddr("127.0.0.1", 0);
+    sockaddr_storage addrStorage;
+    auto addrLen = bindAddr.getAddress(&addrStorage);
+    CHECK_EQ(
+        ::bind(fd_, reinterpret_cast<sockaddr*>(&addrStorage), addrLen), 0);
+    address_.setFromLocalAddress(folly::NetworkSocket::fromFd(fd_));
+  }
+
+  ~LoopbackReceiver() {
+    ::close(fd_);
+  }
+
+  [[nodiscard]] const folly::SocketAddress& address() const {
+    return address_;
+  }
+
+  void drain() {
+    char buf[2048];
+    while (::recv(fd_, buf, sizeof(buf), MSG_DONTWAIT) > 0) {
+    }
+  }
+
+ private:
+  int fd_{-1};
+  folly::SocketAddress address_;
+};
+
+/**
+ * Reads zerocopy completions off the sending socket's error queue.
+ */
+void drainErrorQueue(int fd, ZeroCopyBufferRing& ring) {
+#ifdef FOLLY_HAVE_MSG_ERRQUEUE
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(sock_extended_err)) * 2];
+  while (true) {
+    struct msghdr msg = {};
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    if (::recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+      return;
+    }
+    for (auto* cmsg = CMSG_FIRSTHDR(&msg); cmsg;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      ring.onErrMessage(*cmsg);
+    }
+  }
+#else
+  (void)fd;
+  (void)ring;
+#endif
+}
+
+void gsoWriteBench(folly::UserCounters& counters, size_t iters, bool zeroCopy) {
+  folly::BenchmarkSuspender suspender;
+  folly::EventBase evb;
+  auto qEvb = std::make_shared<FollyQuicEventBase>(&evb);
+  FollyQuicAsyncUDPSocket sock(qEvb);
+  sock.bind(folly::SocketAddress("127.0.0.1", 0));
+  CHECK_GE(sock.getGSO(), 0) << "GSO is not available";
+  LoopbackReceiver receiver;
+
+  auto conn = makeBenchConnection({});
+  conn->udpSendPacketLen = FLAGS_zc_packet_size;
+  auto capacity = FLAGS_zc_packet_size * FLAGS_zc_packets_per_write;
+  BufAccessor bufAccessor(capacity);
+  conn->bufAccessor = &bufAccessor;
+  Optional<ZeroCopyBufferRing> ring;
+  if (zeroCopy) {
+    CHECK(sock.setZeroCopy(true)) << "SO_ZEROCOPY is not available";
+    ring.emplace(capacity, FLAGS_zc_ring_buffers);
+    conn->zeroCopyBufferRing = &ring.value();
+  }
+  auto batchWriter = BatchWriterFactory::makeBatchWriter(
+      QuicBatchingMode::BATCHING_MODE_GSO,
+      FLAGS_zc_packets_per_write,
+      false /* enableBackpressure */,
+      DataPathType::ContinuousMemory,
+      *conn,
+      true /* gsoSupported */);
+
+  uint64_t cpuNanos = 0;
+  uint64_t bytesWritten = 0;
+  for (size_t i = 0; i < iters; i++) {
+    for (size_t j = 0; j < FLAGS_zc_packets_per_write; j++) {
+      bufAccessor.append(FLAGS_zc_packet_size);
+      batchWriter->append(
+          nullptr, FLAGS_zc_packet_size, receiver.address(), &sock);
+    }
+    suspender.dismiss();
+    auto start = threadCpuNanos();
+    auto ret = batchWriter->write(sock, receiver.address());
+    if (ring) {
+      drainErrorQueue(sock.getFD(), *ring);
+    }
+    cpuNanos += threadCpuNanos() - start;
+    suspender.rehire();
+    batchWriter->reset();
+    if (ret > 0) {
+      bytesWritten += ret;
+    }
+    receiver.drain();
+  }
+
+  counters["cpu_ns/KB"] = folly::UserMetric(
+      bytesWritten ? static_cast<double>(cpuNanos) * 1024 / bytesWritten : 0,
+      folly::UserMetric::Type::METRIC);
+  if (ring) {
+    counters["copied%"] = folly::UserMetric(
+        ring->numCompletedSends()
+            ? 100.0 * ring->numCopiedSends() / ring->numCompletedSends()
+            : 0,
+        folly::UserMetric::Type::METRIC);
+  }
+}
+
+} // namespace
+
+BENCHMARK_COUNTERS(gsoWriteCopy, counters, iters) {
+  gsoWriteBench(counters, iters, false /* zeroCopy */);
+}
+
+BENCHMARK_COUNTERS(gsoWriteZeroCopy, counters, iters) {
+  gsoWriteBench(counters, iters, true /* zeroCopy */);
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
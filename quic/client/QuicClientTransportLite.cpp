@@ -970,14 +970,12 @@ void QuicClientTransportLite::writeData() {
     return;
   }
 
-  uint64_t packetLimit =
-      (isConnectionPaced(*conn_)
-           ? conn_->pacer->updateAndGetWriteBatchSize(Clock::now())
-           : conn_->transportSettings.writeConnectionDataPacketsLimit);
+  uint64_t packetLimit = updateAndGetWritePacketLimit(*conn_, *socket_);
   // At the end of this function, clear out any probe packets credit we didn't
   // use.
   SCOPE_EXIT {
     conn_->pendingEvents.numProbePackets = {};
+    finishTxTimeSchedule(*conn_);
     maybeInitiateKeyUpdate(*conn_);
   };
   if (conn_->initialWriteCipher) {
@@ -1110,6 +1108,9 @@ bool QuicClientTransportLite::isTLSResumed() const {
 
 void QuicClientTransportLite::errMessage(
     [[maybe_unused]] const cmsghdr& cmsg) noexcept {
+  if (zeroCopyBufferRing_ && zeroCopyBufferRing_->onErrMessage(cmsg)) {
+    return;
+  }
 #ifdef FOLLY_HAVE_MSG_ERRQUEUE
   if ((cmsg.cmsg_level == SOL_IP && cmsg.cmsg_type == IP_RECVERR) ||
       (cmsg.cmsg_level == SOL_IPV6 && cmsg.cmsg_type == IPV6_RECVERR)) {
@@ -1913,7 +1914,39 @@ void QuicClientTransportLite::onNetworkSwitch(
 
     // adjust the GRO buffers
     adjustGROBuffers();
+
+    // The kernel numbers zerocopy sends per socket, so start over with a new
+    // ring for the new socket.
+    if (conn_->zeroCopyBufferRing) {
+      auto capacity = zeroCopyBufferRing_->capacity();
+      conn_->zeroCopyBufferRing = nullptr;
+      zeroCopyBufferRing_.reset();
+      createZeroCopyBufferRing(
+          capacity, conn_->transportSettings.zeroCopyWriteBuffers);
+    }
+  }
+}
+
+void QuicClientTransportLite::createZeroCopyBufferRing(
+    size_t capacity,
+    size_t numBuffers) {
+  if (zeroCopyBufferRing_) {
+    // Replacing the ring would lose track of sends the kernel has not
+    // completed yet, so keep the existing one if it still fits.
+    if (zeroCopyBufferRing_->capacity() != capacity) {
+      LOG(ERROR) << "Disabling zerocopy writes, buffer capacity changed from "
+                 << zeroCopyBufferRing_->capacity() << " to " << capacity;
+      conn_->zeroCopyBufferRing = nullptr;
+    }
+    return;
+  }
+  if (!socket_ || !socket_->setZeroCopy(true)) {
+    VLOG(4) << "Zerocopy writes are not supported on this socket " << *this;
+    return;
   }
+  zeroCopyBufferRing_ =
+      std::make_unique<ZeroCopyBufferRing>(capacity, numBuffers);
+  conn_->zeroCopyBufferRing = zeroCopyBufferRing_.get();
 }
 
 void QuicClientTransportLite::setTransportStatsCallback(
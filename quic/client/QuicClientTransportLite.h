@@ -15,6 +15,7 @@
 #include <quic/client/state/ClientStateMachine.h>
 #include <quic/common/BufAccessor.h>
 #include <quic/common/BufUtil.h>
+#include <quic/common/ZeroCopyBufferRing.h>
 #include <quic/common/udpsocket/QuicAsyncUDPSocket.h>
 #include <quic/state/QuicConnectionStats.h>
 
@@ -223,6 +224,8 @@ class QuicClientTransportLite
     conn_->bufAccessor = bufAccessor_.get();
   }
 
+  void createZeroCopyBufferRing(size_t capacity, size_t numBuffers) override;
+
   Optional<std::vector<TransportParameter>> getPeerTransportParams()
       const override;
 
@@ -422,5 +425,7 @@ class QuicClientTransportLite
 
   // Output buf/accessor to be used for continuous memory writes.
   std::unique_ptr<BufAccessor> bufAccessor_;
+  // Spare output buffers for zerocopy writes, fed by errMessage().
+  std::unique_ptr<ZeroCopyBufferRing> zeroCopyBufferRing_;
 };
 } // namespace quic
@@ -217,6 +217,11 @@ folly::Expected<ReadAckFrame, QuicError> decodeAckFrame(
   }
   frame.ackDelay = std::chrono::microseconds(adjustedDelay);
 
+  // Size the blocks up front rather than growing them block by block. Every
+  // block takes at least two bytes, which bounds a bogus block count.
+  frame.ackBlocks.reserve(
+      1 +
+      std::min<uint64_t>(additionalAckBlocks->first, cursor.totalLength() / 2));
   frame.ackBlocks.emplace_back(currentPacketNum, largestAcked);
   for (uint64_t numBlocks = 0; numBlocks < additionalAckBlocks->first;
        ++numBlocks) {
@@ -275,6 +280,9 @@ static folly::Expected<folly::Unit, QuicError> decodeReceiveTimestampsInAck(
         quic::TransportErrorCode::FRAME_ENCODING_ERROR,
         "Bad receive timestamps range count"));
   }
+  // Every range takes at least two bytes.
+  frame.recvdPacketsTimestampRanges.reserve(
+      std::min<uint64_t>(timeStampRangeCount->first, cursor.totalLength() / 2));
   for (uint64_t numRanges = 0; numRanges < timeStampRangeCount->first;
        numRanges++) {
     RecvdPacketsTimestampsRange timeStampRange;
@@ -292,6 +300,8 @@ static folly::Expected<folly::Unit, QuicError> decodeReceiveTimestampsInAck(
           "Bad receive timestamps block length"));
     }
     timeStampRange.timestamp_delta_count = receiveTimeStampsLen->first;
+    timeStampRange.deltas.reserve(
+        std::min<uint64_t>(receiveTimeStampsLen->first, cursor.totalLength()));
     uint8_t receiveTimestampsExponentToUse =
         (params.maybeAckReceiveTimestampsConfig)
         ? params.maybeAckReceiveTimestampsConfig.value()
@@ -313,7 +323,7 @@ static folly::Expected<folly::Unit, QuicError> decodeReceiveTimestampsInAck(
       auto adjustedDelta = *res;
       timeStampRange.deltas.push_back(adjustedDelta);
     }
-    frame.recvdPacketsTimestampRanges.emplace_back(timeStampRange);
+    frame.recvdPacketsTimestampRanges.emplace_back(std::move(timeStampRange));
   }
   return folly::unit;
 }
@@ -344,7 +354,7 @@ ReadAckFrame decodeAckExtendedFrame(
     throw QuicTransportException(
         res.error().message, *res.error().code.asTransportErrorCode());
   }
-  frame = *res;
+  frame = std::move(*res);
   auto extendedAckFeatures = decodeQuicInteger(cursor);
   if (!extendedAckFeatures) {
     throw QuicTransportException(
@@ -383,7 +393,7 @@ folly::Expected<QuicFrame, QuicError> decodeAckFrameWithReceivedTimestamps(
     throw QuicTransportException(
         ack.error().message, *ack.error().code.asTransportErrorCode());
   }
-  frame = *ack;
+  frame = std::move(*ack);
   frame.frameType = frameType;
 
   auto ts = decodeReceiveTimestampsInAck(frame, cursor, params);
@@ -391,7 +401,7 @@ folly::Expected<QuicFrame, QuicError> decodeAckFrameWithReceivedTimestamps(
     return folly::makeUnexpected(ts.error());
   }
 
-  return QuicFrame(frame);
+  return QuicFrame(std::move(frame));
 }
 
 folly::Expected<QuicFrame, QuicError> decodeAckFrameWithECN(
@@ -404,7 +414,7 @@ folly::Expected<QuicFrame, QuicError> decodeAckFrameWithECN(
   if (ack.hasError()) {
     return folly::makeUnexpected(ack.error());
   }
-  readAckFrame = *ack;
+  readAckFrame = std::move(*ack);
   readAckFrame.frameType = FrameType::ACK_ECN;
 
   auto ecn = decodeEcnCountsInAck(readAckFrame, cursor);
@@ -412,7 +422,7 @@ folly::Expected<QuicFrame, QuicError> decodeAckFrameWithECN(
     return folly::makeUnexpected(ecn.error());
   }
 
-  return QuicFrame(readAckFrame);
+  return QuicFrame(std::move(readAckFrame));
 }
 
 RstStreamFrame decodeRstStreamFrame(folly::io::Cursor& cursor, bool reliable) {
@@ -476,7 +486,8 @@ StopSendingFrame decodeStopSendingFrame(folly::io::Cursor& cursor) {
   return StopSendingFrame(folly::to<StreamId>(streamId->first), errorCode);
 }
 
-ReadCryptoFrame decodeCryptoFrame(folly::io::Cursor& cursor) {
+ReadCryptoFrame decodeCryptoFrame(BufQueue& queue) {
+  folly::io::Cursor cursor(queue.front());
   auto optionalOffset = decodeQuicInteger(cursor);
   if (!optionalOffset) {
     throw QuicTransportException(
@@ -489,14 +500,14 @@ ReadCryptoFrame decodeCryptoFrame(folly::io::Cursor& cursor) {
     throw QuicTransportException(
         "Invalid length", quic::TransportErrorCode::FRAME_ENCODING_ERROR);
   }
-  Buf data;
   if (cursor.totalLength() < dataLength->first) {
     throw QuicTransportException(
         "Length mismatch", quic::TransportErrorCode::FRAME_ENCODING_ERROR);
   }
-  // If dataLength > data's actual length then the cursor will throw.
-  cursor.clone(data, dataLength->first);
-  return ReadCryptoFrame(offset, std::move(data));
+  // Split the data off the packet like stream data instead of cloning it, so
+  // that a frame that ends the packet takes over the packet buffer.
+  queue.trimStart(cursor - queue.front());
+  return ReadCryptoFrame(offset, queue.splitAtMost(dataLength->first));
 }
 
 ReadNewTokenFrame decodeNewTokenFrame(folly::io::Cursor& cursor) {
@@ -872,14 +883,14 @@ QuicFrame parseFrame(
           throw QuicTransportException(
               res.error().message, *res.error().code.asTransportErrorCode());
         }
-        return *res;
+        return std::move(*res);
       case FrameType::ACK_ECN:
         res = decodeAckFrameWithECN(cursor, header, params);
         if (res.hasError()) {
           throw QuicTransportException(
               res.error().message, *res.error().code.asTransportErrorCode());
         }
-        return *res;
+        return std::move(*res);
       case FrameType::RST_STREAM:
       case FrameType::RST_STREAM_AT:
         return QuicFrame(decodeRstStreamFrame(
@@ -887,7 +898,8 @@ QuicFrame parseFrame(
       case FrameType::STOP_SENDING:
         return QuicFrame(decodeStopSendingFrame(cursor));
       case FrameType::CRYPTO_FRAME:
-        return QuicFrame(decodeCryptoFrame(cursor));
+        consumedQueue = true;
+        return QuicFrame(decodeCryptoFrame(queue));
       case FrameType::NEW_TOKEN:
         return QuicFrame(decodeNewTokenFrame(cursor));
       case FrameType::STREAM:
@@ -960,14 +972,14 @@ QuicFrame parseFrame(
           throw QuicTransportException(
               res.error().message, *res.error().code.asTransportErrorCode());
         }
-        return QuicFrame(*res);
+        return QuicFrame(std::move(*res));
       case FrameType::ACK_FREQUENCY:
         res = decodeAckFrequencyFrame(cursor);
         if (res.hasError()) {
           throw QuicTransportException(
               res.error().message, *res.error().code.asTransportErrorCode());
         }
-        return *res;
+        return std::move(*res);
       case FrameType::IMMEDIATE_ACK:
         return QuicFrame(decodeImmediateAckFrame(cursor));
       case FrameType::ACK_RECEIVE_TIMESTAMPS: {
@@ -977,8 +989,7 @@ QuicFrame parseFrame(
           throw QuicTransportException(
               res.error().message, *res.error().code.asTransportErrorCode());
         }
-        auto frame = *res;
-        return frame;
+        return std::move(*res);
       }
       case FrameType::ACK_EXTENDED:
         auto frame = QuicFrame(decodeAckExtendedFrame(cursor, header, params));
@@ -157,7 +157,7 @@ ReadStreamFrame decodeStreamFrame(
     StreamTypeField frameTypeField,
     bool isGroupFrame = false);
 
-ReadCryptoFrame decodeCryptoFrame(folly::io::Cursor& cursor);
+ReadCryptoFrame decodeCryptoFrame(BufQueue& queue);
 
 ReadNewTokenFrame decodeNewTokenFrame(folly::io::Cursor& cursor);
 
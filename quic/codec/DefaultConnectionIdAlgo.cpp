@@ -53,14 +53,14 @@ setVersionBitsInConnId(
  * Extract the version id bits (0 - 1) from the given ConnectionId
  */
 folly::Expected<quic::ConnectionIdVersion, quic::QuicInternalException>
-getVersionBitsFromConnId(const quic::ConnectionId& connId) noexcept {
-  if (UNLIKELY(connId.size() == 0)) {
+getVersionBitsFromConnId(const uint8_t* data, size_t size) noexcept {
+  if (UNLIKELY(size == 0)) {
     return folly::makeUnexpected(quic::QuicInternalException(
         "ConnectionId is too small for version",
         quic::LocalErrorCode::INTERNAL_ERROR));
   }
   uint8_t version = 0;
-  version = (kShortVersionBitsMask & connId.data()[0]) >> 6;
+  version = (kShortVersionBitsMask & data[0]) >> 6;
   return static_cast<quic::ConnectionIdVersion>(version);
 }
 
@@ -123,9 +123,10 @@ folly::Expected<folly::Unit, quic::QuicInternalException> setHostIdBitsInConnId(
  * Extract the host id bits from the given ConnectionId
  */
 folly::Expected<uint32_t, quic::QuicInternalException> getHostIdBitsInConnId(
-    const quic::ConnectionId& connId,
+    const uint8_t* data,
+    size_t size,
     quic::ConnectionIdVersion version) noexcept {
-  if (UNLIKELY(connId.size() < quic::kMinSelfConnectionIdV1Size)) {
+  if (UNLIKELY(size < quic::kMinSelfConnectionIdV1Size)) {
     return folly::makeUnexpected(quic::QuicInternalException(
         "ConnectionId is too small for hostid",
         quic::LocalErrorCode::INTERNAL_ERROR));
@@ -133,36 +134,36 @@ folly::Expected<uint32_t, quic::QuicInternalException> getHostIdBitsInConnId(
   if (version == quic::ConnectionIdVersion::V1) {
     uint16_t hostId = 0;
     // get 2 - 7 bits from the connId and set first 6 bits of the host id
-    hostId = (kHostIdV1FirstByteMask & (connId.data()[0]));
+    hostId = (kHostIdV1FirstByteMask & (data[0]));
     // shift by 10 bits and make room for the last 10 bits
     hostId = hostId << 10;
     // get 8 - 15 bits from the connId
-    hostId |= (kHostIdV1SecondByteMask & connId.data()[1]) << 2;
+    hostId |= (kHostIdV1SecondByteMask & data[1]) << 2;
     // get 16 - 17 bits from the connId
-    hostId |= (kHostIdV1ThirdByteMask & connId.data()[2]) >> 6;
+    hostId |= (kHostIdV1ThirdByteMask & data[2]) >> 6;
     return hostId;
   } else if (version == quic::ConnectionIdVersion::V2) {
-    if (UNLIKELY(connId.size() < quic::kMinSelfConnectionIdV2Size)) {
+    if (UNLIKELY(size < quic::kMinSelfConnectionIdV2Size)) {
       return folly::makeUnexpected(quic::QuicInternalException(
           "ConnectionId is too small for hostid V2",
           quic::LocalErrorCode::INTERNAL_ERROR));
     }
     uint32_t hostId = 0;
-    hostId |= connId.data()[1] << 16;
-    hostId |= connId.data()[2] << 8;
-    hostId |= connId.data()[3];
+    hostId |= data[1] << 16;
+    hostId |= data[2] << 8;
+    hostId |= data[3];
     return hostId;
   } else if (version == quic::ConnectionIdVersion::V3) {
-    if (UNLIKELY(connId.size() < quic::kMinSelfConnectionIdV3Size)) {
+    if (UNLIKELY(size < quic::kMinSelfConnectionIdV3Size)) {
       return folly::makeUnexpected(quic::QuicInternalException(
           "ConnectionId is too small for hostid V3",
           quic::LocalErrorCode::INTERNAL_ERROR));
     }
     uint32_t hostId = 0;
-    hostId |= connId.data()[1] << 24;
-    hostId |= connId.data()[2] << 16;
-    hostId |= connId.data()[3] << 8;
-    hostId |= connId.data()[4];
+    hostId |= data[1] << 24;
+    hostId |= data[2] << 16;
+    hostId |= data[3] << 8;
+    hostId |= data[4];
     return hostId;
   } else {
     return folly::makeUnexpected(quic::QuicInternalException(
@@ -219,33 +220,34 @@ setWorkerIdBitsInConnId(
  * Extracts the 'workerId' bits from the given ConnectionId
  */
 folly::Expected<uint8_t, quic::QuicInternalException> getWorkerIdFromConnId(
-    const quic::ConnectionId& connId,
+    const uint8_t* data,
+    size_t size,
     quic::ConnectionIdVersion version) noexcept {
   if (version == quic::ConnectionIdVersion::V1) {
-    if (UNLIKELY(connId.size() < quic::kMinSelfConnectionIdV1Size)) {
+    if (UNLIKELY(size < quic::kMinSelfConnectionIdV1Size)) {
       return folly::makeUnexpected(quic::QuicInternalException(
           "ConnectionId is too small for workerid",
           quic::LocalErrorCode::INTERNAL_ERROR));
     }
     // get 18 - 23 bits from the connId
-    uint8_t workerId = connId.data()[2] << 2;
+    uint8_t workerId = data[2] << 2;
     // get 24 - 25 bits in the connId
-    workerId |= connId.data()[3] >> 6;
+    workerId |= data[3] >> 6;
     return workerId;
   } else if (version == quic::ConnectionIdVersion::V2) {
-    if (UNLIKELY(connId.size() < quic::kMinSelfConnectionIdV2Size)) {
+    if (UNLIKELY(size < quic::kMinSelfConnectionIdV2Size)) {
       return folly::makeUnexpected(quic::QuicInternalException(
           "ConnectionId is too small for workerid V2",
           quic::LocalErrorCode::INTERNAL_ERROR));
     }
-    return connId.data()[4];
+    return data[4];
   } else if (version == quic::ConnectionIdVersion::V3) {
-    if (UNLIKELY(connId.size() < quic::kMinSelfConnectionIdV3Size)) {
+    if (UNLIKELY(size < quic::kMinSelfConnectionIdV3Size)) {
       return folly::makeUnexpected(quic::QuicInternalException(
           "ConnectionId is too small for workerid V3",
           quic::LocalErrorCode::INTERNAL_ERROR));
     }
-    return connId.data()[5];
+    return data[5];
   } else {
     return folly::makeUnexpected(quic::QuicInternalException(
         "Unsupported CID version", quic::LocalErrorCode::INTERNAL_ERROR));
@@ -301,34 +303,35 @@ setProcessIdBitsInConnId(
  */
 folly::Expected<uint8_t, quic::QuicInternalException>
 getProcessIdBitsFromConnId(
-    const quic::ConnectionId& connId,
+    const uint8_t* data,
+    size_t size,
     quic::ConnectionIdVersion version) noexcept {
   if (version == quic::ConnectionIdVersion::V1) {
-    if (connId.size() < quic::kMinSelfConnectionIdV1Size) {
+    if (size < quic::kMinSelfConnectionIdV1Size) {
       return folly::makeUnexpected(quic::QuicInternalException(
           "ConnectionId is too small for processid",
           quic::LocalErrorCode::INTERNAL_ERROR));
     }
     uint8_t processId = 0;
-    processId = (kProcessIdV1BitMask & connId.data()[3]) >> 5;
+    processId = (kProcessIdV1BitMask & data[3]) >> 5;
     return processId;
   } else if (version == quic::ConnectionIdVersion::V2) {
-    if (UNLIKELY(connId.size() < quic::kMinSelfConnectionIdV2Size)) {
+    if (UNLIKELY(size < quic::kMinSelfConnectionIdV2Size)) {
       return folly::makeUnexpected(quic::QuicInternalException(
           "ConnectionId is too small for processid V2",
           quic::LocalErrorCode::INTERNAL_ERROR));
     }
     uint8_t processId = 0;
-    processId = (kProcessIdV2BitMask & connId.data()[5]) >> 7;
+    processId = (kProcessIdV2BitMask & data[5]) >> 7;
     return processId;
   } else if (version == quic::ConnectionIdVersion::V3) {
-    if (UNLIKELY(connId.size() < quic::kMinSelfConnectionIdV3Size)) {
+    if (UNLIKELY(size < quic::kMinSelfConnectionIdV3Size)) {
       return folly::makeUnexpected(quic::QuicInternalException(
           "ConnectionId is too small for processid V3",
           quic::LocalErrorCode::INTERNAL_ERROR));
     }
     uint8_t processId = 0;
-    processId = (kProcessIdV3BitMask & connId.data()[6]) >> 7;
+    processId = (kProcessIdV3BitMask & data[6]) >> 7;
     return processId;
   } else {
     return folly::makeUnexpected(quic::QuicInternalException(
@@ -340,7 +343,7 @@ getProcessIdBitsFromConnId(
 namespace quic {
 
 bool DefaultConnectionIdAlgo::canParse(const ConnectionId& id) const noexcept {
-  auto versionExpected = getVersionBitsFromConnId(id);
+  auto versionExpected = getVersionBitsFromConnId(id.data(), id.size());
   if (!versionExpected) {
     return false;
   }
@@ -359,19 +362,27 @@ bool DefaultConnectionIdAlgo::canParse(const ConnectionId& id) const noexcept {
 folly::Expected<ServerConnectionIdParams, QuicInternalException>
 DefaultConnectionIdAlgo::parseConnectionIdDefault(
     const ConnectionId& id) noexcept {
-  auto expectingVersion = getVersionBitsFromConnId(id);
+  return parseConnectionIdDefault(id.data(), id.size());
+}
+
+folly::Expected<ServerConnectionIdParams, QuicInternalException>
+DefaultConnectionIdAlgo::parseConnectionIdDefault(
+    const uint8_t* data,
+    size_t size) noexcept {
+  auto expectingVersion = getVersionBitsFromConnId(data, size);
   if (UNLIKELY(!expectingVersion)) {
     return folly::makeUnexpected(expectingVersion.error());
   }
-  auto expectingHost = getHostIdBitsInConnId(id, *expectingVersion);
+  auto expectingHost = getHostIdBitsInConnId(data, size, *expectingVersion);
   if (UNLIKELY(!expectingHost)) {
     return folly::makeUnexpected(expectingHost.error());
   }
-  auto expectingProcess = getProcessIdBitsFromConnId(id, *expectingVersion);
+  auto expectingProcess =
+      getProcessIdBitsFromConnId(data, size, *expectingVersion);
   if (UNLIKELY(!expectingProcess)) {
     return folly::makeUnexpected(expectingProcess.error());
   }
-  auto expectingWorker = getWorkerIdFromConnId(id, *expectingVersion);
+  auto expectingWorker = getWorkerIdFromConnId(data, size, *expectingVersion);
   if (UNLIKELY(!expectingWorker)) {
     return folly::makeUnexpected(expectingWorker.error());
   }
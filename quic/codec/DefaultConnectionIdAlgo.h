@@ -57,6 +57,13 @@ class DefaultConnectionIdAlgo : public ConnectionIdAlgo {
   static folly::Expected<ServerConnectionIdParams, QuicInternalException>
   parseConnectionIdDefault(const ConnectionId& id) noexcept;
 
+  /**
+   * Parses the connection id in the size bytes at data, for callers that have
+   * not built a ConnectionId, e.g. routing straight off a packet buffer.
+   */
+  static folly::Expected<ServerConnectionIdParams, QuicInternalException>
+  parseConnectionIdDefault(const uint8_t* data, size_t size) noexcept;
+
   /**
    * Check if this implementation of algorithm can parse the given ConnectionId
    */
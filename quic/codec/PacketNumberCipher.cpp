@@ -11,6 +11,8 @@
 
 #include <quic/codec/Types.h>
 
+#include <algorithm>
+
 namespace quic {
 
 void PacketNumberCipher::decipherHeader(
@@ -19,8 +21,15 @@ void PacketNumberCipher::decipherHeader(
     folly::MutableByteRange packetNumberBytes,
     uint8_t initialByteMask,
     uint8_t /* packetNumLengthMask */) const {
+  removeMask(mask(sample), initialByte, packetNumberBytes, initialByteMask);
+}
+
+void PacketNumberCipher::removeMask(
+    const HeaderProtectionMask& headerMask,
+    folly::MutableByteRange initialByte,
+    folly::MutableByteRange packetNumberBytes,
+    uint8_t initialByteMask) {
   CHECK_EQ(packetNumberBytes.size(), kMaxPacketNumEncodingSize);
-  HeaderProtectionMask headerMask = mask(sample);
   // Mask size should be > packet number length + 1.
   DCHECK_GE(headerMask.size(), 5);
   initialByte.data()[0] ^= headerMask.data()[0] & initialByteMask;
@@ -36,7 +45,14 @@ void PacketNumberCipher::cipherHeader(
     folly::MutableByteRange packetNumberBytes,
     uint8_t initialByteMask,
     uint8_t /* packetNumLengthMask */) const {
-  HeaderProtectionMask headerMask = mask(sample);
+  applyMask(mask(sample), initialByte, packetNumberBytes, initialByteMask);
+}
+
+void PacketNumberCipher::applyMask(
+    const HeaderProtectionMask& headerMask,
+    folly::MutableByteRange initialByte,
+    folly::MutableByteRange packetNumberBytes,
+    uint8_t initialByteMask) {
   // Mask size should be > packet number length + 1.
   DCHECK_GE(headerMask.size(), kMaxPacketNumEncodingSize + 1);
   size_t packetNumLength = parsePacketNumberLength(*initialByte.data());
@@ -46,6 +62,39 @@ void PacketNumberCipher::cipherHeader(
   }
 }
 
+void PacketNumberCipher::masks(
+    folly::Range<const Sample*> samples,
+    HeaderProtectionMask* out) const {
+  for (const auto& sample : samples) {
+    *out++ = mask(folly::range(sample));
+  }
+}
+
+void PacketNumberCipher::encryptHeaders(
+    folly::Range<PendingHeaderProtection*> headers) const {
+  std::array<Sample, kMaxHeaderProtectionBatch> samples;
+  std::array<HeaderProtectionMask, kMaxHeaderProtectionBatch> headerMasks;
+  while (!headers.empty()) {
+    auto batchSize = std::min(headers.size(), kMaxHeaderProtectionBatch);
+    for (size_t i = 0; i < batchSize; ++i) {
+      samples[i] = headers[i].sample;
+    }
+    masks(
+        folly::Range<const Sample*>(samples.data(), batchSize),
+        headerMasks.data());
+    for (size_t i = 0; i < batchSize; ++i) {
+      auto& header = headers[i];
+      applyMask(
+          headerMasks[i],
+          header.initialByte,
+          header.packetNumberBytes,
+          header.longHeader ? LongHeader::kTypeBitsMask
+                            : ShortHeader::kTypeBitsMask);
+    }
+    headers.advance(batchSize);
+  }
+}
+
 void PacketNumberCipher::decryptLongHeader(
     folly::ByteRange sample,
     folly::MutableByteRange initialByte,
@@ -70,6 +119,14 @@ void PacketNumberCipher::decryptShortHeader(
       ShortHeader::kPacketNumLenMask);
 }
 
+void PacketNumberCipher::decryptShortHeaderWithMask(
+    const HeaderProtectionMask& headerMask,
+    folly::MutableByteRange initialByte,
+    folly::MutableByteRange packetNumberBytes) {
+  removeMask(
+      headerMask, initialByte, packetNumberBytes, ShortHeader::kTypeBitsMask);
+}
+
 void PacketNumberCipher::encryptLongHeader(
     folly::ByteRange sample,
     folly::MutableByteRange initialByte,
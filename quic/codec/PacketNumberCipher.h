@@ -16,6 +16,17 @@ namespace quic {
 using HeaderProtectionMask = std::array<uint8_t, 16>;
 using Sample = std::array<uint8_t, 16>;
 
+/**
+ * The header of a packet whose payload is already encrypted, waiting to be
+ * protected together with the headers of the other packets of a batch.
+ */
+struct PendingHeaderProtection {
+  Sample sample;
+  folly::MutableByteRange initialByte;
+  folly::MutableByteRange packetNumberBytes;
+  bool longHeader{false};
+};
+
 class PacketNumberCipher {
  public:
   virtual ~PacketNumberCipher() = default;
@@ -24,6 +35,16 @@ class PacketNumberCipher {
 
   virtual HeaderProtectionMask mask(folly::ByteRange sample) const = 0;
 
+  /**
+   * Computes the mask for each of the samples into out, which must have room
+   * for samples.size() masks. The default calls mask() for each sample;
+   * ciphers that can pipeline the blocks of several samples should override
+   * it.
+   */
+  virtual void masks(
+      folly::Range<const Sample*> samples,
+      HeaderProtectionMask* out) const;
+
   /**
    * Decrypts a long header from a sample.
    * sample should be 16 bytes long.
@@ -46,6 +67,16 @@ class PacketNumberCipher {
       folly::MutableByteRange initialByte,
       folly::MutableByteRange packetNumberBytes) const;
 
+  /**
+   * Decrypts a short header with the mask that masks() computed for its
+   * sample.
+   * packetNumberBytes should be supplied with at least 4 bytes.
+   */
+  static void decryptShortHeaderWithMask(
+      const HeaderProtectionMask& headerMask,
+      folly::MutableByteRange initialByte,
+      folly::MutableByteRange packetNumberBytes);
+
   /**
    * Encrypts a long header from a sample.
    * sample should be 16 bytes long.
@@ -66,6 +97,14 @@ class PacketNumberCipher {
       folly::MutableByteRange initialByte,
       folly::MutableByteRange packetNumberBytes) const;
 
+  /**
+   * Encrypts the headers of a batch of packets, computing their masks with
+   * one masks() call per up to kMaxHeaderProtectionBatch headers.
+   */
+  void encryptHeaders(folly::Range<PendingHeaderProtection*> headers) const;
+
+  static constexpr size_t kMaxHeaderProtectionBatch = 64;
+
   /**
    * Returns the length of key needed for the pn cipher.
    */
@@ -90,6 +129,18 @@ class PacketNumberCipher {
       folly::MutableByteRange packetNumberBytes,
       uint8_t initialByteMask,
       uint8_t packetNumLengthMask) const;
+
+  static void applyMask(
+      const HeaderProtectionMask& headerMask,
+      folly::MutableByteRange initialByte,
+      folly::MutableByteRange packetNumberBytes,
+      uint8_t initialByteMask);
+
+  static void removeMask(
+      const HeaderProtectionMask& headerMask,
+      folly::MutableByteRange initialByte,
+      folly::MutableByteRange packetNumberBytes,
+      uint8_t initialByteMask);
 };
 
 } // namespace quic
@@ -15,6 +15,8 @@
 #include <quic/common/BufUtil.h>
 #include <quic/common/Optional.h>
 
+#include <cstring>
+
 namespace quic {
 
 constexpr uint64_t kOneByteLimit = 0x3F;
@@ -123,6 +125,72 @@ folly::Expected<size_t, TransportErrorCode> getQuicIntegerSize(uint64_t value);
  */
 size_t getQuicIntegerSizeThrows(uint64_t value);
 
+/**
+ * Returns number of bytes needed to encode value as a QUIC integer. The value
+ * must be representable with the variable length encoding. Meant for hot loops
+ * whose values are known to fit, like packet number ranges.
+ */
+inline uint8_t getQuicIntegerSizeUnchecked(uint64_t value) {
+  DCHECK_LE(value, kEightByteLimit);
+  if (value <= kOneByteLimit) {
+    return 1;
+  } else if (value <= kTwoByteLimit) {
+    return 2;
+  } else if (value <= kFourByteLimit) {
+    return 4;
+  }
+  return 8;
+}
+
+/**
+ * Writes value to out as a QUIC integer of the given size, as returned by
+ * getQuicIntegerSizeUnchecked. Does no bounds checking, out must have room for
+ * size bytes. Returns the number of bytes written.
+ */
+inline size_t
+encodeQuicIntegerUnchecked(uint64_t value, uint8_t size, uint8_t* out) {
+  switch (size) {
+    case 1:
+      *out = static_cast<uint8_t>(value);
+      return 1;
+    case 2: {
+      auto encoded = folly::Endian::big(
+          static_cast<uint16_t>(static_cast<uint16_t>(value) | 0x4000));
+      memcpy(out, &encoded, sizeof(encoded));
+      return sizeof(encoded);
+    }
+    case 4: {
+      auto encoded = folly::Endian::big(
+          static_cast<uint32_t>(static_cast<uint32_t>(value) | 0x80000000));
+      memcpy(out, &encoded, sizeof(encoded));
+      return sizeof(encoded);
+    }
+    default: {
+      DCHECK_EQ(size, 8);
+      auto encoded = folly::Endian::big(value | 0xC000000000000000);
+      memcpy(out, &encoded, sizeof(encoded));
+      return sizeof(encoded);
+    }
+  }
+}
+
+/**
+ * Writes count QUIC integers back to back to out, each with the size at the
+ * same index in sizes. Does no bounds checking, out must have room for the sum
+ * of the sizes. Returns the number of bytes written.
+ */
+inline size_t encodeQuicIntegers(
+    const uint64_t* values,
+    const uint8_t* sizes,
+    size_t count,
+    uint8_t* out) {
+  size_t written = 0;
+  for (size_t i = 0; i < count; i++) {
+    written += encodeQuicIntegerUnchecked(values[i], sizes[i], out + written);
+  }
+  return written;
+}
+
 /**
  * A better API for dealing with QUIC integers for encoding.
  */
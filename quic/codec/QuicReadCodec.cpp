@@ -287,8 +287,14 @@ CodecResult QuicReadCodec::tryParseShortHeaderPacket(
   folly::ByteRange sampleByteRange(
       data->writableData() + sampleOffset, sample.size());
 
-  oneRttHeaderCipher_->decryptShortHeader(
-      sampleByteRange, initialByteRange, packetNumberByteRange);
+  auto headerMask = findHeaderMask(data->data(), sampleByteRange);
+  if (headerMask) {
+    PacketNumberCipher::decryptShortHeaderWithMask(
+        *headerMask, initialByteRange, packetNumberByteRange);
+  } else {
+    oneRttHeaderCipher_->decryptShortHeader(
+        sampleByteRange, initialByteRange, packetNumberByteRange);
+  }
   std::pair<PacketNum, size_t> packetNum = parsePacketNumber(
       initialByteRange.data()[0], packetNumberByteRange, expectedNextPacketNum);
   auto shortHeader =
@@ -450,6 +456,58 @@ CodecResult QuicReadCodec::parsePacket(
       std::move(data), ackStates, dstConnIdSize, cursor);
 }
 
+void QuicReadCodec::computeHeaderMasks(
+    const std::vector<ReceivedUdpPacket>& packets,
+    size_t dstConnIdSize) {
+  clearHeaderMasks();
+  if (!oneRttHeaderCipher_) {
+    return;
+  }
+  size_t sampleOffset = 1 + dstConnIdSize + kMaxPacketNumEncodingSize;
+  for (const auto& packet : packets) {
+    const folly::IOBuf* buf = packet.buf.front();
+    // A short header packet can only be the last one in a datagram, so this
+    // only covers datagrams that have nothing but it.
+    if (!buf || buf->length() < sampleOffset + sizeof(Sample) ||
+        getHeaderForm(buf->data()[0]) != HeaderForm::Short) {
+      continue;
+    }
+    headerMaskPackets_.push_back(buf->data());
+    auto& sample = headerMaskSamples_.emplace_back();
+    memcpy(sample.data(), buf->data() + sampleOffset, sample.size());
+  }
+  headerMasks_.resize(headerMaskSamples_.size());
+  oneRttHeaderCipher_->masks(
+      folly::range(headerMaskSamples_), headerMasks_.data());
+}
+
+void QuicReadCodec::clearHeaderMasks() {
+  headerMaskPackets_.clear();
+  headerMaskSamples_.clear();
+  headerMasks_.clear();
+  nextHeaderMask_ = 0;
+}
+
+const HeaderProtectionMask* QuicReadCodec::findHeaderMask(
+    const uint8_t* packetData,
+    folly::ByteRange sample) {
+  for (size_t i = nextHeaderMask_; i < headerMaskPackets_.size(); i++) {
+    if (headerMaskPackets_[i] != packetData) {
+      continue;
+    }
+    nextHeaderMask_ = i + 1;
+    // The packet might have been freed and another one put at the same
+    // address, so only use the mask if it was computed from this sample.
+    const auto& maskSample = headerMaskSamples_[i];
+    if (sample.size() != maskSample.size() ||
+        memcmp(sample.data(), maskSample.data(), maskSample.size()) != 0) {
+      return nullptr;
+    }
+    return &headerMasks_[i];
+  }
+  return nullptr;
+}
+
 bool QuicReadCodec::canInitiateKeyUpdate() const {
   if (!nextOneRttReadCipher_ || !currentOneRttReadPhaseStartPacketNum_) {
     // We haven't received any packets in the current oneRtt phase yet.
@@ -530,6 +588,7 @@ void QuicReadCodec::setInitialHeaderCipher(
 
 void QuicReadCodec::setOneRttHeaderCipher(
     std::unique_ptr<PacketNumberCipher> oneRttHeaderCipher) {
+  clearHeaderMasks();
   oneRttHeaderCipher_ = std::move(oneRttHeaderCipher);
 }
 
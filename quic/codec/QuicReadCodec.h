@@ -110,6 +110,19 @@ class QuicReadCodec {
       const AckStates& ackStates,
       size_t dstConnIdSize = kDefaultConnectionIdSize);
 
+  /**
+   * Computes the header protection masks of the short header packets that
+   * start the given datagrams with one PacketNumberCipher::masks() call, so
+   * that parsePacket() does not have to compute them one at a time. The
+   * masks are used in the order of the datagrams, until the next call or
+   * clearHeaderMasks().
+   */
+  void computeHeaderMasks(
+      const std::vector<ReceivedUdpPacket>& packets,
+      size_t dstConnIdSize = kDefaultConnectionIdSize);
+
+  void clearHeaderMasks();
+
   /**
    * Tries to parse the packet and returns whether or not
    * it is a version negotiation packet.
@@ -199,6 +212,14 @@ class QuicReadCodec {
 
   [[nodiscard]] std::string connIdToHex() const;
 
+  /**
+   * Returns the precomputed mask for the packet starting at packetData, if
+   * there is one and it was computed from the same sample.
+   */
+  const HeaderProtectionMask* findHeaderMask(
+      const uint8_t* packetData,
+      folly::ByteRange sample);
+
   QuicNodeType nodeType_;
 
   CodecParameters params_;
@@ -230,6 +251,13 @@ class QuicReadCodec {
   Optional<TimePoint> handshakeDoneTime_;
 
   QuicTransportStatsCallback* statsCallback_{nullptr};
+
+  // Masks from computeHeaderMasks(), with the start and the sample of the
+  // packet each one is for.
+  std::vector<const uint8_t*> headerMaskPackets_;
+  std::vector<Sample> headerMaskSamples_;
+  std::vector<HeaderProtectionMask> headerMasks_;
+  size_t nextHeaderMask_{0};
 };
 
 } // namespace quic
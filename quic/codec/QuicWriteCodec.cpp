@@ -15,6 +15,8 @@
 #include <cstdint>
 #include <sstream>
 
+#include <folly/small_vector.h>
+
 namespace {
 
 /**
@@ -211,21 +213,49 @@ Optional<WriteCryptoFrame> writeCryptoFrame(
   return WriteCryptoFrame(offsetIn, lengthVarInt.getValue());
 }
 
+namespace {
+
+/*
+ * The QUIC integers of the base fields of an ACK frame, followed by a gap and
+ * a length for each additional ack block, with their encoded sizes. The first
+ * pass of the ACK encoder computes them, the second writes them all at once.
+ */
+struct AckFrameIntegers {
+  // Type, largest acked, delay, block count and first block length.
+  static constexpr size_t kNumBaseFields = 5;
+  static constexpr size_t kBlockCountIndex = 3;
+  static constexpr size_t kInlineBlocks = 32;
+
+  void add(uint64_t value, uint8_t size) {
+    values.push_back(value);
+    sizes.push_back(size);
+    encodedSize += size;
+  }
+
+  folly::small_vector<uint64_t, kNumBaseFields + 2 * kInlineBlocks> values;
+  folly::small_vector<uint8_t, kNumBaseFields + 2 * kInlineBlocks> sizes;
+  size_t encodedSize{0};
+};
+
+} // namespace
+
 /*
  * This function will fill the parameter ack frame with ack blocks from the
- * parameter ackBlocks until it runs out of space (bytesLimit). The largest
- * ack block should have been inserted by the caller.
+ * parameter ackBlocks until it runs out of space (bytesLimit), adding the gap
+ * and length of each block to integers. The largest ack block should have been
+ * inserted by the caller.
  */
 static size_t fillFrameWithAckBlocks(
     const AckBlocks& ackBlocks,
     WriteAckFrame& ackFrame,
+    AckFrameIntegers& integers,
     uint64_t bytesLimit) {
   PacketNum currentSeqNum = ackBlocks.crbegin()->start;
 
   // starts off with 0 which is what we assumed the initial ack block to be for
   // the largest acked.
   size_t numAdditionalAckBlocks = 0;
-  size_t previousNumAckBlocks = 0;
+  uint8_t numAckBlocksSize = 1;
 
   // Skip the largest, as it has already been emplaced.
   for (auto blockItr = ackBlocks.crbegin() + 1; blockItr != ackBlocks.crend();
@@ -236,26 +266,23 @@ static size_t fillFrameWithAckBlocks(
     PacketNum gap = currentSeqNum - currBlock.end - 2;
     PacketNum currBlockLen = currBlock.end - currBlock.start;
 
-    // TODO this is still extra work, as we end up duplicating these
-    // calculations in the caller, we could store the results so they
-    // can be reused by the caller when writing the frame.
-    size_t gapSize = getQuicIntegerSizeThrows(gap);
-    size_t currBlockLenSize = getQuicIntegerSizeThrows(currBlockLen);
-    size_t numAdditionalAckBlocksSize =
-        getQuicIntegerSizeThrows(numAdditionalAckBlocks + 1);
-    size_t previousNumAckBlocksSize =
-        getQuicIntegerSizeThrows(previousNumAckBlocks);
-
-    size_t additionalSize = gapSize + currBlockLenSize +
-        (numAdditionalAckBlocksSize - previousNumAckBlocksSize);
+    uint8_t gapSize = getQuicIntegerSizeUnchecked(gap);
+    uint8_t currBlockLenSize = getQuicIntegerSizeUnchecked(currBlockLen);
+    uint8_t nextNumAckBlocksSize =
+        getQuicIntegerSizeUnchecked(numAdditionalAckBlocks + 1);
+
+    size_t additionalSize =
+        gapSize + currBlockLenSize + (nextNumAckBlocksSize - numAckBlocksSize);
     if (bytesLimit < additionalSize) {
       break;
     }
     numAdditionalAckBlocks++;
     bytesLimit -= additionalSize;
-    previousNumAckBlocks = numAdditionalAckBlocks;
+    numAckBlocksSize = nextNumAckBlocksSize;
     currentSeqNum = currBlock.start;
     ackFrame.ackBlocks.emplace_back(currBlock.start, currBlock.end);
+    integers.add(gap, gapSize);
+    integers.add(currBlockLen, currBlockLenSize);
   }
   return numAdditionalAckBlocks;
 }
@@ -412,29 +439,33 @@ static Optional<WriteAckFrame> maybeWriteAckBaseFields(
   // Account for the header size
   spaceLeft -= headerSize;
 
+  // First pass: pick the blocks that fit and size every field. The block count
+  // is filled in once it is known.
+  AckFrameIntegers integers;
+  integers.add(encodedintFrameType.getValue(), encodedintFrameType.getSize());
+  integers.add(largestAckedPacket, largestAckedPacketInt.getSize());
+  integers.add(encodedAckDelay, ackDelayInt.getSize());
+  integers.add(0, 0);
+  integers.add(firstAckBlockLength, firstAckBlockLengthInt.getSize());
+
   ackFrame.ackBlocks.push_back(ackState.acks.back());
   auto numAdditionalAckBlocks =
-      fillFrameWithAckBlocks(ackState.acks, ackFrame, spaceLeft);
-  QuicInteger numAdditionalAckBlocksInt(numAdditionalAckBlocks);
-  builder.write(encodedintFrameType);
-  builder.write(largestAckedPacketInt);
-  builder.write(ackDelayInt);
-  builder.write(numAdditionalAckBlocksInt);
-  builder.write(firstAckBlockLengthInt);
-
-  PacketNum currentSeqNum = ackState.acks.back().start;
-  for (auto it = ackFrame.ackBlocks.cbegin() + 1;
-       it != ackFrame.ackBlocks.cend();
-       ++it) {
-    CHECK_GE(currentSeqNum, it->end + 2);
-    PacketNum gap = currentSeqNum - it->end - 2;
-    PacketNum currBlockLen = it->end - it->start;
-    QuicInteger gapInt(gap);
-    QuicInteger currentBlockLenInt(currBlockLen);
-    builder.write(gapInt);
-    builder.write(currentBlockLenInt);
-    currentSeqNum = it->start;
-  }
+      fillFrameWithAckBlocks(ackState.acks, ackFrame, integers, spaceLeft);
+  auto blockCountSize = getQuicIntegerSizeUnchecked(numAdditionalAckBlocks);
+  integers.values[AckFrameIntegers::kBlockCountIndex] = numAdditionalAckBlocks;
+  integers.sizes[AckFrameIntegers::kBlockCountIndex] = blockCountSize;
+  integers.encodedSize += blockCountSize;
+
+  // Second pass: encode everything into one buffer and hand it to the builder
+  // in a single write.
+  folly::small_vector<uint8_t, 256> encoded(integers.encodedSize);
+  auto written = encodeQuicIntegers(
+      integers.values.data(),
+      integers.sizes.data(),
+      integers.values.size(),
+      encoded.data());
+  DCHECK_EQ(written, integers.encodedSize);
+  builder.push(encoded.data(), written);
   ackFrame.ackDelay = ackFrameMetaData.ackDelay;
 
   return ackFrame;
@@ -879,25 +879,41 @@ TEST_F(DecodeTest, CryptoDecodeSuccess) {
   QuicInteger length(1);
   auto cryptoFrame =
       createCryptoFrame(offset, length, folly::IOBuf::copyBuffer("a"));
-  folly::io::Cursor cursor(cryptoFrame.get());
-  auto decodedFrame = decodeCryptoFrame(cursor);
+  BufQueue queue(std::move(cryptoFrame));
+  auto decodedFrame = decodeCryptoFrame(queue);
   EXPECT_EQ(decodedFrame.offset, 10);
   EXPECT_EQ(decodedFrame.data->computeChainDataLength(), 1);
+  EXPECT_EQ(queue.chainLength(), 0);
+}
+
+TEST_F(DecodeTest, CryptoDecodeLeavesFollowingFrames) {
+  QuicInteger offset(10);
+  QuicInteger length(1);
+  auto data = folly::IOBuf::copyBuffer("ab");
+  const auto* dataPtr = data->data();
+  auto cryptoFrame = createCryptoFrame(offset, length, std::move(data));
+  BufQueue queue(std::move(cryptoFrame));
+  auto decodedFrame = decodeCryptoFrame(queue);
+  EXPECT_EQ(decodedFrame.offset, 10);
+  EXPECT_EQ("a", decodedFrame.data->to<std::string>());
+  // The data is a slice of the packet, not a copy.
+  EXPECT_EQ(dataPtr, decodedFrame.data->data());
+  EXPECT_EQ("b", queue.front()->to<std::string>());
 }
 
 TEST_F(DecodeTest, CryptoOffsetNotPresent) {
   QuicInteger length(1);
   auto cryptoFrame =
       createCryptoFrame(none, length, folly::IOBuf::copyBuffer("a"));
-  folly::io::Cursor cursor(cryptoFrame.get());
-  EXPECT_THROW(decodeCryptoFrame(cursor), QuicTransportException);
+  BufQueue queue(std::move(cryptoFrame));
+  EXPECT_THROW(decodeCryptoFrame(queue), QuicTransportException);
 }
 
 TEST_F(DecodeTest, CryptoLengthNotPresent) {
   QuicInteger offset(0);
   auto cryptoFrame = createCryptoFrame(offset, none, nullptr);
-  folly::io::Cursor cursor(cryptoFrame.get());
-  EXPECT_THROW(decodeCryptoFrame(cursor), QuicTransportException);
+  BufQueue queue(std::move(cryptoFrame));
+  EXPECT_THROW(decodeCryptoFrame(queue), QuicTransportException);
 }
 
 TEST_F(DecodeTest, CryptoIncorrectDataLength) {
@@ -905,8 +921,8 @@ TEST_F(DecodeTest, CryptoIncorrectDataLength) {
   QuicInteger length(10);
   auto cryptoFrame =
       createCryptoFrame(offset, length, folly::IOBuf::copyBuffer("a"));
-  folly::io::Cursor cursor(cryptoFrame.get());
-  EXPECT_THROW(decodeCryptoFrame(cursor), QuicTransportException);
+  BufQueue queue(std::move(cryptoFrame));
+  EXPECT_THROW(decodeCryptoFrame(queue), QuicTransportException);
 }
 
 TEST_F(DecodeTest, PaddingFrameTest) {
@@ -123,4 +123,28 @@ TEST(DefaultConnectionIdAlgoTest, encodeDecode) {
   }
 }
 
+TEST(DefaultConnectionIdAlgoTest, parseBytes) {
+  DefaultConnectionIdAlgo al;
+  for (auto version :
+       {ConnectionIdVersion::V1,
+        ConnectionIdVersion::V2,
+        ConnectionIdVersion::V3}) {
+    ServerConnectionIdParams params(version, 0x1234, 1, 0x56);
+    auto connId = *al.encodeConnectionId(params);
+    auto fromId = DefaultConnectionIdAlgo::parseConnectionIdDefault(connId);
+    auto fromBytes = DefaultConnectionIdAlgo::parseConnectionIdDefault(
+        connId.data(), connId.size());
+    ASSERT_TRUE(fromBytes.hasValue());
+    EXPECT_EQ(fromBytes->version, fromId->version);
+    EXPECT_EQ(fromBytes->hostId, fromId->hostId);
+    EXPECT_EQ(fromBytes->workerId, fromId->workerId);
+    EXPECT_EQ(fromBytes->processId, fromId->processId);
+  }
+  // Too short for the version's worker id.
+  const uint8_t shortId[] = {0x80, 0x01, 0x02, 0x03};
+  EXPECT_TRUE(DefaultConnectionIdAlgo::parseConnectionIdDefault(
+                  shortId, sizeof(shortId))
+                  .hasError());
+}
+
 } // namespace quic::test
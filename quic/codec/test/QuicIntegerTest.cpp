@@ -124,6 +124,42 @@ TEST_F(QuicIntegerEncodeTest, ForceWrongBytes) {
   EXPECT_DEATH(encodeQuicInteger(15293, appendOp, 1), "");
 }
 
+TEST_P(QuicIntegerEncodeTest, EncodeUnchecked) {
+  if (GetParam().error) {
+    return;
+  }
+  uint8_t buf[8];
+  auto size = getQuicIntegerSizeUnchecked(GetParam().decoded);
+  EXPECT_EQ(size, GetParam().hexEncoded.size() / 2);
+  EXPECT_EQ(size, encodeQuicIntegerUnchecked(GetParam().decoded, size, buf));
+  auto encodedValue =
+      folly::hexlify(folly::StringPiece((const char*)buf, size));
+  EXPECT_EQ(encodedValue, GetParam().hexEncoded);
+}
+
+TEST_F(QuicIntegerEncodeTest, EncodeBatch) {
+  std::vector<uint64_t> values = {
+      0, 37, 37, 15293, 494878333, 37, 151288809941952652};
+  std::vector<uint8_t> sizes;
+  auto queue = folly::IOBuf::create(0);
+  BufAppender appender(queue.get(), 64);
+  auto appendOp = [&](auto val) { appender.writeBE(val); };
+  for (size_t i = 0; i < values.size(); i++) {
+    // Force a wider encoding for one of the values.
+    uint8_t size = i == 2 ? 4 : getQuicIntegerSizeUnchecked(values[i]);
+    sizes.push_back(size);
+    encodeQuicInteger(values[i], appendOp, size);
+  }
+
+  std::vector<uint8_t> buf(queue->length());
+  auto written = encodeQuicIntegers(
+      values.data(), sizes.data(), values.size(), buf.data());
+  EXPECT_EQ(written, queue->length());
+  EXPECT_EQ(
+      folly::hexlify(folly::StringPiece((const char*)buf.data(), buf.size())),
+      folly::hexlify(queue->to<std::string>()));
+}
+
 INSTANTIATE_TEST_SUITE_P(
     QuicIntegerTests,
     QuicIntegerDecodeTest,
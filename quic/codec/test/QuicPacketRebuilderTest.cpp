@@ -148,16 +148,9 @@ TEST_F(QuicPacketRebuilderTest, RebuildPacket) {
       cryptoOffset, ChainedByteRangeHead(cryptoBuf), regularBuilder1);
   auto packet1 = std::move(regularBuilder1).buildPacket();
   ASSERT_EQ(8, packet1.packet.frames.size());
-  stream->retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(0),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(buf), 0, true)));
+  stream->retransmissionBuffer.emplace(ChainedByteRangeHead(buf), 0, true);
   conn.cryptoState->oneRttStream.retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(0),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(cryptoBuf), 0, true)));
+      ChainedByteRangeHead(cryptoBuf), 0, true);
   // Write an updated ackState that should be used when rebuilding the AckFrame
   conn.ackStates.appDataAckState.acks.insert(1000, 1200);
   conn.ackStates.appDataAckState.largestRecvdPacketTime.assign(
@@ -304,11 +297,7 @@ TEST_F(QuicPacketRebuilderTest, FinOnlyStreamRebuild) {
   writeStreamFrameHeader(
       regularBuilder1, streamId, 0, 0, 0, true, none /* skipLenHint */);
   auto packet1 = std::move(regularBuilder1).buildPacket();
-  stream->retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(0),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(), 0, true)));
+  stream->retransmissionBuffer.emplace(ChainedByteRangeHead(), 0, true);
 
   // rebuild a packet from the built out packet
   ShortHeader shortHeader2(
@@ -365,11 +354,7 @@ TEST_F(QuicPacketRebuilderTest, RebuildDataStreamAndEmptyCryptoStream) {
       cryptoOffset, ChainedByteRangeHead(cryptoBuf), regularBuilder1);
   auto packet1 = std::move(regularBuilder1).buildPacket();
   ASSERT_EQ(2, packet1.packet.frames.size());
-  stream->retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(0),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(buf), 0, true)));
+  stream->retransmissionBuffer.emplace(ChainedByteRangeHead(buf), 0, true);
   // Do not add the buf to crypto stream's retransmission buffer,
   // imagine it was cleared
 
@@ -474,11 +459,7 @@ TEST_F(QuicPacketRebuilderTest, CannotRebuild) {
       regularBuilder1, buf->clone(), buf->computeChainDataLength());
   auto packet1 = std::move(regularBuilder1).buildPacket();
   ASSERT_EQ(5, packet1.packet.frames.size());
-  stream->retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(0),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(buf), 0, true)));
+  stream->retransmissionBuffer.emplace(ChainedByteRangeHead(buf), 0, true);
 
   // new builder has a much smaller writable bytes limit
   ShortHeader shortHeader2(
@@ -579,16 +560,9 @@ TEST_F(QuicPacketRebuilderTest, LastStreamFrameSkipLen) {
       regularBuilder, buf2->clone(), buf2->computeChainDataLength());
   auto packet = std::move(regularBuilder).buildPacket();
   auto outstandingPacket = makeDummyOutstandingPacket(packet.packet, 1200);
+  stream->retransmissionBuffer.emplace(ChainedByteRangeHead(buf1), 0, false);
   stream->retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(0),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(buf1), 0, false)));
-  stream->retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(buf1->computeChainDataLength()),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(buf2), buf1->computeChainDataLength(), true)));
+      ChainedByteRangeHead(buf2), buf1->computeChainDataLength(), true);
 
   MockQuicPacketBuilder mockBuilder;
   size_t packetLimit = 1200;
@@ -653,16 +627,9 @@ TEST_F(QuicPacketRebuilderTest, LastStreamFrameFinOnlySkipLen) {
   writeStreamFrameData(regularBuilder, ChainedByteRangeHead(), 0);
   auto packet = std::move(regularBuilder).buildPacket();
   auto outstandingPacket = makeDummyOutstandingPacket(packet.packet, 1200);
+  stream->retransmissionBuffer.emplace(ChainedByteRangeHead(buf1), 0, false);
   stream->retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(0),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(buf1), 0, false)));
-  stream->retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(buf1->computeChainDataLength()),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(), buf1->computeChainDataLength(), true)));
+      ChainedByteRangeHead(), buf1->computeChainDataLength(), true);
 
   MockQuicPacketBuilder mockBuilder;
   size_t packetLimit = 1200;
@@ -1408,3 +1408,84 @@ TEST_F(QuicReadCodecTest, KeyUpdateInitiate) {
     EXPECT_TRUE(codec->advanceOneRttReadPhase());
   }
 }
+
+TEST_F(QuicReadCodecTest, ComputeHeaderMasks) {
+  FizzCryptoFactory cryptoFactory;
+  auto connId = getTestConnectionId();
+  auto aead = cryptoFactory.getClientInitialCipher(connId, QuicVersion::MVFST);
+  auto headerCipher =
+      cryptoFactory.makeClientInitialHeaderCipher(connId, QuicVersion::MVFST);
+  auto codec = makeEncryptedCodec(
+      connId, cryptoFactory.getClientInitialCipher(connId, QuicVersion::MVFST));
+  codec->setOneRttHeaderCipher(
+      cryptoFactory.makeClientInitialHeaderCipher(connId, QuicVersion::MVFST));
+
+  constexpr PacketNum kNumPackets = 5;
+  std::vector<ReceivedUdpPacket> packets;
+  for (PacketNum packetNum = 1; packetNum <= kNumPackets; packetNum++) {
+    auto data = folly::IOBuf::copyBuffer("hello");
+    auto streamPacket = createStreamPacket(
+        connId,
+        connId,
+        packetNum,
+        2 /* streamId */,
+        *data,
+        aead->getCipherOverhead(),
+        0 /* largestAcked */);
+    auto packetBuf =
+        packetToBufCleartext(streamPacket, *aead, *headerCipher, packetNum);
+    packetBuf->coalesce();
+    packets.emplace_back(std::move(packetBuf));
+  }
+  codec->computeHeaderMasks(packets, connId.size());
+
+  AckStates ackStates;
+  for (PacketNum packetNum = 1; packetNum <= kNumPackets; packetNum++) {
+    auto result = codec->parsePacket(
+        packets[packetNum - 1].buf, ackStates, connId.size());
+    auto regularPacket = result.regularPacket();
+    ASSERT_NE(regularPacket, nullptr);
+    EXPECT_EQ(regularPacket->header.getPacketSequenceNum(), packetNum);
+    ackStates.appDataAckState.largestRecvdPacketNum = packetNum;
+  }
+}
+
+TEST_F(QuicReadCodecTest, ComputeHeaderMasksOnlyForTheSamePacket) {
+  auto connId = getTestConnectionId();
+  auto codec = makeEncryptedCodec(connId, createNoOpAead());
+  auto headerCipher = std::make_unique<NiceMock<MockPacketNumberCipher>>();
+  auto rawHeaderCipher = headerCipher.get();
+  codec->setOneRttHeaderCipher(std::move(headerCipher));
+
+  std::vector<ReceivedUdpPacket> packets;
+  for (PacketNum packetNum = 1; packetNum <= 3; packetNum++) {
+    auto data = folly::IOBuf::copyBuffer("hello");
+    auto streamPacket = createStreamPacket(
+        connId,
+        connId,
+        packetNum,
+        2 /* streamId */,
+        *data,
+        0 /* cipherOverhead */,
+        0 /* largestAcked */);
+    packets.emplace_back(bufToQueue(packetToBuf(streamPacket)).move());
+  }
+  EXPECT_CALL(*rawHeaderCipher, mask(_))
+      .Times(3)
+      .WillRepeatedly(Return(HeaderProtectionMask{}));
+  codec->computeHeaderMasks(packets, connId.size());
+  Mock::VerifyAndClearExpectations(rawHeaderCipher);
+
+  // Only the copy of the last packet needs its mask computed again.
+  EXPECT_CALL(*rawHeaderCipher, mask(_))
+      .Times(1)
+      .WillRepeatedly(Return(HeaderProtectionMask{}));
+  auto lastPacket = packets.back().buf.front()->clone();
+  lastPacket->unshare();
+  packets.back().buf = bufToQueue(std::move(lastPacket));
+  AckStates ackStates;
+  for (auto& packet : packets) {
+    EXPECT_TRUE(parseSuccess(
+        codec->parsePacket(packet.buf, ackStates, connId.size())));
+  }
+}
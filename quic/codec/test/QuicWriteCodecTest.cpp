@@ -1340,6 +1340,65 @@ TEST_P(QuicWriteCodecTest, WriteSimpleAckFrame) {
   }
 }
 
+TEST_P(QuicWriteCodecTest, WriteAckFrameMixedIntegerSizes) {
+  MockQuicPacketBuilder pktBuilder;
+  setupCommonExpects(pktBuilder);
+  auto frameType = GetParam();
+  auto extendedAckSupport = frameType == FrameType::ACK_EXTENDED ? 3 : 0;
+
+  // Gaps and block lengths that need 1, 2 and 4 byte encodings.
+  const std::vector<uint64_t> sizes = {0, 5, 100, 20000, 70000};
+  AckBlocks ackBlocks;
+  PacketNum current = 1;
+  for (size_t i = 0; i < 40; i++) {
+    auto length = sizes[i % sizes.size()];
+    ackBlocks.insert({current, current + length});
+    current += length + 2 + sizes[(i * 3) % sizes.size()];
+  }
+  TimePoint connTime = Clock::now();
+  WriteAckFrameState ackState = createTestWriteAckState(
+      frameType,
+      connTime,
+      ackBlocks,
+      kMaxReceivedPktsTimestampsStored,
+      extendedAckSupport);
+  WriteAckFrameMetaData ackFrameMetaData = {
+      .ackState = ackState,
+      .ackDelay = 1000us,
+      .ackDelayExponent = static_cast<uint8_t>(kDefaultAckDelayExponent),
+      .connTime = connTime,
+  };
+  auto ackFrameWriteResult = *writeAckFrame(
+      ackFrameMetaData,
+      pktBuilder,
+      frameType,
+      defaultAckReceiveTimestmpsConfig,
+      kMaxReceivedPktsTimestampsStored,
+      extendedAckSupport);
+  EXPECT_EQ(ackFrameWriteResult.ackBlocksWritten, ackBlocks.size());
+  EXPECT_EQ(
+      kDefaultUDPSendPacketLen - ackFrameWriteResult.bytesWritten,
+      pktBuilder.remainingSpaceInPkt());
+
+  auto builtOut = std::move(pktBuilder).buildTestPacket();
+  BufQueue queue;
+  queue.append(builtOut.second->clone());
+  auto hasTimestamps = frameType == FrameType::ACK_RECEIVE_TIMESTAMPS ||
+      ackFrameWriteResult.extendedAckFeaturesEnabled &
+          static_cast<ExtendedAckFeatureMaskType>(
+              ExtendedAckFeatureMask::RECEIVE_TIMESTAMPS);
+  QuicFrame decodedFrame =
+      parseQuicFrame(queue, hasTimestamps, extendedAckSupport);
+  auto& decodedAckFrame = *decodedFrame.asReadAckFrame();
+  ASSERT_EQ(decodedAckFrame.ackBlocks.size(), ackBlocks.size());
+  auto expected = ackBlocks.crbegin();
+  for (const auto& block : decodedAckFrame.ackBlocks) {
+    EXPECT_EQ(block.startPacket, expected->start);
+    EXPECT_EQ(block.endPacket, expected->end);
+    expected++;
+  }
+}
+
 TEST_P(QuicWriteCodecTest, WriteAckFrameWillSaveAckDelay) {
   MockQuicPacketBuilder pktBuilder;
   setupCommonExpects(pktBuilder);
@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace quic {
+
+template <typename T, size_t ChunkSize>
+typename ChunkedDeque<T, ChunkSize>::size_type
+ChunkedDeque<T, ChunkSize>::allocatedBytes() const noexcept {
+  auto bytes = chunks_.max_size() * sizeof(std::unique_ptr<Chunk>) +
+      chunkStarts_.max_size() * sizeof(size_type);
+  for (const auto& chunk : chunks_) {
+    bytes += sizeof(Chunk) + chunk->max_size() * sizeof(T);
+  }
+  if (spareChunk_) {
+    bytes += sizeof(Chunk) + spareChunk_->max_size() * sizeof(T);
+  }
+  return bytes;
+}
+
+template <typename T, size_t ChunkSize>
+void ChunkedDeque<T, ChunkSize>::shrink_to_fit() {
+  for (auto& chunk : chunks_) {
+    chunk->shrink_to_fit();
+  }
+  chunks_.shrink_to_fit();
+  spareChunk_.reset();
+  chunkStarts_.shrink_to_fit();
+}
+
+template <typename T, size_t ChunkSize>
+typename ChunkedDeque<T, ChunkSize>::const_reference
+ChunkedDeque<T, ChunkSize>::operator[](size_type index) const {
+  auto [chunk, pos] = locate(index);
+  return (*chunks_[chunk])[pos];
+}
+
+template <typename T, size_t ChunkSize>
+typename ChunkedDeque<T, ChunkSize>::reference
+ChunkedDeque<T, ChunkSize>::operator[](size_type index) {
+  auto [chunk, pos] = locate(index);
+  return (*chunks_[chunk])[pos];
+}
+
+template <typename T, size_t ChunkSize>
+typename ChunkedDeque<T, ChunkSize>::const_reference
+ChunkedDeque<T, ChunkSize>::at(size_type index) const {
+  if (index >= size()) {
+    throw std::out_of_range("Out of bound access");
+  }
+  return operator[](index);
+}
+
+template <typename T, size_t ChunkSize>
+typename ChunkedDeque<T, ChunkSize>::reference ChunkedDeque<T, ChunkSize>::at(
+    size_type index) {
+  if (index >= size()) {
+    throw std::out_of_range("Out of bound access");
+  }
+  return operator[](index);
+}
+
+template <typename T, size_t ChunkSize>
+template <class... Args>
+typename ChunkedDeque<T, ChunkSize>::reference
+ChunkedDeque<T, ChunkSize>::emplace_back(Args&&... args) {
+  if (chunks_.empty() || chunks_.back()->size() == ChunkSize) {
+    // Appending keeps the other chunks where they start. The index is only
+    // needed once there are two chunks.
+    if (!chunks_.empty() && chunkStarts_.size() == chunks_.size()) {
+      chunkStarts_.push_back(frontIndex_ + size_);
+    }
+    chunks_.emplace_back(takeChunk());
+  }
+  auto& elem = chunks_.back()->emplace_back(std::forward<Args>(args)...);
+  size_++;
+  return elem;
+}
+
+template <typename T, size_t ChunkSize>
+template <class... Args>
+typename ChunkedDeque<T, ChunkSize>::iterator
+ChunkedDeque<T, ChunkSize>::emplace(const_iterator pos, Args&&... args) {
+  if (pos == cend()) {
+    emplace_back(std::forward<Args>(args)...);
+    return end() - 1;
+  }
+  auto chunk = pos.chunk_;
+  auto index = pos.pos_;
+  if (chunks_[chunk]->size() == ChunkSize) {
+    splitChunk(chunk);
+    auto lowerHalf = chunks_[chunk]->size();
+    if (index > lowerHalf) {
+      chunk++;
+      index -= lowerHalf;
+    }
+  }
+  auto& target = *chunks_[chunk];
+  target.emplace(target.begin() + index, std::forward<Args>(args)...);
+  size_++;
+  invalidateChunkStarts(chunk + 1);
+  return iterator(this, chunk, index);
+}
+
+template <typename T, size_t ChunkSize>
+void ChunkedDeque<T, ChunkSize>::pop_front() {
+  chunks_.front()->pop_front();
+  if (chunks_.front()->empty()) {
+    recycleChunk(std::move(chunks_.front()));
+    chunks_.pop_front();
+    if (!chunkStarts_.empty()) {
+      chunkStarts_.pop_front();
+    }
+  }
+  size_--;
+  frontIndex_++;
+}
+
+template <typename T, size_t ChunkSize>
+void ChunkedDeque<T, ChunkSize>::pop_back() {
+  chunks_.back()->pop_back();
+  if (chunks_.back()->empty()) {
+    recycleChunk(std::move(chunks_.back()));
+    chunks_.pop_back();
+    invalidateChunkStarts(chunks_.size());
+  }
+  size_--;
+}
+
+template <typename T, size_t ChunkSize>
+typename ChunkedDeque<T, ChunkSize>::iterator ChunkedDeque<T, ChunkSize>::erase(
+    const_iterator pos) {
+  return erase(pos, std::next(pos));
+}
+
+template <typename T, size_t ChunkSize>
+typename ChunkedDeque<T, ChunkSize>::iterator ChunkedDeque<T, ChunkSize>::erase(
+    const_iterator first,
+    const_iterator last) {
+  auto chunk = first.chunk_;
+  if (first == last) {
+    return iterator(this, chunk, first.pos_);
+  }
+  invalidateChunkStarts(chunk);
+  if (chunk == last.chunk_) {
+    auto& target = *chunks_[chunk];
+    target.erase(target.begin() + first.pos_, target.begin() + last.pos_);
+    size_ -= last.pos_ - first.pos_;
+    if (target.empty()) {
+      recycleChunk(std::move(chunks_[chunk]));
+      chunks_.erase(chunks_.begin() + chunk);
+      return iterator(this, chunk, 0);
+    }
+    if (first.pos_ == target.size()) {
+      return iterator(this, chunk + 1, 0);
+    }
+    return iterator(this, chunk, first.pos_);
+  }
+  // Trim the first and the last chunk of the range, then drop the chunks in
+  // between along with the first one if it was erased entirely.
+  auto& head = *chunks_[chunk];
+  size_ -= head.size() - first.pos_;
+  head.erase(head.begin() + first.pos_, head.end());
+  for (auto i = chunk + 1; i < last.chunk_; i++) {
+    size_ -= chunks_[i]->size();
+  }
+  if (last.pos_ > 0) {
+    auto& tail = *chunks_[last.chunk_];
+    tail.erase(tail.begin(), tail.begin() + last.pos_);
+    size_ -= last.pos_;
+  }
+  auto eraseFrom = head.empty() ? chunk : chunk + 1;
+  if (eraseFrom < last.chunk_) {
+    chunks_[eraseFrom]->clear();
+    recycleChunk(std::move(chunks_[eraseFrom]));
+  }
+  chunks_.erase(chunks_.begin() + eraseFrom, chunks_.begin() + last.chunk_);
+  return iterator(this, eraseFrom, 0);
+}
+
+template <typename T, size_t ChunkSize>
+void ChunkedDeque<T, ChunkSize>::clear() noexcept {
+  chunks_.clear();
+  chunkStarts_.clear();
+  size_ = 0;
+  frontIndex_ = 0;
+}
+
+template <typename T, size_t ChunkSize>
+void ChunkedDeque<T, ChunkSize>::swap(ChunkedDeque& other) noexcept {
+  chunks_.swap(other.chunks_);
+  chunkStarts_.swap(other.chunkStarts_);
+  spareChunk_.swap(other.spareChunk_);
+  std::swap(size_, other.size_);
+  std::swap(frontIndex_, other.frontIndex_);
+}
+
+template <typename T, size_t ChunkSize>
+template <typename K, typename Compare>
+typename ChunkedDeque<T, ChunkSize>::iterator
+ChunkedDeque<T, ChunkSize>::lowerBound(const K& key, Compare comp) {
+  // The bound is in the first chunk whose last element is not less than key.
+  // Indices rather than iterators, which cost more to step on a CircularDeque.
+  size_type lo = 0;
+  size_type hi = chunks_.size();
+  while (lo < hi) {
+    auto mid = lo + (hi - lo) / 2;
+    if (comp(chunks_[mid]->back(), key)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo == chunks_.size()) {
+    return end();
+  }
+  auto chunk = lo;
+  const auto& target = *chunks_[chunk];
+  lo = 0;
+  hi = target.size() - 1;
+  while (lo < hi) {
+    auto mid = lo + (hi - lo) / 2;
+    if (comp(target[mid], key)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return iterator(this, chunk, lo);
+}
+
+template <typename T, size_t ChunkSize>
+void ChunkedDeque<T, ChunkSize>::splitChunk(size_type chunk) {
+  auto& full = *chunks_[chunk];
+  auto upperHalf = takeChunk();
+  auto mid = full.begin() + full.size() / 2;
+  for (auto it = mid; it != full.end(); ++it) {
+    upperHalf->emplace_back(std::move(*it));
+  }
+  full.erase(mid, full.end());
+  chunks_.emplace(chunks_.begin() + chunk + 1, std::move(upperHalf));
+  invalidateChunkStarts(chunk + 1);
+}
+
+template <typename T, size_t ChunkSize>
+std::unique_ptr<typename ChunkedDeque<T, ChunkSize>::Chunk>
+ChunkedDeque<T, ChunkSize>::takeChunk() {
+  if (spareChunk_) {
+    return std::move(spareChunk_);
+  }
+  return std::make_unique<Chunk>();
+}
+
+template <typename T, size_t ChunkSize>
+void ChunkedDeque<T, ChunkSize>::recycleChunk(
+    std::unique_ptr<Chunk> chunk) noexcept {
+  DCHECK(chunk->empty());
+  if (!spareChunk_) {
+    spareChunk_ = std::move(chunk);
+  }
+}
+
+template <typename T, size_t ChunkSize>
+typename ChunkedDeque<T, ChunkSize>::size_type
+ChunkedDeque<T, ChunkSize>::indexOf(size_type chunk, size_type pos) const {
+  if (chunk == 0 || chunk == chunks_.size()) {
+    return chunk == 0 ? pos : size_;
+  }
+  ensureChunkStarts();
+  return chunkStarts_[chunk] - frontIndex_ + pos;
+}
+
+template <typename T, size_t ChunkSize>
+std::pair<
+    typename ChunkedDeque<T, ChunkSize>::size_type,
+    typename ChunkedDeque<T, ChunkSize>::size_type>
+ChunkedDeque<T, ChunkSize>::locate(size_type index) const {
+  DCHECK_LE(index, size_);
+  if (index == size_) {
+    return {chunks_.size(), 0};
+  }
+  if (index < chunks_.front()->size()) {
+    return {0, index};
+  }
+  ensureChunkStarts();
+  // The first chunk was handled above, so its entry is not looked at.
+  auto it = std::upper_bound(
+      chunkStarts_.begin() + 1, chunkStarts_.end(), frontIndex_ + index);
+  size_type chunk = std::distance(chunkStarts_.begin(), it) - 1;
+  return {chunk, frontIndex_ + index - chunkStarts_[chunk]};
+}
+
+template <typename T, size_t ChunkSize>
+void ChunkedDeque<T, ChunkSize>::invalidateChunkStarts(
+    size_type chunk) noexcept {
+  while (chunkStarts_.size() > chunk) {
+    chunkStarts_.pop_back();
+  }
+}
+
+template <typename T, size_t ChunkSize>
+void ChunkedDeque<T, ChunkSize>::ensureChunkStarts() const {
+  if (chunkStarts_.size() == chunks_.size()) {
+    return;
+  }
+  if (chunkStarts_.empty()) {
+    chunkStarts_.push_back(frontIndex_);
+  }
+  // The first chunk may have been popped from since its entry was made.
+  auto last = chunkStarts_.size() - 1;
+  auto start = (last == 0 ? frontIndex_ : chunkStarts_[last]) +
+      chunks_[last]->size();
+  for (auto i = chunkStarts_.size(); i < chunks_.size(); i++) {
+    chunkStarts_.push_back(start);
+    start += chunks_[i]->size();
+  }
+}
+
+} // namespace quic
@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <quic/common/CircularDeque.h>
+
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace quic {
+
+/**
+ * A deque that keeps its elements in chunks of at most ChunkSize elements. It
+ * pushes and pops at both ends like CircularDeque, but emplace() and erase()
+ * in the middle only move the elements of the chunks they touch, plus the
+ * chunk pointers when a chunk is split or emptied, instead of every element on
+ * one side of the position.
+ *
+ * With C = ChunkSize, the costs are:
+ * - emplace_back(), pop_front() and pop_back(): amortized O(1). A chunk that
+ *   empties is kept as a spare for the next one, so a deque that keeps
+ *   filling up and draining does not go back to malloc.
+ * - emplace() and erase() of a single element: O(C) to shift the rest of its
+ *   chunk, plus O(n / C) to shift the chunk pointers when a chunk is split or
+ *   emptied. The latter is a move of one pointer per chunk.
+ * - lowerBound(): O(log n).
+ * - Stepping an iterator by one: O(1). Longer jumps, distances and
+ *   operator[]: O(log(n / C)) through an index of where each chunk starts.
+ *   pop_front() and appends keep that index. Inserting or erasing in chunk k
+ *   drops its entries past k, which the next jump rebuilds in
+ *   O(n / C - k).
+ *
+ * So it is not O(log n) throughout like a balanced tree. A stream read buffer
+ * holds at most a flow control window of segments, mostly inserts near the
+ * back, and moves one chunk pointer per C segments when it does not.
+ *
+ * emplace() and erase() invalidate all iterators.
+ */
+template <typename T, size_t ChunkSize = 32>
+class ChunkedDeque {
+  static_assert(ChunkSize > 1, "Full chunks must be splittable");
+
+  using Chunk = CircularDeque<T>;
+
+ public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using difference_type = std::ptrdiff_t;
+
+  template <bool IsConst>
+  class Iterator {
+    using DequePtr =
+        std::conditional_t<IsConst, const ChunkedDeque*, ChunkedDeque*>;
+    using ChunkPtr = std::conditional_t<IsConst, const Chunk*, Chunk*>;
+
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<IsConst, const T*, T*>;
+    using reference = std::conditional_t<IsConst, const T&, T&>;
+
+    Iterator() = default;
+
+    template <
+        bool OtherConst,
+        typename = std::enable_if_t<IsConst && !OtherConst>>
+    /* implicit */ Iterator(const Iterator<OtherConst>& other)
+        : deque_(other.deque_),
+          chunkPtr_(other.chunkPtr_),
+          chunk_(other.chunk_),
+          pos_(other.pos_) {}
+
+    reference operator*() const {
+      return (*chunkPtr_)[pos_];
+    }
+
+    pointer operator->() const {
+      return &**this;
+    }
+
+    reference operator[](difference_type n) const {
+      return *(*this + n);
+    }
+
+    Iterator& operator++() {
+      if (++pos_ == chunkPtr_->size()) {
+        setChunk(chunk_ + 1);
+        pos_ = 0;
+      }
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      auto it = *this;
+      ++*this;
+      return it;
+    }
+
+    Iterator& operator--() {
+      if (pos_ == 0) {
+        setChunk(chunk_ - 1);
+        pos_ = chunkPtr_->size();
+      }
+      --pos_;
+      return *this;
+    }
+
+    Iterator operator--(int) {
+      auto it = *this;
+      --*this;
+      return it;
+    }
+
+    Iterator& operator+=(difference_type n) {
+      auto pos = static_cast<difference_type>(pos_) + n;
+      if (pos >= 0 && chunkPtr_ &&
+          static_cast<size_type>(pos) < chunkPtr_->size()) {
+        pos_ = pos;
+      } else if (n == 1) {
+        ++*this;
+      } else if (n == -1) {
+        --*this;
+      } else {
+        size_type chunk;
+        std::tie(chunk, pos_) = deque_->locate(index() + n);
+        setChunk(chunk);
+      }
+      return *this;
+    }
+
+    Iterator& operator-=(difference_type n) {
+      return *this += -n;
+    }
+
+    friend Iterator operator+(Iterator it, difference_type n) {
+      return it += n;
+    }
+
+    friend Iterator operator+(difference_type n, Iterator it) {
+      return it += n;
+    }
+
+    friend Iterator operator-(Iterator it, difference_type n) {
+      return it -= n;
+    }
+
+    friend difference_type operator-(
+        const Iterator& lhs,
+        const Iterator& rhs) {
+      return static_cast<difference_type>(lhs.index()) -
+          static_cast<difference_type>(rhs.index());
+    }
+
+    friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+      return lhs.chunk_ == rhs.chunk_ && lhs.pos_ == rhs.pos_;
+    }
+
+    friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+    friend bool operator<(const Iterator& lhs, const Iterator& rhs) {
+      return lhs.chunk_ < rhs.chunk_ ||
+          (lhs.chunk_ == rhs.chunk_ && lhs.pos_ < rhs.pos_);
+    }
+
+    friend bool operator>(const Iterator& lhs, const Iterator& rhs) {
+      return rhs < lhs;
+    }
+
+    friend bool operator<=(const Iterator& lhs, const Iterator& rhs) {
+      return !(rhs < lhs);
+    }
+
+    friend bool operator>=(const Iterator& lhs, const Iterator& rhs) {
+      return !(lhs < rhs);
+    }
+
+   private:
+    friend class ChunkedDeque;
+    template <bool>
+    friend class Iterator;
+
+    Iterator(DequePtr deque, size_type chunk, size_type pos)
+        : deque_(deque), pos_(pos) {
+      setChunk(chunk);
+    }
+
+    [[nodiscard]] size_type index() const {
+      return deque_->indexOf(chunk_, pos_);
+    }
+
+    void setChunk(size_type chunk) {
+      chunk_ = chunk;
+      chunkPtr_ = chunk < deque_->chunks_.size() ? deque_->chunks_[chunk].get()
+                                                 : nullptr;
+    }
+
+    DequePtr deque_{nullptr};
+    // Saves going through chunks_ on every access. emplace() and erase(),
+    // which move chunks around, invalidate iterators anyway.
+    ChunkPtr chunkPtr_{nullptr};
+    // The end iterator is one chunk past the last, at position 0.
+    size_type chunk_{0};
+    size_type pos_{0};
+  };
+
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  ChunkedDeque() = default;
+
+  ChunkedDeque(const ChunkedDeque&) = delete;
+  ChunkedDeque& operator=(const ChunkedDeque&) = delete;
+
+  // Move constructor will leave other in a default-initialized state.
+  ChunkedDeque(ChunkedDeque&& other) noexcept {
+    swap(other);
+  }
+
+  // Move assignment will leave other in a default-initialized state.
+  ChunkedDeque& operator=(ChunkedDeque&& other) noexcept {
+    swap(other);
+    ChunkedDeque{}.swap(other);
+    return *this;
+  }
+
+  [[nodiscard]] bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  [[nodiscard]] size_type size() const noexcept {
+    return size_;
+  }
+
+  // The heap bytes held by the deque, including unused capacity.
+  [[nodiscard]] size_type allocatedBytes() const noexcept;
+
+  void shrink_to_fit();
+
+  const_reference operator[](size_type index) const;
+  reference operator[](size_type index);
+  [[nodiscard]] const_reference at(size_type index) const;
+  [[nodiscard]] reference at(size_type index);
+
+  [[nodiscard]] const_reference front() const {
+    return chunks_.front()->front();
+  }
+
+  [[nodiscard]] reference front() {
+    return chunks_.front()->front();
+  }
+
+  [[nodiscard]] const_reference back() const {
+    return chunks_.back()->back();
+  }
+
+  [[nodiscard]] reference back() {
+    return chunks_.back()->back();
+  }
+
+  [[nodiscard]] iterator begin() noexcept {
+    return iterator(this, 0, 0);
+  }
+
+  [[nodiscard]] const_iterator begin() const noexcept {
+    return cbegin();
+  }
+
+  [[nodiscard]] iterator end() noexcept {
+    return iterator(this, chunks_.size(), 0);
+  }
+
+  [[nodiscard]] const_iterator end() const noexcept {
+    return cend();
+  }
+
+  [[nodiscard]] const_iterator cbegin() const noexcept {
+    return const_iterator(this, 0, 0);
+  }
+
+  [[nodiscard]] const_iterator cend() const noexcept {
+    return const_iterator(this, chunks_.size(), 0);
+  }
+
+  template <class... Args>
+  reference emplace_back(Args&&... args);
+  template <class... Args>
+  iterator emplace(const_iterator pos, Args&&... args);
+
+  void pop_front();
+  void pop_back();
+
+  iterator erase(const_iterator pos);
+  iterator erase(const_iterator first, const_iterator last);
+  void clear() noexcept;
+  void swap(ChunkedDeque& other) noexcept;
+
+  /**
+   * Like std::lower_bound(begin(), end(), key, comp) on a deque sorted by
+   * comp: the first element for which comp(element, key) is false.
+   */
+  template <typename K, typename Compare>
+  iterator lowerBound(const K& key, Compare comp);
+
+ private:
+  // Moves the upper half of a full chunk into a new chunk after it.
+  void splitChunk(size_type chunk);
+
+  // Returns the spare chunk if there is one, or a new one.
+  std::unique_ptr<Chunk> takeChunk();
+  // Keeps an emptied chunk as the spare, or frees it.
+  void recycleChunk(std::unique_ptr<Chunk> chunk) noexcept;
+
+  [[nodiscard]] size_type indexOf(size_type chunk, size_type pos) const;
+  [[nodiscard]] std::pair<size_type, size_type> locate(size_type index) const;
+  // Drops the chunk starts from chunk on.
+  void invalidateChunkStarts(size_type chunk) noexcept;
+  void ensureChunkStarts() const;
+
+  // Never holds an empty chunk.
+  CircularDeque<std::unique_ptr<Chunk>> chunks_;
+  size_type size_{0};
+  std::unique_ptr<Chunk> spareChunk_;
+  // Elements popped from the front since the deque was last empty. Chunk
+  // starts count them too, so that popping does not move them.
+  size_type frontIndex_{0};
+  // Where each chunk starts, for a prefix of the chunks. The first chunk
+  // always starts at frontIndex_, whatever its entry says.
+  mutable CircularDeque<size_type> chunkStarts_;
+};
+
+} // namespace quic
+
+#include <quic/common/ChunkedDeque-inl.h>
@@ -89,6 +89,15 @@ void CircularDeque<T>::resize(size_type count) {
   end_ = newSize;
 }
 
+template <typename T>
+void CircularDeque<T>::shrink_to_fit() {
+  if (empty()) {
+    CircularDeque{}.swap(*this);
+    return;
+  }
+  resize(size());
+}
+
 template <typename T>
 typename CircularDeque<T>::const_reference CircularDeque<T>::operator[](
     size_type index) const {
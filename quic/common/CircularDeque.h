@@ -120,13 +120,15 @@ struct CircularDeque {
       if (n == 0) {
         return;
       }
+      // Keep both directions O(1) so that binary searches over (reverse)
+      // iterators stay logarithmic.
+      auto maxSize = deque_->capacity_;
+      size_type modulo = wrapped() ? maxSize : maxSize + 1;
       if (n > 0) {
-        auto maxSize = deque_->capacity_;
-        index_ = (index_ + n) % (wrapped() ? maxSize : maxSize + 1);
+        index_ = (index_ + n) % modulo;
       } else {
-        while (n++ != 0) {
-          decrement();
-        }
+        auto steps = static_cast<size_type>(-n) % modulo;
+        index_ = (index_ + modulo - steps) % modulo;
       }
     }
 
@@ -176,9 +178,9 @@ struct CircularDeque {
 
   FOLLY_NODISCARD size_type max_size() const noexcept;
   void resize(size_type count);
+  void shrink_to_fit();
   // Missing compared to std::deque:
   // resize(size_t, const T&);
-  // shrink_to_fit();
 
   const_reference operator[](size_type index) const;
   reference operator[](size_type index);
@@ -21,7 +21,8 @@ FunctionLooper::FunctionLooper(
       type_(type),
       running_(false),
       inLoopBody_(false),
-      fireLoopEarly_(false) {
+      fireLoopEarly_(false),
+      inPacingTimeout_(false) {
   CHECK(func_);
 }
 
@@ -132,6 +133,10 @@ bool FunctionLooper::isLoopCallbackScheduled() {
   return QuicEventBaseLoopCallback::isLoopCallbackScheduled();
 }
 
+bool FunctionLooper::isInPacingTimeout() const {
+  return inPacingTimeout_;
+}
+
 void FunctionLooper::attachEventBase(std::shared_ptr<QuicEventBase> evb) {
   VLOG(10) << __func__ << ": " << type_;
   DCHECK(!evb_);
@@ -149,6 +154,10 @@ void FunctionLooper::detachEventBase() {
 
 void FunctionLooper::timeoutExpired() noexcept {
   folly::DelayedDestruction::DestructorGuard dg(this);
+  inPacingTimeout_ = true;
+  SCOPE_EXIT {
+    inPacingTimeout_ = false;
+  };
   commonLoopBody();
 }
 
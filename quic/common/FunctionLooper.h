@@ -77,6 +77,11 @@ class FunctionLooper : public QuicEventBaseLoopCallback,
    */
   bool isLoopCallbackScheduled();
 
+  /**
+   * Whether the loop body is running because the pacing timer fired.
+   */
+  bool isInPacingTimeout() const;
+
   /**
    * Attaches a new event base to the function looper. Must be invoked on the
    * evb that the looper is to be attached to.
@@ -118,6 +123,7 @@ class FunctionLooper : public QuicEventBaseLoopCallback,
     bool running_ : 1;
     bool inLoopBody_ : 1;
     bool fireLoopEarly_ : 1;
+    bool inPacingTimeout_ : 1;
   };
 };
 } // namespace quic
@@ -122,6 +122,20 @@ struct NetworkData {
     totalData_ += packets_.back().buf.chainLength();
   }
 
+  /**
+   * Moves the packets of other to the end of this one. Unlike addPacket(),
+   * the packets keep their own timings.
+   */
+  void append(NetworkData&& other) {
+    packets_.reserve(packets_.size() + other.packets_.size());
+    for (auto& packet : other.packets_) {
+      packets_.emplace_back(std::move(packet));
+    }
+    totalData_ += other.totalData_;
+    other.packets_.clear();
+    other.totalData_ = 0;
+  }
+
   [[nodiscard]] const std::vector<ReceivedUdpPacket>& getPackets() const {
     return packets_;
   }
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/common/SlabAllocator.h>
+
+#include <glog/logging.h>
+
+#include <cstdlib>
+#include <functional>
+
+namespace {
+
+thread_local quic::SlabAllocator* currentAllocator = nullptr;
+// The block last returned by SlabAllocated::operator new, until the
+// SlabAllocated base of the object constructed in it picks it up.
+thread_local const void* pendingBlock = nullptr;
+
+} // namespace
+
+namespace quic {
+
+void SlabAllocator::Deleter::operator()(SlabAllocator* allocator) const {
+  allocator->released_ = true;
+  if (allocator->numBlocksInUse_ == 0) {
+    delete allocator;
+  }
+}
+
+SlabAllocator::Ptr SlabAllocator::create() {
+  return Ptr(new SlabAllocator());
+}
+
+SlabAllocator::~SlabAllocator() {
+  DCHECK_EQ(numBlocksInUse_, 0);
+  for (auto slab : slabs_) {
+    std::free(slab);
+  }
+}
+
+void* SlabAllocator::allocate(SlabAllocator* allocator, size_t size) {
+  auto blockSize = sizeof(BlockHeader) + size;
+  if (!allocator || blockSize > kMaxBlockSize) {
+    auto header = static_cast<BlockHeader*>(std::malloc(blockSize));
+    if (!header) {
+      throw std::bad_alloc();
+    }
+    header->allocator = nullptr;
+    header->blockSize = blockSize;
+    return header + 1;
+  }
+  return allocator->allocateBlock(
+      (blockSize - 1) / kSizeClassGranularity /* sizeClass */);
+}
+
+void SlabAllocator::deallocate(void* ptr) noexcept {
+  if (!ptr) {
+    return;
+  }
+  if (pendingBlock == ptr) {
+    pendingBlock = nullptr;
+  }
+  auto header = static_cast<BlockHeader*>(ptr) - 1;
+  if (!header->allocator) {
+    std::free(header);
+    return;
+  }
+  header->allocator->deallocateBlock(header);
+}
+
+size_t SlabAllocator::blockSize(const void* ptr) noexcept {
+  return (static_cast<const BlockHeader*>(ptr) - 1)->blockSize;
+}
+
+void* SlabAllocator::allocateBlock(size_t sizeClass) {
+  DCHECK_LT(sizeClass, kNumSizeClasses);
+  if (!freeLists_[sizeClass]) {
+    refill(sizeClass);
+  }
+  auto block = freeLists_[sizeClass];
+  freeLists_[sizeClass] = block->next;
+  auto header = reinterpret_cast<BlockHeader*>(block);
+  header->allocator = this;
+  header->blockSize = (sizeClass + 1) * kSizeClassGranularity;
+  bytesInUse_ += header->blockSize;
+  numBlocksInUse_++;
+  return header + 1;
+}
+
+void SlabAllocator::deallocateBlock(BlockHeader* header) noexcept {
+  auto blockSize = header->blockSize;
+  auto sizeClass = blockSize / kSizeClassGranularity - 1;
+  auto block = reinterpret_cast<FreeBlock*>(header);
+  block->next = freeLists_[sizeClass];
+  freeLists_[sizeClass] = block;
+  bytesInUse_ -= blockSize;
+  DCHECK_GT(numBlocksInUse_, 0);
+  if (--numBlocksInUse_ == 0 && released_) {
+    delete this;
+  }
+}
+
+void SlabAllocator::refill(size_t sizeClass) {
+  auto slab = static_cast<char*>(std::malloc(kSlabSize));
+  if (!slab) {
+    throw std::bad_alloc();
+  }
+  slabs_.push_back(slab);
+  auto blockSize = (sizeClass + 1) * kSizeClassGranularity;
+  // Push in reverse so that blocks are handed out in address order.
+  for (size_t offset = kSlabSize - kSlabSize % blockSize; offset > 0;) {
+    offset -= blockSize;
+    auto block = reinterpret_cast<FreeBlock*>(slab + offset);
+    block->next = freeLists_[sizeClass];
+    freeLists_[sizeClass] = block;
+  }
+}
+
+SlabAllocator* SlabAllocator::current() {
+  return currentAllocator;
+}
+
+SlabAllocator::ScopedCurrent::ScopedCurrent(SlabAllocator* allocator)
+    : prev_(currentAllocator) {
+  currentAllocator = allocator;
+}
+
+SlabAllocator::ScopedCurrent::~ScopedCurrent() {
+  currentAllocator = prev_;
+}
+
+void* SlabAllocated::operator new(size_t size) {
+  auto ptr = SlabAllocator::allocate(SlabAllocator::current(), size);
+  pendingBlock = ptr;
+  return ptr;
+}
+
+SlabAllocated::SlabAllocated() noexcept {
+  if (!pendingBlock) {
+    return;
+  }
+  // Bases are constructed before members, so the first SlabAllocated
+  // constructed inside the pending block is the base of the object that
+  // operator new allocated it for.
+  auto begin = static_cast<const char*>(pendingBlock);
+  auto blockSize = SlabAllocator::blockSize(pendingBlock);
+  auto self = reinterpret_cast<const char*>(this);
+  if (std::greater_equal<const char*>()(self, begin) &&
+      std::less<const char*>()(self, begin + blockSize)) {
+    slabAllocatedBytes_ = blockSize;
+    pendingBlock = nullptr;
+  }
+}
+
+} // namespace quic
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace quic {
+
+/**
+ * A single-threaded allocator for the objects that every connection creates
+ * when it is set up and destroys when it closes: its state, stream manager,
+ * crypto state, congestion controller and pacer.
+ *
+ * Blocks are carved out of slabs, one size class per slab, and freed blocks
+ * go onto a free list per size class. Once the allocator has seen as many
+ * concurrent connections as it has to serve, accepting and closing connections
+ * no longer goes to malloc. Slabs are only released when the allocator is.
+ *
+ * Objects opt in by deriving from SlabAllocated, and are allocated from the
+ * allocator that is current on the thread they are created on. A server
+ * worker makes its allocator current while it sets connections up and feeds
+ * them packets. The allocator must only be used from that thread.
+ */
+class SlabAllocator {
+ public:
+  static constexpr size_t kSlabSize = 64 * 1024;
+  static constexpr size_t kSizeClassGranularity = 64;
+  // Larger blocks are left to malloc.
+  static constexpr size_t kMaxBlockSize = 16 * 1024;
+
+  struct Deleter {
+    void operator()(SlabAllocator* allocator) const;
+  };
+  // Blocks keep the allocator alive until they are freed.
+  using Ptr = std::unique_ptr<SlabAllocator, Deleter>;
+
+  static Ptr create();
+
+  SlabAllocator(const SlabAllocator&) = delete;
+  SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+  /**
+   * Returns a block with room for size bytes, aligned like operator new. The
+   * block comes from malloc if allocator is null or size is too large.
+   */
+  static void* allocate(SlabAllocator* allocator, size_t size);
+
+  // Frees a block returned by allocate().
+  static void deallocate(void* ptr) noexcept;
+
+  /**
+   * The bytes that the block returned by allocate() takes up, including its
+   * header and the rounding up to its size class.
+   */
+  static size_t blockSize(const void* ptr) noexcept;
+
+  // The bytes of the blocks handed out, rounded up to their size class.
+  [[nodiscard]] size_t bytesInUse() const {
+    return bytesInUse_;
+  }
+
+  // The bytes of all the slabs.
+  [[nodiscard]] size_t bytesReserved() const {
+    return slabs_.size() * kSlabSize;
+  }
+
+  // The allocator that SlabAllocated objects come from on this thread.
+  static SlabAllocator* current();
+
+  // Makes an allocator current on this thread for the guard's lifetime.
+  class ScopedCurrent {
+   public:
+    explicit ScopedCurrent(SlabAllocator* allocator);
+    ~ScopedCurrent();
+
+    ScopedCurrent(const ScopedCurrent&) = delete;
+    ScopedCurrent& operator=(const ScopedCurrent&) = delete;
+
+   private:
+    SlabAllocator* prev_;
+  };
+
+ private:
+  static constexpr size_t kNumSizeClasses =
+      kMaxBlockSize / kSizeClassGranularity;
+
+  // Precedes every block, padded to keep the block aligned.
+  struct alignas(alignof(std::max_align_t)) BlockHeader {
+    // Null for blocks from malloc.
+    SlabAllocator* allocator;
+    size_t blockSize;
+  };
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  SlabAllocator() = default;
+  ~SlabAllocator();
+
+  void* allocateBlock(size_t sizeClass);
+  void deallocateBlock(BlockHeader* header) noexcept;
+  // Splits a new slab into blocks of the size class.
+  void refill(size_t sizeClass);
+
+  std::array<FreeBlock*, kNumSizeClasses> freeLists_{};
+  std::vector<void*> slabs_;
+  size_t bytesInUse_{0};
+  size_t numBlocksInUse_{0};
+  // Set once the owner has let go of the allocator.
+  bool released_{false};
+};
+
+/**
+ * Base for the objects allocated from the current SlabAllocator. Deleting
+ * them through a pointer to a base needs a virtual destructor, as usual.
+ */
+struct SlabAllocated {
+  SlabAllocated() noexcept;
+
+  // A copy is a different object, which may not have been allocated the same
+  // way.
+  SlabAllocated(const SlabAllocated&) noexcept : SlabAllocated() {}
+
+  SlabAllocated& operator=(const SlabAllocated&) noexcept {
+    return *this;
+  }
+
+  static void* operator new(size_t size);
+
+  static void operator delete(void* ptr) noexcept {
+    SlabAllocator::deallocate(ptr);
+  }
+
+  // The class operator new hides the placement form.
+  static void* operator new(size_t, void* ptr) noexcept {
+    return ptr;
+  }
+
+  static void operator delete(void*, void*) noexcept {}
+
+  /**
+   * The bytes that the allocation of the object takes up, as
+   * SlabAllocator::blockSize() reports them, or 0 if the object was not
+   * created by operator new above, e.g. on the stack, as a member or with
+   * std::make_shared.
+   */
+  [[nodiscard]] size_t slabAllocatedBytes() const noexcept {
+    return slabAllocatedBytes_;
+  }
+
+ private:
+  size_t slabAllocatedBytes_{0};
+};
+
+} // namespace quic
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/common/ZeroCopyBufferRing.h>
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+#ifdef FOLLY_HAVE_MSG_ERRQUEUE
+#include <linux/errqueue.h>
+
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+
+#ifndef SO_EE_CODE_ZEROCOPY_COPIED
+#define SO_EE_CODE_ZEROCOPY_COPIED 1
+#endif
+#endif
+
+namespace quic {
+
+ZeroCopyBufferRing::ZeroCopyBufferRing(size_t capacity, size_t numBuffers)
+    : capacity_(capacity) {
+  CHECK_GT(numBuffers, 0);
+  freeBufs_.reserve(numBuffers);
+  inFlight_.reserve(numBuffers);
+  for (size_t i = 0; i < numBuffers; i++) {
+    freeBufs_.push_back(folly::IOBuf::createCombined(capacity));
+  }
+}
+
+Buf ZeroCopyBufferRing::acquire() {
+  if (freeBufs_.empty()) {
+    return nullptr;
+  }
+  auto buf = std::move(freeBufs_.back());
+  freeBufs_.pop_back();
+  return buf;
+}
+
+void ZeroCopyBufferRing::onSent(Buf buf, uint32_t numSends) {
+  CHECK(buf);
+  CHECK_GT(numSends, 0);
+  inFlight_.push_back(InFlightBuf{
+      .buf = std::move(buf),
+      .firstSend = nextSend_,
+      .numSends = numSends,
+      .numPending = numSends});
+  nextSend_ += numSends;
+}
+
+bool ZeroCopyBufferRing::onErrMessage([[maybe_unused]] const cmsghdr& cmsg) {
+#ifdef FOLLY_HAVE_MSG_ERRQUEUE
+  if (!(cmsg.cmsg_level == SOL_IP && cmsg.cmsg_type == IP_RECVERR) &&
+      !(cmsg.cmsg_level == SOL_IPV6 && cmsg.cmsg_type == IPV6_RECVERR)) {
+    return false;
+  }
+  const auto* serr =
+      reinterpret_cast<const struct sock_extended_err*>(CMSG_DATA(&cmsg));
+  if (serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY || serr->ee_errno != 0) {
+    return false;
+  }
+  onCompletion(
+      serr->ee_info,
+      serr->ee_data,
+      (serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0);
+  return true;
+#else
+  return false;
+#endif
+}
+
+void ZeroCopyBufferRing::onCompletion(
+    uint32_t first,
+    uint32_t last,
+    bool copied) {
+  // The send counter wraps, so positions are compared relative to the start
+  // of each buffer's range.
+  auto rangeLen = static_cast<int64_t>(last - first) + 1;
+  numCompletedSends_ += rangeLen;
+  if (copied) {
+    numCopiedSends_ += rangeLen;
+  }
+  for (auto& inFlight : inFlight_) {
+    auto start = static_cast<int64_t>(
+        static_cast<int32_t>(first - inFlight.firstSend));
+    auto end = start + rangeLen;
+    auto overlap = std::min<int64_t>(end, inFlight.numSends) -
+        std::max<int64_t>(start, 0);
+    if (overlap > 0) {
+      inFlight.numPending -= std::min<int64_t>(overlap, inFlight.numPending);
+    }
+  }
+  size_t kept = 0;
+  for (auto& inFlight : inFlight_) {
+    if (inFlight.numPending) {
+      inFlight_[kept++] = std::move(inFlight);
+      continue;
+    }
+    inFlight.buf->clear();
+    freeBufs_.push_back(std::move(inFlight.buf));
+  }
+  inFlight_.resize(kept);
+}
+
+} // namespace quic
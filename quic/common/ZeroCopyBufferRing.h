@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/io/IOBuf.h>
+#include <folly/portability/Sockets.h>
+#include <quic/QuicConstants.h>
+
+#include <vector>
+
+namespace quic {
+
+/**
+ * Output buffers for MSG_ZEROCOPY writes from the continuous memory data path.
+ *
+ * After a zerocopy send the kernel keeps referencing the sent bytes until it
+ * posts a completion to the socket's error queue, so the buffer cannot be
+ * reused for the next batch. The in-place batch writers hand the sent buffer
+ * to the ring and continue with a free one, and the ring returns buffers to
+ * the free list as completions arrive.
+ *
+ * The kernel numbers zerocopy sends per socket, starting at 0 and counting
+ * every successful send made with MSG_ZEROCOPY. The ring mirrors that counter,
+ * so it must see every such send on the socket and nothing else. Sockets that
+ * share an fd must therefore share a ring.
+ */
+class ZeroCopyBufferRing {
+ public:
+  // Each buffer has the same capacity as a BufAccessor(capacity).
+  ZeroCopyBufferRing(size_t capacity, size_t numBuffers);
+
+  ~ZeroCopyBufferRing() = default;
+
+  [[nodiscard]] size_t capacity() const {
+    return capacity_;
+  }
+
+  [[nodiscard]] bool hasFreeBuffer() const {
+    return !freeBufs_.empty();
+  }
+
+  /**
+   * Returns an empty buffer, or nullptr if every buffer is still waiting for
+   * its completion.
+   */
+  Buf acquire();
+
+  /**
+   * Takes ownership of a buffer that was just passed to numSends successful
+   * MSG_ZEROCOPY sends. The buffer becomes free once the kernel has completed
+   * all of them.
+   */
+  void onSent(Buf buf, uint32_t numSends);
+
+  /**
+   * Handles a message read from the socket's error queue. Returns true if it
+   * was a zerocopy completion.
+   */
+  bool onErrMessage(const cmsghdr& cmsg);
+
+  /**
+   * Marks the sends numbered [first, last] as complete. copied is set when the
+   * kernel fell back to copying the data, e.g. on loopback.
+   */
+  void onCompletion(uint32_t first, uint32_t last, bool copied);
+
+  [[nodiscard]] size_t numFreeBuffers() const {
+    return freeBufs_.size();
+  }
+
+  [[nodiscard]] size_t numBuffersInFlight() const {
+    return inFlight_.size();
+  }
+
+  [[nodiscard]] uint64_t numCompletedSends() const {
+    return numCompletedSends_;
+  }
+
+  // Completed sends for which the kernel copied the data anyway.
+  [[nodiscard]] uint64_t numCopiedSends() const {
+    return numCopiedSends_;
+  }
+
+ private:
+  struct InFlightBuf {
+    Buf buf;
+    // Number of the first send that referenced buf.
+    uint32_t firstSend;
+    uint32_t numSends;
+    uint32_t numPending;
+  };
+
+  size_t capacity_;
+  std::vector<Buf> freeBufs_;
+  std::vector<InFlightBuf> inFlight_;
+  // Number the kernel will give to the next zerocopy send.
+  uint32_t nextSend_{0};
+  uint64_t numCompletedSends_{0};
+  uint64_t numCopiedSends_{0};
+};
+
+} // namespace quic
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/common/events/CoalescedQuicTimer.h>
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+namespace quic {
+
+CoalescedQuicTimer::Entry::~Entry() {
+  if (timer_) {
+    timer_->removeEntry(this);
+  }
+}
+
+void CoalescedQuicTimer::Entry::cancelImpl() noexcept {
+  if (timer_ && scheduled_) {
+    timer_->unschedule(this);
+  }
+}
+
+std::chrono::milliseconds CoalescedQuicTimer::Entry::getTimeRemainingImpl()
+    const noexcept {
+  if (!scheduled_) {
+    return std::chrono::milliseconds(0);
+  }
+  auto now = Clock::now();
+  if (deadline_ <= now) {
+    return std::chrono::milliseconds(0);
+  }
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+      deadline_ - now);
+}
+
+CoalescedQuicTimer::~CoalescedQuicTimer() {
+  // The callbacks outlive us when they are not owned by the same object.
+  for (auto entry : entries_) {
+    entry->timer_ = nullptr;
+    entry->scheduled_ = false;
+    entry->due_ = false;
+  }
+}
+
+void CoalescedQuicTimer::scheduleTimeout(
+    QuicEventBase& evb,
+    QuicTimerCallback* callback,
+    std::chrono::milliseconds timeout) {
+  if (!callback) {
+    // There is no callback. Nothing to schedule.
+    return;
+  }
+  auto entry = getOrCreateEntry(callback);
+  auto now = Clock::now();
+  if (!entry->scheduled_) {
+    entry->scheduled_ = true;
+    numScheduled_++;
+  }
+  entry->deadline_ = now + timeout;
+  entry->due_ = false;
+  if (evb_ != &evb) {
+    wakeup_.cancelTimerCallback();
+    evb_ = &evb;
+  }
+  if (isArmed()) {
+    // The wheel entry is never armed later than a scheduled deadline, so the
+    // new deadline is the earliest one if it is before it.
+    if (entry->deadline_ < armedDeadline_) {
+      arm(entry->deadline_, now);
+    }
+    return;
+  }
+  rearm(now);
+}
+
+CoalescedQuicTimer::Entry* CoalescedQuicTimer::getOrCreateEntry(
+    QuicTimerCallback* callback) {
+  auto handle = QuicEventBase::getImplHandle(callback);
+  if (handle) {
+    auto it = std::find(entries_.begin(), entries_.end(), handle);
+    if (it != entries_.end()) {
+      return *it;
+    }
+    // The callback was scheduled somewhere else before.
+    handle->cancelImpl();
+    delete handle;
+  }
+  auto entry = new Entry(this, callback);
+  QuicEventBase::setImplHandle(callback, entry);
+  entries_.push_back(entry);
+  return entry;
+}
+
+void CoalescedQuicTimer::unschedule(Entry* entry) {
+  DCHECK(entry->scheduled_);
+  entry->scheduled_ = false;
+  entry->due_ = false;
+  DCHECK_GT(numScheduled_, 0);
+  if (--numScheduled_ == 0) {
+    // Nothing left to wake up for.
+    wakeup_.cancelTimerCallback();
+  }
+}
+
+void CoalescedQuicTimer::removeEntry(Entry* entry) {
+  if (entry->scheduled_) {
+    unschedule(entry);
+  }
+  auto it = std::find(entries_.begin(), entries_.end(), entry);
+  DCHECK(it != entries_.end());
+  entries_.erase(it);
+}
+
+CoalescedQuicTimer::Entry* CoalescedQuicTimer::earliestEntry(
+    bool dueOnly) const {
+  Entry* earliest = nullptr;
+  for (auto entry : entries_) {
+    if (!entry->scheduled_ || (dueOnly && !entry->due_)) {
+      continue;
+    }
+    if (!earliest || entry->deadline_ < earliest->deadline_) {
+      earliest = entry;
+    }
+  }
+  return earliest;
+}
+
+void CoalescedQuicTimer::arm(
+    Clock::time_point deadline,
+    Clock::time_point now) {
+  DCHECK(evb_);
+  armedDeadline_ = deadline;
+  // Round up so that the deadline has passed when the wheel entry fires.
+  auto timeout = deadline > now
+      ? std::chrono::ceil<std::chrono::milliseconds>(deadline - now)
+      : std::chrono::milliseconds(0);
+  evb_->scheduleTimeout(&wakeup_, timeout);
+}
+
+void CoalescedQuicTimer::rearm(Clock::time_point now) {
+  auto earliest = earliestEntry(false /* dueOnly */);
+  if (!earliest) {
+    wakeup_.cancelTimerCallback();
+    return;
+  }
+  arm(earliest->deadline_, now);
+}
+
+bool CoalescedQuicTimer::runDue(
+    Clock::time_point dueBy,
+    bool canceled) noexcept {
+  for (auto entry : entries_) {
+    entry->due_ = entry->scheduled_ && entry->deadline_ <= dueBy;
+  }
+  // The callbacks can schedule, cancel and destroy any of the entries, so
+  // they are looked up again after each one.
+  DestructorCheck::Safety safety(*this);
+  while (auto entry = earliestEntry(true /* dueOnly */)) {
+    auto callback = entry->callback_;
+    unschedule(entry);
+    if (canceled) {
+      callback->callbackCanceled();
+    } else {
+      callback->timeoutExpired();
+    }
+    if (safety.destroyed()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void CoalescedQuicTimer::onWakeup() noexcept {
+  // The wheel fires at tick granularity, it cannot wake us up any closer to
+  // the deadlines within a tick from now.
+  auto now = Clock::now();
+  if (!runDue(now + evb_->getTimerTickInterval(), false /* canceled */)) {
+    return;
+  }
+  if (!isArmed()) {
+    rearm(Clock::now());
+  }
+}
+
+void CoalescedQuicTimer::onWakeupCanceled() noexcept {
+  // The event base's timer is going away, and the scheduled callbacks with it.
+  runDue(Clock::time_point::max(), true /* canceled */);
+}
+
+} // namespace quic
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <quic/common/events/QuicEventBase.h>
+
+#include <folly/io/async/DestructorCheck.h>
+
+#include <chrono>
+#include <vector>
+
+namespace quic {
+
+/**
+ * Coalesces the timeouts of one connection into a single entry in the event
+ * base's timer wheel, armed for the earliest of their deadlines.
+ *
+ * Scheduling a timeout only updates its deadline, unless it is now the
+ * earliest one. Moving a deadline later, like the loss timer being pushed out
+ * on every ACK, and cancelling a timeout leave the wheel entry as it is. When
+ * the entry fires, the timeouts that are due run in deadline order and the
+ * entry is armed again for the next one, so the wheel sees one operation per
+ * wakeup rather than one per reschedule.
+ *
+ * The timeouts keep the QuicTimerCallback interface: cancelTimerCallback(),
+ * isTimerCallbackScheduled() and getTimerCallbackTimeRemaining() work on them
+ * as if they were scheduled on the event base directly. A connection has a
+ * handful of timeouts, so they are kept in a small unsorted vector.
+ */
+class CoalescedQuicTimer : private folly::DestructorCheck {
+ public:
+  CoalescedQuicTimer() : wakeup_(this) {}
+
+  ~CoalescedQuicTimer();
+
+  CoalescedQuicTimer(const CoalescedQuicTimer&) = delete;
+  CoalescedQuicTimer& operator=(const CoalescedQuicTimer&) = delete;
+
+  /**
+   * Schedules the callback to run after timeout, replacing its deadline if it
+   * is already scheduled. The wheel entry is armed on evb, which must be the
+   * same for all the callbacks scheduled at the same time.
+   */
+  void scheduleTimeout(
+      QuicEventBase& evb,
+      QuicTimerCallback* callback,
+      std::chrono::milliseconds timeout);
+
+  // The number of callbacks that are scheduled.
+  [[nodiscard]] size_t numScheduled() const {
+    return numScheduled_;
+  }
+
+  // Whether the wheel entry is armed.
+  [[nodiscard]] bool isArmed() const {
+    return wakeup_.isTimerCallbackScheduled();
+  }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  class Entry : public QuicTimerCallback::TimerCallbackImpl {
+   public:
+    Entry(CoalescedQuicTimer* timer, QuicTimerCallback* callback)
+        : timer_(timer), callback_(callback) {}
+
+    ~Entry() override;
+
+    void cancelImpl() noexcept override;
+
+    [[nodiscard]] bool isScheduledImpl() const noexcept override {
+      return scheduled_;
+    }
+
+    [[nodiscard]] std::chrono::milliseconds getTimeRemainingImpl()
+        const noexcept override;
+
+   private:
+    friend class CoalescedQuicTimer;
+
+    // Null once the timer is destroyed.
+    CoalescedQuicTimer* timer_;
+    QuicTimerCallback* callback_;
+    Clock::time_point deadline_;
+    bool scheduled_{false};
+    // Set for the entries that are due when the wheel entry fires.
+    bool due_{false};
+  };
+
+  class Wakeup : public QuicTimerCallback {
+   public:
+    explicit Wakeup(CoalescedQuicTimer* timer) : timer_(timer) {}
+
+    void timeoutExpired() noexcept override {
+      timer_->onWakeup();
+    }
+
+    void callbackCanceled() noexcept override {
+      timer_->onWakeupCanceled();
+    }
+
+   private:
+    CoalescedQuicTimer* timer_;
+  };
+
+  Entry* getOrCreateEntry(QuicTimerCallback* callback);
+  void unschedule(Entry* entry);
+  void removeEntry(Entry* entry);
+  // The scheduled (and due) entry with the earliest deadline, if any.
+  Entry* earliestEntry(bool dueOnly) const;
+  void arm(Clock::time_point deadline, Clock::time_point now);
+  // Arms the wheel entry for the earliest deadline, or cancels it.
+  void rearm(Clock::time_point now);
+  /**
+   * Marks the scheduled entries with deadlines up to dueBy, then runs them in
+   * deadline order. Entries scheduled by the callbacks wait for the next
+   * wakeup. Returns false if the timer was destroyed by a callback.
+   */
+  bool runDue(Clock::time_point dueBy, bool canceled) noexcept;
+  void onWakeup() noexcept;
+  void onWakeupCanceled() noexcept;
+
+  std::vector<Entry*> entries_;
+  size_t numScheduled_{0};
+  Wakeup wakeup_;
+  QuicEventBase* evb_{nullptr};
+  Clock::time_point armedDeadline_;
+};
+
+} // namespace quic
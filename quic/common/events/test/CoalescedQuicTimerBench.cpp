@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/Benchmark.h>
+#include <gflags/gflags.h>
+#include <quic/common/events/CoalescedQuicTimer.h>
+#include <quic/common/events/FollyQuicEventBase.h>
+
+#include <memory>
+
+/**
+ * A worker with 1M connections receiving ACKs: each ACK reschedules the
+ * connection's loss timeout and pushes its idle timeout out, either on the
+ * event base's timer wheel directly or through the connection's
+ * CoalescedQuicTimer. One iteration is one ACK on a random connection.
+ *
+ * The event base does not loop, so the coalesced timers never wake up. On a
+ * real worker they wake up about once per loss timeout, far less often than
+ * the ACKs arrive.
+ */
+
+using namespace quic;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr size_t kNumConnections = 1000000;
+constexpr auto kLossTimeout = 200ms;
+constexpr auto kIdleTimeout = 30s;
+
+class NoopTimeout : public QuicTimerCallback {
+ public:
+  void timeoutExpired() noexcept override {}
+
+  void callbackCanceled() noexcept override {}
+};
+
+struct Connection {
+  CoalescedQuicTimer timer;
+  NoopTimeout lossTimeout;
+  NoopTimeout idleTimeout;
+};
+
+FollyQuicEventBase& getEventBase() {
+  // Never destroyed, like the connections.
+  static auto evb = new folly::EventBase();
+  static auto qEvb = new FollyQuicEventBase(evb);
+  return *qEvb;
+}
+
+void onAck(Connection& conn, bool coalesced) {
+  auto& evb = getEventBase();
+  if (coalesced) {
+    conn.timer.scheduleTimeout(evb, &conn.lossTimeout, kLossTimeout);
+    conn.timer.scheduleTimeout(evb, &conn.idleTimeout, kIdleTimeout);
+  } else {
+    evb.scheduleTimeout(&conn.lossTimeout, kLossTimeout);
+    evb.scheduleTimeout(&conn.idleTimeout, kIdleTimeout);
+  }
+}
+
+Connection* getConnections(bool coalesced) {
+  // The two modes cannot share callbacks, each keeps its own connections.
+  static Connection* connections[2] = {nullptr, nullptr};
+  auto& conns = connections[coalesced ? 1 : 0];
+  if (!conns) {
+    conns = new Connection[kNumConnections];
+    for (size_t i = 0; i < kNumConnections; i++) {
+      onAck(conns[i], coalesced);
+    }
+  }
+  return conns;
+}
+
+void rescheduleOnAckBench(size_t iters, bool coalesced) {
+  folly::BenchmarkSuspender suspender;
+  auto conns = getConnections(coalesced);
+  uint64_t rng = 0x9e3779b97f4a7c15;
+  suspender.dismiss();
+
+  while (iters--) {
+    // xorshift64
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    onAck(conns[rng % kNumConnections], coalesced);
+  }
+}
+
+} // namespace
+
+BENCHMARK_NAMED_PARAM(rescheduleOnAckBench, wheel, false)
+BENCHMARK_RELATIVE_NAMED_PARAM(rescheduleOnAckBench, coalesced, true)
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/common/events/CoalescedQuicTimer.h>
+
+#include <folly/portability/GTest.h>
+#include <quic/common/events/FollyQuicEventBase.h>
+
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace quic::test {
+
+namespace {
+
+class TestCallback : public QuicTimerCallback {
+ public:
+  TestCallback() = default;
+
+  explicit TestCallback(folly::Function<void()> onExpired)
+      : onExpired_(std::move(onExpired)) {}
+
+  void timeoutExpired() noexcept override {
+    numExpired++;
+    if (onExpired_) {
+      onExpired_();
+    }
+  }
+
+  void callbackCanceled() noexcept override {
+    numCanceled++;
+  }
+
+  size_t numExpired{0};
+  size_t numCanceled{0};
+
+ private:
+  folly::Function<void()> onExpired_;
+};
+
+class CoalescedQuicTimerTest : public ::testing::Test {
+ protected:
+  folly::EventBase evb_;
+  FollyQuicEventBase qEvb_{&evb_};
+  CoalescedQuicTimer timer_;
+};
+
+} // namespace
+
+TEST_F(CoalescedQuicTimerTest, FiresInDeadlineOrder) {
+  std::vector<int> order;
+  TestCallback a([&] { order.push_back(0); });
+  TestCallback b([&] { order.push_back(1); });
+  TestCallback c([&] { order.push_back(2); });
+  timer_.scheduleTimeout(qEvb_, &a, 30ms);
+  timer_.scheduleTimeout(qEvb_, &b, 10ms);
+  timer_.scheduleTimeout(qEvb_, &c, 20ms);
+  EXPECT_TRUE(a.isTimerCallbackScheduled());
+  EXPECT_TRUE(b.isTimerCallbackScheduled());
+  EXPECT_TRUE(c.isTimerCallbackScheduled());
+  EXPECT_EQ(timer_.numScheduled(), 3);
+  EXPECT_TRUE(timer_.isArmed());
+
+  evb_.loop();
+  EXPECT_EQ(order, std::vector<int>({1, 2, 0}));
+  EXPECT_FALSE(a.isTimerCallbackScheduled());
+  EXPECT_EQ(timer_.numScheduled(), 0);
+  EXPECT_FALSE(timer_.isArmed());
+}
+
+TEST_F(CoalescedQuicTimerTest, RescheduleLater) {
+  TestCallback cb;
+  timer_.scheduleTimeout(qEvb_, &cb, 10ms);
+  timer_.scheduleTimeout(qEvb_, &cb, 50ms);
+  EXPECT_EQ(timer_.numScheduled(), 1);
+  EXPECT_GT(cb.getTimerCallbackTimeRemaining(), 40ms);
+
+  auto start = std::chrono::steady_clock::now();
+  evb_.loop();
+  EXPECT_EQ(cb.numExpired, 1);
+  EXPECT_GE(std::chrono::steady_clock::now() - start, 40ms);
+}
+
+TEST_F(CoalescedQuicTimerTest, RescheduleEarlier) {
+  TestCallback early;
+  TestCallback late;
+  timer_.scheduleTimeout(qEvb_, &late, 10s);
+  timer_.scheduleTimeout(qEvb_, &early, 1s);
+  timer_.scheduleTimeout(qEvb_, &late, 10ms);
+
+  auto start = std::chrono::steady_clock::now();
+  evb_.loopOnce();
+  EXPECT_EQ(late.numExpired, 1);
+  EXPECT_EQ(early.numExpired, 0);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+  EXPECT_TRUE(timer_.isArmed());
+  early.cancelTimerCallback();
+}
+
+TEST_F(CoalescedQuicTimerTest, Cancel) {
+  TestCallback a;
+  TestCallback b;
+  timer_.scheduleTimeout(qEvb_, &a, 10ms);
+  timer_.scheduleTimeout(qEvb_, &b, 20ms);
+  a.cancelTimerCallback();
+  EXPECT_FALSE(a.isTimerCallbackScheduled());
+  EXPECT_EQ(a.getTimerCallbackTimeRemaining(), 0ms);
+  EXPECT_EQ(timer_.numScheduled(), 1);
+  EXPECT_TRUE(timer_.isArmed());
+  b.cancelTimerCallback();
+  EXPECT_EQ(timer_.numScheduled(), 0);
+  EXPECT_FALSE(timer_.isArmed());
+
+  evb_.loop();
+  EXPECT_EQ(a.numExpired, 0);
+  EXPECT_EQ(b.numExpired, 0);
+}
+
+TEST_F(CoalescedQuicTimerTest, RescheduleFromCallback) {
+  TestCallback cb;
+  // Runs again on the next wakeup rather than in a loop on this one.
+  TestCallback other([&] {
+    if (other.numExpired == 1) {
+      timer_.scheduleTimeout(qEvb_, &other, 0ms);
+      timer_.scheduleTimeout(qEvb_, &cb, 0ms);
+    }
+  });
+  timer_.scheduleTimeout(qEvb_, &other, 0ms);
+  evb_.loop();
+  EXPECT_EQ(other.numExpired, 2);
+  EXPECT_EQ(cb.numExpired, 1);
+}
+
+TEST_F(CoalescedQuicTimerTest, CallbackDestroyedFromCallback) {
+  auto victim = std::make_unique<TestCallback>();
+  TestCallback killer([&] { victim.reset(); });
+  timer_.scheduleTimeout(qEvb_, &killer, 0ms);
+  timer_.scheduleTimeout(qEvb_, victim.get(), 0ms);
+  evb_.loop();
+  EXPECT_EQ(killer.numExpired, 1);
+  EXPECT_EQ(victim, nullptr);
+  EXPECT_EQ(timer_.numScheduled(), 0);
+}
+
+TEST_F(CoalescedQuicTimerTest, TimerDestroyedFromCallback) {
+  auto timer = std::make_unique<CoalescedQuicTimer>();
+  TestCallback other;
+  TestCallback killer([&] { timer.reset(); });
+  timer->scheduleTimeout(qEvb_, &killer, 0ms);
+  timer->scheduleTimeout(qEvb_, &other, 0ms);
+  evb_.loop();
+  EXPECT_EQ(killer.numExpired, 1);
+  EXPECT_EQ(other.numExpired, 0);
+  EXPECT_FALSE(other.isTimerCallbackScheduled());
+  EXPECT_FALSE(killer.isTimerCallbackScheduled());
+}
+
+TEST_F(CoalescedQuicTimerTest, ScheduledOnEventBaseBefore) {
+  TestCallback cb;
+  qEvb_.scheduleTimeout(&cb, 10s);
+  timer_.scheduleTimeout(qEvb_, &cb, 10ms);
+  EXPECT_TRUE(cb.isTimerCallbackScheduled());
+  evb_.loop();
+  EXPECT_EQ(cb.numExpired, 1);
+}
+
+} // namespace quic::test
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/common/ChunkedDeque.h>
+
+#include <folly/portability/GTest.h>
+
+#include <deque>
+#include <random>
+
+namespace quic {
+
+namespace {
+
+// Small chunks so that a few elements already span several chunks.
+using TestDeque = ChunkedDeque<int, 4>;
+
+void expectSame(const TestDeque& cd, const std::deque<int>& expected) {
+  ASSERT_EQ(expected.size(), cd.size());
+  EXPECT_EQ(expected.empty(), cd.empty());
+  EXPECT_TRUE(std::equal(cd.begin(), cd.end(), expected.begin()));
+  EXPECT_EQ(expected.size(), cd.cend() - cd.cbegin());
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(expected[i], cd[i]);
+    EXPECT_EQ(expected[i], cd.cbegin()[i]);
+  }
+  if (!expected.empty()) {
+    EXPECT_EQ(expected.front(), cd.front());
+    EXPECT_EQ(expected.back(), cd.back());
+    EXPECT_EQ(expected.back(), *(cd.end() - 1));
+  }
+}
+
+} // namespace
+
+TEST(ChunkedDequeTest, PushAndPop) {
+  TestDeque cd;
+  std::deque<int> expected;
+  expectSame(cd, expected);
+  for (int i = 0; i < 10; i++) {
+    cd.emplace_back(i);
+    expected.push_back(i);
+  }
+  expectSame(cd, expected);
+  cd.pop_front();
+  expected.pop_front();
+  cd.pop_back();
+  expected.pop_back();
+  expectSame(cd, expected);
+  EXPECT_EQ(1, cd.at(0));
+  EXPECT_THROW((void)cd.at(cd.size()), std::out_of_range);
+
+  cd.clear();
+  EXPECT_TRUE(cd.empty());
+  EXPECT_EQ(cd.begin(), cd.end());
+}
+
+TEST(ChunkedDequeTest, EmplaceSplitsFullChunks) {
+  TestDeque cd;
+  std::deque<int> expected;
+  for (int i = 0; i < 4; i++) {
+    cd.emplace_back(i * 10);
+    expected.push_back(i * 10);
+  }
+  auto it = cd.emplace(cd.begin() + 3, 25);
+  expected.insert(expected.begin() + 3, 25);
+  EXPECT_EQ(25, *it);
+  EXPECT_EQ(3, it - cd.begin());
+  it = cd.emplace(cd.begin() + 2, 15);
+  expected.insert(expected.begin() + 2, 15);
+  EXPECT_EQ(15, *it);
+  it = cd.emplace(cd.end(), 40);
+  expected.push_back(40);
+  EXPECT_EQ(40, *it);
+  expectSame(cd, expected);
+}
+
+TEST(ChunkedDequeTest, EraseAcrossChunks) {
+  TestDeque cd;
+  std::deque<int> expected;
+  for (int i = 0; i < 20; i++) {
+    cd.emplace_back(i);
+    expected.push_back(i);
+  }
+  // Within a chunk.
+  auto it = cd.erase(cd.begin() + 1, cd.begin() + 3);
+  expected.erase(expected.begin() + 1, expected.begin() + 3);
+  EXPECT_EQ(3, *it);
+  expectSame(cd, expected);
+
+  // Across chunks, keeping both ends of the range.
+  it = cd.erase(cd.begin() + 3, cd.begin() + 11);
+  expected.erase(expected.begin() + 3, expected.begin() + 11);
+  EXPECT_EQ(13, *it);
+  expectSame(cd, expected);
+
+  // Up to the end.
+  it = cd.erase(cd.begin() + 5, cd.end());
+  expected.erase(expected.begin() + 5, expected.end());
+  EXPECT_EQ(cd.end(), it);
+  expectSame(cd, expected);
+
+  it = cd.erase(cd.begin());
+  expected.erase(expected.begin());
+  EXPECT_EQ(expected.front(), *it);
+  expectSame(cd, expected);
+
+  cd.erase(cd.begin(), cd.end());
+  EXPECT_TRUE(cd.empty());
+}
+
+TEST(ChunkedDequeTest, IndexAfterPopFrontAndInsert) {
+  TestDeque cd;
+  std::deque<int> expected;
+  for (int i = 0; i < 40; i++) {
+    cd.emplace_back(i);
+    expected.push_back(i);
+  }
+  // Builds the index, which popping from the front keeps.
+  EXPECT_EQ(30, cd[30]);
+  for (int i = 0; i < 7; i++) {
+    cd.pop_front();
+    expected.pop_front();
+    expectSame(cd, expected);
+  }
+  // Only the chunk starts after the insert are rebuilt.
+  cd.emplace(cd.begin() + 25, -1);
+  expected.insert(expected.begin() + 25, -1);
+  expectSame(cd, expected);
+  cd.emplace(cd.begin() + 2, -2);
+  expected.insert(expected.begin() + 2, -2);
+  cd.pop_front();
+  expected.pop_front();
+  expectSame(cd, expected);
+}
+
+TEST(ChunkedDequeTest, ReusesEmptiedChunk) {
+  TestDeque cd;
+  cd.emplace_back(0);
+  cd.pop_front();
+  auto bytes = cd.allocatedBytes();
+  EXPECT_GT(bytes, 0);
+  for (int i = 0; i < 10; i++) {
+    cd.emplace_back(i);
+    cd.pop_front();
+    EXPECT_EQ(bytes, cd.allocatedBytes());
+  }
+  cd.shrink_to_fit();
+  EXPECT_EQ(0, cd.allocatedBytes());
+}
+
+TEST(ChunkedDequeTest, LowerBound) {
+  TestDeque cd;
+  for (int i = 0; i < 30; i++) {
+    cd.emplace_back(i * 2);
+  }
+  auto less = [](int elem, int key) { return elem < key; };
+  for (int key = -1; key < 61; key++) {
+    auto it = cd.lowerBound(key, less);
+    auto expected = std::lower_bound(cd.begin(), cd.end(), key);
+    EXPECT_EQ(expected, it) << key;
+  }
+  EXPECT_EQ(cd.end(), cd.lowerBound(100, less));
+}
+
+TEST(ChunkedDequeTest, RandomOperations) {
+  TestDeque cd;
+  std::deque<int> expected;
+  std::mt19937 rng(0);
+  for (int i = 0; i < 5000; i++) {
+    auto op = rng() % 6;
+    size_t index = expected.empty() ? 0 : rng() % expected.size();
+    if (op == 0 || expected.empty()) {
+      cd.emplace_back(i);
+      expected.push_back(i);
+    } else if (op == 1) {
+      cd.emplace(cd.begin() + index, i);
+      expected.insert(expected.begin() + index, i);
+    } else if (op == 2) {
+      auto count = std::min<size_t>(rng() % 10, expected.size() - index);
+      cd.erase(cd.begin() + index, cd.begin() + index + count);
+      expected.erase(
+          expected.begin() + index, expected.begin() + index + count);
+    } else if (op == 3) {
+      cd.pop_front();
+      expected.pop_front();
+    } else if (op == 4) {
+      cd.pop_back();
+      expected.pop_back();
+    } else {
+      cd[index] = -i;
+      expected[index] = -i;
+    }
+    if (i % 100 == 0) {
+      expectSame(cd, expected);
+    }
+  }
+  expectSame(cd, expected);
+  cd.shrink_to_fit();
+  expectSame(cd, expected);
+}
+
+TEST(ChunkedDequeTest, Move) {
+  TestDeque cd;
+  for (int i = 0; i < 10; i++) {
+    cd.emplace_back(i);
+  }
+  TestDeque moved(std::move(cd));
+  EXPECT_EQ(10, moved.size());
+  EXPECT_TRUE(cd.empty());
+  EXPECT_EQ(9, moved[9]);
+
+  cd = std::move(moved);
+  EXPECT_EQ(10, cd.size());
+  EXPECT_TRUE(moved.empty());
+  EXPECT_EQ(5, *(cd.begin() + 5));
+}
+
+} // namespace quic
@@ -601,6 +601,30 @@ TEST(CircularDequeTest, Resize) {
   EXPECT_TRUE(verifyStorageContent(emptyCD, expected));
 }
 
+TEST(CircularDequeTest, ShrinkToFit) {
+  CircularDeque<int> cd;
+  for (int i = 0; i < 100; i++) {
+    cd.push_back(i);
+  }
+  for (int i = 0; i < 90; i++) {
+    cd.pop_front();
+  }
+  cd.shrink_to_fit();
+  EXPECT_EQ(10, cd.max_size());
+  std::vector<int> expected = {90, 91, 92, 93, 94, 95, 96, 97, 98, 99};
+  EXPECT_TRUE(verifyStorageContent(cd, expected));
+  cd.push_back(100);
+  expected.push_back(100);
+  EXPECT_TRUE(verifyStorageContent(cd, expected));
+
+  cd.clear();
+  cd.shrink_to_fit();
+  EXPECT_TRUE(cd.empty());
+  EXPECT_EQ(0, cd.max_size());
+  cd.push_front(1);
+  EXPECT_EQ(1, cd.front());
+}
+
 TEST(CircularDequeTest, MiddleOpsNoCrashNoLeak) {
   CircularDeque<std::string> cd;
   size_t counter = 0;
@@ -770,4 +794,36 @@ TEST(CircularDequeTest, MoveOrCopyDoNotOverwrite) {
   EXPECT_EQ(5, *pos);
   EXPECT_TRUE(verifyStorageContent(cd, expected));
 }
+
+TEST(CircularDequeTest, BackwardAdvanceAndBinarySearch) {
+  CircularDeque<int> cd;
+  // Force the content to wrap around the end of the storage.
+  for (int i = 0; i < 100; i++) {
+    cd.push_back(i);
+  }
+  for (int i = 0; i < 60; i++) {
+    cd.pop_front();
+  }
+  for (int i = 100; i < 150; i++) {
+    cd.push_back(i);
+  }
+  ASSERT_EQ(90, cd.size());
+  for (size_t i = 0; i <= cd.size(); i++) {
+    EXPECT_EQ(cd.begin() + i, cd.end() - (cd.size() - i));
+    EXPECT_EQ(cd.rbegin() + i, cd.rend() - (cd.size() - i));
+  }
+  for (int val = 55; val < 155; val++) {
+    auto expected = std::find_if(
+        cd.begin(), cd.end(), [val](int elem) { return elem >= val; });
+    EXPECT_EQ(expected, std::lower_bound(cd.begin(), cd.end(), val));
+    auto rexpected = std::find_if(
+        cd.rbegin(), cd.rend(), [val](int elem) { return elem <= val; });
+    EXPECT_EQ(
+        rexpected,
+        std::lower_bound(
+            cd.rbegin(), cd.rend(), val, [](int elem, int target) {
+              return elem > target;
+            }));
+  }
+}
 } // namespace quic
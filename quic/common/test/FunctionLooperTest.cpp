@@ -193,6 +193,33 @@ TEST(FunctionLooperTest, PacingOnce) {
   looper->stop();
 }
 
+TEST(FunctionLooperTest, InPacingTimeout) {
+  folly::EventBase backingEvb;
+  auto evb = std::make_shared<FollyQuicEventBase>(&backingEvb);
+  QuicTimer::SharedPtr pacingTimer =
+      std::make_shared<HighResQuicTimer>(evb->getBackingEventBase(), 1ms);
+  FunctionLooper* rawLooper = nullptr;
+  std::vector<bool> inPacingTimeout;
+  auto func = [&]() {
+    inPacingTimeout.push_back(rawLooper->isInPacingTimeout());
+  };
+  auto pacingFunc = [&]() -> auto {
+    return 3600000ms;
+  };
+  FunctionLooper::Ptr looper(
+      new FunctionLooper(evb, std::move(func), LooperType::WriteLooper));
+  rawLooper = looper.get();
+  looper->setPacingTimer(std::move(pacingTimer));
+  looper->setPacingFunction(std::move(pacingFunc));
+  looper->run();
+  evb->loopOnce();
+  looper->cancelTimerCallback();
+  looper->timeoutExpired();
+  EXPECT_EQ(std::vector<bool>({false, true}), inPacingTimeout);
+  EXPECT_FALSE(looper->isInPacingTimeout());
+  looper->stop();
+}
+
 TEST(FunctionLooperTest, KeepPacing) {
   folly::EventBase backingEvb;
   auto evb = std::make_shared<FollyQuicEventBase>(&backingEvb);
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/common/SlabAllocator.h>
+
+#include <folly/portability/GTest.h>
+
+#include <vector>
+
+namespace quic {
+
+namespace {
+
+struct TestObject : public SlabAllocated {
+  virtual ~TestObject() = default;
+
+  uint64_t value{0};
+  // 1024 bytes with the block header.
+  char payload[984];
+};
+
+struct TestObjectHolder : public SlabAllocated {
+  TestObject member;
+};
+
+struct LargeTestObject : public TestObject {
+  char morePayload[SlabAllocator::kMaxBlockSize];
+};
+
+} // namespace
+
+TEST(SlabAllocator, AllocatesFromCurrent) {
+  auto allocator = SlabAllocator::create();
+  std::unique_ptr<TestObject> obj;
+  {
+    SlabAllocator::ScopedCurrent scope(allocator.get());
+    EXPECT_EQ(allocator.get(), SlabAllocator::current());
+    obj = std::make_unique<TestObject>();
+  }
+  EXPECT_EQ(nullptr, SlabAllocator::current());
+  EXPECT_EQ(1024, allocator->bytesInUse());
+  EXPECT_EQ(SlabAllocator::kSlabSize, allocator->bytesReserved());
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(obj.get()) % alignof(TestObject));
+  EXPECT_EQ(1024, SlabAllocator::blockSize(obj.get()));
+  EXPECT_EQ(1024, obj->slabAllocatedBytes());
+
+  obj.reset();
+  EXPECT_EQ(0, allocator->bytesInUse());
+  EXPECT_EQ(SlabAllocator::kSlabSize, allocator->bytesReserved());
+}
+
+TEST(SlabAllocator, RecyclesBlocks) {
+  auto allocator = SlabAllocator::create();
+  SlabAllocator::ScopedCurrent scope(allocator.get());
+  std::vector<std::unique_ptr<TestObject>> objs;
+  for (size_t i = 0; i < 200; i++) {
+    objs.push_back(std::make_unique<TestObject>());
+    objs.back()->value = i;
+  }
+  for (size_t i = 0; i < objs.size(); i++) {
+    EXPECT_EQ(i, objs[i]->value);
+  }
+  auto reserved = allocator->bytesReserved();
+  EXPECT_EQ(200 * 1024, allocator->bytesInUse());
+
+  objs.clear();
+  EXPECT_EQ(0, allocator->bytesInUse());
+  for (size_t i = 0; i < 200; i++) {
+    objs.push_back(std::make_unique<TestObject>());
+  }
+  EXPECT_EQ(reserved, allocator->bytesReserved());
+}
+
+TEST(SlabAllocator, LargeAndUnscopedObjectsUseMalloc) {
+  auto allocator = SlabAllocator::create();
+  auto unscoped = std::make_unique<TestObject>();
+  SlabAllocator::ScopedCurrent scope(allocator.get());
+  std::unique_ptr<TestObject> large = std::make_unique<LargeTestObject>();
+  EXPECT_EQ(0, allocator->bytesInUse());
+  EXPECT_EQ(0, allocator->bytesReserved());
+  EXPECT_EQ(1024, SlabAllocator::blockSize(unscoped.get()));
+  EXPECT_EQ(
+      1024 + sizeof(LargeTestObject::morePayload),
+      SlabAllocator::blockSize(dynamic_cast<const void*>(large.get())));
+}
+
+TEST(SlabAllocator, SlabAllocatedBytesOnlyForOperatorNew) {
+  auto allocator = SlabAllocator::create();
+  SlabAllocator::ScopedCurrent scope(allocator.get());
+  std::unique_ptr<TestObject> large = std::make_unique<LargeTestObject>();
+  EXPECT_EQ(
+      SlabAllocator::blockSize(dynamic_cast<const void*>(large.get())),
+      large->slabAllocatedBytes());
+
+  TestObject onStack;
+  EXPECT_EQ(0, onStack.slabAllocatedBytes());
+  auto shared = std::make_shared<TestObject>();
+  EXPECT_EQ(0, shared->slabAllocatedBytes());
+  auto holder = std::make_unique<TestObjectHolder>();
+  EXPECT_EQ(
+      SlabAllocator::blockSize(holder.get()), holder->slabAllocatedBytes());
+  EXPECT_EQ(0, holder->member.slabAllocatedBytes());
+  TestObject copy(*large);
+  EXPECT_EQ(0, copy.slabAllocatedBytes());
+}
+
+TEST(SlabAllocator, BlocksOutliveOwner) {
+  auto allocator = SlabAllocator::create();
+  std::unique_ptr<TestObject> obj;
+  {
+    SlabAllocator::ScopedCurrent scope(allocator.get());
+    obj = std::make_unique<TestObject>();
+  }
+  allocator.reset();
+  obj->value = 1;
+  // Frees the allocator with the last block.
+  obj.reset();
+}
+
+TEST(SlabAllocator, NestedScopes) {
+  auto allocator1 = SlabAllocator::create();
+  auto allocator2 = SlabAllocator::create();
+  SlabAllocator::ScopedCurrent scope1(allocator1.get());
+  {
+    SlabAllocator::ScopedCurrent scope2(allocator2.get());
+    EXPECT_EQ(allocator2.get(), SlabAllocator::current());
+    {
+      SlabAllocator::ScopedCurrent scope3(nullptr);
+      EXPECT_EQ(nullptr, SlabAllocator::current());
+    }
+    EXPECT_EQ(allocator2.get(), SlabAllocator::current());
+  }
+  EXPECT_EQ(allocator1.get(), SlabAllocator::current());
+}
+
+} // namespace quic
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/common/ZeroCopyBufferRing.h>
+
+#include <folly/portability/GTest.h>
+
+#include <limits>
+
+#ifdef FOLLY_HAVE_MSG_ERRQUEUE
+#include <linux/errqueue.h>
+#endif
+
+namespace quic {
+
+TEST(ZeroCopyBufferRing, AcquireUntilEmpty) {
+  ZeroCopyBufferRing ring(1000, 2);
+  EXPECT_EQ(2, ring.numFreeBuffers());
+  auto buf1 = ring.acquire();
+  auto buf2 = ring.acquire();
+  ASSERT_TRUE(buf1);
+  ASSERT_TRUE(buf2);
+  EXPECT_LE(1000, buf1->capacity());
+  EXPECT_FALSE(ring.hasFreeBuffer());
+  EXPECT_EQ(nullptr, ring.acquire());
+}
+
+TEST(ZeroCopyBufferRing, CompletionFreesBuffer) {
+  ZeroCopyBufferRing ring(1000, 1);
+  auto buf = ring.acquire();
+  buf->append(500);
+  ring.onSent(std::move(buf), 1);
+  EXPECT_EQ(1, ring.numBuffersInFlight());
+  EXPECT_FALSE(ring.hasFreeBuffer());
+
+  ring.onCompletion(0, 0, false /* copied */);
+  EXPECT_EQ(0, ring.numBuffersInFlight());
+  buf = ring.acquire();
+  ASSERT_TRUE(buf);
+  EXPECT_EQ(0, buf->length());
+  EXPECT_EQ(0, buf->headroom());
+  EXPECT_EQ(1, ring.numCompletedSends());
+  EXPECT_EQ(0, ring.numCopiedSends());
+}
+
+TEST(ZeroCopyBufferRing, BufferWaitsForAllItsSends) {
+  ZeroCopyBufferRing ring(1000, 2);
+  ring.onSent(ring.acquire(), 3);
+  ring.onSent(ring.acquire(), 1);
+
+  ring.onCompletion(0, 1, false /* copied */);
+  EXPECT_EQ(2, ring.numBuffersInFlight());
+  // Completions may arrive out of order.
+  ring.onCompletion(3, 3, false /* copied */);
+  EXPECT_EQ(1, ring.numBuffersInFlight());
+  ring.onCompletion(2, 2, true /* copied */);
+  EXPECT_EQ(0, ring.numBuffersInFlight());
+  EXPECT_EQ(2, ring.numFreeBuffers());
+  EXPECT_EQ(4, ring.numCompletedSends());
+  EXPECT_EQ(1, ring.numCopiedSends());
+}
+
+TEST(ZeroCopyBufferRing, CoalescedCompletion) {
+  ZeroCopyBufferRing ring(1000, 3);
+  for (int i = 0; i < 3; i++) {
+    ring.onSent(ring.acquire(), 1);
+  }
+  ring.onCompletion(0, 2, false /* copied */);
+  EXPECT_EQ(0, ring.numBuffersInFlight());
+  EXPECT_EQ(3, ring.numFreeBuffers());
+}
+
+TEST(ZeroCopyBufferRing, SendCounterWraps) {
+  ZeroCopyBufferRing ring(1000, 1);
+  // Advance the counter to just below the wrap point.
+  constexpr auto kMax = std::numeric_limits<uint32_t>::max();
+  ring.onSent(ring.acquire(), kMax - 1);
+  ring.onCompletion(0, kMax - 2, false /* copied */);
+  EXPECT_EQ(0, ring.numBuffersInFlight());
+
+  // Sends kMax - 1, kMax, 0 and 1.
+  ring.onSent(ring.acquire(), 4);
+  ring.onCompletion(kMax - 1, 0, false /* copied */);
+  EXPECT_EQ(1, ring.numBuffersInFlight());
+  ring.onCompletion(1, 1, false /* copied */);
+  EXPECT_EQ(0, ring.numBuffersInFlight());
+}
+
+#ifdef FOLLY_HAVE_MSG_ERRQUEUE
+TEST(ZeroCopyBufferRing, ErrMessage) {
+  ZeroCopyBufferRing ring(1000, 1);
+  ring.onSent(ring.acquire(), 2);
+
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(sock_extended_err))] = {};
+  auto* cmsg = reinterpret_cast<cmsghdr*>(control);
+  cmsg->cmsg_level = SOL_IPV6;
+  cmsg->cmsg_type = IPV6_RECVERR;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(sock_extended_err));
+  auto* serr = reinterpret_cast<sock_extended_err*>(CMSG_DATA(cmsg));
+
+  // An ICMP error is not a completion.
+  serr->ee_origin = SO_EE_ORIGIN_ICMP6;
+  serr->ee_errno = EHOSTUNREACH;
+  EXPECT_FALSE(ring.onErrMessage(*cmsg));
+
+  serr->ee_origin = SO_EE_ORIGIN_ZEROCOPY;
+  serr->ee_errno = 0;
+  serr->ee_code = SO_EE_CODE_ZEROCOPY_COPIED;
+  serr->ee_info = 0;
+  serr->ee_data = 1;
+  EXPECT_TRUE(ring.onErrMessage(*cmsg));
+  EXPECT_EQ(0, ring.numBuffersInFlight());
+  EXPECT_EQ(2, ring.numCopiedSends());
+}
+#endif
+
+} // namespace quic
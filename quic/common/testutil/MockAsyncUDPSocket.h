@@ -67,6 +67,10 @@ struct MockAsyncUDPSocket : public FollyQuicAsyncUDPSocket {
        size_t& totalData));
   MOCK_METHOD(int, getGRO, ());
   MOCK_METHOD(bool, setGRO, (bool));
+  MOCK_METHOD(bool, setZeroCopy, (bool));
+  MOCK_METHOD(bool, getZeroCopy, (), (const));
+  MOCK_METHOD(bool, enableTxTime, ());
+  MOCK_METHOD(bool, getTxTime, (), (const));
   MOCK_METHOD(
       void,
       setAdditionalCmsgsFunc,
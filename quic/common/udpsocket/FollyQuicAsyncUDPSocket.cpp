@@ -136,6 +136,25 @@ bool FollyQuicAsyncUDPSocket::setGRO(bool bVal) {
   return follySocket_.setGRO(bVal);
 }
 
+bool FollyQuicAsyncUDPSocket::setZeroCopy(bool enable) {
+  return follySocket_.setZeroCopy(enable);
+}
+
+bool FollyQuicAsyncUDPSocket::getZeroCopy() const {
+  return follySocket_.getZeroCopy();
+}
+
+bool FollyQuicAsyncUDPSocket::enableTxTime() {
+  folly::AsyncUDPSocket::TXTime txTime;
+  // The fq qdisc schedules departures against the monotonic clock.
+  txTime.clockid = CLOCK_MONOTONIC;
+  return follySocket_.setTXTime(txTime);
+}
+
+bool FollyQuicAsyncUDPSocket::getTxTime() const {
+  return follySocket_.getTXTime().clockid >= 0;
+}
+
 void FollyQuicAsyncUDPSocket::setRecvTos(bool recvTos) {
   follySocket_.setRecvTos(recvTos);
 }
@@ -124,6 +124,12 @@ class FollyQuicAsyncUDPSocket : public QuicAsyncUDPSocketImpl {
   int getGRO() override;
   bool setGRO(bool bVal) override;
 
+  bool setZeroCopy(bool enable) override;
+  [[nodiscard]] bool getZeroCopy() const override;
+
+  bool enableTxTime() override;
+  [[nodiscard]] bool getTxTime() const override;
+
   // receive tos cmsgs
   // if true, the IPv6 Traffic Class/IPv4 Type of Service field should be
   // populated in OnDataAvailableParams.
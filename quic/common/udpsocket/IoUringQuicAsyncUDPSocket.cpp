@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/common/udpsocket/IoUringQuicAsyncUDPSocket.h>
+
+#if FOLLY_HAS_LIBURING
+
+#include <folly/String.h>
+#include <netinet/udp.h>
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+namespace quic {
+
+namespace {
+
+size_t iovecLength(const struct iovec* vec, size_t iovec_len) {
+  size_t len = 0;
+  for (size_t i = 0; i < iovec_len; i++) {
+    len += vec[i].iov_len;
+  }
+  return len;
+}
+
+} // namespace
+
+IoUringQuicAsyncUDPSocket::IoUringQuicAsyncUDPSocket(
+    std::shared_ptr<FollyQuicEventBase> qEvb,
+    std::unique_ptr<folly::AsyncUDPSocket> socketToWrap,
+    std::shared_ptr<IoUringSendRing> ring)
+    : FollyQuicAsyncUDPSocket(qEvb, std::move(socketToWrap)),
+      ring_(
+          ring ? std::move(ring)
+               : IoUringSendRing::getOrCreate(qEvb->getBackingEventBase())) {}
+
+IoUringQuicAsyncUDPSocket::IoUringQuicAsyncUDPSocket(
+    std::shared_ptr<FollyQuicEventBase> qEvb,
+    std::shared_ptr<IoUringSendRing> ring)
+    : FollyQuicAsyncUDPSocket(qEvb),
+      ring_(
+          ring ? std::move(ring)
+               : IoUringSendRing::getOrCreate(qEvb->getBackingEventBase())) {}
+
+IoUringQuicAsyncUDPSocket::~IoUringQuicAsyncUDPSocket() {
+  detachFromRing();
+}
+
+bool IoUringQuicAsyncUDPSocket::isSupported() {
+  return IoUringSendRing::isSupported();
+}
+
+void IoUringQuicAsyncUDPSocket::connect(const folly::SocketAddress& address) {
+  FollyQuicAsyncUDPSocket::connect(address);
+  connectedAddress_ = address;
+}
+
+void IoUringQuicAsyncUDPSocket::close() {
+  detachFromRing();
+  FollyQuicAsyncUDPSocket::close();
+}
+
+ssize_t IoUringQuicAsyncUDPSocket::write(
+    const folly::SocketAddress& address,
+    const struct iovec* vec,
+    size_t iovec_len) {
+  return send(address, vec, iovec_len, WriteOptions());
+}
+
+int IoUringQuicAsyncUDPSocket::writem(
+    folly::Range<folly::SocketAddress const*> addrs,
+    iovec* iov,
+    size_t* numIovecsInBuffer,
+    size_t count) {
+  return writemGSO(addrs, iov, numIovecsInBuffer, count, nullptr);
+}
+
+ssize_t IoUringQuicAsyncUDPSocket::writeGSO(
+    const folly::SocketAddress& address,
+    const struct iovec* vec,
+    size_t iovec_len,
+    WriteOptions options) {
+  return send(address, vec, iovec_len, options);
+}
+
+int IoUringQuicAsyncUDPSocket::writemGSO(
+    folly::Range<folly::SocketAddress const*> addrs,
+    const std::unique_ptr<folly::IOBuf>* bufs,
+    size_t count,
+    const WriteOptions* options) {
+  iovec vec[kNumIovecBufferChains];
+  for (size_t i = 0; i < count; i++) {
+    const auto& address = addrs.size() == 1 ? addrs[0] : addrs[i];
+    auto writeOptions = options ? options[i] : WriteOptions();
+    auto numIovecs = bufs[i]->fillIov(vec, kNumIovecBufferChains).numIovecs;
+    ssize_t ret;
+    if (numIovecs == 0 && !bufs[i]->empty()) {
+      // The chain is too long to describe with our iovecs.
+      ring_->submit();
+      ret = FollyQuicAsyncUDPSocket::writemGSO(
+          folly::Range<folly::SocketAddress const*>(&address, 1),
+          &bufs[i],
+          1,
+          &writeOptions);
+    } else {
+      ret = send(address, vec, numIovecs, writeOptions);
+    }
+    if (ret < 0) {
+      return i == 0 ? -1 : static_cast<int>(i);
+    }
+  }
+  return static_cast<int>(count);
+}
+
+int IoUringQuicAsyncUDPSocket::writemGSO(
+    folly::Range<folly::SocketAddress const*> addrs,
+    iovec* iov,
+    size_t* numIovecsInBuffer,
+    size_t count,
+    const WriteOptions* options) {
+  size_t iovOffset = 0;
+  for (size_t i = 0; i < count; i++) {
+    const auto& address = addrs.size() == 1 ? addrs[0] : addrs[i];
+    auto ret = send(
+        address,
+        iov + iovOffset,
+        numIovecsInBuffer[i],
+        options ? options[i] : WriteOptions());
+    if (ret < 0) {
+      return i == 0 ? -1 : static_cast<int>(i);
+    }
+    iovOffset += numIovecsInBuffer[i];
+  }
+  return static_cast<int>(count);
+}
+
+void IoUringQuicAsyncUDPSocket::attachEventBase(
+    std::shared_ptr<QuicEventBase> evb) {
+  FollyQuicAsyncUDPSocket::attachEventBase(evb);
+  auto* backingEvb =
+      std::dynamic_pointer_cast<FollyQuicEventBase>(evb)->getBackingEventBase();
+  if (ring_->getEventBase() != backingEvb) {
+    ring_ = IoUringSendRing::getOrCreate(backingEvb, ring_->getOptions());
+  }
+}
+
+void IoUringQuicAsyncUDPSocket::detachEventBase() {
+  detachFromRing();
+  FollyQuicAsyncUDPSocket::detachEventBase();
+}
+
+void IoUringQuicAsyncUDPSocket::setCmsgs(const folly::SocketCmsgMap& cmsgs) {
+  cmsgs_ = cmsgs;
+  FollyQuicAsyncUDPSocket::setCmsgs(cmsgs);
+}
+
+void IoUringQuicAsyncUDPSocket::appendCmsgs(
+    const folly::SocketCmsgMap& cmsgs) {
+  for (const auto& [key, value] : cmsgs) {
+    cmsgs_[key] = value;
+  }
+  FollyQuicAsyncUDPSocket::appendCmsgs(cmsgs);
+}
+
+void IoUringQuicAsyncUDPSocket::setAdditionalCmsgsFunc(
+    folly::Function<Optional<folly::SocketCmsgMap>()>&& additionalCmsgsFunc) {
+  if (!additionalCmsgsFunc) {
+    additionalCmsgsFunc_.reset();
+    FollyQuicAsyncUDPSocket::setAdditionalCmsgsFunc(nullptr);
+    return;
+  }
+  additionalCmsgsFunc_ =
+      std::make_shared<folly::Function<Optional<folly::SocketCmsgMap>()>>(
+          std::move(additionalCmsgsFunc));
+  FollyQuicAsyncUDPSocket::setAdditionalCmsgsFunc(
+      [func = additionalCmsgsFunc_]() { return (*func)(); });
+}
+
+void IoUringQuicAsyncUDPSocket::flush() {
+  ring_->submit();
+}
+
+void IoUringQuicAsyncUDPSocket::detachFromRing() {
+  ring_->detach(this);
+  numSendsInFlight_ = 0;
+}
+
+void IoUringQuicAsyncUDPSocket::onSendComplete(int result) noexcept {
+  DCHECK_GT(numSendsInFlight_, 0);
+  numSendsInFlight_--;
+  if (result < 0) {
+    VLOG(4) << "io_uring send failed: " << folly::errnoStr(-result);
+    numAsyncSendErrors_++;
+    pendingSendErrno_ = -result;
+  }
+}
+
+ssize_t IoUringQuicAsyncUDPSocket::send(
+    const folly::SocketAddress& address,
+    const struct iovec* vec,
+    size_t iovec_len,
+    const WriteOptions& options) {
+  auto len = iovecLength(vec, iovec_len);
+  Optional<folly::SocketCmsgMap> additionalCmsgs;
+  if (additionalCmsgsFunc_) {
+    additionalCmsgs = (*additionalCmsgsFunc_)();
+  }
+  auto numCmsgs =
+      cmsgs_.size() + (additionalCmsgs ? additionalCmsgs->size() : 0);
+  ring_->reapCompletions();
+  if (pendingSendErrno_ != 0) {
+    errno = std::exchange(pendingSendErrno_, 0);
+    return -1;
+  }
+  if (options.zerocopy || options.txTime.count() > 0 ||
+      len > ring_->getOptions().slotSize ||
+      numCmsgs > IoUringSendRing::kMaxCmsgs) {
+    // Keep the datagrams in order with respect to what is already queued.
+    ring_->submit();
+    return FollyQuicAsyncUDPSocket::writeGSO(address, vec, iovec_len, options);
+  }
+
+  auto* slotPtr = ring_->allocateSlot();
+  if (!slotPtr) {
+    return -1;
+  }
+  auto& slot = *slotPtr;
+  size_t offset = 0;
+  for (size_t i = 0; i < iovec_len; i++) {
+    memcpy(slot.data + offset, vec[i].iov_base, vec[i].iov_len);
+    offset += vec[i].iov_len;
+  }
+  slot.iov.iov_base = slot.data;
+  slot.iov.iov_len = len;
+  memset(&slot.msg, 0, sizeof(slot.msg));
+  if (!connectedAddress_) {
+    slot.msg.msg_namelen = address.getAddress(&slot.addr);
+    slot.msg.msg_name = &slot.addr;
+  }
+  slot.msg.msg_iov = &slot.iov;
+  slot.msg.msg_iovlen = 1;
+  fillControl(slot, options.gso, additionalCmsgs);
+
+  if (!ring_->queue(slot, getFD(), this)) {
+    return -1;
+  }
+  numSendsInFlight_++;
+  return static_cast<ssize_t>(len);
+}
+
+void IoUringQuicAsyncUDPSocket::fillControl(
+    SendSlot& slot,
+    int gso,
+    const Optional<folly::SocketCmsgMap>& additionalCmsgs) {
+  size_t numCmsgs = 0;
+  for (const auto& cmsg : cmsgs_) {
+    if (!additionalCmsgs || !additionalCmsgs->count(cmsg.first)) {
+      numCmsgs++;
+    }
+  }
+  numCmsgs += additionalCmsgs ? additionalCmsgs->size() : 0;
+  size_t controlLen = numCmsgs * CMSG_SPACE(sizeof(int));
+  if (gso > 0) {
+    controlLen += CMSG_SPACE(sizeof(uint16_t));
+  }
+  if (controlLen == 0) {
+    return;
+  }
+  DCHECK_LE(controlLen, sizeof(slot.control));
+  memset(slot.control, 0, controlLen);
+  slot.msg.msg_control = slot.control;
+  slot.msg.msg_controllen = controlLen;
+
+  struct cmsghdr* cm = nullptr;
+  auto appendCmsg = [&](int level, int type, const void* data, size_t len) {
+    cm = cm ? CMSG_NXTHDR(&slot.msg, cm) : CMSG_FIRSTHDR(&slot.msg);
+    CHECK(cm);
+    cm->cmsg_level = level;
+    cm->cmsg_type = type;
+    cm->cmsg_len = CMSG_LEN(len);
+    memcpy(CMSG_DATA(cm), data, len);
+  };
+  if (gso > 0) {
+    auto segmentSize = static_cast<uint16_t>(gso);
+    appendCmsg(SOL_UDP, UDP_SEGMENT, &segmentSize, sizeof(segmentSize));
+  }
+  for (const auto& [key, value] : cmsgs_) {
+    if (!additionalCmsgs || !additionalCmsgs->count(key)) {
+      appendCmsg(key.level, key.optname, &value, sizeof(value));
+    }
+  }
+  if (additionalCmsgs) {
+    for (const auto& [key, value] : *additionalCmsgs) {
+      appendCmsg(key.level, key.optname, &value, sizeof(value));
+    }
+  }
+}
+
+} // namespace quic
+
+#endif // FOLLY_HAS_LIBURING
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/io/async/Liburing.h>
+#include <quic/common/udpsocket/FollyQuicAsyncUDPSocket.h>
+#include <quic/common/udpsocket/IoUringSendRing.h>
+
+#if FOLLY_HAS_LIBURING
+
+namespace quic {
+
+/**
+ * A FollyQuicAsyncUDPSocket that sends through the IoUringSendRing of its
+ * event base instead of calling sendmsg/sendmmsg. Reads, socket options and
+ * the error queue are still handled by FollyQuicAsyncUDPSocket.
+ *
+ * A write copies each datagram (or GSO batch) out of the caller's buffer,
+ * which is normally the connection's BufAccessor, into a slot of the ring and
+ * queues it there. The sockets of an event base share the ring and its slots,
+ * so its sends go out together with those of the other connections of the
+ * event base. When no slot is free, writes fail with ENOBUFS, which the write
+ * path already treats as a retriable error.
+ *
+ * A send that fails asynchronously is reported by the next write on the
+ * socket, which fails with the errno of that send, the way a pending socket
+ * error is reported by the kernel. The transport then counts it and handles
+ * it like any other write error.
+ *
+ * Writes requesting zerocopy or a TX time, datagrams larger than a slot, and
+ * writes carrying more cmsgs than a slot has room for go through the
+ * synchronous FollyQuicAsyncUDPSocket path instead, after anything already
+ * queued has been submitted.
+ */
+class IoUringQuicAsyncUDPSocket : public FollyQuicAsyncUDPSocket,
+                                  private IoUringSendRing::Sender {
+ public:
+  // Sends through ring, or through the ring of the event base if null.
+  IoUringQuicAsyncUDPSocket(
+      std::shared_ptr<FollyQuicEventBase> qEvb,
+      std::unique_ptr<folly::AsyncUDPSocket> socketToWrap,
+      std::shared_ptr<IoUringSendRing> ring = nullptr);
+
+  explicit IoUringQuicAsyncUDPSocket(
+      std::shared_ptr<FollyQuicEventBase> qEvb,
+      std::shared_ptr<IoUringSendRing> ring = nullptr);
+
+  ~IoUringQuicAsyncUDPSocket() override;
+
+  /**
+   * Returns whether an io_uring can be created on this host.
+   */
+  static bool isSupported();
+
+  void connect(const folly::SocketAddress& address) override;
+
+  void close() override;
+
+  ssize_t write(
+      const folly::SocketAddress& address,
+      const struct iovec* vec,
+      size_t iovec_len) override;
+
+  int writem(
+      folly::Range<folly::SocketAddress const*> addrs,
+      iovec* iov,
+      size_t* numIovecsInBuffer,
+      size_t count) override;
+
+  ssize_t writeGSO(
+      const folly::SocketAddress& address,
+      const struct iovec* vec,
+      size_t iovec_len,
+      WriteOptions options) override;
+
+  int writemGSO(
+      folly::Range<folly::SocketAddress const*> addrs,
+      const std::unique_ptr<folly::IOBuf>* bufs,
+      size_t count,
+      const WriteOptions* options) override;
+
+  int writemGSO(
+      folly::Range<folly::SocketAddress const*> addrs,
+      iovec* iov,
+      size_t* numIovecsInBuffer,
+      size_t count,
+      const WriteOptions* options) override;
+
+  void attachEventBase(std::shared_ptr<QuicEventBase> evb) override;
+  void detachEventBase() override;
+
+  void setCmsgs(const folly::SocketCmsgMap& cmsgs) override;
+  void appendCmsgs(const folly::SocketCmsgMap& cmsgs) override;
+  void setAdditionalCmsgsFunc(
+      folly::Function<Optional<folly::SocketCmsgMap>()>&& additionalCmsgsFunc)
+      override;
+
+  /**
+   * Submits queued sends without waiting for the end of the loop iteration.
+   */
+  void flush();
+
+  [[nodiscard]] size_t numSendsInFlight() const {
+    return numSendsInFlight_;
+  }
+
+  [[nodiscard]] uint64_t numAsyncSendErrors() const {
+    return numAsyncSendErrors_;
+  }
+
+  [[nodiscard]] const std::shared_ptr<IoUringSendRing>& getSendRing() const {
+    return ring_;
+  }
+
+ private:
+  using SendSlot = IoUringSendRing::SendSlot;
+
+  void onSendComplete(int result) noexcept override;
+
+  // Copies the datagram into a free slot and queues a send for it, or writes
+  // it synchronously if it cannot go through the ring. Returns the number of
+  // bytes written or queued, or -1 with errno set.
+  ssize_t send(
+      const folly::SocketAddress& address,
+      const struct iovec* vec,
+      size_t iovec_len,
+      const WriteOptions& options);
+
+  void fillControl(
+      SendSlot& slot,
+      int gso,
+      const Optional<folly::SocketCmsgMap>& additionalCmsgs);
+  void detachFromRing();
+
+  std::shared_ptr<IoUringSendRing> ring_;
+  size_t numSendsInFlight_{0};
+  uint64_t numAsyncSendErrors_{0};
+  // The errno of a send that failed asynchronously, until a write reports it.
+  int pendingSendErrno_{0};
+
+  Optional<folly::SocketAddress> connectedAddress_;
+  folly::SocketCmsgMap cmsgs_;
+  // Shared with the wrapped socket so that both write paths see the same
+  // additional cmsgs.
+  std::shared_ptr<folly::Function<Optional<folly::SocketCmsgMap>()>>
+      additionalCmsgsFunc_;
+};
+
+} // namespace quic
+
+#endif // FOLLY_HAS_LIBURING
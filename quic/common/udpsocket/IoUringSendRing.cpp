@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/common/udpsocket/IoUringSendRing.h>
+
+#if FOLLY_HAS_LIBURING
+
+#include <folly/String.h>
+#include <folly/io/async/AsyncSocketException.h>
+#include <folly/io/async/EventBaseLocal.h>
+#include <glog/logging.h>
+
+namespace quic {
+
+namespace {
+
+folly::EventBaseLocal<std::shared_ptr<IoUringSendRing>>& evbRings() {
+  static folly::EventBaseLocal<std::shared_ptr<IoUringSendRing>> rings;
+  return rings;
+}
+
+} // namespace
+
+IoUringSendRing::IoUringSendRing(folly::EventBase* evb, Options options)
+    : evb_(evb), options_(options) {
+  CHECK(evb_);
+  CHECK_GT(options_.numSlots, 0);
+  CHECK_GT(options_.slotSize, 0);
+  int ret = io_uring_queue_init(options_.ringEntries, &ring_, 0);
+  if (ret < 0) {
+    throw folly::AsyncSocketException(
+        folly::AsyncSocketException::INTERNAL_ERROR,
+        "Failed to create io_uring",
+        -ret);
+  }
+  slotData_.reset(
+      new uint8_t[static_cast<size_t>(options_.numSlots) * options_.slotSize]);
+  slots_.resize(options_.numSlots);
+  freeSlots_.reserve(options_.numSlots);
+  for (uint32_t i = options_.numSlots; i > 0; i--) {
+    slots_[i - 1].data =
+        slotData_.get() + static_cast<size_t>(i - 1) * options_.slotSize;
+    freeSlots_.push_back(i - 1);
+  }
+}
+
+IoUringSendRing::~IoUringSendRing() {
+  cancelLoopCallback();
+  drain();
+  io_uring_queue_exit(&ring_);
+}
+
+bool IoUringSendRing::isSupported() {
+  struct io_uring ring;
+  if (io_uring_queue_init(1, &ring, 0) < 0) {
+    return false;
+  }
+  io_uring_queue_exit(&ring);
+  return true;
+}
+
+std::shared_ptr<IoUringSendRing> IoUringSendRing::getOrCreate(
+    folly::EventBase* evb,
+    const Options& options) {
+  auto* ring = evbRings().get(*evb);
+  if (ring && *ring) {
+    return *ring;
+  }
+  return evbRings().emplace(
+      *evb, std::make_shared<IoUringSendRing>(evb, options));
+}
+
+std::shared_ptr<IoUringSendRing> IoUringSendRing::get(folly::EventBase* evb) {
+  auto* ring = evbRings().get(*evb);
+  return ring ? *ring : nullptr;
+}
+
+IoUringSendRing::SendSlot* IoUringSendRing::allocateSlot() {
+  reapCompletions();
+  if (freeSlots_.empty()) {
+    // UDP sends normally complete while being submitted, so pushing out what
+    // is queued is usually enough to free up a slot.
+    submit();
+    reapCompletions();
+    if (freeSlots_.empty()) {
+      errno = ENOBUFS;
+      return nullptr;
+    }
+  }
+  auto index = freeSlots_.back();
+  freeSlots_.pop_back();
+  return &slots_[index];
+}
+
+bool IoUringSendRing::queue(SendSlot& slot, int fd, Sender* sender) {
+  auto* sqe = io_uring_get_sqe(&ring_);
+  if (!sqe) {
+    submit();
+    sqe = io_uring_get_sqe(&ring_);
+    if (!sqe) {
+      freeSlots_.push_back(static_cast<uint32_t>(&slot - slots_.data()));
+      errno = EAGAIN;
+      return false;
+    }
+  }
+  slot.sender = sender;
+  io_uring_prep_sendmsg(sqe, fd, &slot.msg, 0);
+  io_uring_sqe_set_data(sqe, &slot);
+  numQueued_++;
+  if (!isLoopCallbackScheduled()) {
+    evb_->runInLoop(this);
+  }
+  return true;
+}
+
+void IoUringSendRing::submit() {
+  if (numQueued_ == 0) {
+    return;
+  }
+  int ret = io_uring_submit(&ring_);
+  if (ret < 0) {
+    // The entries stay in the submission queue and are retried on the next
+    // submit.
+    LOG(ERROR) << "io_uring_submit failed: " << folly::errnoStr(-ret);
+    return;
+  }
+  numQueued_ -= std::min(numQueued_, static_cast<uint32_t>(ret));
+}
+
+void IoUringSendRing::reapCompletions() {
+  struct io_uring_cqe* cqe;
+  unsigned head;
+  unsigned numReaped = 0;
+  io_uring_for_each_cqe(&ring_, head, cqe) {
+    auto* slot = static_cast<SendSlot*>(io_uring_cqe_get_data(cqe));
+    auto* sender = slot->sender;
+    slot->sender = nullptr;
+    freeSlots_.push_back(static_cast<uint32_t>(slot - slots_.data()));
+    numReaped++;
+    if (sender) {
+      sender->onSendComplete(cqe->res);
+    }
+  }
+  io_uring_cq_advance(&ring_, numReaped);
+}
+
+void IoUringSendRing::detach(Sender* sender) {
+  submit();
+  if (numQueued_ > 0) {
+    // Some of them may still refer to the sender's fd.
+    drain();
+  }
+  for (auto& slot : slots_) {
+    if (slot.sender == sender) {
+      slot.sender = nullptr;
+    }
+  }
+}
+
+void IoUringSendRing::runLoopCallback() noexcept {
+  submit();
+  reapCompletions();
+}
+
+void IoUringSendRing::drain() {
+  while (numSendsInFlight() > 0) {
+    auto numQueued = numQueued_;
+    submit();
+    if (numQueued_ > 0 && numQueued_ == numQueued) {
+      LOG(ERROR) << "Dropping " << numQueued_ << " unsubmitted io_uring sends";
+      return;
+    }
+    struct io_uring_cqe* cqe;
+    int ret = io_uring_wait_cqe(&ring_, &cqe);
+    if (ret == -EINTR) {
+      continue;
+    }
+    if (ret < 0) {
+      LOG(ERROR) << "io_uring_wait_cqe failed: " << folly::errnoStr(-ret);
+      return;
+    }
+    reapCompletions();
+  }
+}
+
+} // namespace quic
+
+#endif // FOLLY_HAS_LIBURING
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/io/async/EventBase.h>
+#include <folly/io/async/Liburing.h>
+
+#if FOLLY_HAS_LIBURING
+
+#include <liburing.h>
+#include <sys/socket.h>
+
+#include <memory>
+#include <vector>
+
+namespace quic {
+
+/**
+ * An io_uring and a pool of send buffers shared by the sockets of one event
+ * base. The sockets copy their datagrams into slots from the pool and queue
+ * an IORING_OP_SENDMSG for each of them. Everything queued during one event
+ * loop iteration, by any socket, is submitted with a single io_uring_enter at
+ * the end of that iteration, or earlier if the submission queue fills up.
+ * Slots are recycled as completions are reaped, and each completion is
+ * reported to the socket that queued it.
+ *
+ * Event base thread only.
+ */
+class IoUringSendRing : private folly::EventBase::LoopCallback {
+ public:
+  struct Options {
+    // Size of the submission queue.
+    uint32_t ringEntries{256};
+    // Maximum number of sends in flight.
+    uint32_t numSlots{256};
+    // Largest datagram or GSO batch that can be sent through the ring.
+    uint32_t slotSize{64 * 1024};
+  };
+
+  // Room for UDP_SEGMENT plus this many int valued cmsgs.
+  static constexpr size_t kMaxCmsgs = 8;
+  static constexpr size_t kControlSize =
+      CMSG_SPACE(sizeof(uint16_t)) + kMaxCmsgs * CMSG_SPACE(sizeof(int));
+
+  class Sender {
+   public:
+    virtual ~Sender() = default;
+
+    // result is what sendmsg would have returned, or -errno.
+    virtual void onSendComplete(int result) noexcept = 0;
+  };
+
+  struct SendSlot {
+    struct msghdr msg;
+    struct iovec iov;
+    struct sockaddr_storage addr;
+    alignas(struct cmsghdr) char control[kControlSize];
+    uint8_t* data{nullptr};
+    Sender* sender{nullptr};
+  };
+
+  // Throws folly::AsyncSocketException if the ring can't be created.
+  IoUringSendRing(folly::EventBase* evb, Options options = Options());
+
+  ~IoUringSendRing() override;
+
+  IoUringSendRing(const IoUringSendRing&) = delete;
+  IoUringSendRing& operator=(const IoUringSendRing&) = delete;
+
+  /**
+   * Returns whether an io_uring can be created on this host.
+   */
+  static bool isSupported();
+
+  /**
+   * The ring shared by the sockets of evb, created with options if evb does
+   * not have one yet. Throws if the ring can't be created.
+   */
+  static std::shared_ptr<IoUringSendRing> getOrCreate(
+      folly::EventBase* evb,
+      const Options& options = Options());
+
+  /**
+   * The ring shared by the sockets of evb, or nullptr if it has none.
+   */
+  static std::shared_ptr<IoUringSendRing> get(folly::EventBase* evb);
+
+  /**
+   * Returns a free slot, or nullptr with errno set to ENOBUFS if every slot is
+   * in flight. The slot must be handed back to queue().
+   */
+  SendSlot* allocateSlot();
+
+  /**
+   * Queues a sendmsg of slot.msg on fd, whose completion is reported to
+   * sender. Returns false with errno set to EAGAIN, and frees the slot, if the
+   * submission queue is full and can't be submitted.
+   */
+  bool queue(SendSlot& slot, int fd, Sender* sender);
+
+  /**
+   * Submits everything queued so far.
+   */
+  void submit();
+
+  void reapCompletions();
+
+  /**
+   * Submits the sends queued by sender, and stops reporting their completions
+   * to it. Once this returns, sender may close its fd.
+   */
+  void detach(Sender* sender);
+
+  [[nodiscard]] size_t numSendsInFlight() const {
+    return options_.numSlots - freeSlots_.size();
+  }
+
+  [[nodiscard]] const Options& getOptions() const {
+    return options_;
+  }
+
+  [[nodiscard]] folly::EventBase* getEventBase() const {
+    return evb_;
+  }
+
+ private:
+  void runLoopCallback() noexcept override;
+
+  // Blocks until every in flight send has completed.
+  void drain();
+
+  folly::EventBase* evb_;
+  Options options_;
+  struct io_uring ring_;
+  std::unique_ptr<uint8_t[]> slotData_;
+  std::vector<SendSlot> slots_;
+  std::vector<uint32_t> freeSlots_;
+  uint32_t numQueued_{0};
+};
+
+} // namespace quic
+
+#endif // FOLLY_HAS_LIBURING
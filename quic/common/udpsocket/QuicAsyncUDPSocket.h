@@ -30,8 +30,10 @@ namespace quic {
  * Functions that contain behavior that will be common to all implementations is
  * implemented in QuicAsyncUDPSocketImpl.
  *
- * Two implementations of QuicAsyncUDPSocket are provided:
+ * Three implementations of QuicAsyncUDPSocket are provided:
  *  - FollyQuicAsyncUDPSocket which wraps a folly::AsyncUDPSocket
+ *  - IoUringQuicAsyncUDPSocket which extends FollyQuicAsyncUDPSocket to send
+ *    through io_uring
  *  - LibevQuicAsyncUDPSocket which wraps a plain libc socket.
  */
 class QuicAsyncUDPSocket {
@@ -274,6 +276,26 @@ class QuicAsyncUDPSocket {
   virtual int getGRO() = 0;
   virtual bool setGRO(bool /* bVal */) = 0;
 
+  // SO_ZEROCOPY get/set. Writes only use MSG_ZEROCOPY when the WriteOptions
+  // ask for it and zerocopy has been enabled on the socket. Completions are
+  // delivered to the ErrMessageCallback.
+  virtual bool setZeroCopy(bool /* enable */) {
+    return false;
+  }
+  [[nodiscard]] virtual bool getZeroCopy() const {
+    return false;
+  }
+
+  // SO_TXTIME. Once enabled, a write whose WriteOptions carry a txTime is held
+  // back by the qdisc (e.g. fq) until that long after the write. Returns
+  // whether the socket accepted it.
+  virtual bool enableTxTime() {
+    return false;
+  }
+  [[nodiscard]] virtual bool getTxTime() const {
+    return false;
+  }
+
   // receive tos cmsgs
   // if true, the IPv6 Traffic Class/IPv4 Type of Service field should be
   // populated in OnDataAvailableParams.
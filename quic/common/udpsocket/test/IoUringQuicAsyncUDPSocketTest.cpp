@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/Conv.h>
+#include <folly/portability/GTest.h>
+#include <quic/common/udpsocket/IoUringQuicAsyncUDPSocket.h>
+#include <quic/common/udpsocket/test/QuicAsyncUDPSocketTestBase.h>
+
+#if FOLLY_HAS_LIBURING
+
+using namespace ::testing;
+
+class IoUringQuicAsyncUDPSocketProvider {
+ public:
+  static std::shared_ptr<quic::QuicAsyncUDPSocket> makeQuicAsyncUDPSocket() {
+    static folly::EventBase fEvb;
+    auto evb = std::make_shared<quic::FollyQuicEventBase>(&fEvb);
+    return std::make_shared<quic::IoUringQuicAsyncUDPSocket>(evb);
+  }
+};
+
+using IoUringQuicAsyncUDPSocketType = Types<IoUringQuicAsyncUDPSocketProvider>;
+
+INSTANTIATE_TYPED_TEST_SUITE_P(
+    IoUringQuicAsyncUDPSocketTest, // Instance name
+    QuicAsyncUDPSocketTest, // Test case name
+    IoUringQuicAsyncUDPSocketType); // Type list
+
+namespace quic::test {
+
+class IoUringQuicAsyncUDPSocketSendTest : public Test {
+ public:
+  void SetUp() override {
+    if (!IoUringQuicAsyncUDPSocket::isSupported()) {
+      GTEST_SKIP() << "io_uring is not available";
+    }
+    qEvb_ = std::make_shared<FollyQuicEventBase>(&evb_);
+    socket_ = std::make_unique<IoUringQuicAsyncUDPSocket>(qEvb_);
+    socket_->bind(folly::SocketAddress("127.0.0.1", 0));
+
+    receiverFd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(receiverFd_, 0);
+    struct timeval timeout = {1, 0};
+    ::setsockopt(
+        receiverFd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    folly::SocketAddress bindAddr("127.0.0.1", 0);
+    sockaddr_storage addrStorage;
+    auto addrLen = bindAddr.getAddress(&addrStorage);
+    ASSERT_EQ(
+        ::bind(
+            receiverFd_, reinterpret_cast<sockaddr*>(&addrStorage), addrLen),
+        0);
+    receiverAddr_.setFromLocalAddress(
+        folly::NetworkSocket::fromFd(receiverFd_));
+  }
+
+  void TearDown() override {
+    socket_.reset();
+    if (receiverFd_ >= 0) {
+      ::close(receiverFd_);
+    }
+  }
+
+  ssize_t write(const std::string& data) {
+    iovec vec{const_cast<char*>(data.data()), data.size()};
+    return socket_->write(receiverAddr_, &vec, 1);
+  }
+
+  std::string receive() {
+    char buf[2048];
+    auto ret = ::recv(receiverFd_, buf, sizeof(buf), 0);
+    return ret > 0 ? std::string(buf, ret) : std::string();
+  }
+
+ protected:
+  folly::EventBase evb_;
+  std::shared_ptr<FollyQuicEventBase> qEvb_;
+  std::unique_ptr<IoUringQuicAsyncUDPSocket> socket_;
+  int receiverFd_{-1};
+  folly::SocketAddress receiverAddr_;
+};
+
+TEST_F(IoUringQuicAsyncUDPSocketSendTest, SendsSubmittedAtEndOfLoop) {
+  EXPECT_EQ(write("one"), 3);
+  EXPECT_EQ(write("two"), 3);
+  EXPECT_EQ(write("three"), 5);
+  // Nothing has been submitted yet.
+  EXPECT_EQ(socket_->numSendsInFlight(), 3);
+  char buf[16];
+  EXPECT_LT(::recv(receiverFd_, buf, sizeof(buf), MSG_DONTWAIT), 0);
+
+  evb_.loopOnce(EVLOOP_NONBLOCK);
+  EXPECT_EQ(receive(), "one");
+  EXPECT_EQ(receive(), "two");
+  EXPECT_EQ(receive(), "three");
+}
+
+TEST_F(IoUringQuicAsyncUDPSocketSendTest, WritemSendsEveryMessage) {
+  std::string first = "first";
+  std::string second = "second";
+  iovec iov[2] = {
+      {first.data(), first.size()}, {second.data(), second.size()}};
+  size_t numIovecsInBuffer[2] = {1, 1};
+  EXPECT_EQ(
+      socket_->writem(
+          folly::Range<folly::SocketAddress const*>(&receiverAddr_, 1),
+          iov,
+          numIovecsInBuffer,
+          2),
+      2);
+  socket_->flush();
+  EXPECT_EQ(receive(), first);
+  EXPECT_EQ(receive(), second);
+}
+
+TEST_F(IoUringQuicAsyncUDPSocketSendTest, GSOSplitsIntoSegments) {
+  if (socket_->getGSO() < 0) {
+    GTEST_SKIP() << "GSO is not available";
+  }
+  std::string data(300, 'a');
+  data.replace(100, 100, 100, 'b');
+  data.replace(200, 100, 100, 'c');
+  iovec vec{data.data(), data.size()};
+  EXPECT_EQ(
+      socket_->writeGSO(
+          receiverAddr_,
+          &vec,
+          1,
+          QuicAsyncUDPSocket::WriteOptions(100, false /* zerocopy */)),
+      300);
+  socket_->flush();
+  EXPECT_EQ(receive(), std::string(100, 'a'));
+  EXPECT_EQ(receive(), std::string(100, 'b'));
+  EXPECT_EQ(receive(), std::string(100, 'c'));
+}
+
+TEST_F(IoUringQuicAsyncUDPSocketSendTest, CloseFlushesQueuedSends) {
+  EXPECT_EQ(write("bye"), 3);
+  socket_->close();
+  EXPECT_EQ(socket_->numSendsInFlight(), 0);
+  EXPECT_EQ(receive(), "bye");
+}
+
+TEST_F(IoUringQuicAsyncUDPSocketSendTest, SlotsAreRecycled) {
+  auto ring = std::make_shared<IoUringSendRing>(
+      &evb_, IoUringSendRing::Options{.numSlots = 2});
+  socket_ = std::make_unique<IoUringQuicAsyncUDPSocket>(qEvb_, ring);
+  socket_->bind(folly::SocketAddress("127.0.0.1", 0));
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(write(folly::to<std::string>(i)), 1);
+  }
+  socket_->flush();
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(receive(), folly::to<std::string>(i));
+  }
+}
+
+TEST_F(IoUringQuicAsyncUDPSocketSendTest, SocketsShareTheRingOfTheirEvb) {
+  IoUringQuicAsyncUDPSocket other(qEvb_);
+  other.bind(folly::SocketAddress("127.0.0.1", 0));
+  EXPECT_EQ(other.getSendRing(), socket_->getSendRing());
+  EXPECT_EQ(IoUringSendRing::get(&evb_), socket_->getSendRing());
+
+  EXPECT_EQ(write("one"), 3);
+  std::string data = "two";
+  iovec vec{data.data(), data.size()};
+  EXPECT_EQ(other.write(receiverAddr_, &vec, 1), 3);
+  EXPECT_EQ(socket_->numSendsInFlight(), 1);
+  EXPECT_EQ(other.numSendsInFlight(), 1);
+  EXPECT_EQ(socket_->getSendRing()->numSendsInFlight(), 2);
+
+  // Both go out with the same submit.
+  evb_.loopOnce(EVLOOP_NONBLOCK);
+  EXPECT_EQ(receive(), "one");
+  EXPECT_EQ(receive(), "two");
+}
+
+TEST_F(IoUringQuicAsyncUDPSocketSendTest, AsyncSendErrorFailsNextWrite) {
+  std::string data = "lost";
+  iovec vec{data.data(), data.size()};
+  // The socket is IPv4, so the send only fails once the ring runs it.
+  EXPECT_EQ(socket_->write(folly::SocketAddress("::1", 1234), &vec, 1), 4);
+  socket_->flush();
+  EXPECT_EQ(write("next"), -1);
+  EXPECT_EQ(errno, EAFNOSUPPORT);
+  EXPECT_EQ(socket_->numAsyncSendErrors(), 1);
+
+  // The error is reported once.
+  EXPECT_EQ(write("after"), 5);
+  socket_->flush();
+  EXPECT_EQ(receive(), "after");
+}
+
+} // namespace quic::test
+
+#endif // FOLLY_HAS_LIBURING
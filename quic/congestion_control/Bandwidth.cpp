@@ -30,45 +30,6 @@ std::string Bandwidth::normalizedDescribe() const noexcept {
   return folly::to<std::string>(normalize(), " ", unitName(), "/s");
 }
 
-bool operator<(const Bandwidth& lhs, const Bandwidth& rhs) {
-  return !(lhs >= rhs);
-}
-
-bool operator<=(const Bandwidth& lhs, const Bandwidth& rhs) {
-  return (lhs < rhs) || (lhs == rhs);
-}
-
-bool operator>(const Bandwidth& lhs, const Bandwidth& rhs) {
-  if (!lhs && !rhs) {
-    return false;
-  }
-  if (!lhs && rhs) {
-    return false;
-  }
-  if (lhs && !rhs) {
-    return true;
-  }
-  return (lhs.units * rhs.interval) > (rhs.units * lhs.interval);
-}
-
-bool operator>=(const Bandwidth& lhs, const Bandwidth& rhs) {
-  return (lhs > rhs) || (lhs == rhs);
-}
-
-bool operator==(const Bandwidth& lhs, const Bandwidth& rhs) {
-  if (!lhs && !rhs) {
-    return true;
-  }
-  if (!lhs || !rhs) {
-    return false;
-  }
-  return (lhs.units * rhs.interval) == (rhs.units * lhs.interval);
-}
-
-bool operator!=(const Bandwidth& lhs, const Bandwidth& rhs) {
-  return !(lhs == rhs);
-}
-
 std::ostream& operator<<(std::ostream& os, const Bandwidth& bandwidth) {
   os << bandwidth.describe();
   return os;
@@ -97,12 +97,46 @@ struct Bandwidth {
   std::string unitName() const noexcept;
 };
 
-bool operator<(const Bandwidth& lhs, const Bandwidth& rhs);
-bool operator<=(const Bandwidth& lhs, const Bandwidth& rhs);
-bool operator>(const Bandwidth& lhs, const Bandwidth& rhs);
-bool operator>=(const Bandwidth& lhs, const Bandwidth& rhs);
-bool operator==(const Bandwidth& lhs, const Bandwidth& rhs);
-bool operator!=(const Bandwidth& lhs, const Bandwidth& rhs);
+// The comparisons run for every acked packet, so they are inline. A zero
+// bandwidth is smaller than any other and equal to any other zero bandwidth.
+inline bool operator>(const Bandwidth& lhs, const Bandwidth& rhs) {
+  if (!lhs) {
+    return false;
+  }
+  if (!rhs) {
+    return true;
+  }
+  return (lhs.units * rhs.interval) > (rhs.units * lhs.interval);
+}
+
+inline bool operator==(const Bandwidth& lhs, const Bandwidth& rhs) {
+  if (!lhs || !rhs) {
+    return !lhs && !rhs;
+  }
+  return (lhs.units * rhs.interval) == (rhs.units * lhs.interval);
+}
+
+inline bool operator>=(const Bandwidth& lhs, const Bandwidth& rhs) {
+  if (!rhs) {
+    return true;
+  }
+  if (!lhs) {
+    return false;
+  }
+  return (lhs.units * rhs.interval) >= (rhs.units * lhs.interval);
+}
+
+inline bool operator<(const Bandwidth& lhs, const Bandwidth& rhs) {
+  return !(lhs >= rhs);
+}
+
+inline bool operator<=(const Bandwidth& lhs, const Bandwidth& rhs) {
+  return !(lhs > rhs);
+}
+
+inline bool operator!=(const Bandwidth& lhs, const Bandwidth& rhs) {
+  return !(lhs == rhs);
+}
 
 template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
 Bandwidth operator*(T t, const Bandwidth& bandwidth) noexcept;
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/congestion_control/BandwidthCache.h>
+
+#include <glog/logging.h>
+
+namespace {
+
+constexpr uint8_t kIPv4PrefixLen = 24;
+constexpr uint8_t kIPv6PrefixLen = 48;
+
+} // namespace
+
+namespace quic {
+
+BandwidthCache::BandwidthCache(Config config) : config_(std::move(config)) {
+  CHECK_GT(config_.numShards, 0);
+  shards_.reserve(config_.numShards);
+  for (size_t i = 0; i < config_.numShards; i++) {
+    shards_.push_back(std::make_unique<Shard>(config_.maxEntriesPerShard));
+  }
+}
+
+void BandwidthCache::update(
+    const folly::IPAddress& peer,
+    uint64_t bandwidthBytesPerSec,
+    std::chrono::microseconds minRtt,
+    TimePoint now) {
+  auto prefix = prefixOf(peer);
+  auto& shard = getShard(prefix);
+  std::lock_guard<std::mutex> guard(shard.mutex);
+  shard.entries.set(prefix, Entry{bandwidthBytesPerSec, minRtt, now});
+}
+
+Optional<BandwidthCache::Entry> BandwidthCache::get(
+    const folly::IPAddress& peer,
+    TimePoint now) const {
+  auto prefix = prefixOf(peer);
+  auto& shard = getShard(prefix);
+  std::lock_guard<std::mutex> guard(shard.mutex);
+  auto it = shard.entries.find(prefix);
+  if (it == shard.entries.end()) {
+    return none;
+  }
+  if (now - it->second.updateTime > config_.maxAge) {
+    shard.entries.erase(it);
+    return none;
+  }
+  return it->second;
+}
+
+folly::IPAddress BandwidthCache::prefixOf(const folly::IPAddress& peer) {
+  if (peer.isIPv4Mapped()) {
+    return peer.createIPv4().mask(kIPv4PrefixLen);
+  }
+  return peer.mask(peer.isV4() ? kIPv4PrefixLen : kIPv6PrefixLen);
+}
+
+BandwidthCache::Shard& BandwidthCache::getShard(
+    const folly::IPAddress& prefix) const {
+  return *shards_[prefix.hash() % shards_.size()];
+}
+
+} // namespace quic
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/IPAddress.h>
+#include <folly/container/EvictingCacheMap.h>
+#include <quic/QuicConstants.h>
+#include <quic/common/Optional.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace quic {
+
+/**
+ * The path estimates of recently closed connections, keyed by the client's
+ * /24 (IPv4) or /48 (IPv6) prefix, so that a new connection from the same
+ * network can start from them instead of from the default initial cwnd.
+ *
+ * The cache is shared by all the workers of a server. Entries are spread over
+ * shards, each with its own lock and LRU eviction.
+ */
+class BandwidthCache {
+ public:
+  struct Config {
+    size_t numShards{16};
+    size_t maxEntriesPerShard{1024};
+    // Older entries are ignored.
+    std::chrono::microseconds maxAge{60s};
+    // Caps the initial cwnd of the connections seeded from the cache.
+    uint64_t maxSeededCwndBytes{kDefaultUDPSendPacketLen * 100};
+  };
+
+  struct Entry {
+    uint64_t bandwidthBytesPerSec{0};
+    std::chrono::microseconds minRtt{0us};
+    TimePoint updateTime;
+
+    [[nodiscard]] uint64_t bdpBytes() const {
+      return bandwidthBytesPerSec * minRtt.count() / 1000000;
+    }
+  };
+
+  explicit BandwidthCache(Config config = Config());
+
+  BandwidthCache(const BandwidthCache&) = delete;
+  BandwidthCache& operator=(const BandwidthCache&) = delete;
+
+  // Replaces the entry for the peer's prefix.
+  void update(
+      const folly::IPAddress& peer,
+      uint64_t bandwidthBytesPerSec,
+      std::chrono::microseconds minRtt,
+      TimePoint now = Clock::now());
+
+  // The entry for the peer's prefix, unless it has expired.
+  [[nodiscard]] Optional<Entry> get(
+      const folly::IPAddress& peer,
+      TimePoint now = Clock::now()) const;
+
+  [[nodiscard]] const Config& getConfig() const {
+    return config_;
+  }
+
+  // The peer's /24 or /48 network.
+  static folly::IPAddress prefixOf(const folly::IPAddress& peer);
+
+ private:
+  struct Shard {
+    explicit Shard(size_t maxEntries) : entries(maxEntries) {}
+
+    std::mutex mutex;
+    folly::EvictingCacheMap<folly::IPAddress, Entry> entries;
+  };
+
+  Shard& getShard(const folly::IPAddress& prefix) const;
+
+  Config config_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+} // namespace quic
@@ -69,7 +69,7 @@ bool BbrCongestionController::updateRoundTripCounter(
     TimePoint largestAckedSentTime) noexcept {
   if (largestAckedSentTime > endOfRoundTrip_) {
     roundTripCounter_++;
-    endOfRoundTrip_ = Clock::now();
+    endOfRoundTrip_ = lastSentTime_;
     return true;
   }
   return false;
@@ -88,7 +88,7 @@ void BbrCongestionController::setBandwidthSampler(
 void BbrCongestionController::onPacketLoss(
     const LossEvent& loss,
     uint64_t ackedBytes) {
-  endOfRecovery_ = Clock::now();
+  endOfRecovery_ = loss.lossTime;
 
   if (!inRecovery()) {
     recoveryState_ = BbrCongestionController::RecoveryState::CONSERVATIVE;
@@ -101,7 +101,7 @@ void BbrCongestionController::onPacketLoss(
 
     // We need to make sure CONSERVATIVE can last for a round trip, so update
     // endOfRoundTrip_ to the latest sent packet.
-    endOfRoundTrip_ = Clock::now();
+    endOfRoundTrip_ = lastSentTime_;
   }
 
   recoveryWindow_ = recoveryWindow_ >
@@ -129,6 +129,7 @@ void BbrCongestionController::onPacketSent(
   }
   addAndCheckOverflow(
       conn_.lossState.inflightBytes, packet.metadata.encodedSize);
+  lastSentTime_ = packet.metadata.time;
   if (!ackAggregationStartTime_) {
     ackAggregationStartTime_ = packet.metadata.time;
   }
@@ -229,6 +229,8 @@ class BbrCongestionController : public CongestionController {
   // When a packet with send time later than endOfRoundTrip_ is acked, the
   // current round strip is ended.
   TimePoint endOfRoundTrip_;
+  // Send time of the latest packet passed to onPacketSent().
+  TimePoint lastSentTime_;
   // When a packet with send time later than endOfRecovery_ is acked, the
   // connection is no longer in recovery
   Optional<TimePoint> endOfRecovery_;
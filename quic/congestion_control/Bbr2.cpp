@@ -45,11 +45,11 @@ constexpr uint8_t kPacingMarginPercent = 0;
 Bbr2CongestionController::Bbr2CongestionController(
     QuicConnectionStateBase& conn)
     : conn_(conn),
-      // WindowedFilter window_length is expiry time which inflates the window
+      // The filter's window length is expiry time which inflates the window
       // length by 1
-      maxBwFilter_(kMaxBwFilterLen - 1, Bandwidth(), 0),
+      maxBwFilter_(kMaxBwFilterLen - 1, Bandwidth()),
       probeRttMinTimestamp_(Clock::now()),
-      maxExtraAckedFilter_(kMaxExtraAckedFilterLen, 0, 0),
+      maxExtraAckedFilter_(kMaxExtraAckedFilterLen, 0),
       cwndBytes_(
           conn_.udpSendPacketLen * conn_.transportSettings.initCwndInMss) {
   resetCongestionSignals();
@@ -79,13 +79,13 @@ void Bbr2CongestionController::onPacketSent(
   // Handle restart from idle
   if (conn_.lossState.inflightBytes == 0 && isAppLimited()) {
     idleRestart_ = true;
-    extraAckedStartTimestamp_ = Clock::now();
+    extraAckedStartTimestamp_ = packet.metadata.time;
     extraAckedDelivered_ = 0;
 
     if (isProbeBwState(state_)) {
       setPacing();
     } else if (state_ == State::ProbeRTT) {
-      checkProbeRttDone();
+      checkProbeRttDone(packet.metadata.time);
     }
   }
 
@@ -217,8 +217,12 @@ bool Bbr2CongestionController::isAppLimited() const {
 }
 
 void Bbr2CongestionController::setAppLimited() noexcept {
+  setAppLimited(Clock::now());
+}
+
+void Bbr2CongestionController::setAppLimited(TimePoint lastSendTime) noexcept {
   appLimited_ = true;
-  appLimitedLastSendTime_ = Clock::now();
+  appLimitedLastSendTime_ = lastSendTime;
   if (conn_.qLogger) {
     conn_.qLogger->addAppLimitedUpdate();
   }
@@ -241,7 +245,7 @@ void Bbr2CongestionController::onPacketLoss(
   }
 
   saveCwnd();
-  recoveryStartTime_ = Clock::now();
+  recoveryStartTime_ = lossEvent.lossTime;
   if (!isInRecovery()) {
     recoveryState_ = RecoveryState::CONSERVATIVE;
     recoveryWindow_ = conn_.lossState.inflightBytes + ackedBytes;
@@ -350,7 +354,7 @@ void Bbr2CongestionController::setCwnd() {
   const auto& ackedBytes = currentAckEvent_->ackedBytes;
   auto targetBDP = getBDPWithGain(cwndGain_);
   if (fullBwReached_) {
-    targetBDP += maxExtraAckedFilter_.GetBest();
+    targetBDP += maxExtraAckedFilter_.getBest();
   } else if (conn_.transportSettings.ccaConfig.enableAckAggregationInStartup) {
     targetBDP += latestExtraAcked_;
   }
@@ -400,14 +404,13 @@ void Bbr2CongestionController::setCwnd() {
       kMinCwndInMssForBbr);
 }
 
-void Bbr2CongestionController::checkProbeRttDone() {
-  auto timeNow = Clock::now();
+void Bbr2CongestionController::checkProbeRttDone(TimePoint timeNow) {
   if ((probeRttDoneTimestamp_ && timeNow > *probeRttDoneTimestamp_) ||
       conn_.lossState.inflightBytes == 0) {
     // Schedule the next ProbeRTT
     probeRttMinTimestamp_ = timeNow;
     restoreCwnd();
-    exitProbeRtt();
+    exitProbeRtt(timeNow);
   }
 }
 
@@ -415,10 +418,10 @@ void Bbr2CongestionController::restoreCwnd() {
   cwndBytes_ = std::max(cwndBytes_, previousCwndBytes_);
   VLOG(6) << "Restored cwnd: " << cwndBytes_;
 }
-void Bbr2CongestionController::exitProbeRtt() {
+void Bbr2CongestionController::exitProbeRtt(TimePoint timeNow) {
   resetLowerBounds();
   if (fullBwReached_) {
-    startProbeBwDown();
+    startProbeBwDown(timeNow);
     startProbeBwCruise();
   } else {
     enterStartup();
@@ -450,11 +453,11 @@ void Bbr2CongestionController::updateLatestDeliverySignals() {
 void Bbr2CongestionController::updateCongestionSignals(
     const LossEvent* FOLLY_NULLABLE lossEvent) {
   // Update max bandwidth
-  if (bandwidthLatest_ > maxBwFilter_.GetBest() ||
+  if (bandwidthLatest_ > maxBwFilter_.getBest() ||
       !bandwidthLatest_.isAppLimited) {
     VLOG(6) << "Updating bandwidth filter with sample: "
             << bandwidthLatest_.normalizedDescribe();
-    maxBwFilter_.Update(bandwidthLatest_, cycleCount_);
+    maxBwFilter_.update(bandwidthLatest_, cycleCount_);
   }
 
   // Update loss signal
@@ -483,7 +486,7 @@ void Bbr2CongestionController::updateCongestionSignals(
   if (lossBytesInRound_ > 0 && !isProbingBandwidth(state_)) {
     // InitLowerBounds
     if (!bandwidthLo_.has_value()) {
-      bandwidthLo_ = maxBwFilter_.GetBest();
+      bandwidthLo_ = maxBwFilter_.getBest();
     }
     if (!inflightLo_.has_value()) {
       inflightLo_ = cwndBytes_;
@@ -507,20 +510,20 @@ void Bbr2CongestionController::updateCongestionSignals(
 
 void Bbr2CongestionController::updateAckAggregation() {
   /* Find excess ACKed beyond expected amount over this interval */
-  auto interval =
-      Clock::now() - extraAckedStartTimestamp_.value_or(conn_.connectionTime);
+  auto interval = currentAckEvent_->ackTime -
+      extraAckedStartTimestamp_.value_or(conn_.connectionTime);
   auto expectedDelivered = bandwidth_ *
       std::chrono::duration_cast<std::chrono::microseconds>(interval);
   /* Reset interval if ACK rate is below expected rate: */
   if (extraAckedDelivered_ < expectedDelivered) {
     extraAckedDelivered_ = 0;
-    extraAckedStartTimestamp_ = Clock::now();
+    extraAckedStartTimestamp_ = currentAckEvent_->ackTime;
     expectedDelivered = 0;
   }
   extraAckedDelivered_ += currentAckEvent_->ackedBytes;
   latestExtraAcked_ = extraAckedDelivered_ - expectedDelivered;
   latestExtraAcked_ = std::min(latestExtraAcked_, cwndBytes_);
-  maxExtraAckedFilter_.Update(latestExtraAcked_, roundCount_);
+  maxExtraAckedFilter_.update(latestExtraAcked_, roundCount_);
 }
 void Bbr2CongestionController::checkStartupDone() {
   checkStartupHighLoss();
@@ -562,9 +565,9 @@ void Bbr2CongestionController::checkFullBwReached() {
   if (!roundStart_) {
     return;
   }
-  if (maxBwFilter_.GetBest() >= fullBw_ * 1.25) {
+  if (maxBwFilter_.getBest() >= fullBw_ * 1.25) {
     resetFullBw(); // bw still growing, reset tracking
-    fullBw_ = maxBwFilter_.GetBest(); /* record new baseline level */
+    fullBw_ = maxBwFilter_.getBest(); /* record new baseline level */
     return;
   }
   fullBwCount_++; /* another round w/o much growth */
@@ -629,7 +632,7 @@ void Bbr2CongestionController::updateProbeBwCyclePhase() {
     case State::ProbeBw_Up:
       if (checkTimeToGoDown()) {
         canUpdateLongtermLossModel_ = false;
-        startProbeBwDown();
+        startProbeBwDown(currentAckEvent_->ackTime);
       }
       break;
     default:
@@ -683,7 +686,7 @@ bool Bbr2CongestionController::checkTimeToGoDown() {
   if (cwndLimitedInRound_ && inflightHi_.has_value() &&
       getTargetInflightWithGain(1.25) >= inflightHi_.value()) {
     resetFullBw();
-    fullBw_ = maxBwFilter_.GetBest();
+    fullBw_ = maxBwFilter_.getBest();
   } else if (fullBwNow_) {
     return true;
   }
@@ -692,7 +695,7 @@ bool Bbr2CongestionController::checkTimeToGoDown() {
 
 bool Bbr2CongestionController::hasElapsedInPhase(
     std::chrono::microseconds interval) {
-  return Clock::now() > probeBWCycleStart_ + interval;
+  return currentAckEvent_->ackTime > probeBWCycleStart_ + interval;
 }
 
 // Was the loss percent too high for the last ack received?
@@ -723,7 +726,7 @@ void Bbr2CongestionController::handleInFlightTooHigh() {
             static_cast<float>(getTargetInflightWithGain()) * kBeta));
   }
   if (state_ == State::ProbeBw_Up) {
-    startProbeBwDown();
+    startProbeBwDown(currentAckEvent_->ackTime);
   }
 }
 
@@ -761,21 +764,22 @@ void Bbr2CongestionController::probeInflightHiUpward() {
 }
 
 void Bbr2CongestionController::updateMinRtt() {
+  auto ackTime = currentAckEvent_->ackTime;
   if (idleRestart_) {
-    probeRttMinTimestamp_ = Clock::now();
+    probeRttMinTimestamp_ = ackTime;
     probeRttMinValue_ = kDefaultMinRtt;
   }
   probeRttExpired_ = probeRttMinTimestamp_
-      ? Clock::now() > (probeRttMinTimestamp_.value() + kProbeRTTInterval)
+      ? ackTime > (probeRttMinTimestamp_.value() + kProbeRTTInterval)
       : true;
   auto& lrtt = conn_.lossState.lrtt;
   if (lrtt > 0us && (lrtt < probeRttMinValue_ || probeRttExpired_)) {
     probeRttMinValue_ = lrtt;
-    probeRttMinTimestamp_ = Clock::now();
+    probeRttMinTimestamp_ = ackTime;
   }
 
   auto minRttExpired = minRttTimestamp_
-      ? Clock::now() > (minRttTimestamp_.value() + kMinRttFilterLen)
+      ? ackTime > (minRttTimestamp_.value() + kMinRttFilterLen)
       : true;
   if (probeRttMinValue_ < minRtt_ || minRttExpired) {
     minRtt_ = probeRttMinValue_;
@@ -808,18 +812,19 @@ void Bbr2CongestionController::handleProbeRtt() {
   /* Ignore low rate samples during ProbeRTT: */
   // TODO: I don't understand the logic in the spec in
   // MarkConnectionAppLimited() but just setting app limited is reasonable
-  setAppLimited();
+  auto ackTime = currentAckEvent_->ackTime;
+  setAppLimited(ackTime);
 
   if (!probeRttDoneTimestamp_ &&
       conn_.lossState.inflightBytes <= getProbeRTTCwnd()) {
     /* Wait for at least ProbeRTTDuration to elapse: */
-    probeRttDoneTimestamp_ = Clock::now() + kProbeRttDuration;
+    probeRttDoneTimestamp_ = ackTime + kProbeRttDuration;
     /* Wait for at least one round to elapse: */
     // Is this needed? BBR.probe_rtt_round_done = false
     startRound();
   } else if (probeRttDoneTimestamp_) {
     if (roundStart_) {
-      checkProbeRttDone();
+      checkProbeRttDone(ackTime);
     }
   }
 }
@@ -844,7 +849,7 @@ void Bbr2CongestionController::boundCwndForProbeRTT() {
 
 void Bbr2CongestionController::boundBwForModel() {
   Bandwidth previousBw = bandwidth_;
-  bandwidth_ = maxBwFilter_.GetBest();
+  bandwidth_ = maxBwFilter_.getBest();
   if (state_ != State::Startup) {
     if (bandwidthLo_.has_value() &&
         !conn_.transportSettings.ccaConfig.ignoreLoss) {
@@ -892,7 +897,7 @@ uint64_t Bbr2CongestionController::getBDPWithGain(float gain) const {
 }
 
 void Bbr2CongestionController::enterProbeBW() {
-  startProbeBwDown();
+  startProbeBwDown(currentAckEvent_->ackTime);
 }
 
 void Bbr2CongestionController::startRound() {
@@ -911,7 +916,7 @@ void Bbr2CongestionController::updateRound() {
   }
 }
 
-void Bbr2CongestionController::startProbeBwDown() {
+void Bbr2CongestionController::startProbeBwDown(TimePoint timeNow) {
   resetCongestionSignals();
   probeUpCount_ =
       std::numeric_limits<uint64_t>::max(); /* not growing inflight_hi */
@@ -921,7 +926,7 @@ void Bbr2CongestionController::startProbeBwDown() {
   bwProbeWait_ =
       std::chrono::milliseconds(2000 + (folly::Random::rand32() % 1000));
 
-  probeBWCycleStart_ = Clock::now();
+  probeBWCycleStart_ = timeNow;
   state_ = State::ProbeBw_Down;
   updatePacingAndCwndGain();
   startRound();
@@ -946,7 +951,7 @@ void Bbr2CongestionController::startProbeBwRefill() {
   startRound();
 }
 void Bbr2CongestionController::startProbeBwUp() {
-  probeBWCycleStart_ = Clock::now();
+  probeBWCycleStart_ = currentAckEvent_->ackTime;
   state_ = State::ProbeBw_Up;
   updatePacingAndCwndGain();
   startRound();
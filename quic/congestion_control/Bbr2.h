@@ -9,7 +9,7 @@
 
 #include <quic/congestion_control/Bandwidth.h>
 #include <quic/congestion_control/CongestionController.h>
-#include <quic/congestion_control/third_party/windowed_filter.h>
+#include <quic/congestion_control/MonotonicWindowedFilter.h>
 #include <quic/state/StateData.h>
 #include <quic/state/TransportSettings.h>
 #include <sys/types.h>
@@ -57,6 +57,10 @@ class Bbr2CongestionController : public CongestionController {
   [[nodiscard]] State getState() const noexcept;
 
  private:
+  // Internals take the time of the ack, loss or send being processed rather
+  // than reading the clock.
+  void setAppLimited(TimePoint lastSendTime) noexcept;
+
   void resetCongestionSignals();
   void resetLowerBounds();
   void updateLatestDeliverySignals();
@@ -88,14 +92,14 @@ class Bbr2CongestionController : public CongestionController {
   void enterProbeRtt();
   void handleProbeRtt();
   void checkProbeRtt();
-  void checkProbeRttDone();
-  void exitProbeRtt();
+  void checkProbeRttDone(TimePoint timeNow);
+  void exitProbeRtt(TimePoint timeNow);
   void updateMinRtt();
   uint64_t getProbeRTTCwnd();
   void boundCwndForProbeRTT();
 
   void enterProbeBW();
-  void startProbeBwDown();
+  void startProbeBwDown(TimePoint timeNow);
   void startProbeBwCruise();
   void updateProbeBwCyclePhase();
   void startProbeBwRefill();
@@ -139,8 +143,7 @@ class Bbr2CongestionController : public CongestionController {
   State state_{State::Startup};
 
   // Data Rate Model Parameters
-  WindowedFilter<Bandwidth, MaxFilter<Bandwidth>, uint64_t, uint64_t>
-      maxBwFilter_;
+  WindowedMaxFilter<Bandwidth, uint64_t, uint64_t> maxBwFilter_;
   Bandwidth bandwidth_;
   Optional<Bandwidth> bandwidthLo_;
   uint64_t cycleCount_{0}; // TODO: this can be one bit
@@ -159,8 +162,7 @@ class Bbr2CongestionController : public CongestionController {
   Optional<uint64_t> inflightLo_, inflightHi_;
   Optional<TimePoint> extraAckedStartTimestamp_;
   uint64_t extraAckedDelivered_{0};
-  WindowedFilter<uint64_t, MaxFilter<uint64_t>, uint64_t, uint64_t>
-      maxExtraAckedFilter_;
+  WindowedMaxFilter<uint64_t, uint64_t, uint64_t> maxExtraAckedFilter_;
   uint64_t latestExtraAcked_{0};
 
   // Responding to congestion
@@ -11,10 +11,10 @@ namespace quic {
 
 BbrBandwidthSampler::BbrBandwidthSampler(QuicConnectionStateBase& conn)
     : conn_(conn),
-      windowedFilter_(bandwidthWindowLength(kNumOfCycles), Bandwidth(), 0) {}
+      windowedFilter_(bandwidthWindowLength(kNumOfCycles), Bandwidth()) {}
 
 Bandwidth BbrBandwidthSampler::getBandwidth() const noexcept {
-  auto bandwidth = windowedFilter_.GetBest();
+  auto bandwidth = windowedFilter_.getBest();
 
   // Override the bandwidth value if the connection is being throttled and
   // throttling signal is present.
@@ -59,7 +59,7 @@ Bandwidth BbrBandwidthSampler::getLatestSample() const noexcept {
 
 void BbrBandwidthSampler::setWindowLength(
     const uint64_t windowLength) noexcept {
-  windowedFilter_.SetWindowLength(windowLength);
+  windowedFilter_.setWindowLength(windowLength);
 }
 
 void BbrBandwidthSampler::onPacketAcked(
@@ -73,12 +73,12 @@ void BbrBandwidthSampler::onPacketAcked(
       }
     }
   }
-  // TODO: If i'm smart enough, maybe we don't have to loop through the acked
-  // packets. Can we calculate the bandwidth based on aggregated stats?
-  bool bandwidthUpdated = false;
-  for (auto const& ackedPacket : ackEvent.ackedPackets) {
+  // All the samples from one ack share the same round, so the filter only
+  // needs to see the best eligible one.
+  auto bestBandwidth = windowedFilter_.getBest();
+  auto sampleFromPacket = [&](const auto& ackedPacket) -> Optional<Bandwidth> {
     if (ackedPacket.outstandingPacketMetadata.encodedSize == 0) {
-      continue;
+      return none;
     }
     Bandwidth sendRate, ackRate;
     if (ackedPacket.lastAckedPacketInfo) {
@@ -132,12 +132,16 @@ void BbrBandwidthSampler::onPacketAcked(
 
     // If a sample is from a packet sent during app-limited period, we should
     // still use this sample if it's >= current best value.
-    if (measuredBandwidth >= windowedFilter_.GetBest() ||
-        !ackedPacket.isAppLimited) {
-      windowedFilter_.Update(measuredBandwidth, rttCounter);
-      bandwidthUpdated = true;
+    if (measuredBandwidth >= bestBandwidth || !ackedPacket.isAppLimited) {
+      return measuredBandwidth;
     }
-  }
+    return none;
+  };
+  bool bandwidthUpdated = windowedFilter_.updateBatch(
+      ackEvent.ackedPackets.begin(),
+      ackEvent.ackedPackets.end(),
+      rttCounter,
+      sampleFromPacket);
   if (bandwidthUpdated && conn_.qLogger) {
     auto newBandwidth = getBandwidth();
     conn_.qLogger->addBandwidthEstUpdate(
@@ -8,7 +8,7 @@
 #pragma once
 
 #include <quic/congestion_control/Bbr.h>
-#include <quic/congestion_control/third_party/windowed_filter.h>
+#include <quic/congestion_control/MonotonicWindowedFilter.h>
 #include <quic/state/StateData.h>
 
 namespace quic {
@@ -40,8 +40,7 @@ class BbrBandwidthSampler : public BbrCongestionController::BandwidthSampler {
 
  private:
   QuicConnectionStateBase& conn_;
-  WindowedFilter<Bandwidth, MaxFilter<Bandwidth>, uint64_t, uint64_t>
-      windowedFilter_;
+  WindowedMaxFilter<Bandwidth, uint64_t, uint64_t> windowedFilter_;
   Bandwidth latestSample_;
   bool appLimited_{false};
 
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <quic/QuicConstants.h>
+#include <quic/common/SlabAllocator.h>
 #include <quic/congestion_control/Bandwidth.h>
 #include <quic/state/ClonedPacketIdentifier.h>
 #include <quic/state/OutstandingPacket.h>
@@ -43,7 +44,7 @@ union CongestionControllerStats {
   struct CubicStats cubicStats;
 };
 
-struct CongestionController {
+struct CongestionController : public SlabAllocated {
  public:
   using AckEvent = quic::AckEvent;
 
@@ -27,6 +27,12 @@ class CongestionControllerFactory {
   virtual std::unique_ptr<CongestionController> makeCongestionController(
       QuicConnectionStateBase& conn,
       CongestionControlType type) = 0;
+
+  /**
+   * Called when a server connection closes after its handshake completed,
+   * while its congestion controller is still in place.
+   */
+  virtual void onConnectionClose(const QuicConnectionStateBase& /* conn */) {}
 };
 
 class DefaultCongestionControllerFactory : public CongestionControllerFactory {
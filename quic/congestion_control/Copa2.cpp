@@ -76,13 +76,15 @@ void Copa2::onPacketAckOrLoss(
 }
 
 // Switch to and from lossy mode
-void Copa2::manageLossyMode(Optional<TimePoint> sentTime) {
+void Copa2::manageLossyMode(
+    Optional<TimePoint> sentTime,
+    TimePoint eventTime) {
   if (!sentTime) {
     // Loss happened and we don't know when. Be safe
     lossyMode_ = true;
     numAckedInLossCycle_ = 0;
     numLostInLossCycle_ = 0;
-    lossCycleStartTime_ = Clock::now();
+    lossCycleStartTime_ = eventTime;
     return;
   }
 
@@ -103,7 +105,7 @@ void Copa2::manageLossyMode(Optional<TimePoint> sentTime) {
   lossyMode_ = numLostInLossCycle_ >= numPktsInLossCycle * lossToleranceParam_;
   numAckedInLossCycle_ = 0;
   numLostInLossCycle_ = 0;
-  lossCycleStartTime_ = Clock::now();
+  lossCycleStartTime_ = eventTime;
 }
 
 void Copa2::onPacketLoss(const LossEvent& loss) {
@@ -136,7 +138,7 @@ void Copa2::onPacketLoss(const LossEvent& loss) {
   }
 
   numLostInLossCycle_ += loss.lostPackets;
-  manageLossyMode(loss.largestLostSentTime);
+  manageLossyMode(loss.largestLostSentTime, loss.lossTime);
 }
 
 void Copa2::onPacketAcked(const AckEvent& ack) {
@@ -153,7 +155,7 @@ void Copa2::onPacketAcked(const AckEvent& ack) {
   auto rttMin = minRTTFilter_.GetBest();
 
   numAckedInLossCycle_ += ack.ackedPackets.size();
-  manageLossyMode(ack.largestNewlyAckedPacketSentTime);
+  manageLossyMode(ack.largestNewlyAckedPacketSentTime, ack.ackTime);
 
   auto dParam = rttMin;
   if (lossyMode_) {
@@ -47,7 +47,8 @@ class Copa2 : public CongestionController {
  private:
   void onPacketLoss(const LossEvent&);
   void onPacketAcked(const AckEvent&);
-  void manageLossyMode(Optional<TimePoint> sentTime);
+  // eventTime is when the ack or loss being processed happened.
+  void manageLossyMode(Optional<TimePoint> sentTime, TimePoint eventTime);
 
   QuicConnectionStateBase& conn_;
   uint64_t cwndBytes_;
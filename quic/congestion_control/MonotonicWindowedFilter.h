@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <quic/common/Optional.h>
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+namespace quic {
+
+/**
+ * Tracks the best (max or min, depending on Compare) sample seen over a
+ * sliding window of time. The time can be a round count or a TimePoint.
+ *
+ * Unlike the three-sample approximation in third_party/windowed_filter.h, this
+ * keeps the candidates in a monotonic queue: every sample in the fixed-size
+ * ring is better than all the samples that arrived after it. A new sample
+ * drops the candidates it dominates from the back, the front is the current
+ * best, and expired candidates are dropped from the front. Samples taken at
+ * the same time are folded into one candidate, so the ring only needs to hold
+ * one entry per distinct time in the window. If the window holds more distinct
+ * times than kCapacity, the oldest candidate is dropped early.
+ *
+ * Compare(a, b) returns true when a is at least as good as b, e.g.
+ * std::greater_equal for a max filter.
+ */
+template <
+    class T,
+    class Compare,
+    typename TimeT,
+    typename TimeDeltaT,
+    size_t kCapacity = 16>
+class MonotonicWindowedFilter {
+  static_assert(
+      kCapacity > 1 && (kCapacity & (kCapacity - 1)) == 0,
+      "kCapacity must be a power of two");
+
+ public:
+  MonotonicWindowedFilter(TimeDeltaT windowLength, T zeroValue)
+      : windowLength_(windowLength), zeroValue_(std::move(zeroValue)) {}
+
+  void setWindowLength(TimeDeltaT windowLength) {
+    windowLength_ = windowLength;
+  }
+
+  void update(T newSample, TimeT newTime) {
+    while (size_ > 0 && compare_(newSample, back().sample)) {
+      size_--;
+    }
+    if (size_ == 0 || back().time != newTime) {
+      if (size_ == kCapacity) {
+        popFront();
+      }
+      samples_[(head_ + size_) & kMask] = Sample{std::move(newSample), newTime};
+      size_++;
+    }
+    // The back is at newTime, so it never expires.
+    while (size_ > 1 && newTime - front().time > windowLength_) {
+      popFront();
+    }
+  }
+
+  /**
+   * Folds all the samples produced from [begin, end) into one update at time.
+   * sampleFn maps an element to an Optional<T>, none meaning the element has
+   * no sample. The fold only looks at the best candidate once, which is
+   * equivalent to updating with each sample in turn since they share a time.
+   *
+   * Returns whether any sample was produced.
+   */
+  template <typename Iterator, typename SampleFn>
+  bool updateBatch(Iterator begin, Iterator end, TimeT time, SampleFn&& fn) {
+    Optional<T> best;
+    for (auto it = begin; it != end; ++it) {
+      auto sample = fn(*it);
+      if (sample && (!best || compare_(*sample, *best))) {
+        best = std::move(sample);
+      }
+    }
+    if (!best) {
+      return false;
+    }
+    update(std::move(*best), time);
+    return true;
+  }
+
+  [[nodiscard]] T getBest() const {
+    return size_ > 0 ? front().sample : zeroValue_;
+  }
+
+  void reset(T newSample, TimeT newTime) {
+    head_ = 0;
+    size_ = 0;
+    update(std::move(newSample), newTime);
+  }
+
+ private:
+  static constexpr size_t kMask = kCapacity - 1;
+
+  struct Sample {
+    T sample;
+    TimeT time;
+  };
+
+  const Sample& front() const {
+    return samples_[head_];
+  }
+
+  const Sample& back() const {
+    return samples_[(head_ + size_ - 1) & kMask];
+  }
+
+  void popFront() {
+    head_ = (head_ + 1) & kMask;
+    size_--;
+  }
+
+  TimeDeltaT windowLength_;
+  T zeroValue_;
+  std::array<Sample, kCapacity> samples_;
+  size_t head_{0};
+  size_t size_{0};
+  Compare compare_;
+};
+
+template <
+    class T,
+    typename TimeT,
+    typename TimeDeltaT,
+    size_t kCapacity = 16>
+using WindowedMaxFilter = MonotonicWindowedFilter<
+    T,
+    std::greater_equal<T>,
+    TimeT,
+    TimeDeltaT,
+    kCapacity>;
+
+template <
+    class T,
+    typename TimeT,
+    typename TimeDeltaT,
+    size_t kCapacity = 16>
+using WindowedMinFilter = MonotonicWindowedFilter<
+    T,
+    std::less_equal<T>,
+    TimeT,
+    TimeDeltaT,
+    kCapacity>;
+
+} // namespace quic
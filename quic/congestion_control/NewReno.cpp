@@ -114,7 +114,7 @@ void NewReno::onPacketLoss(const LossEvent& loss) {
       loss.largestLostSentTime.has_value());
   subtractAndCheckUnderflow(conn_.lossState.inflightBytes, loss.lostBytes);
   if (!endOfRecovery_ || *endOfRecovery_ < *loss.largestLostSentTime) {
-    endOfRecovery_ = Clock::now();
+    endOfRecovery_ = loss.lossTime;
     cwndBytes_ = (cwndBytes_ >> kRenoLossReductionFactorShift);
     cwndBytes_ = boundedCwnd(
         cwndBytes_,
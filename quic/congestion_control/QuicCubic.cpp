@@ -107,6 +107,7 @@ void Cubic::onPacketSent(const OutstandingPacketWrapper& packet) {
         LocalErrorCode::INFLIGHT_BYTES_OVERFLOW);
   }
   conn_.lossState.inflightBytes += packet.metadata.encodedSize;
+  lastSentTime_ = packet.metadata.time;
 
   if (conn_.transportSettings.ccaConfig.leaveHeadroomForCwndLimited) {
     // Consider cwndBlocked if inflight bytes >= 0.5 * cwnd
@@ -127,7 +128,7 @@ void Cubic::onPacketLoss(const LossEvent& loss) {
   // as it was already accounted for in a recovery period.
   if (*loss.largestLostSentTime >=
       recoveryState_.endOfRecovery.value_or(*loss.largestLostSentTime)) {
-    recoveryState_.endOfRecovery = Clock::now();
+    recoveryState_.endOfRecovery = loss.lossTime;
     cubicReduction(loss.lossTime);
     if (state_ == CubicStates::Hystart || state_ == CubicStates::Steady) {
       state_ = CubicStates::FastRecovery;
@@ -399,7 +400,7 @@ void Cubic::startHystartRttRound(TimePoint time) noexcept {
   hystartState_.ackCount = 0;
   hystartState_.lastSampledRtt = hystartState_.currSampledRtt;
   hystartState_.currSampledRtt.reset();
-  hystartState_.rttRoundEndTarget = Clock::now();
+  hystartState_.rttRoundEndTarget = lastSentTime_;
   hystartState_.inRttRound = true;
   hystartState_.found = HystartFound::No;
 }
@@ -196,6 +196,8 @@ class Cubic : public CongestionController {
   SteadyState steadyState_;
   RecoveryState recoveryState_;
   bool isCwndBlocked_{true};
+  // Sent time of the latest packet passed to onPacketSent().
+  TimePoint lastSentTime_;
 
   TimePoint l4sCwndReducedTimestamp_;
   uint64_t lastCECount_{0};
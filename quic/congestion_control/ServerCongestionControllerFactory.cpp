@@ -17,13 +17,19 @@
 #include <quic/congestion_control/NewReno.h>
 #include <quic/congestion_control/QuicCubic.h>
 
+#include <algorithm>
 #include <memory>
 
 namespace quic {
+ServerCongestionControllerFactory::ServerCongestionControllerFactory(
+    std::shared_ptr<BandwidthCache> bandwidthCache)
+    : bandwidthCache_(std::move(bandwidthCache)) {}
+
 std::unique_ptr<CongestionController>
 ServerCongestionControllerFactory::makeCongestionController(
     QuicConnectionStateBase& conn,
     CongestionControlType type) {
+  auto maybeSeededRtt = maybeSeedInitCwnd(conn);
   auto setupBBR = [&conn](BbrCongestionController* bbr) {
     bbr->setRttSampler(std::make_unique<BbrRttSampler>(
         std::chrono::seconds(kDefaultRttSamplerExpiration)));
@@ -72,7 +78,67 @@ ServerCongestionControllerFactory::makeCongestionController(
       throw QuicInternalException(
           "MAX is not a valid cc algorithm.", LocalErrorCode::INTERNAL_ERROR);
   }
+  // Pace the seeded cwnd over the cached min RTT, after the controller has
+  // set up the pacer.
+  if (maybeSeededRtt && conn.pacer) {
+    conn.pacer->refreshPacingRate(
+        conn.transportSettings.initCwndInMss * conn.udpSendPacketLen,
+        *maybeSeededRtt);
+  }
   QUIC_STATS(conn.statsCallback, onNewCongestionController, type);
   return congestionController;
 }
+
+void ServerCongestionControllerFactory::onConnectionClose(
+    const QuicConnectionStateBase& conn) {
+  if (!bandwidthCache_ || !conn.congestionController ||
+      !conn.originalPeerAddress.isInitialized() ||
+      conn.lossState.mrtt == kDefaultMinRtt) {
+    return;
+  }
+  uint64_t bandwidthBytesPerSec = 0;
+  auto maybeBandwidth = conn.congestionController->getBandwidth();
+  if (maybeBandwidth &&
+      maybeBandwidth->unitType == Bandwidth::UnitType::BYTES) {
+    bandwidthBytesPerSec = maybeBandwidth->normalize();
+  } else if (conn.lossState.srtt > 0us) {
+    // Controllers without a bandwidth model deliver about a cwnd per RTT.
+    bandwidthBytesPerSec = conn.congestionController->getCongestionWindow() *
+        1000000 / conn.lossState.srtt.count();
+  }
+  if (bandwidthBytesPerSec == 0) {
+    return;
+  }
+  bandwidthCache_->update(
+      conn.originalPeerAddress.getIPAddress(),
+      bandwidthBytesPerSec,
+      conn.lossState.mrtt);
+}
+
+Optional<std::chrono::microseconds>
+ServerCongestionControllerFactory::maybeSeedInitCwnd(
+    QuicConnectionStateBase& conn) {
+  if (!bandwidthCache_ || conn.nodeType != QuicNodeType::Server ||
+      !conn.originalPeerAddress.isInitialized()) {
+    return none;
+  }
+  auto maybeEntry =
+      bandwidthCache_->get(conn.originalPeerAddress.getIPAddress());
+  if (!maybeEntry) {
+    return none;
+  }
+  auto cwndBytes = std::min(
+      {maybeEntry->bdpBytes(),
+       bandwidthCache_->getConfig().maxSeededCwndBytes,
+       conn.transportSettings.maxCwndInMss * conn.udpSendPacketLen});
+  auto initCwndInMss = cwndBytes / conn.udpSendPacketLen;
+  if (initCwndInMss <= conn.transportSettings.initCwndInMss) {
+    return none;
+  }
+  VLOG(10) << "Seeding initial cwnd from bandwidth cache, initCwndInMss="
+           << initCwndInMss << " minRtt=" << maybeEntry->minRtt.count()
+           << "us " << conn;
+  conn.transportSettings.initCwndInMss = initCwndInMss;
+  return maybeEntry->minRtt;
+}
 } // namespace quic
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <quic/congestion_control/BandwidthCache.h>
 #include <quic/congestion_control/CongestionControllerFactory.h>
 
 namespace quic {
@@ -21,14 +22,33 @@ namespace quic {
  *
  * To use this interface instead of the default, pass a new instance of this
  * class to QuicServer::setCongestionControllerFactory.
+ *
+ * With a BandwidthCache, closing connections record their bandwidth and min
+ * RTT in it, and new connections from the same network start with a cwnd and
+ * pacing rate seeded from them, up to the cache's maxSeededCwndBytes.
  */
 class ServerCongestionControllerFactory : public CongestionControllerFactory {
  public:
+  ServerCongestionControllerFactory() = default;
+
+  explicit ServerCongestionControllerFactory(
+      std::shared_ptr<BandwidthCache> bandwidthCache);
+
   ~ServerCongestionControllerFactory() override = default;
 
   std::unique_ptr<CongestionController> makeCongestionController(
       QuicConnectionStateBase& conn,
       CongestionControlType type) override;
+
+  void onConnectionClose(const QuicConnectionStateBase& conn) override;
+
+ private:
+  // Raises the connection's initial cwnd from the cache, and returns the min
+  // RTT to pace the new initial cwnd over.
+  Optional<std::chrono::microseconds> maybeSeedInitCwnd(
+      QuicConnectionStateBase& conn);
+
+  std::shared_ptr<BandwidthCache> bandwidthCache_;
 };
 
 } // namespace quic
@@ -203,10 +203,71 @@ uint64_t TokenlessPacer::updateAndGetWriteBatchSize(TimePoint currentTime) {
   return sendBatch;
 }
 
+TxTimeSchedule TokenlessPacer::updateAndGetTxTimeSchedule(
+    TimePoint currentTime,
+    std::chrono::microseconds horizon) {
+  scheduleTime_.reset();
+  TxTimeSchedule schedule;
+  schedule.firstBurstSize = updateAndGetWriteBatchSize(currentTime);
+  if (writeInterval_ == 0us || schedule.firstBurstSize == 0) {
+    return schedule;
+  }
+  // The packets of the previous write may still be waiting in the qdisc, e.g.
+  // when an ack refreshed the pacing rate and reset lastWriteTime_. Queue the
+  // new ones behind them.
+  if (lastDepartureTime_ &&
+      *lastDepartureTime_ + writeInterval_ > currentTime) {
+    schedule.startOffset =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            *lastDepartureTime_ + writeInterval_ - currentTime);
+    if (schedule.startOffset >= horizon) {
+      schedule.firstBurstSize = 0;
+      lastWriteTime_ = *lastDepartureTime_;
+      return schedule;
+    }
+  }
+  schedule.burstSize = batchSize_;
+  schedule.numLaterBursts = (horizon - schedule.startOffset) / writeInterval_;
+  schedule.interval = writeInterval_;
+  scheduleTime_ = currentTime;
+  departureTimeBeforeSchedule_ = lastDepartureTime_;
+  // Assume the whole schedule is used until onTxTimeScheduleWritten() says
+  // otherwise.
+  lastDepartureTime_ = currentTime + schedule.startOffset +
+      writeInterval_ * schedule.numLaterBursts;
+  // The next write is due one interval after the last burst departs.
+  lastWriteTime_ = lastDepartureTime_;
+  return schedule;
+}
+
+void TokenlessPacer::onTxTimeScheduleWritten(const TxTimeSchedule& schedule) {
+  if (!scheduleTime_) {
+    return;
+  }
+  auto scheduleTime = *scheduleTime_;
+  scheduleTime_.reset();
+  if (schedule.packetsScheduled == 0) {
+    lastDepartureTime_ = departureTimeBeforeSchedule_;
+  } else {
+    lastDepartureTime_ = scheduleTime +
+        schedule.departureOffset(schedule.packetsScheduled - 1);
+  }
+  lastWriteTime_ =
+      std::max(scheduleTime, lastDepartureTime_.value_or(scheduleTime));
+}
+
 uint64_t TokenlessPacer::getCachedWriteBatchSize() const {
   return batchSize_;
 }
 
+uint64_t TokenlessPacer::getPacingRateBytesPerSec() const {
+  if (writeInterval_ == 0us) {
+    return 0;
+  }
+  return batchSize_ * conn_.udpSendPacketLen * std::chrono::seconds(1) /
+      writeInterval_;
+}
+
 void TokenlessPacer::setPacingRateCalculator(
     PacingRateCalculator pacingRateCalculator) {
   pacingRateCalculator_ = std::move(pacingRateCalculator);
@@ -39,10 +39,18 @@ class TokenlessPacer : public Pacer {
 
   uint64_t updateAndGetWriteBatchSize(TimePoint currentTime) override;
 
+  TxTimeSchedule updateAndGetTxTimeSchedule(
+      TimePoint currentTime,
+      std::chrono::microseconds horizon) override;
+
+  void onTxTimeScheduleWritten(const TxTimeSchedule& schedule) override;
+
   void setPacingRateCalculator(PacingRateCalculator pacingRateCalculator);
 
   uint64_t getCachedWriteBatchSize() const override;
 
+  [[nodiscard]] uint64_t getPacingRateBytesPerSec() const override;
+
   void onPacketSent() override;
   void onPacketsLoss() override;
 
@@ -61,6 +69,12 @@ class TokenlessPacer : public Pacer {
   std::chrono::microseconds writeInterval_{0};
   PacingRateCalculator pacingRateCalculator_;
   Optional<TimePoint> lastWriteTime_;
+  // When the last packet scheduled by updateAndGetTxTimeSchedule() departs.
+  Optional<TimePoint> lastDepartureTime_;
+  // The time of the pending schedule, and lastDepartureTime_ before it, until
+  // onTxTimeScheduleWritten() tells how much of it was used.
+  Optional<TimePoint> scheduleTime_;
+  Optional<TimePoint> departureTimeBeforeSchedule_;
   uint8_t rttFactorNumerator_{1};
   uint8_t rttFactorDenominator_{1};
   bool experimental_{false};
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/congestion_control/BandwidthCache.h>
+
+#include <folly/portability/GTest.h>
+#include <quic/common/test/TestUtils.h>
+#include <quic/congestion_control/ServerCongestionControllerFactory.h>
+#include <quic/congestion_control/TokenlessPacer.h>
+#include <quic/fizz/server/handshake/FizzServerQuicHandshakeContext.h>
+
+using namespace testing;
+
+namespace quic::test {
+
+namespace {
+
+std::unique_ptr<QuicServerConnectionState> makeConn(const std::string& peer) {
+  auto conn = std::make_unique<QuicServerConnectionState>(
+      FizzServerQuicHandshakeContext::Builder().build());
+  conn->originalPeerAddress = folly::SocketAddress(peer, 443);
+  return conn;
+}
+
+} // namespace
+
+TEST(BandwidthCacheTest, SharedByPrefix) {
+  BandwidthCache cache;
+  auto now = Clock::now();
+  cache.update(folly::IPAddress("10.0.1.5"), 1000, 20ms, now);
+  auto entry = cache.get(folly::IPAddress("10.0.1.200"), now);
+  ASSERT_TRUE(entry.has_value());
+  EXPECT_EQ(1000, entry->bandwidthBytesPerSec);
+  EXPECT_EQ(20ms, entry->minRtt);
+  EXPECT_EQ(20, entry->bdpBytes());
+  EXPECT_FALSE(cache.get(folly::IPAddress("10.0.2.5"), now).has_value());
+
+  // IPv4-mapped addresses share the IPv4 entry.
+  EXPECT_TRUE(cache.get(folly::IPAddress("::ffff:10.0.1.7"), now).has_value());
+
+  cache.update(folly::IPAddress("2001:db8:1::1"), 2000, 30ms, now);
+  EXPECT_TRUE(cache.get(folly::IPAddress("2001:db8:1:ff::1"), now).has_value());
+  EXPECT_FALSE(cache.get(folly::IPAddress("2001:db8:2::1"), now).has_value());
+
+  cache.update(folly::IPAddress("10.0.1.9"), 3000, 10ms, now);
+  EXPECT_EQ(
+      3000,
+      cache.get(folly::IPAddress("10.0.1.5"), now)->bandwidthBytesPerSec);
+}
+
+TEST(BandwidthCacheTest, Expiry) {
+  BandwidthCache::Config config;
+  config.maxAge = 10s;
+  BandwidthCache cache(config);
+  auto now = Clock::now();
+  cache.update(folly::IPAddress("10.0.1.5"), 1000, 20ms, now);
+  EXPECT_TRUE(cache.get(folly::IPAddress("10.0.1.5"), now + 10s).has_value());
+  EXPECT_FALSE(cache.get(folly::IPAddress("10.0.1.5"), now + 11s).has_value());
+  EXPECT_FALSE(cache.get(folly::IPAddress("10.0.1.5"), now).has_value());
+}
+
+TEST(BandwidthCacheTest, Eviction) {
+  BandwidthCache::Config config;
+  config.numShards = 1;
+  config.maxEntriesPerShard = 2;
+  BandwidthCache cache(config);
+  auto now = Clock::now();
+  cache.update(folly::IPAddress("10.0.1.1"), 1000, 20ms, now);
+  cache.update(folly::IPAddress("10.0.2.1"), 1000, 20ms, now);
+  cache.update(folly::IPAddress("10.0.3.1"), 1000, 20ms, now);
+  EXPECT_FALSE(cache.get(folly::IPAddress("10.0.1.1"), now).has_value());
+  EXPECT_TRUE(cache.get(folly::IPAddress("10.0.2.1"), now).has_value());
+  EXPECT_TRUE(cache.get(folly::IPAddress("10.0.3.1"), now).has_value());
+}
+
+TEST(BandwidthCacheTest, FactorySeedsInitCwnd) {
+  auto cache = std::make_shared<BandwidthCache>();
+  ServerCongestionControllerFactory factory(cache);
+
+  // Nothing cached yet.
+  auto conn = makeConn("10.0.1.5");
+  auto defaultInitCwndInMss = conn->transportSettings.initCwndInMss;
+  auto cc =
+      factory.makeCongestionController(*conn, CongestionControlType::Cubic);
+  EXPECT_EQ(
+      defaultInitCwndInMss * conn->udpSendPacketLen,
+      cc->getCongestionWindow());
+
+  // 1 MB/s over 50ms.
+  cache->update(folly::IPAddress("10.0.1.1"), 1000000, 50ms);
+  conn = makeConn("10.0.1.5");
+  conn->transportSettings.pacingEnabled = true;
+  conn->pacer = std::make_unique<TokenlessPacer>(*conn, kMinCwndInMss);
+  cc = factory.makeCongestionController(*conn, CongestionControlType::Cubic);
+  auto expectedInitCwndInMss = 50000 / conn->udpSendPacketLen;
+  EXPECT_EQ(expectedInitCwndInMss, conn->transportSettings.initCwndInMss);
+  EXPECT_EQ(
+      expectedInitCwndInMss * conn->udpSendPacketLen,
+      cc->getCongestionWindow());
+  // Paced over the cached min RTT rather than sent in one burst.
+  auto now = Clock::now();
+  conn->pacer->updateAndGetWriteBatchSize(now);
+  EXPECT_GT(conn->pacer->getTimeUntilNextWrite(now), 0us);
+
+  // Capped.
+  cache->update(folly::IPAddress("10.0.1.1"), 1000000000, 50ms);
+  conn = makeConn("10.0.1.5");
+  cc = factory.makeCongestionController(*conn, CongestionControlType::BBR2);
+  EXPECT_EQ(
+      cache->getConfig().maxSeededCwndBytes / conn->udpSendPacketLen,
+      conn->transportSettings.initCwndInMss);
+
+  // Other networks are not affected.
+  conn = makeConn("10.0.2.5");
+  cc = factory.makeCongestionController(*conn, CongestionControlType::Cubic);
+  EXPECT_EQ(defaultInitCwndInMss, conn->transportSettings.initCwndInMss);
+}
+
+TEST(BandwidthCacheTest, FactoryRecordsOnClose) {
+  auto cache = std::make_shared<BandwidthCache>();
+  ServerCongestionControllerFactory factory(cache);
+  auto conn = makeConn("10.0.1.5");
+  conn->congestionController =
+      factory.makeCongestionController(*conn, CongestionControlType::NewReno);
+
+  // No RTT sample yet.
+  factory.onConnectionClose(*conn);
+  EXPECT_FALSE(cache->get(folly::IPAddress("10.0.1.5")).has_value());
+
+  conn->lossState.mrtt = 20ms;
+  conn->lossState.srtt = 40ms;
+  factory.onConnectionClose(*conn);
+  auto entry = cache->get(folly::IPAddress("10.0.1.6"));
+  ASSERT_TRUE(entry.has_value());
+  EXPECT_EQ(20ms, entry->minRtt);
+  EXPECT_EQ(
+      conn->congestionController->getCongestionWindow() * 1000000 / 40000,
+      entry->bandwidthBytesPerSec);
+
+  // Factories without a cache do nothing.
+  ServerCongestionControllerFactory().onConnectionClose(*conn);
+}
+
+} // namespace quic::test
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/Benchmark.h>
+#include <quic/common/test/TestUtils.h>
+#include <quic/congestion_control/Bbr2.h>
+#include <quic/congestion_control/BbrBandwidthSampler.h>
+#include <quic/congestion_control/MonotonicWindowedFilter.h>
+#include <quic/congestion_control/third_party/windowed_filter.h>
+
+using namespace quic;
+using namespace quic::test;
+
+namespace {
+
+constexpr uint64_t kPacketSize = 1200;
+constexpr std::chrono::microseconds kRtt = 20ms;
+
+/**
+ * Sends a flight of packets and acks all of it with a single AckEvent, one
+ * round trip later. Every acked packet carries the state of the previous ack,
+ * so that each of them yields a bandwidth sample.
+ */
+class AckEventFixture {
+ public:
+  explicit AckEventFixture(size_t packetsPerAck)
+      : conn_(QuicNodeType::Server), packetsPerAck_(packetsPerAck) {
+    conn_.connectionTime = Clock::now();
+    now_ = conn_.connectionTime;
+    lastAckTime_ = now_;
+  }
+
+  QuicConnectionStateBase& conn() {
+    return conn_;
+  }
+
+  template <typename OnPacketSent>
+  CongestionController::AckEvent sendAndAckFlight(OnPacketSent&& onSent) {
+    std::vector<OutstandingPacketWrapper> packets;
+    packets.reserve(packetsPerAck_);
+    auto sendInterval = kRtt / static_cast<int64_t>(packetsPerAck_);
+    for (size_t i = 0; i < packetsPerAck_; i++) {
+      now_ += sendInterval;
+      conn_.lossState.totalBytesSent += kPacketSize;
+      auto packet = makeTestingWritePacket(
+          nextPacketNum_++,
+          kPacketSize,
+          conn_.lossState.totalBytesSent,
+          now_,
+          conn_.lossState.inflightBytes);
+      packet.lastAckedPacketInfo.emplace(
+          lastAckedSentTime_,
+          lastAckTime_,
+          lastAckTime_,
+          lastAckedTotalBytesSent_,
+          conn_.lossState.totalBytesAcked);
+      onSent(packet);
+      packets.push_back(std::move(packet));
+    }
+
+    auto ackTime = now_ + kRtt;
+    auto ackEvent = CongestionController::AckEvent::Builder()
+                        .setAckTime(ackTime)
+                        .setAdjustedAckTime(ackTime)
+                        .setAckDelay(0us)
+                        .setPacketNumberSpace(PacketNumberSpace::AppData)
+                        .setLargestAckedPacket(nextPacketNum_ - 1)
+                        .build();
+    ackEvent.ackedBytes = packetsPerAck_ * kPacketSize;
+    conn_.lossState.totalBytesAcked += ackEvent.ackedBytes;
+    ackEvent.totalBytesAcked = conn_.lossState.totalBytesAcked;
+    ackEvent.largestNewlyAckedPacket = nextPacketNum_ - 1;
+    ackEvent.largestNewlyAckedPacketSentTime = now_;
+    ackEvent.ackedPackets.reserve(packets.size());
+    for (auto& packet : packets) {
+      ackEvent.ackedPackets.push_back(
+          makeAckPacketFromOutstandingPacket(std::move(packet)));
+    }
+    lastAckedSentTime_ = now_;
+    lastAckTime_ = ackTime;
+    lastAckedTotalBytesSent_ = conn_.lossState.totalBytesSent;
+    now_ = ackTime;
+    return ackEvent;
+  }
+
+ private:
+  QuicConnectionStateBase conn_;
+  size_t packetsPerAck_;
+  TimePoint now_;
+  TimePoint lastAckedSentTime_;
+  TimePoint lastAckTime_;
+  uint64_t lastAckedTotalBytesSent_{0};
+  PacketNum nextPacketNum_{0};
+};
+
+void bbr2AckBench(uint32_t iters, size_t packetsPerAck) {
+  folly::BenchmarkSuspender suspender;
+  AckEventFixture fixture(packetsPerAck);
+  Bbr2CongestionController bbr2(fixture.conn());
+  while (iters--) {
+    auto ackEvent = fixture.sendAndAckFlight(
+        [&](const auto& packet) { bbr2.onPacketSent(packet); });
+    suspender.dismiss();
+    bbr2.onPacketAckOrLoss(&ackEvent, nullptr);
+    suspender.rehire();
+  }
+}
+
+void bandwidthSamplerAckBench(uint32_t iters, size_t packetsPerAck) {
+  folly::BenchmarkSuspender suspender;
+  AckEventFixture fixture(packetsPerAck);
+  BbrBandwidthSampler sampler(fixture.conn());
+  uint64_t round = 0;
+  while (iters--) {
+    auto ackEvent = fixture.sendAndAckFlight([](const auto&) {});
+    suspender.dismiss();
+    sampler.onPacketAcked(ackEvent, round++);
+    suspender.rehire();
+  }
+}
+
+std::vector<Bandwidth> makeSamples(size_t numSamples) {
+  std::vector<Bandwidth> samples;
+  samples.reserve(numSamples);
+  for (size_t i = 0; i < numSamples; i++) {
+    samples.emplace_back((i * 7919) % 100000, 1ms, i % 3 == 0);
+  }
+  return samples;
+}
+
+// How BBR fed the filter before: one update per acked packet.
+void perSampleFilterBench(uint32_t iters, size_t samplesPerAck) {
+  folly::BenchmarkSuspender suspender;
+  auto samples = makeSamples(samplesPerAck);
+  WindowedFilter<Bandwidth, MaxFilter<Bandwidth>, uint64_t, uint64_t> filter(
+      10, Bandwidth(), 0);
+  suspender.dismiss();
+  for (uint64_t round = 0; round < iters; round++) {
+    for (const auto& sample : samples) {
+      if (sample >= filter.GetBest() || !sample.isAppLimited) {
+        filter.Update(sample, round);
+      }
+    }
+  }
+  folly::doNotOptimizeAway(filter.GetBest());
+}
+
+void batchFilterBench(uint32_t iters, size_t samplesPerAck) {
+  folly::BenchmarkSuspender suspender;
+  auto samples = makeSamples(samplesPerAck);
+  WindowedMaxFilter<Bandwidth, uint64_t, uint64_t> filter(10, Bandwidth());
+  suspender.dismiss();
+  for (uint64_t round = 0; round < iters; round++) {
+    auto best = filter.getBest();
+    filter.updateBatch(
+        samples.begin(),
+        samples.end(),
+        round,
+        [&](const Bandwidth& sample) -> Optional<Bandwidth> {
+          if (sample >= best || !sample.isAppLimited) {
+            return sample;
+          }
+          return none;
+        });
+  }
+  folly::doNotOptimizeAway(filter.getBest());
+}
+
+} // namespace
+
+BENCHMARK_NAMED_PARAM(bbr2AckBench, 1_packet, 1)
+BENCHMARK_NAMED_PARAM(bbr2AckBench, 10_packets, 10)
+BENCHMARK_NAMED_PARAM(bbr2AckBench, 1k_packets, 1000)
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_NAMED_PARAM(bandwidthSamplerAckBench, 10_packets, 10)
+BENCHMARK_NAMED_PARAM(bandwidthSamplerAckBench, 1k_packets, 1000)
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_NAMED_PARAM(perSampleFilterBench, 1k_samples, 1000)
+BENCHMARK_RELATIVE_NAMED_PARAM(batchFilterBench, 1k_samples, 1000)
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/congestion_control/test/NetworkEmulator.h>
+
+#include <folly/portability/GTest.h>
+
+using namespace testing;
+
+namespace quic::test {
+
+namespace {
+
+// 10 Mbps with a 40 ms RTT.
+constexpr uint64_t kLinkRate = 1250000;
+constexpr uint64_t kBdp = kLinkRate * 40 / 1000;
+constexpr std::chrono::microseconds kDuration = 10s;
+constexpr std::chrono::microseconds kWarmup = 2s;
+
+struct Scenario {
+  std::string name;
+  EmulatedLinkConfig link;
+  // Whether the link drops packets whatever the sender does.
+  bool lossy{false};
+};
+
+std::vector<Scenario> getScenarios() {
+  std::vector<Scenario> scenarios;
+  EmulatedLinkConfig base;
+  base.bottleneckBytesPerSecond = kLinkRate;
+  base.rtt = 40ms;
+  base.bufferBytes = kBdp;
+  scenarios.push_back({"OneBdpBuffer", base});
+
+  auto shallow = base;
+  shallow.bufferBytes = kBdp / 4;
+  scenarios.push_back({"ShallowBuffer", shallow});
+
+  auto deep = base;
+  deep.bufferBytes = kBdp * 4;
+  scenarios.push_back({"DeepBuffer", deep});
+
+  auto randomLoss = base;
+  randomLoss.randomLossRate = 0.01;
+  scenarios.push_back({"RandomLoss", randomLoss, true});
+
+  auto burstyLoss = base;
+  burstyLoss.burstStartProbability = 0.002;
+  burstyLoss.burstEndProbability = 0.25;
+  burstyLoss.burstLossRate = 0.5;
+  scenarios.push_back({"BurstyLoss", burstyLoss, true});
+
+  auto ackAggregation = base;
+  ackAggregation.ackAggregationInterval = 10ms;
+  scenarios.push_back({"AckAggregation", ackAggregation});
+
+  // A fast link policed down to half the usual rate.
+  auto policed = base;
+  policed.bottleneckBytesPerSecond = kLinkRate * 10;
+  policed.bufferBytes = kBdp * 10;
+  SimulatedTBF::Config policer;
+  policer.rateBytesPerSecond = kLinkRate / 2;
+  policer.burstSizeBytes = 20000;
+  policed.policer = policer;
+  scenarios.push_back({"Policer", policed, true});
+  return scenarios;
+}
+
+uint64_t maxGoodput(const EmulatedLinkConfig& link) {
+  uint64_t rate = link.bottleneckBytesPerSecond;
+  if (link.policer) {
+    // The bucket starts full.
+    auto burstPerSecond = static_cast<uint64_t>(
+        link.policer->burstSizeBytes * 1s / (kDuration - kWarmup));
+    rate = std::min<uint64_t>(
+        rate, link.policer->rateBytesPerSecond + burstPerSecond);
+  }
+  return rate;
+}
+
+} // namespace
+
+class CongestionControlScenarioTest
+    : public TestWithParam<CongestionControlType> {};
+
+TEST_P(CongestionControlScenarioTest, ScenarioMatrix) {
+  for (const auto& scenario : getScenarios()) {
+    NetworkEmulator emulator(GetParam(), scenario.link);
+    auto result = emulator.run(kDuration, kWarmup);
+    LOG(INFO) << congestionControlTypeToString(GetParam()) << " "
+              << scenario.name
+              << ": goodput=" << result.goodputBytesPerSecond * 8 / 1000
+              << "kbps p50QueueingDelay=" << result.p50QueueingDelay.count()
+              << "us p99QueueingDelay=" << result.p99QueueingDelay.count()
+              << "us loss=" << result.lossRate()
+              << " markedLost=" << result.packetsMarkedLost;
+
+    const auto& link = scenario.link;
+    EXPECT_GT(result.goodputBytesPerSecond, 0) << scenario.name;
+    // Allow for the packet that is on the link when the run starts.
+    EXPECT_LE(result.goodputBytesPerSecond, maxGoodput(link) * 101 / 100)
+        << scenario.name;
+    EXPECT_LE(result.p50QueueingDelay, result.p99QueueingDelay);
+    auto maxQueueingDelay = std::chrono::microseconds(
+        link.bufferBytes * 1000000 / link.bottleneckBytesPerSecond);
+    EXPECT_LE(result.p99QueueingDelay, maxQueueingDelay) << scenario.name;
+    if (scenario.lossy) {
+      EXPECT_GT(result.packetsDropped, 0) << scenario.name;
+      EXPECT_GT(result.packetsMarkedLost, 0) << scenario.name;
+    }
+  }
+}
+
+TEST_P(CongestionControlScenarioTest, Deterministic) {
+  auto scenario = getScenarios()[4];
+  ASSERT_EQ("BurstyLoss", scenario.name);
+  NetworkEmulator emulator1(GetParam(), scenario.link, 42);
+  auto result1 = emulator1.run(kDuration, kWarmup);
+  NetworkEmulator emulator2(GetParam(), scenario.link, 42);
+  auto result2 = emulator2.run(kDuration, kWarmup);
+  EXPECT_EQ(result1.goodputBytesPerSecond, result2.goodputBytesPerSecond);
+  EXPECT_EQ(result1.p50QueueingDelay, result2.p50QueueingDelay);
+  EXPECT_EQ(result1.p99QueueingDelay, result2.p99QueueingDelay);
+  EXPECT_EQ(result1.packetsSent, result2.packetsSent);
+  EXPECT_EQ(result1.packetsDropped, result2.packetsDropped);
+  EXPECT_EQ(result1.packetsMarkedLost, result2.packetsMarkedLost);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    CongestionControlScenarioTests,
+    CongestionControlScenarioTest,
+    Values(
+        CongestionControlType::Cubic,
+        CongestionControlType::NewReno,
+        CongestionControlType::Copa,
+        CongestionControlType::Copa2,
+        CongestionControlType::BBR,
+        CongestionControlType::BBR2));
+
+} // namespace quic::test
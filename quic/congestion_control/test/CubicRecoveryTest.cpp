@@ -134,7 +134,6 @@ TEST_F(CubicRecoveryTest, AckNotLargestNotChangeCwnd) {
   auto packet4 = makeTestingWritePacket(3, 1000, 4000);
   auto packet5 = makeTestingWritePacket(4, 1000, 5000);
 
-  CongestionController::LossEvent loss;
   cubic.onPacketSent(packet1);
   cubic.onPacketSent(packet2);
   cubic.onPacketSent(packet3);
@@ -143,6 +142,7 @@ TEST_F(CubicRecoveryTest, AckNotLargestNotChangeCwnd) {
   conn.lossState.largestSent = 4;
 
   // packet5 is lost:
+  CongestionController::LossEvent loss;
   loss.addLostPacket(packet5);
   cubic.onPacketAckOrLoss(none, std::move(loss));
   EXPECT_EQ(CubicStates::FastRecovery, cubic.state());
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/congestion_control/MonotonicWindowedFilter.h>
+
+#include <folly/portability/GTest.h>
+#include <quic/QuicConstants.h>
+#include <quic/congestion_control/Bandwidth.h>
+
+#include <vector>
+
+using namespace testing;
+
+namespace quic::test {
+
+TEST(MonotonicWindowedFilterTest, Empty) {
+  WindowedMaxFilter<uint64_t, uint64_t, uint64_t> maxFilter(10, 0);
+  EXPECT_EQ(0, maxFilter.getBest());
+  WindowedMaxFilter<Bandwidth, uint64_t, uint64_t> bwFilter(10, Bandwidth());
+  EXPECT_FALSE(bwFilter.getBest());
+}
+
+TEST(MonotonicWindowedFilterTest, MaxOverRounds) {
+  WindowedMaxFilter<uint64_t, uint64_t, uint64_t> filter(2, 0);
+  filter.update(10, 0);
+  filter.update(5, 1);
+  filter.update(7, 2);
+  EXPECT_EQ(10, filter.getBest());
+  // Round 0 expires, and 5 was dominated by 7.
+  filter.update(3, 3);
+  EXPECT_EQ(7, filter.getBest());
+  filter.update(1, 4);
+  EXPECT_EQ(7, filter.getBest());
+  filter.update(2, 5);
+  EXPECT_EQ(3, filter.getBest());
+  // A better sample replaces everything.
+  filter.update(20, 5);
+  EXPECT_EQ(20, filter.getBest());
+  filter.update(1, 8);
+  EXPECT_EQ(1, filter.getBest());
+}
+
+TEST(MonotonicWindowedFilterTest, MinOverTime) {
+  WindowedMinFilter<
+      std::chrono::microseconds,
+      TimePoint,
+      std::chrono::microseconds>
+      filter(100ms, kDefaultMinRtt);
+  EXPECT_EQ(kDefaultMinRtt, filter.getBest());
+  auto now = Clock::now();
+  filter.update(20ms, now);
+  filter.update(30ms, now + 50ms);
+  filter.update(25ms, now + 60ms);
+  EXPECT_EQ(20ms, filter.getBest());
+  filter.update(40ms, now + 120ms);
+  EXPECT_EQ(25ms, filter.getBest());
+  filter.update(40ms, now + 200ms);
+  EXPECT_EQ(40ms, filter.getBest());
+}
+
+TEST(MonotonicWindowedFilterTest, SameTimeSamplesFold) {
+  WindowedMaxFilter<uint64_t, uint64_t, uint64_t, 4> filter(100, 0);
+  // More samples than the capacity, all in one round.
+  for (uint64_t i = 0; i < 10; i++) {
+    filter.update(10 - i, 0);
+  }
+  for (uint64_t i = 0; i < 3; i++) {
+    filter.update(1, i + 1);
+  }
+  EXPECT_EQ(10, filter.getBest());
+}
+
+TEST(MonotonicWindowedFilterTest, CapacityDropsOldest) {
+  WindowedMaxFilter<uint64_t, uint64_t, uint64_t, 4> filter(100, 0);
+  for (uint64_t i = 0; i < 4; i++) {
+    filter.update(10 - i, i);
+  }
+  EXPECT_EQ(10, filter.getBest());
+  filter.update(1, 4);
+  EXPECT_EQ(9, filter.getBest());
+}
+
+TEST(MonotonicWindowedFilterTest, MatchesBruteForce) {
+  constexpr uint64_t kWindow = 5;
+  WindowedMaxFilter<uint64_t, uint64_t, uint64_t> filter(kWindow, 0);
+  std::vector<std::pair<uint64_t, uint64_t>> samples;
+  uint64_t value = 12345;
+  for (uint64_t round = 0; round < 200; round++) {
+    for (int i = 0; i < 3; i++) {
+      value = value * 1103515245 + 12345;
+      auto sample = (value >> 16) % 1000;
+      filter.update(sample, round);
+      samples.emplace_back(sample, round);
+      uint64_t expected = 0;
+      for (const auto& [s, t] : samples) {
+        if (round - t <= kWindow) {
+          expected = std::max(expected, s);
+        }
+      }
+      ASSERT_EQ(expected, filter.getBest());
+    }
+  }
+}
+
+TEST(MonotonicWindowedFilterTest, UpdateBatch) {
+  WindowedMaxFilter<Bandwidth, uint64_t, uint64_t> filter(10, Bandwidth());
+  std::vector<uint64_t> bytes = {100, 400, 200, 0, 300};
+  auto toSample = [](uint64_t b) -> Optional<Bandwidth> {
+    if (b == 0) {
+      return none;
+    }
+    return Bandwidth(b, 1ms);
+  };
+  EXPECT_TRUE(filter.updateBatch(bytes.begin(), bytes.end(), 0, toSample));
+  EXPECT_EQ(Bandwidth(400, 1ms), filter.getBest());
+
+  std::vector<uint64_t> empty = {0, 0};
+  EXPECT_FALSE(filter.updateBatch(empty.begin(), empty.end(), 1, toSample));
+  EXPECT_EQ(Bandwidth(400, 1ms), filter.getBest());
+
+  bytes = {50, 60};
+  EXPECT_TRUE(filter.updateBatch(bytes.begin(), bytes.end(), 11, toSample));
+  EXPECT_EQ(Bandwidth(60, 1ms), filter.getBest());
+}
+
+TEST(MonotonicWindowedFilterTest, Reset) {
+  WindowedMaxFilter<uint64_t, uint64_t, uint64_t> filter(10, 0);
+  filter.update(100, 0);
+  filter.reset(5, 1);
+  EXPECT_EQ(5, filter.getBest());
+  filter.setWindowLength(1);
+  filter.update(3, 2);
+  filter.update(2, 3);
+  EXPECT_EQ(3, filter.getBest());
+}
+
+} // namespace quic::test
@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/congestion_control/test/NetworkEmulator.h>
+
+#include <folly/ScopeGuard.h>
+#include <quic/api/QuicTransportFunctions.h>
+#include <quic/common/test/TestUtils.h>
+#include <quic/congestion_control/CongestionControllerFactory.h>
+#include <quic/congestion_control/TokenlessPacer.h>
+#include <quic/fizz/server/handshake/FizzServerQuicHandshakeContext.h>
+#include <quic/loss/QuicLossFunctions.h>
+#include <quic/state/AckHandlers.h>
+#include <quic/state/QuicStateFunctions.h>
+
+#include <algorithm>
+
+namespace quic::test {
+
+namespace {
+
+constexpr std::chrono::microseconds kReceiverMaxAckDelay = 25ms;
+constexpr uint64_t kPacketsPerAck = 2;
+constexpr size_t kMaxAckBlocks = 32;
+
+std::chrono::microseconds percentile(
+    std::vector<std::chrono::nanoseconds>& samples,
+    size_t percent) {
+  if (samples.empty()) {
+    return 0us;
+  }
+  auto it = samples.begin() +
+      std::min(samples.size() - 1, samples.size() * percent / 100);
+  std::nth_element(samples.begin(), it, samples.end());
+  return std::chrono::duration_cast<std::chrono::microseconds>(*it);
+}
+
+} // namespace
+
+NetworkEmulator::NetworkEmulator(
+    CongestionControlType ccType,
+    EmulatedLinkConfig link,
+    uint64_t seed)
+    : link_(std::move(link)), rng_(seed) {
+  start_ = Clock::now();
+  now_ = start_;
+  measureStart_ = start_;
+  linkIdleTime_ = start_;
+  lossVisitor_ = [this](auto& conn, auto& packet, bool processed) {
+    if (measuring()) {
+      result_.packetsMarkedLost++;
+    }
+    markPacketLoss(conn, packet, processed);
+  };
+
+  conn_ = std::make_unique<QuicServerConnectionState>(
+      FizzServerQuicHandshakeContext::Builder().build());
+  auto& conn = *conn_;
+  conn.serverConnectionId = getTestConnectionId(0);
+  conn.clientConnectionId = getTestConnectionId(1);
+  conn.version = QuicVersion::MVFST;
+  // PTO probes are only sent once 1-RTT keys are available.
+  conn.oneRttWriteCipher = createNoOpAead();
+  conn.lossState.maxAckDelay = kReceiverMaxAckDelay;
+  conn.transportSettings.pacingEnabled = true;
+  conn.canBePaced = true;
+  bool usingBbr = ccType == CongestionControlType::BBR ||
+      ccType == CongestionControlType::BBRTesting ||
+      ccType == CongestionControlType::BBR2;
+  conn.pacer = std::make_unique<TokenlessPacer>(
+      conn,
+      usingBbr ? kMinCwndInMssForBbr : conn.transportSettings.minCwndInMss);
+  conn.congestionController =
+      DefaultCongestionControllerFactory().makeCongestionController(
+          conn, ccType);
+
+  if (link_.policer) {
+    auto config = *link_.policer;
+    config.maybeMaxDebtQueueSizeBytes = 0;
+    config.trackEmptyIntervals = false;
+    policer_.emplace(std::move(config));
+  }
+}
+
+NetworkEmulator::Result NetworkEmulator::run(
+    std::chrono::microseconds duration,
+    std::chrono::microseconds warmup) {
+  auto previousMockNow = std::move(MockClock::mockNow);
+  MockClock::mockNow = [this] { return now_; };
+  SCOPE_EXIT {
+    MockClock::mockNow = std::move(previousMockNow);
+  };
+  result_ = Result();
+  bytesDelivered_ = 0;
+  queueingDelays_.clear();
+  measureStart_ = now_ + warmup;
+  auto end = now_ + duration;
+  while (true) {
+    while (!events_.empty() && events_.begin()->first <= now_) {
+      auto event = std::move(events_.begin()->second);
+      events_.erase(events_.begin());
+      event();
+    }
+    if (lossTimeoutTime_ && *lossTimeoutTime_ <= now_) {
+      onLossTimeout();
+    }
+    writePackets();
+
+    auto next = end;
+    if (!events_.empty()) {
+      next = std::min(next, events_.begin()->first);
+    }
+    if (lossTimeoutTime_) {
+      next = std::min(next, *lossTimeoutTime_);
+    }
+    if (nextWriteTime_) {
+      next = std::min(next, *nextWriteTime_);
+    }
+    if (next >= end) {
+      break;
+    }
+    now_ = std::max(now_, next);
+  }
+  now_ = end;
+
+  auto measured = std::chrono::duration_cast<std::chrono::microseconds>(
+      end - std::max(measureStart_, start_));
+  if (measured > 0us) {
+    result_.goodputBytesPerSecond = bytesDelivered_ * 1000000 /
+        static_cast<uint64_t>(measured.count());
+  }
+  result_.p50QueueingDelay = percentile(queueingDelays_, 50);
+  result_.p99QueueingDelay = percentile(queueingDelays_, 99);
+  return result_;
+}
+
+void NetworkEmulator::schedule(TimePoint time, std::function<void()> event) {
+  events_.emplace(time, std::move(event));
+}
+
+void NetworkEmulator::writePackets() {
+  auto& conn = *conn_;
+  nextWriteTime_.reset();
+  // Probes go out regardless of the cwnd and the pacer, as in the transport.
+  auto& numProbePackets =
+      conn.pendingEvents.numProbePackets[PacketNumberSpace::AppData];
+  for (; numProbePackets > 0; numProbePackets--) {
+    sendPacket();
+  }
+  while (conn.congestionController->getWritableBytes() > 0) {
+    if (!isConnectionPaced(conn)) {
+      sendPacket();
+      continue;
+    }
+    auto delay = conn.pacer->getTimeUntilNextWrite(now_);
+    if (delay > 0us) {
+      nextWriteTime_ = now_ + delay;
+      break;
+    }
+    auto batchSize = conn.pacer->updateAndGetWriteBatchSize(now_);
+    if (batchSize == 0) {
+      nextWriteTime_ = now_ + conn.transportSettings.pacingTickInterval;
+      break;
+    }
+    for (; batchSize > 0 && conn.congestionController->getWritableBytes() > 0;
+         batchSize--) {
+      sendPacket();
+    }
+  }
+  setLossDetectionAlarm<LossTimeout, MockClock>(conn, lossTimeout_);
+}
+
+void NetworkEmulator::sendPacket() {
+  auto& conn = *conn_;
+  auto packetNum = getNextPacketNum(conn, PacketNumberSpace::AppData);
+  auto packet = createNewPacket(packetNum, PacketNumberSpace::AppData);
+  packet.frames.emplace_back(PingFrame());
+  auto size = static_cast<uint32_t>(conn.udpSendPacketLen);
+  updateConnection(
+      conn,
+      none,
+      std::move(packet),
+      now_,
+      size,
+      size,
+      false /* isDSRPacket */);
+  onPacketOnWire(packetNum, size);
+}
+
+void NetworkEmulator::onLossTimeout() {
+  lossTimeoutTime_.reset();
+  onLossDetectionAlarm<MockClock>(*conn_, lossVisitor_);
+}
+
+void NetworkEmulator::onAckReceived(const ReadAckFrame& ackFrame) {
+  processAckFrame(
+      *conn_,
+      PacketNumberSpace::AppData,
+      ackFrame,
+      [](const auto&) {},
+      [](const auto&, const auto&) {},
+      lossVisitor_,
+      now_);
+}
+
+void NetworkEmulator::onPacketOnWire(PacketNum packetNum, uint32_t size) {
+  if (measuring()) {
+    result_.packetsSent++;
+  }
+  bool dropped = dropOnWire() ||
+      (policer_ &&
+       policer_->consumeWithBorrowNonBlockingAndUpdateState(size, now_) == 0);
+  auto queueStart = std::max(now_, linkIdleTime_);
+  auto backlog =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(queueStart - now_);
+  auto queuedBytes = static_cast<uint64_t>(
+      backlog.count() * static_cast<double>(link_.bottleneckBytesPerSecond) /
+      1e9);
+  if (dropped || queuedBytes + size > link_.bufferBytes) {
+    if (measuring()) {
+      result_.packetsDropped++;
+    }
+    return;
+  }
+  if (measuring()) {
+    queueingDelays_.push_back(backlog);
+  }
+  linkIdleTime_ = queueStart +
+      std::chrono::nanoseconds(
+          uint64_t(size) * 1000000000 / link_.bottleneckBytesPerSecond);
+  schedule(linkIdleTime_ + link_.rtt / 2, [this, packetNum, size] {
+    onPacketReceived(packetNum, size);
+  });
+}
+
+bool NetworkEmulator::dropOnWire() {
+  if (inBurst_) {
+    inBurst_ = nextRandom() >= link_.burstEndProbability;
+  } else {
+    inBurst_ = nextRandom() < link_.burstStartProbability;
+  }
+  bool burstLoss = inBurst_ && nextRandom() < link_.burstLossRate;
+  bool randomLoss = nextRandom() < link_.randomLossRate;
+  return burstLoss || randomLoss;
+}
+
+double NetworkEmulator::nextRandom() {
+  // Uniform in [0, 1), the same on every standard library.
+  return static_cast<double>(rng_() >> 11) * 0x1.0p-53;
+}
+
+void NetworkEmulator::onPacketReceived(PacketNum packetNum, uint32_t size) {
+  if (measuring()) {
+    bytesDelivered_ += size;
+  }
+  bool outOfOrder = largestReceived_ && packetNum != *largestReceived_ + 1;
+  received_.insert(packetNum);
+  if (!largestReceived_ || packetNum > *largestReceived_) {
+    largestReceived_ = packetNum;
+    largestReceivedTime_ = now_;
+  }
+  if (++packetsSinceAck_ >= kPacketsPerAck || outOfOrder) {
+    sendAck();
+    return;
+  }
+  if (!ackTimerScheduled_) {
+    ackTimerScheduled_ = true;
+    schedule(now_ + kReceiverMaxAckDelay, [this, gen = ackGeneration_] {
+      if (gen == ackGeneration_) {
+        sendAck();
+      }
+    });
+  }
+}
+
+void NetworkEmulator::sendAck() {
+  packetsSinceAck_ = 0;
+  ackTimerScheduled_ = false;
+  ackGeneration_++;
+
+  ReadAckFrame ackFrame;
+  ackFrame.largestAcked = *largestReceived_;
+  ackFrame.ackDelay = std::chrono::duration_cast<std::chrono::microseconds>(
+      now_ - largestReceivedTime_);
+  for (auto it = received_.crbegin();
+       it != received_.crend() && ackFrame.ackBlocks.size() < kMaxAckBlocks;
+       ++it) {
+    ackFrame.ackBlocks.emplace_back(it->start, it->end);
+  }
+  // Older ranges would never be acked again.
+  while (received_.size() > kMaxAckBlocks) {
+    auto oldest = received_.front();
+    received_.withdraw(oldest);
+  }
+
+  auto arrival = now_ + link_.rtt / 2;
+  if (link_.ackAggregationInterval > 0us) {
+    auto interval = link_.ackAggregationInterval;
+    auto sinceStart = arrival - start_;
+    arrival = start_ + ((sinceStart + interval - 1ns) / interval) * interval;
+  }
+  schedule(arrival, [this, ackFrame = std::move(ackFrame)] {
+    onAckReceived(ackFrame);
+  });
+}
+
+void NetworkEmulator::LossTimeout::scheduleLossTimeout(
+    std::chrono::milliseconds timeout) {
+  emulator_.lossTimeoutTime_ = emulator_.now_ + timeout;
+}
+
+void NetworkEmulator::LossTimeout::cancelLossTimeout() {
+  emulator_.lossTimeoutTime_.reset();
+}
+
+bool NetworkEmulator::LossTimeout::isLossTimeoutScheduled() const {
+  return emulator_.lossTimeoutTime_.has_value();
+}
+
+} // namespace quic::test
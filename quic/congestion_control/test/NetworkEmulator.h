@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <quic/QuicConstants.h>
+#include <quic/common/IntervalSet.h>
+#include <quic/common/Optional.h>
+#include <quic/congestion_control/SimulatedTBF.h>
+#include <quic/server/state/ServerStateMachine.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace quic::test {
+
+/**
+ * A path with a single bottleneck link. The sender's packets go through the
+ * random and bursty loss models, then the policer, then the drop-tail queue
+ * in front of the bottleneck. ACKs come back without loss.
+ */
+struct EmulatedLinkConfig {
+  uint64_t bottleneckBytesPerSecond{1250000};
+  // Propagation delay, split evenly between the two directions.
+  std::chrono::microseconds rtt{40ms};
+  uint64_t bufferBytes{50000};
+
+  // Chance that any packet is dropped.
+  double randomLossRate{0};
+
+  // Gilbert-Elliott bursty loss: each packet moves the link into the bad
+  // state with burstStartProbability, and back out of it with
+  // burstEndProbability. Packets are dropped with burstLossRate while bad.
+  double burstStartProbability{0};
+  double burstEndProbability{1};
+  double burstLossRate{0};
+
+  // When set, ACKs are held and released together at the end of each
+  // interval, as on WiFi and cellular links.
+  std::chrono::microseconds ackAggregationInterval{0us};
+
+  // Packets that find the bucket empty are dropped. The burst size must be
+  // at least one packet.
+  Optional<SimulatedTBF::Config> policer;
+};
+
+/**
+ * Runs a real congestion controller, pacer and loss detection against an
+ * EmulatedLinkConfig in virtual time, so that a run is fast and a seed always
+ * gives the same result.
+ *
+ * The sender always has data. It sends PING-only packets of udpSendPacketLen
+ * through updateConnection() whenever the controller and the pacer allow, and
+ * handles ACKs with processAckFrame(). The receiver acks every other packet,
+ * right away when packets arrive out of order, and otherwise after the max ack
+ * delay. Everything that reads the clock goes through MockClock, which the
+ * emulator points at its virtual time while it runs.
+ */
+class NetworkEmulator {
+ public:
+  struct Result {
+    // Bytes delivered to the receiver per second.
+    uint64_t goodputBytesPerSecond{0};
+    // Time spent in the bottleneck queue, over the packets that entered it.
+    std::chrono::microseconds p50QueueingDelay{0us};
+    std::chrono::microseconds p99QueueingDelay{0us};
+    uint64_t packetsSent{0};
+    // Dropped by the loss models, the policer or the full queue.
+    uint64_t packetsDropped{0};
+    // Declared lost by the sender.
+    uint64_t packetsMarkedLost{0};
+
+    [[nodiscard]] double lossRate() const {
+      return packetsSent ? double(packetsDropped) / double(packetsSent) : 0;
+    }
+  };
+
+  NetworkEmulator(
+      CongestionControlType ccType,
+      EmulatedLinkConfig link,
+      uint64_t seed = 1);
+
+  /**
+   * Runs for duration of virtual time. Only what happens after warmup counts
+   * towards the result.
+   */
+  Result run(
+      std::chrono::microseconds duration,
+      std::chrono::microseconds warmup = 0us);
+
+  [[nodiscard]] const QuicServerConnectionState& getConn() const {
+    return *conn_;
+  }
+
+ private:
+  // The loss timer that setLossDetectionAlarm() arms.
+  class LossTimeout {
+   public:
+    explicit LossTimeout(NetworkEmulator& emulator) : emulator_(emulator) {}
+
+    void scheduleLossTimeout(std::chrono::milliseconds timeout);
+    void cancelLossTimeout();
+    [[nodiscard]] bool isLossTimeoutScheduled() const;
+
+   private:
+    NetworkEmulator& emulator_;
+  };
+
+  void schedule(TimePoint time, std::function<void()> event);
+
+  // Sender.
+  void writePackets();
+  void sendPacket();
+  void onLossTimeout();
+  void onAckReceived(const ReadAckFrame& ackFrame);
+
+  // Link.
+  void onPacketOnWire(PacketNum packetNum, uint32_t size);
+  bool dropOnWire();
+  double nextRandom();
+
+  // Receiver.
+  void onPacketReceived(PacketNum packetNum, uint32_t size);
+  void sendAck();
+
+  [[nodiscard]] bool measuring() const {
+    return now_ >= measureStart_;
+  }
+
+  EmulatedLinkConfig link_;
+  std::unique_ptr<QuicServerConnectionState> conn_;
+  LossTimeout lossTimeout_{*this};
+  // markPacketLoss(), counting the packets declared lost.
+  LossVisitor lossVisitor_;
+
+  TimePoint start_;
+  TimePoint now_;
+  TimePoint measureStart_;
+  // Events at the same time run in the order they were scheduled.
+  std::multimap<TimePoint, std::function<void()>> events_;
+  Optional<TimePoint> lossTimeoutTime_;
+  Optional<TimePoint> nextWriteTime_;
+
+  std::mt19937_64 rng_;
+  Optional<SimulatedTBF> policer_;
+  bool inBurst_{false};
+  // When the bottleneck is done with the packets queued so far.
+  TimePoint linkIdleTime_;
+  std::vector<std::chrono::nanoseconds> queueingDelays_;
+
+  IntervalSet<PacketNum> received_;
+  Optional<PacketNum> largestReceived_;
+  TimePoint largestReceivedTime_;
+  uint64_t packetsSinceAck_{0};
+  // Bumped on every ACK, to cancel the pending ack timer.
+  uint64_t ackGeneration_{0};
+  bool ackTimerScheduled_{false};
+
+  Result result_;
+  uint64_t bytesDelivered_{0};
+};
+
+} // namespace quic::test
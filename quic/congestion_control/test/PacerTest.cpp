@@ -355,6 +355,7 @@ TEST_F(TokenlessPacerTest, SetMaxPacingRateOnUnlimitedPacer) {
   EXPECT_EQ(0us, pacer.getTimeUntilNextWrite(timestamp));
   EXPECT_NE(0, pacer.updateAndGetWriteBatchSize(timestamp));
   EXPECT_EQ(0us, pacer.getTimeUntilNextWrite(timestamp));
+  EXPECT_EQ(0, pacer.getPacingRateBytesPerSec());
 
   // Set max pacing rate 40 Mbps and ensure it took effect
   pacer.setMaxPacingRate(5 * 1000 * 1000u); // Bytes per second
@@ -364,6 +365,7 @@ TEST_F(TokenlessPacerTest, SetMaxPacingRateOnUnlimitedPacer) {
   uint64_t pacerRate =
       burst * kDefaultUDPSendPacketLen * std::chrono::seconds{1} / interval;
   EXPECT_NEAR(5 * 1000 * 1000u, pacerRate, 1000); // To accommodate rounding
+  EXPECT_NEAR(pacerRate, pacer.getPacingRateBytesPerSec(), 1000);
 }
 
 TEST_F(TokenlessPacerTest, SetZeroPacingRate) {
@@ -419,4 +421,90 @@ TEST_F(TokenlessPacerTest, RefreshPacingRateWhenRTTIsDefault) {
   EXPECT_EQ(tick, pacer.getTimeUntilNextWrite(timestamp));
 }
 
+TEST_F(TokenlessPacerTest, TxTimeSchedule) {
+  pacer.setPacingRateCalculator([](const QuicConnectionStateBase&,
+                                   uint64_t,
+                                   uint64_t,
+                                   std::chrono::microseconds) {
+    return PacingRate::Builder().setInterval(1000us).setBurstSize(10).build();
+  });
+  auto currentTime = Clock::now();
+  pacer.refreshPacingRate(20, 100us); // These two values do not matter here
+  auto schedule = pacer.updateAndGetTxTimeSchedule(currentTime, 4000us);
+  EXPECT_EQ(0us, schedule.startOffset);
+  EXPECT_EQ(10, schedule.firstBurstSize);
+  EXPECT_EQ(10, schedule.burstSize);
+  EXPECT_EQ(4, schedule.numLaterBursts);
+  EXPECT_EQ(1000us, schedule.interval);
+  EXPECT_EQ(50, schedule.packetLimit());
+  EXPECT_EQ(0us, schedule.departureOffset(9));
+  EXPECT_EQ(1000us, schedule.departureOffset(10));
+  EXPECT_EQ(4000us, schedule.departureOffset(49));
+  // Probes beyond the limit leave with the last burst.
+  EXPECT_EQ(4000us, schedule.departureOffset(60));
+  // The next write is due one interval after the last burst departs.
+  EXPECT_EQ(5000us, pacer.getTimeUntilNextWrite(currentTime));
+
+  // An ack resets the pacer, but the bursts still queued in the qdisc keep
+  // the next write from overlapping them.
+  pacer.refreshPacingRate(20, 100us);
+  schedule = pacer.updateAndGetTxTimeSchedule(currentTime + 1000us, 4000us);
+  EXPECT_EQ(0, schedule.packetLimit());
+  EXPECT_EQ(4000us, pacer.getTimeUntilNextWrite(currentTime + 1000us));
+
+  pacer.refreshPacingRate(20, 100us);
+  schedule = pacer.updateAndGetTxTimeSchedule(currentTime + 3000us, 4000us);
+  EXPECT_EQ(2000us, schedule.startOffset);
+  EXPECT_EQ(2, schedule.numLaterBursts);
+  EXPECT_EQ(30, schedule.packetLimit());
+  EXPECT_EQ(2000us, schedule.departureOffset(0));
+  EXPECT_EQ(4000us, schedule.departureOffset(29));
+  EXPECT_EQ(5000us, pacer.getTimeUntilNextWrite(currentTime + 3000us));
+}
+
+TEST_F(TokenlessPacerTest, TxTimeSchedulePartiallyUsed) {
+  pacer.setPacingRateCalculator([](const QuicConnectionStateBase&,
+                                   uint64_t,
+                                   uint64_t,
+                                   std::chrono::microseconds) {
+    return PacingRate::Builder().setInterval(1000us).setBurstSize(10).build();
+  });
+  auto currentTime = Clock::now();
+  pacer.refreshPacingRate(20, 100us); // These two values do not matter here
+  auto schedule = pacer.updateAndGetTxTimeSchedule(currentTime, 4000us);
+  EXPECT_EQ(50, schedule.packetLimit());
+  // The write ran out of data halfway through the third burst.
+  schedule.packetsScheduled = 25;
+  pacer.onTxTimeScheduleWritten(schedule);
+  EXPECT_EQ(3000us, pacer.getTimeUntilNextWrite(currentTime));
+
+  // New bursts queue behind the last packet actually written.
+  pacer.refreshPacingRate(20, 100us);
+  schedule = pacer.updateAndGetTxTimeSchedule(currentTime + 1000us, 4000us);
+  EXPECT_EQ(2000us, schedule.startOffset);
+  EXPECT_EQ(30, schedule.packetLimit());
+
+  // Nothing was written, so only the earlier packets are in the qdisc.
+  schedule.packetsScheduled = 0;
+  pacer.onTxTimeScheduleWritten(schedule);
+  EXPECT_EQ(2000us, pacer.getTimeUntilNextWrite(currentTime + 1000us));
+  schedule = pacer.updateAndGetTxTimeSchedule(currentTime + 4000us, 4000us);
+  EXPECT_EQ(0us, schedule.startOffset);
+  EXPECT_EQ(50, schedule.packetLimit());
+  schedule.packetsScheduled = 0;
+  pacer.onTxTimeScheduleWritten(schedule);
+  EXPECT_EQ(1000us, pacer.getTimeUntilNextWrite(currentTime + 4000us));
+}
+
+TEST_F(TokenlessPacerTest, TxTimeScheduleUnpaced) {
+  // Without a pacing rate everything leaves right away.
+  auto schedule = pacer.updateAndGetTxTimeSchedule(Clock::now(), 4000us);
+  EXPECT_EQ(
+      conn.transportSettings.writeConnectionDataPacketsLimit,
+      schedule.packetLimit());
+  EXPECT_EQ(0, schedule.numLaterBursts);
+  EXPECT_EQ(0us, schedule.departureOffset(0));
+  EXPECT_EQ(0us, pacer.getTimeUntilNextWrite());
+}
+
 } // namespace quic::test
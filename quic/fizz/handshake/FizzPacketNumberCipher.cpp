@@ -42,6 +42,29 @@ static HeaderProtectionMask maskImpl(
   return outMask;
 }
 
+// The samples are encrypted as the blocks of one ECB input, which lets
+// OpenSSL pipeline the AES rounds of several samples.
+static void masksImpl(
+    const folly::ssl::EvpCipherCtxUniquePtr& context,
+    folly::Range<const Sample*> samples,
+    HeaderProtectionMask* out) {
+  static_assert(sizeof(Sample) == 16 && sizeof(HeaderProtectionMask) == 16);
+  if (samples.empty()) {
+    return;
+  }
+  int inLen = static_cast<int>(samples.size() * sizeof(Sample));
+  int outLen = 0;
+  if (EVP_EncryptUpdate(
+          context.get(),
+          out->data(),
+          &outLen,
+          samples.data()->data(),
+          inLen) != 1 ||
+      outLen != inLen) {
+    throw std::runtime_error("Encryption error");
+  }
+}
+
 void Aes128PacketNumberCipher::setKey(folly::ByteRange key) {
   pnKey_ = folly::IOBuf::copyBuffer(key);
   return setKeyImpl(encryptCtx_, EVP_aes_128_ecb(), key);
@@ -70,6 +93,18 @@ HeaderProtectionMask Aes256PacketNumberCipher::mask(
   return maskImpl(encryptCtx_, sample);
 }
 
+void Aes128PacketNumberCipher::masks(
+    folly::Range<const Sample*> samples,
+    HeaderProtectionMask* out) const {
+  masksImpl(encryptCtx_, samples, out);
+}
+
+void Aes256PacketNumberCipher::masks(
+    folly::Range<const Sample*> samples,
+    HeaderProtectionMask* out) const {
+  masksImpl(encryptCtx_, samples, out);
+}
+
 constexpr size_t kAES128KeyLength = 16;
 
 size_t Aes128PacketNumberCipher::keyLength() const {
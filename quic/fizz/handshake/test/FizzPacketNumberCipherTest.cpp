@@ -88,6 +88,52 @@ TEST_P(LongPacketNumberCipherTest, TestEncryptDecrypt) {
       GetParam().decryptedPacketNumberBytes);
 }
 
+TEST_P(LongPacketNumberCipherTest, TestEncryptHeadersBatch) {
+  FizzCryptoFactory cryptoFactory;
+  auto cipher = cryptoFactory.makePacketNumberCipher(GetParam().cipher);
+  auto key = folly::unhexlify(GetParam().key);
+  cipher->setKey(folly::range(key));
+  // Spans more than one masks() call.
+  constexpr size_t kNumHeaders = PacketNumberCipher::kMaxHeaderProtectionBatch;
+  std::vector<CipherBytes> headerBytes(
+      kNumHeaders + 3,
+      CipherBytes(
+          GetParam().sample,
+          GetParam().decryptedInitialByte,
+          GetParam().decryptedPacketNumberBytes));
+  std::vector<PendingHeaderProtection> headers;
+  for (auto& bytes : headerBytes) {
+    PendingHeaderProtection header;
+    header.sample = bytes.sample;
+    header.initialByte = folly::range(bytes.initial);
+    header.packetNumberBytes = folly::range(bytes.packetNumber);
+    header.longHeader = true;
+    headers.push_back(header);
+  }
+  cipher->encryptHeaders(folly::range(headers));
+  for (const auto& bytes : headerBytes) {
+    EXPECT_EQ(folly::hexlify(bytes.initial), GetParam().initialByte);
+    EXPECT_EQ(
+        folly::hexlify(bytes.packetNumber), GetParam().packetNumberBytes);
+  }
+}
+
+TEST_P(LongPacketNumberCipherTest, TestMasksMatchMask) {
+  FizzCryptoFactory cryptoFactory;
+  auto cipher = cryptoFactory.makePacketNumberCipher(GetParam().cipher);
+  auto key = folly::unhexlify(GetParam().key);
+  cipher->setKey(folly::range(key));
+  std::vector<Sample> samples(20);
+  for (size_t i = 0; i < samples.size(); i++) {
+    samples[i].fill(static_cast<uint8_t>(i));
+  }
+  std::vector<HeaderProtectionMask> masks(samples.size());
+  cipher->masks(folly::range(samples), masks.data());
+  for (size_t i = 0; i < samples.size(); i++) {
+    EXPECT_EQ(masks[i], cipher->mask(folly::range(samples[i])));
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(
     LongPacketNumberCipherTests,
     LongPacketNumberCipherTest,
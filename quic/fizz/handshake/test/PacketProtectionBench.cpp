@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/Benchmark.h>
+#include <gflags/gflags.h>
+#include <quic/codec/Types.h>
+#include <quic/fizz/handshake/FizzCryptoFactory.h>
+
+#include <cstring>
+
+/**
+ * Protects packets the way the write loop does: encrypts the payload with the
+ * AEAD, then protects the header either right away, one mask per packet, or
+ * for a whole batch with one PacketNumberCipher::encryptHeaders() call. One
+ * iteration protects one packet, so iters/s is the packets per second
+ * protected on a core.
+ */
+
+using namespace quic;
+
+namespace {
+
+// Short header with an 8 byte connection id and a 4 byte packet number.
+constexpr size_t kHeaderLen = 1 + kDefaultConnectionIdSize + 4;
+constexpr size_t kBodyLen = 1200;
+
+void packetProtectionBench(size_t iters, size_t batchSize) {
+  folly::BenchmarkSuspender suspender;
+  FizzCryptoFactory cryptoFactory;
+  auto connId = ConnectionId::createRandom(kDefaultConnectionIdSize);
+  auto aead = cryptoFactory.getClientInitialCipher(connId, QuicVersion::MVFST);
+  auto headerCipher =
+      cryptoFactory.makeClientInitialHeaderCipher(connId, QuicVersion::MVFST);
+  auto cipherOverhead = aead->getCipherOverhead();
+  // The payload of each packet, with its header in the headroom.
+  std::vector<std::unique_ptr<folly::IOBuf>> packets;
+  for (size_t i = 0; i < batchSize; i++) {
+    auto packet = folly::IOBuf::create(kHeaderLen + kBodyLen + cipherOverhead);
+    memset(packet->writableData(), 0, packet->capacity());
+    packet->advance(kHeaderLen);
+    packet->append(kBodyLen);
+    packets.push_back(std::move(packet));
+  }
+  std::vector<PendingHeaderProtection> headers(batchSize);
+  PacketNum packetNum = 0;
+  suspender.dismiss();
+
+  size_t numProtected = 0;
+  while (numProtected < iters) {
+    auto numPackets = std::min(batchSize, iters - numProtected);
+    for (size_t i = 0; i < numPackets; i++) {
+      auto& packet = packets[i];
+      uint8_t* header = packet->writableData() - kHeaderLen;
+      header[0] = ShortHeader::kFixedBitMask | ShortHeader::kPacketNumLenMask;
+      auto associatedData = folly::IOBuf::wrapBufferAsValue(header, kHeaderLen);
+      packet =
+          aead->inplaceEncrypt(std::move(packet), &associatedData, packetNum++);
+      auto& pending = headers[i];
+      // With a 4 byte packet number the sample starts at the payload.
+      memcpy(pending.sample.data(), packet->data(), pending.sample.size());
+      pending.initialByte = folly::MutableByteRange(header, 1);
+      pending.packetNumberBytes =
+          folly::MutableByteRange(header + kHeaderLen - 4, 4);
+      if (batchSize == 1) {
+        headerCipher->encryptShortHeader(
+            pending.sample, pending.initialByte, pending.packetNumberBytes);
+      }
+      // Encrypt the same bytes again next time around.
+      packet->trimEnd(cipherOverhead);
+    }
+    if (batchSize > 1) {
+      headerCipher->encryptHeaders(
+          folly::Range<PendingHeaderProtection*>(headers.data(), numPackets));
+    }
+    numProtected += numPackets;
+  }
+  folly::doNotOptimizeAway(packets.front()->data());
+}
+
+} // namespace
+
+BENCHMARK_PARAM(packetProtectionBench, 1)
+BENCHMARK_RELATIVE_PARAM(packetProtectionBench, 16)
+BENCHMARK_RELATIVE_PARAM(packetProtectionBench, 64)
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
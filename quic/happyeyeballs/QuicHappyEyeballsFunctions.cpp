@@ -183,6 +183,11 @@ void happyEyeballsSetUpSocket(
   // never fragment, always turn off PMTU
   socket.setDFAndTurnOffPMTU();
 
+  if (transportSettings.pacingEnabled && transportSettings.txTimePacing &&
+      !socket.enableTxTime()) {
+    VLOG(4) << "SO_TXTIME is not supported on this socket";
+  }
+
   if (transportSettings.enableSocketErrMsgCallback) {
     socket.setErrMessageCallback(errMsgCallback);
   }
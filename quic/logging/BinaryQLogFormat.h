@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+namespace quic {
+
+/**
+ * On-disk layout of binary qlog files written by BinaryQLogSink.
+ *
+ * A file is a BinaryQLogFileHeader followed by a sequence of fixed-size
+ * BinaryQLogRecords in host byte order. Every logged event is one record,
+ * optionally followed by numExtra records that carry its variable-length
+ * parts: frames of a packet, ack ranges and string chunks. The records of one
+ * event are always written contiguously, but events of different connections
+ * are interleaved, so readers demultiplex them by connId.
+ */
+
+constexpr std::array<char, 8> kBinaryQLogMagic = {
+    'M', 'V', 'Q', 'L', 'O', 'G', '\0', '\0'};
+constexpr uint32_t kBinaryQLogVersion = 1;
+
+struct BinaryQLogFileHeader {
+  std::array<char, 8> magic;
+  uint32_t version;
+  uint32_t recordSize;
+};
+
+enum class BinaryQLogRecordType : uint16_t {
+  // Connection metadata.
+  ConnectionStart,
+  Dcid,
+  Scid,
+  // Events, one per QLogger::add* method.
+  PacketReceived,
+  PacketSent,
+  VersionNegotiation,
+  Retry,
+  ConnectionClose,
+  TransportSummary,
+  CongestionMetricUpdate,
+  BandwidthEstUpdate,
+  AppLimitedUpdate,
+  PacingMetricUpdate,
+  PacingObservation,
+  AppIdleUpdate,
+  PacketDrop,
+  DatagramReceived,
+  LossAlarm,
+  PacketsLost,
+  TransportStateUpdate,
+  PacketBuffered,
+  MetricUpdate,
+  StreamStateUpdate,
+  ConnectionMigration,
+  PathValidation,
+  PriorityUpdate,
+  L4sWeightUpdate,
+  NetworkPathModelUpdate,
+  // Extra records that follow an event.
+  MoreFields,
+  Frame,
+  AckRanges,
+  StringChunk,
+  Versions,
+};
+
+enum class BinaryQLogFrameType : uint32_t {
+  Padding,
+  RstStream,
+  ConnectionClose,
+  MaxData,
+  MaxStreamData,
+  MaxStreams,
+  StreamsBlocked,
+  Ping,
+  DataBlocked,
+  NewToken,
+  Knob,
+  AckFrequency,
+  ImmediateAck,
+  StreamDataBlocked,
+  Ack,
+  Stream,
+  Crypto,
+  StopSending,
+  PathChallenge,
+  PathResponse,
+  NewConnectionId,
+  RetireConnectionId,
+  ReadNewToken,
+  HandshakeDone,
+  Datagram,
+};
+
+// Packet type codes stored in packet records. Long header packets use their
+// LongHeader::Types value.
+constexpr uint32_t kBinaryQLogShortHeaderPacket = 0xff;
+
+struct BinaryQLogRecord {
+  static constexpr size_t kNumFields = 5;
+  static constexpr size_t kMaxBytes = kNumFields * sizeof(uint64_t);
+
+  // Identifies the connection within the file, assigned by the sink.
+  uint64_t connId;
+  // steady_clock time in microseconds, the same as QLogEvent::refTime.
+  uint64_t refTime;
+  BinaryQLogRecordType type;
+  // Number of extra records following this one that belong to the event.
+  uint16_t numExtra;
+  // Small per-type field, e.g. a flag, a frame type or a chunk length.
+  uint32_t small;
+  // Per-type fields. String chunks and connection ids store raw bytes here.
+  std::array<uint64_t, kNumFields> fields;
+};
+
+static_assert(sizeof(BinaryQLogRecord) == 64, "Records must stay compact");
+static_assert(
+    std::is_trivially_copyable_v<BinaryQLogRecord>,
+    "Records are copied with memcpy");
+
+// Bounds that keep each event to a few records.
+constexpr size_t kMaxBinaryQLogRecordsPerEvent = 64;
+// A string is a run of StringChunk records that ends with the first chunk
+// shorter than BinaryQLogRecord::kMaxBytes.
+constexpr size_t kMaxBinaryQLogStringLen = 4 * BinaryQLogRecord::kMaxBytes - 1;
+constexpr size_t kMaxBinaryQLogAckRanges = 32;
+constexpr size_t kMaxBinaryQLogVersions = 2 * BinaryQLogRecord::kNumFields;
+
+} // namespace quic
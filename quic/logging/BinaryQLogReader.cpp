@@ -0,0 +1,485 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/logging/BinaryQLogReader.h>
+
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <folly/container/F14Map.h>
+#include <folly/lang/Bits.h>
+#include <quic/logging/BinaryQLogFormat.h>
+
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+using quic::BinaryQLogFrameType;
+using quic::BinaryQLogRecord;
+using quic::BinaryQLogRecordType;
+
+/**
+ * Walks the extra records of one event.
+ */
+class ExtraRecords {
+ public:
+  ExtraRecords(const BinaryQLogRecord* begin, const BinaryQLogRecord* end)
+      : next_(begin), end_(end) {}
+
+  // Returns the next record if it has the given type, and consumes it.
+  const BinaryQLogRecord* next(BinaryQLogRecordType type) {
+    if (next_ == end_ || next_->type != type) {
+      return nullptr;
+    }
+    return next_++;
+  }
+
+  const BinaryQLogRecord* nextFrame() {
+    // Skip anything a newer writer added that this reader does not know.
+    while (next_ != end_ && next_->type != BinaryQLogRecordType::Frame) {
+      next_++;
+    }
+    return next(BinaryQLogRecordType::Frame);
+  }
+
+  std::string nextString() {
+    std::string str;
+    while (auto chunk = next(BinaryQLogRecordType::StringChunk)) {
+      auto len = std::min<size_t>(chunk->small, BinaryQLogRecord::kMaxBytes);
+      str.append(reinterpret_cast<const char*>(chunk->fields.data()), len);
+      if (len < BinaryQLogRecord::kMaxBytes) {
+        break;
+      }
+    }
+    return str;
+  }
+
+  // Returns the next field stored in MoreFields records, or 0 if there is
+  // none.
+  uint64_t nextField() {
+    if (fieldIdx_ == BinaryQLogRecord::kNumFields || !fields_) {
+      fields_ = next(BinaryQLogRecordType::MoreFields);
+      fieldIdx_ = 0;
+      if (!fields_) {
+        return 0;
+      }
+    }
+    return fields_->fields[fieldIdx_++];
+  }
+
+ private:
+  const BinaryQLogRecord* next_;
+  const BinaryQLogRecord* end_;
+  const BinaryQLogRecord* fields_{nullptr};
+  size_t fieldIdx_{0};
+};
+
+std::string packetTypeString(uint32_t code) {
+  if (code == quic::kBinaryQLogShortHeaderPacket) {
+    return quic::kShortHeaderPacketType.str();
+  }
+  return quic::toQlogString(static_cast<quic::LongHeader::Types>(code)).str();
+}
+
+quic::QuicErrorCode toQuicErrorCode(uint64_t type, uint64_t value) {
+  switch (static_cast<quic::QuicErrorCode::Type>(type)) {
+    case quic::QuicErrorCode::Type::LocalErrorCode:
+      return quic::QuicErrorCode(static_cast<quic::LocalErrorCode>(value));
+    case quic::QuicErrorCode::Type::TransportErrorCode:
+      return quic::QuicErrorCode(static_cast<quic::TransportErrorCode>(value));
+    case quic::QuicErrorCode::Type::ApplicationErrorCode:
+    default:
+      return quic::QuicErrorCode(
+          static_cast<quic::ApplicationErrorCode>(value));
+  }
+}
+
+std::unique_ptr<quic::QLogFrame> readAckFrame(
+    const BinaryQLogRecord& frame,
+    ExtraRecords& extras) {
+  quic::ReadAckFrame::Vec ackBlocks;
+  while (auto ranges = extras.next(BinaryQLogRecordType::AckRanges)) {
+    for (size_t i = 0; i < ranges->small && i < 2; i++) {
+      ackBlocks.emplace_back(ranges->fields[2 * i], ranges->fields[2 * i + 1]);
+    }
+  }
+  return std::make_unique<quic::ReadAckFrameLog>(
+      ackBlocks,
+      std::chrono::microseconds(frame.fields[0]),
+      static_cast<quic::FrameType>(frame.fields[1]),
+      std::nullopt,
+      std::nullopt,
+      quic::RecvdPacketsTimestampsRangeVec(),
+      frame.fields[2],
+      frame.fields[3],
+      frame.fields[4]);
+}
+
+std::unique_ptr<quic::QLogFrame> readFrame(
+    const BinaryQLogRecord& frame,
+    ExtraRecords& extras) {
+  const auto& f = frame.fields;
+  switch (static_cast<BinaryQLogFrameType>(frame.small)) {
+    case BinaryQLogFrameType::Padding:
+      return std::make_unique<quic::PaddingFrameLog>(f[0]);
+    case BinaryQLogFrameType::RstStream:
+      return std::make_unique<quic::RstStreamFrameLog>(f[0], f[1], f[2]);
+    case BinaryQLogFrameType::ConnectionClose:
+      return std::make_unique<quic::ConnectionCloseFrameLog>(
+          toQuicErrorCode(f[0], f[1]),
+          extras.nextString(),
+          static_cast<quic::FrameType>(f[2]));
+    case BinaryQLogFrameType::MaxData:
+      return std::make_unique<quic::MaxDataFrameLog>(f[0]);
+    case BinaryQLogFrameType::MaxStreamData:
+      return std::make_unique<quic::MaxStreamDataFrameLog>(f[0], f[1]);
+    case BinaryQLogFrameType::MaxStreams:
+      return std::make_unique<quic::MaxStreamsFrameLog>(f[0], f[1] != 0);
+    case BinaryQLogFrameType::StreamsBlocked:
+      return std::make_unique<quic::StreamsBlockedFrameLog>(f[0], f[1] != 0);
+    case BinaryQLogFrameType::Ping:
+      return std::make_unique<quic::PingFrameLog>();
+    case BinaryQLogFrameType::DataBlocked:
+      return std::make_unique<quic::DataBlockedFrameLog>(f[0]);
+    case BinaryQLogFrameType::NewToken:
+      return std::make_unique<quic::NewTokenFrameLog>(
+          folly::hexlify(extras.nextString()));
+    case BinaryQLogFrameType::Knob:
+      return std::make_unique<quic::KnobFrameLog>(f[0], f[1], f[2]);
+    case BinaryQLogFrameType::AckFrequency:
+      return std::make_unique<quic::AckFrequencyFrameLog>(
+          f[0], f[1], f[2], f[3]);
+    case BinaryQLogFrameType::ImmediateAck:
+      return std::make_unique<quic::ImmediateAckFrameLog>();
+    case BinaryQLogFrameType::StreamDataBlocked:
+      return std::make_unique<quic::StreamDataBlockedFrameLog>(f[0], f[1]);
+    case BinaryQLogFrameType::Ack:
+      return readAckFrame(frame, extras);
+    case BinaryQLogFrameType::Stream:
+      return std::make_unique<quic::StreamFrameLog>(f[0], f[1], f[2], f[3]);
+    case BinaryQLogFrameType::Crypto:
+      return std::make_unique<quic::CryptoFrameLog>(f[0], f[1]);
+    case BinaryQLogFrameType::StopSending:
+      return std::make_unique<quic::StopSendingFrameLog>(f[0], f[1]);
+    case BinaryQLogFrameType::PathChallenge:
+      return std::make_unique<quic::PathChallengeFrameLog>(f[0]);
+    case BinaryQLogFrameType::PathResponse:
+      return std::make_unique<quic::PathResponseFrameLog>(f[0]);
+    case BinaryQLogFrameType::NewConnectionId: {
+      quic::StatelessResetToken token;
+      std::memcpy(token.data(), &f[1], token.size());
+      return std::make_unique<quic::NewConnectionIdFrameLog>(f[0], token);
+    }
+    case BinaryQLogFrameType::RetireConnectionId:
+      return std::make_unique<quic::RetireConnectionIdFrameLog>(f[0]);
+    case BinaryQLogFrameType::ReadNewToken:
+      return std::make_unique<quic::ReadNewTokenFrameLog>();
+    case BinaryQLogFrameType::HandshakeDone:
+      return std::make_unique<quic::HandshakeDoneFrameLog>();
+    case BinaryQLogFrameType::Datagram:
+      return std::make_unique<quic::DatagramFrameLog>(f[0]);
+  }
+  return nullptr;
+}
+
+std::unique_ptr<quic::QLogEvent> readPacketEvent(
+    const BinaryQLogRecord& record,
+    ExtraRecords& extras) {
+  auto event = std::make_unique<quic::QLogPacketEvent>();
+  event->eventType = record.type == BinaryQLogRecordType::PacketSent
+      ? quic::QLogEventType::PacketSent
+      : quic::QLogEventType::PacketReceived;
+  event->packetType = packetTypeString(record.small);
+  event->packetNum = record.fields[0];
+  event->packetSize = record.fields[1];
+  while (auto frame = extras.nextFrame()) {
+    if (auto frameLog = readFrame(*frame, extras)) {
+      event->frames.push_back(std::move(frameLog));
+    }
+  }
+  return event;
+}
+
+/**
+ * Rebuilds the QLogEvent for an event record. Returns nullptr for records that
+ * are not events.
+ */
+std::unique_ptr<quic::QLogEvent> readEvent(
+    const quic::FileQLogger& logger,
+    const BinaryQLogRecord& record,
+    ExtraRecords& extras) {
+  const auto& f = record.fields;
+  std::chrono::microseconds refTime(record.refTime);
+  std::unique_ptr<quic::QLogEvent> event;
+  switch (record.type) {
+    case BinaryQLogRecordType::PacketReceived:
+    case BinaryQLogRecordType::PacketSent:
+      event = readPacketEvent(record, extras);
+      break;
+    case BinaryQLogRecordType::VersionNegotiation: {
+      auto vnEvent = std::make_unique<quic::QLogVersionNegotiationEvent>();
+      vnEvent->eventType = record.small ? quic::QLogEventType::PacketReceived
+                                        : quic::QLogEventType::PacketSent;
+      vnEvent->packetType = quic::kVersionNegotiationPacketType;
+      vnEvent->packetSize = f[0];
+      std::vector<quic::QuicVersion> versions;
+      if (auto packed = extras.next(BinaryQLogRecordType::Versions)) {
+        auto numVersions =
+            std::min<size_t>(packed->small, quic::kMaxBinaryQLogVersions);
+        for (size_t i = 0; i < numVersions; i++) {
+          versions.push_back(static_cast<quic::QuicVersion>(
+              packed->fields[i / 2] >> (32 * (i % 2))));
+        }
+      }
+      vnEvent->versionLog =
+          std::make_unique<quic::VersionNegotiationLog>(versions);
+      event = std::move(vnEvent);
+      break;
+    }
+    case BinaryQLogRecordType::Retry: {
+      auto retryEvent = std::make_unique<quic::QLogRetryEvent>();
+      retryEvent->eventType = record.small
+          ? quic::QLogEventType::PacketReceived
+          : quic::QLogEventType::PacketSent;
+      retryEvent->packetType =
+          quic::toQlogString(quic::LongHeader::Types::Retry).str();
+      retryEvent->packetSize = f[0];
+      retryEvent->tokenSize = f[1];
+      event = std::move(retryEvent);
+      break;
+    }
+    case BinaryQLogRecordType::ConnectionClose: {
+      auto error = extras.nextString();
+      auto reason = extras.nextString();
+      event = std::make_unique<quic::QLogConnectionCloseEvent>(
+          std::move(error), std::move(reason), f[0] != 0, f[1] != 0, refTime);
+      break;
+    }
+    case BinaryQLogRecordType::TransportSummary: {
+      // Arguments are evaluated in an unspecified order, so read the extra
+      // fields in order first.
+      std::array<uint64_t, 12> more;
+      for (auto& field : more) {
+        field = extras.nextField();
+      }
+      event = std::make_unique<quic::QLogTransportSummaryEvent>(
+          f[0],
+          f[1],
+          f[2],
+          f[3],
+          f[4],
+          more[0],
+          more[1],
+          more[2],
+          more[3],
+          more[4],
+          more[5],
+          more[6],
+          more[7],
+          more[8],
+          more[9],
+          more[11] != 0,
+          static_cast<quic::QuicVersion>(record.small),
+          more[10],
+          extras.nextString(),
+          refTime);
+      break;
+    }
+    case BinaryQLogRecordType::CongestionMetricUpdate: {
+      auto congestionEvent = extras.nextString();
+      auto state = extras.nextString();
+      auto recoveryState = extras.nextString();
+      event = std::make_unique<quic::QLogCongestionMetricUpdateEvent>(
+          f[0],
+          f[1],
+          std::move(congestionEvent),
+          std::move(state),
+          std::move(recoveryState),
+          refTime);
+      break;
+    }
+    case BinaryQLogRecordType::BandwidthEstUpdate:
+      event = std::make_unique<quic::QLogBandwidthEstUpdateEvent>(
+          f[0], std::chrono::microseconds(f[1]), refTime);
+      break;
+    case BinaryQLogRecordType::AppLimitedUpdate:
+      event = std::make_unique<quic::QLogAppLimitedUpdateEvent>(
+          record.small != 0, refTime);
+      break;
+    case BinaryQLogRecordType::PacingMetricUpdate:
+      event = std::make_unique<quic::QLogPacingMetricUpdateEvent>(
+          f[0], std::chrono::microseconds(f[1]), refTime);
+      break;
+    case BinaryQLogRecordType::PacingObservation: {
+      auto actual = extras.nextString();
+      auto expect = extras.nextString();
+      auto conclusion = extras.nextString();
+      event = std::make_unique<quic::QLogPacingObservationEvent>(
+          std::move(actual), std::move(expect), std::move(conclusion), refTime);
+      break;
+    }
+    case BinaryQLogRecordType::AppIdleUpdate:
+      event = std::make_unique<quic::QLogAppIdleUpdateEvent>(
+          extras.nextString(), record.small != 0, refTime);
+      break;
+    case BinaryQLogRecordType::PacketDrop:
+      event = std::make_unique<quic::QLogPacketDropEvent>(
+          f[0], extras.nextString(), refTime);
+      break;
+    case BinaryQLogRecordType::DatagramReceived:
+      event = std::make_unique<quic::QLogDatagramReceivedEvent>(f[0], refTime);
+      break;
+    case BinaryQLogRecordType::LossAlarm:
+      event = std::make_unique<quic::QLogLossAlarmEvent>(
+          f[0], f[1], f[2], extras.nextString(), refTime);
+      break;
+    case BinaryQLogRecordType::PacketsLost:
+      event = std::make_unique<quic::QLogPacketsLostEvent>(
+          f[0], f[1], f[2], refTime);
+      break;
+    case BinaryQLogRecordType::TransportStateUpdate:
+      event = std::make_unique<quic::QLogTransportStateUpdateEvent>(
+          extras.nextString(), refTime);
+      break;
+    case BinaryQLogRecordType::PacketBuffered:
+      event = std::make_unique<quic::QLogPacketBufferedEvent>(
+          static_cast<quic::ProtectionType>(record.small), f[0], refTime);
+      break;
+    case BinaryQLogRecordType::MetricUpdate:
+      event = std::make_unique<quic::QLogMetricUpdateEvent>(
+          std::chrono::microseconds(f[0]),
+          std::chrono::microseconds(f[1]),
+          std::chrono::microseconds(f[2]),
+          std::chrono::microseconds(f[3]),
+          refTime);
+      break;
+    case BinaryQLogRecordType::StreamStateUpdate: {
+      quic::Optional<std::chrono::milliseconds> timeSinceStreamCreation;
+      if (record.small) {
+        timeSinceStreamCreation = std::chrono::milliseconds(f[1]);
+      }
+      event = std::make_unique<quic::QLogStreamStateUpdateEvent>(
+          f[0],
+          extras.nextString(),
+          timeSinceStreamCreation,
+          logger.vantagePoint,
+          refTime);
+      break;
+    }
+    case BinaryQLogRecordType::ConnectionMigration:
+      event = std::make_unique<quic::QLogConnectionMigrationEvent>(
+          record.small != 0, logger.vantagePoint, refTime);
+      break;
+    case BinaryQLogRecordType::PathValidation:
+      event = std::make_unique<quic::QLogPathValidationEvent>(
+          record.small != 0, logger.vantagePoint, refTime);
+      break;
+    case BinaryQLogRecordType::PriorityUpdate:
+      event = std::make_unique<quic::QLogPriorityUpdateEvent>(
+          f[0], static_cast<uint8_t>(f[1]), record.small != 0, refTime);
+      break;
+    case BinaryQLogRecordType::L4sWeightUpdate:
+      event = std::make_unique<quic::QLogL4sWeightUpdateEvent>(
+          folly::bit_cast<double>(f[0]), f[1], f[2], refTime);
+      break;
+    case BinaryQLogRecordType::NetworkPathModelUpdate:
+      event = std::make_unique<quic::QLogNetworkPathModelUpdateEvent>(
+          f[0],
+          f[1],
+          f[2],
+          std::chrono::microseconds(f[3]),
+          f[4],
+          std::chrono::microseconds(extras.nextField()),
+          refTime);
+      break;
+    default:
+      return nullptr;
+  }
+  event->refTime = refTime;
+  return event;
+}
+
+quic::ConnectionId readConnectionId(const BinaryQLogRecord& record) {
+  auto len = std::min<size_t>(record.small, quic::kMaxConnectionIdSize);
+  auto bytes = reinterpret_cast<const uint8_t*>(record.fields.data());
+  return quic::ConnectionId(std::vector<uint8_t>(bytes, bytes + len));
+}
+
+} // namespace
+
+namespace quic {
+
+std::vector<std::unique_ptr<FileQLogger>> readBinaryQLog(
+    const std::string& path) {
+  std::string contents;
+  if (!folly::readFile(path.c_str(), contents)) {
+    throw std::runtime_error("Failed to read binary qlog " + path);
+  }
+  BinaryQLogFileHeader header;
+  if (contents.size() < sizeof(header)) {
+    throw std::runtime_error("Truncated binary qlog header in " + path);
+  }
+  std::memcpy(&header, contents.data(), sizeof(header));
+  if (header.magic != kBinaryQLogMagic ||
+      header.version != kBinaryQLogVersion ||
+      header.recordSize != sizeof(BinaryQLogRecord)) {
+    throw std::runtime_error("Unsupported binary qlog format in " + path);
+  }
+  std::vector<BinaryQLogRecord> records(
+      (contents.size() - sizeof(header)) / sizeof(BinaryQLogRecord));
+  std::memcpy(
+      records.data(),
+      contents.data() + sizeof(header),
+      records.size() * sizeof(BinaryQLogRecord));
+
+  std::vector<std::unique_ptr<FileQLogger>> loggers;
+  folly::F14FastMap<uint64_t, FileQLogger*> loggersByConnId;
+  size_t i = 0;
+  while (i < records.size()) {
+    const auto& record = records[i];
+    auto extrasBegin = records.data() + i + 1;
+    i += 1 + record.numExtra;
+    if (i > records.size()) {
+      // The file ends in the middle of an event.
+      break;
+    }
+    ExtraRecords extras(extrasBegin, records.data() + i);
+
+    auto& logger = loggersByConnId[record.connId];
+    if (!logger) {
+      // The ConnectionStart record is missing if it was dropped, in which
+      // case the defaults stand in for its fields.
+      auto vantagePoint = VantagePoint::Client;
+      std::string protocolType = kHTTP3ProtocolType;
+      if (record.type == BinaryQLogRecordType::ConnectionStart) {
+        vantagePoint = static_cast<VantagePoint>(record.small);
+        protocolType = extras.nextString();
+      }
+      loggers.push_back(
+          std::make_unique<FileQLogger>(vantagePoint, std::move(protocolType)));
+      logger = loggers.back().get();
+    }
+    switch (record.type) {
+      case BinaryQLogRecordType::ConnectionStart:
+        break;
+      case BinaryQLogRecordType::Dcid:
+        logger->setDcid(readConnectionId(record));
+        break;
+      case BinaryQLogRecordType::Scid:
+        logger->setScid(readConnectionId(record));
+        break;
+      default:
+        if (auto event = readEvent(*logger, record, extras)) {
+          logger->logs.push_back(std::move(event));
+        }
+        break;
+    }
+  }
+  return loggers;
+}
+
+} // namespace quic
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <quic/logging/FileQLogger.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace quic {
+
+/**
+ * Decodes a file written by BinaryQLogSink. Returns one FileQLogger per
+ * connection, in the order the connections started logging, with the
+ * connection's events in logs and its dcid and scid set. Use
+ * FileQLogger::outputLogsToFile() to write them out as JSON qlog.
+ *
+ * Throws std::runtime_error if the file cannot be read or is not a binary
+ * qlog. A file cut short by a crash decodes up to the last complete event.
+ */
+std::vector<std::unique_ptr<FileQLogger>> readBinaryQLog(
+    const std::string& path);
+
+} // namespace quic
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/logging/BinaryQLogSink.h>
+
+#include <folly/FileUtil.h>
+#include <folly/lang/Bits.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+// Records moved out of a ring per write to the file.
+constexpr size_t kDrainBatchRecords = 1024;
+} // namespace
+
+namespace quic {
+
+BinaryQLogRing::BinaryQLogRing(size_t capacity)
+    : slots_(folly::nextPowTwo(std::max<size_t>(capacity, 2))),
+      mask_(slots_.size() - 1) {}
+
+bool BinaryQLogRing::tryWrite(
+    const BinaryQLogRecord* records,
+    size_t numRecords) {
+  auto tail = tail_.load(std::memory_order_relaxed);
+  if (tail + numRecords - cachedHead_ > slots_.size()) {
+    cachedHead_ = head_.load(std::memory_order_acquire);
+    if (tail + numRecords - cachedHead_ > slots_.size()) {
+      return false;
+    }
+  }
+  auto start = tail & mask_;
+  auto firstPart = std::min(numRecords, slots_.size() - start);
+  std::memcpy(&slots_[start], records, firstPart * sizeof(BinaryQLogRecord));
+  std::memcpy(
+      slots_.data(),
+      records + firstPart,
+      (numRecords - firstPart) * sizeof(BinaryQLogRecord));
+  tail_.store(tail + numRecords, std::memory_order_release);
+  return true;
+}
+
+size_t BinaryQLogRing::read(BinaryQLogRecord* out, size_t maxRecords) {
+  auto head = head_.load(std::memory_order_relaxed);
+  auto tail = tail_.load(std::memory_order_acquire);
+  auto numRecords = std::min<size_t>(tail - head, maxRecords);
+  auto start = head & mask_;
+  auto firstPart = std::min(numRecords, slots_.size() - start);
+  std::memcpy(out, &slots_[start], firstPart * sizeof(BinaryQLogRecord));
+  std::memcpy(
+      out + firstPart,
+      slots_.data(),
+      (numRecords - firstPart) * sizeof(BinaryQLogRecord));
+  head_.store(head + numRecords, std::memory_order_release);
+  return numRecords;
+}
+
+BinaryQLogSink::BinaryQLogSink(const std::string& path, Options options)
+    : options_(options), file_(path, O_WRONLY | O_CREAT | O_TRUNC) {
+  BinaryQLogFileHeader header{
+      .magic = kBinaryQLogMagic,
+      .version = kBinaryQLogVersion,
+      .recordSize = sizeof(BinaryQLogRecord)};
+  writeToFile(&header, sizeof(header));
+  writerThread_ = std::thread([this] { run(); });
+}
+
+BinaryQLogSink::~BinaryQLogSink() {
+  {
+    std::lock_guard<std::mutex> guard(stopMutex_);
+    stop_ = true;
+  }
+  stopCv_.notify_one();
+  writerThread_.join();
+}
+
+bool BinaryQLogSink::write(
+    const BinaryQLogRecord* records,
+    size_t numRecords) {
+  if (!localRing().tryWrite(records, numRecords)) {
+    numDroppedRecords_.fetch_add(numRecords, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+BinaryQLogRing& BinaryQLogSink::localRing() {
+  auto& ring = *localRing_;
+  if (FOLLY_UNLIKELY(!ring)) {
+    ring = std::make_shared<BinaryQLogRing>(options_.ringCapacity);
+    std::lock_guard<std::mutex> guard(ringsMutex_);
+    rings_.push_back(ring);
+  }
+  return *ring;
+}
+
+void BinaryQLogSink::run() {
+  std::vector<BinaryQLogRecord> buf(kDrainBatchRecords);
+  while (true) {
+    bool stopping;
+    {
+      std::lock_guard<std::mutex> guard(stopMutex_);
+      stopping = stop_;
+    }
+    // Once stop is observed, this drain picks up everything the producers
+    // wrote before the sink started shutting down.
+    auto numDrained = drain(buf);
+    if (stopping) {
+      return;
+    }
+    if (numDrained == 0) {
+      std::unique_lock<std::mutex> lock(stopMutex_);
+      stopCv_.wait_for(lock, options_.flushInterval, [this] { return stop_; });
+    }
+  }
+}
+
+size_t BinaryQLogSink::drain(std::vector<BinaryQLogRecord>& buf) {
+  std::vector<std::shared_ptr<BinaryQLogRing>> rings;
+  {
+    std::lock_guard<std::mutex> guard(ringsMutex_);
+    // A ring only referenced here belongs to a thread that has exited. Drop
+    // it once everything in it has been written.
+    rings_.erase(
+        std::remove_if(
+            rings_.begin(),
+            rings_.end(),
+            [](const auto& ring) {
+              return ring.use_count() == 1 && ring->empty();
+            }),
+        rings_.end());
+    rings = rings_;
+  }
+  size_t total = 0;
+  for (auto& ring : rings) {
+    size_t numRead;
+    while ((numRead = ring->read(buf.data(), buf.size())) > 0) {
+      writeToFile(buf.data(), numRead * sizeof(BinaryQLogRecord));
+      total += numRead;
+    }
+  }
+  numWrittenRecords_.fetch_add(total, std::memory_order_relaxed);
+  return total;
+}
+
+void BinaryQLogSink::writeToFile(const void* data, size_t len) {
+  if (folly::writeFull(file_.fd(), data, len) < 0) {
+    PLOG_EVERY_N(ERROR, 1000) << "Failed to write binary qlog";
+  }
+}
+
+} // namespace quic
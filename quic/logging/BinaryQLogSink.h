@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/File.h>
+#include <folly/ThreadLocal.h>
+#include <folly/lang/Align.h>
+#include <quic/logging/BinaryQLogFormat.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace quic {
+
+constexpr size_t kDefaultBinaryQLogRingCapacity = 16384;
+constexpr std::chrono::milliseconds kDefaultBinaryQLogFlushInterval{20};
+
+/**
+ * Single-producer single-consumer ring of qlog records. Writes are
+ * all-or-nothing, so the records of one event are never split by a full ring.
+ */
+class BinaryQLogRing {
+ public:
+  // capacity is rounded up to a power of two.
+  explicit BinaryQLogRing(size_t capacity);
+
+  /**
+   * Appends numRecords records, or nothing if they do not all fit. Must only
+   * be called from the producer thread.
+   */
+  bool tryWrite(const BinaryQLogRecord* records, size_t numRecords);
+
+  /**
+   * Moves up to maxRecords records into out and returns how many. Must only
+   * be called from the consumer thread.
+   */
+  size_t read(BinaryQLogRecord* out, size_t maxRecords);
+
+  [[nodiscard]] size_t capacity() const {
+    return slots_.size();
+  }
+
+  [[nodiscard]] bool empty() const {
+    return head_.load(std::memory_order_acquire) ==
+        tail_.load(std::memory_order_acquire);
+  }
+
+ private:
+  std::vector<BinaryQLogRecord> slots_;
+  size_t mask_;
+  // Next record to read, only advanced by the consumer.
+  alignas(folly::hardware_destructive_interference_size)
+      std::atomic<uint64_t> head_{0};
+  // Next record to write, only advanced by the producer.
+  alignas(folly::hardware_destructive_interference_size)
+      std::atomic<uint64_t> tail_{0};
+  // The producer's last view of head_, so that it only reads the consumer's
+  // cache line when the ring looks full.
+  uint64_t cachedHead_{0};
+};
+
+/**
+ * Collects binary qlog records from any number of threads and writes them to
+ * a single file.
+ *
+ * Each producing thread gets its own BinaryQLogRing the first time it writes,
+ * so the logging path is a copy into thread-local memory with no locks and no
+ * allocation. A background thread drains the rings and appends the records to
+ * the file. If a ring is full the event is dropped and counted rather than
+ * blocking the transport.
+ *
+ * Shared by every BinaryQLogger that logs to the same file. Throws
+ * std::system_error if the file cannot be created.
+ */
+class BinaryQLogSink {
+ public:
+  struct Options {
+    // Records buffered per producing thread.
+    size_t ringCapacity{kDefaultBinaryQLogRingCapacity};
+    // How long the writer thread sleeps when all rings are empty.
+    std::chrono::milliseconds flushInterval{kDefaultBinaryQLogFlushInterval};
+  };
+
+  explicit BinaryQLogSink(const std::string& path)
+      : BinaryQLogSink(path, Options()) {}
+
+  BinaryQLogSink(const std::string& path, Options options);
+
+  // Writes out everything that has been logged before returning.
+  ~BinaryQLogSink();
+
+  BinaryQLogSink(const BinaryQLogSink&) = delete;
+  BinaryQLogSink& operator=(const BinaryQLogSink&) = delete;
+
+  // Returns an id that identifies a connection's records in the file.
+  uint64_t newConnectionId() {
+    return nextConnId_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * Queues the records of one event from the calling thread. Returns false and
+   * drops them if the thread's ring is full.
+   */
+  bool write(const BinaryQLogRecord* records, size_t numRecords);
+
+  [[nodiscard]] uint64_t numDroppedRecords() const {
+    return numDroppedRecords_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] uint64_t numWrittenRecords() const {
+    return numWrittenRecords_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  BinaryQLogRing& localRing();
+  void run();
+  // Drains every ring into the file and returns the number of records.
+  size_t drain(std::vector<BinaryQLogRecord>& buf);
+  void writeToFile(const void* data, size_t len);
+
+  Options options_;
+  folly::File file_;
+
+  folly::ThreadLocal<std::shared_ptr<BinaryQLogRing>> localRing_;
+  std::mutex ringsMutex_;
+  std::vector<std::shared_ptr<BinaryQLogRing>> rings_;
+
+  std::atomic<uint64_t> nextConnId_{0};
+  std::atomic<uint64_t> numDroppedRecords_{0};
+  std::atomic<uint64_t> numWrittenRecords_{0};
+
+  std::mutex stopMutex_;
+  std::condition_variable stopCv_;
+  bool stop_{false};
+  std::thread writerThread_;
+};
+
+} // namespace quic
@@ -0,0 +1,802 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/logging/BinaryQLogger.h>
+
+#include <folly/lang/Bits.h>
+
+#include <cstring>
+
+namespace {
+
+uint64_t nowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * Builds the records of one event on the stack. Records that do not fit in
+ * kMaxBinaryQLogRecordsPerEvent are silently dropped.
+ */
+class EventBuilder {
+ public:
+  EventBuilder(uint64_t connId, quic::BinaryQLogRecordType type)
+      : connId_(connId), refTime_(nowMicros()) {
+    add(type);
+  }
+
+  quic::BinaryQLogRecord& event() {
+    return records_[0];
+  }
+
+  quic::BinaryQLogRecord* add(quic::BinaryQLogRecordType type) {
+    if (size_ == records_.size()) {
+      return nullptr;
+    }
+    auto& record = records_[size_++];
+    record.connId = connId_;
+    record.refTime = refTime_;
+    record.type = type;
+    record.numExtra = 0;
+    record.small = 0;
+    record.fields = {};
+    return &record;
+  }
+
+  quic::BinaryQLogRecord* addFrame(quic::BinaryQLogFrameType frameType) {
+    auto record = add(quic::BinaryQLogRecordType::Frame);
+    if (record) {
+      record->small = static_cast<uint32_t>(frameType);
+    }
+    return record;
+  }
+
+  // Adds fields beyond the five in the event record.
+  void addFields(std::initializer_list<uint64_t> values) {
+    auto it = values.begin();
+    while (it != values.end()) {
+      auto record = add(quic::BinaryQLogRecordType::MoreFields);
+      if (!record) {
+        return;
+      }
+      for (size_t i = 0; i < record->fields.size() && it != values.end();
+           i++, it++) {
+        record->fields[i] = *it;
+      }
+    }
+  }
+
+  void addString(folly::StringPiece str) {
+    addBytes(str.data(), std::min(str.size(), quic::kMaxBinaryQLogStringLen));
+  }
+
+  void addBytes(const void* data, size_t len) {
+    constexpr size_t kChunk = quic::BinaryQLogRecord::kMaxBytes;
+    auto bytes = static_cast<const uint8_t*>(data);
+    // The final chunk is always shorter than kChunk, even when it is empty.
+    size_t offset = 0;
+    while (true) {
+      auto record = add(quic::BinaryQLogRecordType::StringChunk);
+      if (!record) {
+        return;
+      }
+      auto chunkLen = std::min(len - offset, kChunk);
+      if (offset + chunkLen == len && chunkLen == kChunk) {
+        chunkLen--;
+      }
+      std::memcpy(record->fields.data(), bytes + offset, chunkLen);
+      record->small = chunkLen;
+      offset += chunkLen;
+      if (chunkLen < kChunk) {
+        return;
+      }
+    }
+  }
+
+  void send(quic::BinaryQLogSink& sink) {
+    records_[0].numExtra = size_ - 1;
+    sink.write(records_.data(), size_);
+  }
+
+ private:
+  uint64_t connId_;
+  uint64_t refTime_;
+  // Left uninitialized, only the first size_ records are written.
+  std::array<quic::BinaryQLogRecord, quic::kMaxBinaryQLogRecordsPerEvent>
+      records_;
+  size_t size_{0};
+};
+
+uint32_t packetTypeCode(const quic::PacketHeader& header) {
+  if (header.asShort()) {
+    return quic::kBinaryQLogShortHeaderPacket;
+  }
+  return static_cast<uint32_t>(header.asLong()->getHeaderType());
+}
+
+template <typename AckBlocks, typename GetRange>
+void addAckFrame(
+    EventBuilder& builder,
+    const AckBlocks& ackBlocks,
+    std::chrono::microseconds ackDelay,
+    quic::FrameType frameType,
+    uint32_t ecnECT0Count,
+    uint32_t ecnECT1Count,
+    uint32_t ecnCECount,
+    GetRange getRange) {
+  auto frame = builder.addFrame(quic::BinaryQLogFrameType::Ack);
+  if (!frame) {
+    return;
+  }
+  frame->fields = {
+      static_cast<uint64_t>(ackDelay.count()),
+      static_cast<uint64_t>(frameType),
+      ecnECT0Count,
+      ecnECT1Count,
+      ecnCECount};
+  // Each AckRanges record holds two [start, end] pairs.
+  quic::BinaryQLogRecord* ranges = nullptr;
+  size_t numRanges = 0;
+  for (const auto& block : ackBlocks) {
+    if (numRanges == quic::kMaxBinaryQLogAckRanges) {
+      break;
+    }
+    if (numRanges % 2 == 0) {
+      ranges = builder.add(quic::BinaryQLogRecordType::AckRanges);
+      if (!ranges) {
+        return;
+      }
+    }
+    auto [start, end] = getRange(block);
+    auto idx = (numRanges % 2) * 2;
+    ranges->fields[idx] = start;
+    ranges->fields[idx + 1] = end;
+    ranges->small++;
+    numRanges++;
+  }
+}
+
+void addErrorCode(quic::BinaryQLogRecord& frame, quic::QuicErrorCode code) {
+  frame.fields[0] = static_cast<uint64_t>(code.type());
+  switch (code.type()) {
+    case quic::QuicErrorCode::Type::ApplicationErrorCode:
+      frame.fields[1] = *code.asApplicationErrorCode();
+      break;
+    case quic::QuicErrorCode::Type::LocalErrorCode:
+      frame.fields[1] = static_cast<uint64_t>(*code.asLocalErrorCode());
+      break;
+    case quic::QuicErrorCode::Type::TransportErrorCode:
+      frame.fields[1] = static_cast<uint64_t>(*code.asTransportErrorCode());
+      break;
+  }
+}
+
+void addSimpleFrame(
+    EventBuilder& builder,
+    const quic::QuicSimpleFrame& simpleFrame) {
+  using quic::BinaryQLogFrameType;
+  switch (simpleFrame.type()) {
+    case quic::QuicSimpleFrame::Type::StopSendingFrame: {
+      const quic::StopSendingFrame& frame = *simpleFrame.asStopSendingFrame();
+      if (auto record = builder.addFrame(BinaryQLogFrameType::StopSending)) {
+        record->fields[0] = frame.streamId;
+        record->fields[1] = frame.errorCode;
+      }
+      break;
+    }
+    case quic::QuicSimpleFrame::Type::PathChallengeFrame: {
+      const quic::PathChallengeFrame& frame =
+          *simpleFrame.asPathChallengeFrame();
+      if (auto record = builder.addFrame(BinaryQLogFrameType::PathChallenge)) {
+        record->fields[0] = frame.pathData;
+      }
+      break;
+    }
+    case quic::QuicSimpleFrame::Type::PathResponseFrame: {
+      const quic::PathResponseFrame& frame = *simpleFrame.asPathResponseFrame();
+      if (auto record = builder.addFrame(BinaryQLogFrameType::PathResponse)) {
+        record->fields[0] = frame.pathData;
+      }
+      break;
+    }
+    case quic::QuicSimpleFrame::Type::NewConnectionIdFrame: {
+      const quic::NewConnectionIdFrame& frame =
+          *simpleFrame.asNewConnectionIdFrame();
+      if (auto record =
+              builder.addFrame(BinaryQLogFrameType::NewConnectionId)) {
+        record->fields[0] = frame.sequenceNumber;
+        static_assert(sizeof(frame.token) <= 2 * sizeof(uint64_t));
+        std::memcpy(&record->fields[1], frame.token.data(), frame.token.size());
+      }
+      break;
+    }
+    case quic::QuicSimpleFrame::Type::MaxStreamsFrame: {
+      const quic::MaxStreamsFrame& frame = *simpleFrame.asMaxStreamsFrame();
+      if (auto record = builder.addFrame(BinaryQLogFrameType::MaxStreams)) {
+        record->fields[0] = frame.maxStreams;
+        record->fields[1] = frame.isForBidirectional;
+      }
+      break;
+    }
+    case quic::QuicSimpleFrame::Type::RetireConnectionIdFrame: {
+      const quic::RetireConnectionIdFrame& frame =
+          *simpleFrame.asRetireConnectionIdFrame();
+      if (auto record =
+              builder.addFrame(BinaryQLogFrameType::RetireConnectionId)) {
+        record->fields[0] = frame.sequenceNumber;
+      }
+      break;
+    }
+    case quic::QuicSimpleFrame::Type::HandshakeDoneFrame: {
+      builder.addFrame(BinaryQLogFrameType::HandshakeDone);
+      break;
+    }
+    case quic::QuicSimpleFrame::Type::KnobFrame: {
+      const quic::KnobFrame& frame = *simpleFrame.asKnobFrame();
+      if (auto record = builder.addFrame(BinaryQLogFrameType::Knob)) {
+        record->fields[0] = frame.knobSpace;
+        record->fields[1] = frame.id;
+        record->fields[2] = frame.blob->length();
+      }
+      break;
+    }
+    case quic::QuicSimpleFrame::Type::AckFrequencyFrame: {
+      const quic::AckFrequencyFrame& frame = *simpleFrame.asAckFrequencyFrame();
+      if (auto record = builder.addFrame(BinaryQLogFrameType::AckFrequency)) {
+        record->fields[0] = frame.sequenceNumber;
+        record->fields[1] = frame.packetTolerance;
+        record->fields[2] = frame.updateMaxAckDelay;
+        record->fields[3] = frame.reorderThreshold;
+      }
+      break;
+    }
+    case quic::QuicSimpleFrame::Type::NewTokenFrame: {
+      const quic::NewTokenFrame& frame = *simpleFrame.asNewTokenFrame();
+      if (builder.addFrame(BinaryQLogFrameType::NewToken)) {
+        // The reader hexlifies the token, like BaseQLogger does.
+        auto token = frame.token->coalesce();
+        builder.addBytes(
+            token.data(),
+            std::min(token.size(), quic::kMaxBinaryQLogStringLen));
+      }
+      break;
+    }
+  }
+}
+
+// Frames that are represented the same way in read and write packets.
+template <typename Frame>
+void addCommonFrame(EventBuilder& builder, const Frame& quicFrame) {
+  using quic::BinaryQLogFrameType;
+  using Type = typename Frame::Type;
+  switch (quicFrame.type()) {
+    case Type::RstStreamFrame: {
+      const auto& frame = *quicFrame.asRstStreamFrame();
+      if (auto record = builder.addFrame(BinaryQLogFrameType::RstStream)) {
+        record->fields[0] = frame.streamId;
+        record->fields[1] = frame.errorCode;
+        record->fields[2] = frame.finalSize;
+      }
+      break;
+    }
+    case Type::ConnectionCloseFrame: {
+      const auto& frame = *quicFrame.asConnectionCloseFrame();
+      if (auto record =
+              builder.addFrame(BinaryQLogFrameType::ConnectionClose)) {
+        addErrorCode(*record, frame.errorCode);
+        record->fields[2] = static_cast<uint64_t>(frame.closingFrameType);
+        builder.addString(frame.reasonPhrase);
+      }
+      break;
+    }
+    case Type::MaxDataFrame: {
+      const auto& frame = *quicFrame.asMaxDataFrame();
+      if (auto record = builder.addFrame(BinaryQLogFrameType::MaxData)) {
+        record->fields[0] = frame.maximumData;
+      }
+      break;
+    }
+    case Type::MaxStreamDataFrame: {
+      const auto& frame = *quicFrame.asMaxStreamDataFrame();
+      if (auto record = builder.addFrame(BinaryQLogFrameType::MaxStreamData)) {
+        record->fields[0] = frame.streamId;
+        record->fields[1] = frame.maximumData;
+      }
+      break;
+    }
+    case Type::DataBlockedFrame: {
+      const auto& frame = *quicFrame.asDataBlockedFrame();
+      if (auto record = builder.addFrame(BinaryQLogFrameType::DataBlocked)) {
+        record->fields[0] = frame.dataLimit;
+      }
+      break;
+    }
+    case Type::StreamDataBlockedFrame: {
+      const auto& frame = *quicFrame.asStreamDataBlockedFrame();
+      if (auto record =
+              builder.addFrame(BinaryQLogFrameType::StreamDataBlocked)) {
+        record->fields[0] = frame.streamId;
+        record->fields[1] = frame.dataLimit;
+      }
+      break;
+    }
+    case Type::StreamsBlockedFrame: {
+      const auto& frame = *quicFrame.asStreamsBlockedFrame();
+      if (auto record =
+              builder.addFrame(BinaryQLogFrameType::StreamsBlocked)) {
+        record->fields[0] = frame.streamLimit;
+        record->fields[1] = frame.isForBidirectional;
+      }
+      break;
+    }
+    case Type::QuicSimpleFrame:
+      addSimpleFrame(builder, *quicFrame.asQuicSimpleFrame());
+      break;
+    case Type::PingFrame:
+      builder.addFrame(BinaryQLogFrameType::Ping);
+      break;
+    case Type::ImmediateAckFrame:
+      builder.addFrame(BinaryQLogFrameType::ImmediateAck);
+      break;
+    default:
+      break;
+  }
+}
+
+void addStreamFrame(
+    EventBuilder& builder,
+    quic::StreamId streamId,
+    uint64_t offset,
+    uint64_t len,
+    bool fin) {
+  if (auto record = builder.addFrame(quic::BinaryQLogFrameType::Stream)) {
+    record->fields[0] = streamId;
+    record->fields[1] = offset;
+    record->fields[2] = len;
+    record->fields[3] = fin;
+  }
+}
+
+void addCryptoFrame(EventBuilder& builder, uint64_t offset, uint64_t len) {
+  if (auto record = builder.addFrame(quic::BinaryQLogFrameType::Crypto)) {
+    record->fields[0] = offset;
+    record->fields[1] = len;
+  }
+}
+
+void addPaddingFrame(EventBuilder& builder, uint64_t numPaddingFrames) {
+  if (numPaddingFrames == 0) {
+    return;
+  }
+  if (auto record = builder.addFrame(quic::BinaryQLogFrameType::Padding)) {
+    record->fields[0] = numPaddingFrames;
+  }
+}
+
+} // namespace
+
+namespace quic {
+
+BinaryQLogger::BinaryQLogger(
+    VantagePoint vantagePointIn,
+    std::string protocolTypeIn,
+    std::shared_ptr<BinaryQLogSink> sink)
+    : QLogger(vantagePointIn, std::move(protocolTypeIn)),
+      sink_(std::move(sink)),
+      connId_(sink_->newConnectionId()) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::ConnectionStart);
+  builder.event().small = static_cast<uint32_t>(vantagePoint);
+  builder.addString(protocolType);
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addPacket(
+    const RegularQuicPacket& regularPacket,
+    uint64_t packetSize) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::PacketReceived);
+  auto& event = builder.event();
+  event.small = packetTypeCode(regularPacket.header);
+  if (event.small != static_cast<uint32_t>(LongHeader::Types::Retry)) {
+    // A Retry packet does not include a packet number.
+    event.fields[0] = regularPacket.header.getPacketSequenceNum();
+  }
+  event.fields[1] = packetSize;
+
+  uint64_t numPaddingFrames = 0;
+  for (const auto& quicFrame : regularPacket.frames) {
+    switch (quicFrame.type()) {
+      case QuicFrame::Type::PaddingFrame:
+        numPaddingFrames += quicFrame.asPaddingFrame()->numFrames;
+        break;
+      case QuicFrame::Type::ReadAckFrame: {
+        const auto& frame = *quicFrame.asReadAckFrame();
+        addAckFrame(
+            builder,
+            frame.ackBlocks,
+            frame.ackDelay,
+            frame.frameType,
+            frame.ecnECT0Count,
+            frame.ecnECT1Count,
+            frame.ecnCECount,
+            [](const AckBlock& block) {
+              return std::make_pair(block.startPacket, block.endPacket);
+            });
+        break;
+      }
+      case QuicFrame::Type::ReadStreamFrame: {
+        const auto& frame = *quicFrame.asReadStreamFrame();
+        addStreamFrame(
+            builder,
+            frame.streamId,
+            frame.offset,
+            frame.data->length(),
+            frame.fin);
+        break;
+      }
+      case QuicFrame::Type::ReadCryptoFrame: {
+        const auto& frame = *quicFrame.asReadCryptoFrame();
+        addCryptoFrame(
+            builder, frame.offset, frame.data->length());
+        break;
+      }
+      case QuicFrame::Type::ReadNewTokenFrame:
+        builder.addFrame(BinaryQLogFrameType::ReadNewToken);
+        break;
+      case QuicFrame::Type::DatagramFrame:
+        if (auto record = builder.addFrame(BinaryQLogFrameType::Datagram)) {
+          record->fields[0] = quicFrame.asDatagramFrame()->length;
+        }
+        break;
+      default:
+        addCommonFrame(builder, quicFrame);
+        break;
+    }
+  }
+  addPaddingFrame(builder, numPaddingFrames);
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addPacket(
+    const RegularQuicWritePacket& writePacket,
+    uint64_t packetSize) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::PacketSent);
+  auto& event = builder.event();
+  event.small = packetTypeCode(writePacket.header);
+  event.fields[0] = writePacket.header.getPacketSequenceNum();
+  event.fields[1] = packetSize;
+
+  uint64_t numPaddingFrames = 0;
+  for (const auto& quicFrame : writePacket.frames) {
+    switch (quicFrame.type()) {
+      case QuicWriteFrame::Type::PaddingFrame:
+        numPaddingFrames += quicFrame.asPaddingFrame()->numFrames;
+        break;
+      case QuicWriteFrame::Type::WriteAckFrame: {
+        const WriteAckFrame& frame = *quicFrame.asWriteAckFrame();
+        addAckFrame(
+            builder,
+            frame.ackBlocks,
+            frame.ackDelay,
+            frame.frameType,
+            frame.ecnECT0Count,
+            frame.ecnECT1Count,
+            frame.ecnCECount,
+            [](const Interval<PacketNum>& block) {
+              return std::make_pair(block.start, block.end);
+            });
+        break;
+      }
+      case QuicWriteFrame::Type::WriteStreamFrame: {
+        const WriteStreamFrame& frame = *quicFrame.asWriteStreamFrame();
+        addStreamFrame(
+            builder, frame.streamId, frame.offset, frame.len, frame.fin);
+        break;
+      }
+      case QuicWriteFrame::Type::WriteCryptoFrame: {
+        const WriteCryptoFrame& frame = *quicFrame.asWriteCryptoFrame();
+        addCryptoFrame(builder, frame.offset, frame.len);
+        break;
+      }
+      default:
+        addCommonFrame(builder, quicFrame);
+        break;
+    }
+  }
+  addPaddingFrame(builder, numPaddingFrames);
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addPacket(
+    const VersionNegotiationPacket& versionPacket,
+    uint64_t packetSize,
+    bool isPacketRecvd) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::VersionNegotiation);
+  builder.event().small = isPacketRecvd;
+  builder.event().fields[0] = packetSize;
+  auto numVersions =
+      std::min(versionPacket.versions.size(), kMaxBinaryQLogVersions);
+  if (auto record = builder.add(BinaryQLogRecordType::Versions)) {
+    record->small = numVersions;
+    // Two 32-bit versions per field.
+    for (size_t i = 0; i < numVersions; i++) {
+      record->fields[i / 2] |=
+          static_cast<uint64_t>(versionPacket.versions[i]) << (32 * (i % 2));
+    }
+  }
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addPacket(
+    const RetryPacket& retryPacket,
+    uint64_t packetSize,
+    bool isPacketRecvd) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::Retry);
+  builder.event().small = isPacketRecvd;
+  builder.event().fields[0] = packetSize;
+  builder.event().fields[1] = retryPacket.header.getToken().size();
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addConnectionClose(
+    std::string error,
+    std::string reason,
+    bool drainConnection,
+    bool sendCloseImmediately) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::ConnectionClose);
+  builder.event().fields[0] = drainConnection;
+  builder.event().fields[1] = sendCloseImmediately;
+  builder.addString(error);
+  builder.addString(reason);
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addTransportSummary(const TransportSummaryArgs& args) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::TransportSummary);
+  builder.event().small = static_cast<uint32_t>(args.quicVersion);
+  builder.event().fields = {
+      args.totalBytesSent,
+      args.totalBytesRecvd,
+      args.sumCurWriteOffset,
+      args.sumMaxObservedOffset,
+      args.sumCurStreamBufferLen};
+  builder.addFields(
+      {args.totalBytesRetransmitted,
+       args.totalStreamBytesCloned,
+       args.totalBytesCloned,
+       args.totalCryptoDataWritten,
+       args.totalCryptoDataRecvd,
+       args.currentWritableBytes,
+       args.currentConnFlowControl,
+       args.totalPacketsSpuriouslyMarkedLost,
+       args.finalPacketLossReorderingThreshold,
+       args.finalPacketLossTimeReorderingThreshDividend,
+       args.dsrPacketCount,
+       args.usedZeroRtt});
+  builder.addString(args.alpn);
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addCongestionMetricUpdate(
+    uint64_t bytesInFlight,
+    uint64_t currentCwnd,
+    std::string congestionEvent,
+    std::string state,
+    std::string recoveryState) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::CongestionMetricUpdate);
+  builder.event().fields[0] = bytesInFlight;
+  builder.event().fields[1] = currentCwnd;
+  builder.addString(congestionEvent);
+  builder.addString(state);
+  builder.addString(recoveryState);
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addBandwidthEstUpdate(
+    uint64_t bytes,
+    std::chrono::microseconds interval) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::BandwidthEstUpdate);
+  builder.event().fields[0] = bytes;
+  builder.event().fields[1] = interval.count();
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addAppLimitedUpdate() {
+  EventBuilder builder(connId_, BinaryQLogRecordType::AppLimitedUpdate);
+  builder.event().small = true;
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addAppUnlimitedUpdate() {
+  EventBuilder builder(connId_, BinaryQLogRecordType::AppLimitedUpdate);
+  builder.event().small = false;
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addPacingMetricUpdate(
+    uint64_t pacingBurstSizeIn,
+    std::chrono::microseconds pacingIntervalIn) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::PacingMetricUpdate);
+  builder.event().fields[0] = pacingBurstSizeIn;
+  builder.event().fields[1] = pacingIntervalIn.count();
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addPacingObservation(
+    std::string actual,
+    std::string expected,
+    std::string conclusion) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::PacingObservation);
+  builder.addString(actual);
+  builder.addString(expected);
+  builder.addString(conclusion);
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addAppIdleUpdate(std::string idleEvent, bool idle) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::AppIdleUpdate);
+  builder.event().small = idle;
+  builder.addString(idleEvent);
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addPacketDrop(size_t packetSize, std::string dropReason) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::PacketDrop);
+  builder.event().fields[0] = packetSize;
+  builder.addString(dropReason);
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addDatagramReceived(uint64_t dataLen) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::DatagramReceived);
+  builder.event().fields[0] = dataLen;
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addLossAlarm(
+    PacketNum largestSent,
+    uint64_t alarmCount,
+    uint64_t outstandingPackets,
+    std::string type) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::LossAlarm);
+  builder.event().fields[0] = largestSent;
+  builder.event().fields[1] = alarmCount;
+  builder.event().fields[2] = outstandingPackets;
+  builder.addString(type);
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addPacketsLost(
+    PacketNum largestLostPacketNum,
+    uint64_t lostBytes,
+    uint64_t lostPackets) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::PacketsLost);
+  builder.event().fields[0] = largestLostPacketNum;
+  builder.event().fields[1] = lostBytes;
+  builder.event().fields[2] = lostPackets;
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addTransportStateUpdate(std::string update) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::TransportStateUpdate);
+  builder.addString(update);
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addPacketBuffered(
+    ProtectionType protectionType,
+    uint64_t packetSize) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::PacketBuffered);
+  builder.event().small = static_cast<uint32_t>(protectionType);
+  builder.event().fields[0] = packetSize;
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addMetricUpdate(
+    std::chrono::microseconds latestRtt,
+    std::chrono::microseconds mrtt,
+    std::chrono::microseconds srtt,
+    std::chrono::microseconds ackDelay) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::MetricUpdate);
+  builder.event().fields[0] = latestRtt.count();
+  builder.event().fields[1] = mrtt.count();
+  builder.event().fields[2] = srtt.count();
+  builder.event().fields[3] = ackDelay.count();
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addStreamStateUpdate(
+    StreamId id,
+    std::string update,
+    Optional<std::chrono::milliseconds> timeSinceStreamCreation) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::StreamStateUpdate);
+  builder.event().fields[0] = id;
+  if (timeSinceStreamCreation.has_value()) {
+    builder.event().small = true;
+    builder.event().fields[1] = timeSinceStreamCreation->count();
+  }
+  builder.addString(update);
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addConnectionMigrationUpdate(bool intentionalMigration) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::ConnectionMigration);
+  builder.event().small = intentionalMigration;
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addPathValidationEvent(bool success) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::PathValidation);
+  builder.event().small = success;
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addPriorityUpdate(
+    quic::StreamId streamId,
+    uint8_t urgency,
+    bool incremental) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::PriorityUpdate);
+  builder.event().small = incremental;
+  builder.event().fields[0] = streamId;
+  builder.event().fields[1] = urgency;
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addL4sWeightUpdate(
+    double l4sWeight,
+    uint32_t newEct1,
+    uint32_t newCe) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::L4sWeightUpdate);
+  builder.event().fields[0] = folly::bit_cast<uint64_t>(l4sWeight);
+  builder.event().fields[1] = newEct1;
+  builder.event().fields[2] = newCe;
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::addNetworkPathModelUpdate(
+    uint64_t inflightHi,
+    uint64_t inflightLo,
+    uint64_t bandwidthHiBytes,
+    std::chrono::microseconds bandwidthHiInterval,
+    uint64_t bandwidthLoBytes,
+    std::chrono::microseconds bandwidthLoInterval) {
+  EventBuilder builder(connId_, BinaryQLogRecordType::NetworkPathModelUpdate);
+  builder.event().fields = {
+      inflightHi,
+      inflightLo,
+      bandwidthHiBytes,
+      static_cast<uint64_t>(bandwidthHiInterval.count()),
+      bandwidthLoBytes};
+  builder.addFields({static_cast<uint64_t>(bandwidthLoInterval.count())});
+  builder.send(*sink_);
+}
+
+void BinaryQLogger::setDcid(Optional<ConnectionId> connID) {
+  if (connID.hasValue()) {
+    dcid = connID.value();
+    logConnectionId(BinaryQLogRecordType::Dcid, *dcid);
+  }
+}
+
+void BinaryQLogger::setScid(Optional<ConnectionId> connID) {
+  if (connID.hasValue()) {
+    scid = connID.value();
+    logConnectionId(BinaryQLogRecordType::Scid, *scid);
+  }
+}
+
+void BinaryQLogger::logConnectionId(
+    BinaryQLogRecordType type,
+    const ConnectionId& connId) {
+  EventBuilder builder(connId_, type);
+  static_assert(kMaxConnectionIdSize <= BinaryQLogRecord::kMaxBytes);
+  builder.event().small = connId.size();
+  std::memcpy(builder.event().fields.data(), connId.data(), connId.size());
+  builder.send(*sink_);
+}
+
+} // namespace quic
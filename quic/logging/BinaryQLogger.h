@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <quic/codec/Types.h>
+#include <quic/logging/BinaryQLogSink.h>
+#include <quic/logging/QLogger.h>
+#include <quic/logging/QLoggerConstants.h>
+
+namespace quic {
+
+/**
+ * QLogger that encodes each event into fixed-size binary records and hands
+ * them to a BinaryQLogSink, which writes them to disk on a background thread.
+ * Unlike FileQLogger it builds no folly::dynamic objects and does not
+ * allocate, so it is cheap enough to enable on a large sample of connections.
+ * Use readBinaryQLog() from BinaryQLogReader.h to convert the output to JSON
+ * qlog.
+ *
+ * To keep every event bounded, strings are truncated to
+ * kMaxBinaryQLogStringLen bytes, packets keep at most
+ * kMaxBinaryQLogRecordsPerEvent records worth of frames, ACK frames keep
+ * their first kMaxBinaryQLogAckRanges ranges and receive timestamps are not
+ * logged.
+ */
+class BinaryQLogger : public QLogger {
+ public:
+  using QLogger::TransportSummaryArgs;
+
+  BinaryQLogger(
+      VantagePoint vantagePointIn,
+      std::string protocolTypeIn,
+      std::shared_ptr<BinaryQLogSink> sink);
+
+  ~BinaryQLogger() override = default;
+
+  void addPacket(const RegularQuicPacket& regularPacket, uint64_t packetSize)
+      override;
+  void addPacket(
+      const VersionNegotiationPacket& versionPacket,
+      uint64_t packetSize,
+      bool isPacketRecvd) override;
+  void addPacket(const RegularQuicWritePacket& writePacket, uint64_t packetSize)
+      override;
+  void addPacket(
+      const RetryPacket& retryPacket,
+      uint64_t packetSize,
+      bool isPacketRecvd) override;
+  void addConnectionClose(
+      std::string error,
+      std::string reason,
+      bool drainConnection,
+      bool sendCloseImmediately) override;
+  void addTransportSummary(const TransportSummaryArgs& args) override;
+  void addCongestionMetricUpdate(
+      uint64_t bytesInFlight,
+      uint64_t currentCwnd,
+      std::string congestionEvent,
+      std::string state = "",
+      std::string recoveryState = "") override;
+  void addBandwidthEstUpdate(uint64_t bytes, std::chrono::microseconds interval)
+      override;
+  void addAppLimitedUpdate() override;
+  void addAppUnlimitedUpdate() override;
+  void addPacingMetricUpdate(
+      uint64_t pacingBurstSizeIn,
+      std::chrono::microseconds pacingIntervalIn) override;
+  void addPacingObservation(
+      std::string actual,
+      std::string expected,
+      std::string conclusion) override;
+  void addAppIdleUpdate(std::string idleEvent, bool idle) override;
+  void addPacketDrop(size_t packetSize, std::string dropReasonIn) override;
+  void addDatagramReceived(uint64_t dataLen) override;
+  void addLossAlarm(
+      PacketNum largestSent,
+      uint64_t alarmCount,
+      uint64_t outstandingPackets,
+      std::string type) override;
+  void addPacketsLost(
+      PacketNum largestLostPacketNum,
+      uint64_t lostBytes,
+      uint64_t lostPackets) override;
+  void addTransportStateUpdate(std::string update) override;
+  void addPacketBuffered(ProtectionType protectionType, uint64_t packetSize)
+      override;
+  void addMetricUpdate(
+      std::chrono::microseconds latestRtt,
+      std::chrono::microseconds mrtt,
+      std::chrono::microseconds srtt,
+      std::chrono::microseconds ackDelay) override;
+  void addStreamStateUpdate(
+      StreamId id,
+      std::string update,
+      Optional<std::chrono::milliseconds> timeSinceStreamCreation) override;
+  void addConnectionMigrationUpdate(bool intentionalMigration) override;
+  void addPathValidationEvent(bool success) override;
+  void addPriorityUpdate(
+      quic::StreamId streamId,
+      uint8_t urgency,
+      bool incremental) override;
+  void addL4sWeightUpdate(double l4sWeight, uint32_t newEct1, uint32_t newCe)
+      override;
+  void addNetworkPathModelUpdate(
+      uint64_t inflightHi,
+      uint64_t inflightLo,
+      uint64_t bandwidthHiBytes,
+      std::chrono::microseconds bandwidthHiInterval,
+      uint64_t bandwidthLoBytes,
+      std::chrono::microseconds bandwidthLoInterval) override;
+
+  void setDcid(Optional<ConnectionId> connID) override;
+  void setScid(Optional<ConnectionId> connID) override;
+
+  // Id of this connection's records in the sink's file.
+  [[nodiscard]] uint64_t connectionId() const {
+    return connId_;
+  }
+
+ private:
+  void logConnectionId(
+      BinaryQLogRecordType type,
+      const ConnectionId& connId);
+
+  std::shared_ptr<BinaryQLogSink> sink_;
+  uint64_t connId_;
+};
+
+} // namespace quic
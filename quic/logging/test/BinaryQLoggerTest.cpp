@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/logging/BinaryQLogger.h>
+
+#include <folly/Conv.h>
+#include <folly/Random.h>
+#include <folly/json/json.h> // @manual=//folly:dynamic
+#include <folly/portability/Filesystem.h>
+#include <gtest/gtest.h>
+#include <quic/common/test/TestUtils.h>
+#include <quic/logging/BinaryQLogReader.h>
+#include <quic/logging/FileQLogger.h>
+
+#include <thread>
+
+using namespace testing;
+
+namespace quic::test {
+
+class BinaryQLoggerTest : public Test {
+ public:
+  void SetUp() override {
+    path_ = folly::to<std::string>(
+        folly::fs::temp_directory_path().string(),
+        "/binary_qlog_test_",
+        folly::Random::rand64(),
+        ".bin");
+  }
+
+  void TearDown() override {
+    folly::fs::remove(path_);
+  }
+
+  // Drops the test's references to the loggers and sink, which flushes the
+  // file, and reads it back.
+  std::vector<std::unique_ptr<FileQLogger>> readBack(
+      std::shared_ptr<BinaryQLogSink>& sink) {
+    sink.reset();
+    return readBinaryQLog(path_);
+  }
+
+  // Events as they appear in JSON qlog, without their timestamps.
+  static folly::dynamic eventsWithoutTime(const FileQLogger& logger) {
+    auto events = folly::dynamic::array();
+    for (const auto& event : logger.logs) {
+      auto d = event->toDynamic();
+      d.erase(d.begin());
+      events.push_back(std::move(d));
+    }
+    return events;
+  }
+
+ protected:
+  std::string path_;
+};
+
+TEST_F(BinaryQLoggerTest, RoundTripMatchesFileQLogger) {
+  auto sink = std::make_shared<BinaryQLogSink>(path_);
+  auto binaryLogger = std::make_unique<BinaryQLogger>(
+      VantagePoint::Server, "some-protocol", sink);
+  FileQLogger fileLogger(VantagePoint::Server, "some-protocol");
+
+  auto logBoth = [&](auto&& fn) {
+    fn(*binaryLogger);
+    fn(fileLogger);
+  };
+  logBoth([](QLogger& q) {
+    q.setDcid(getTestConnectionId(1));
+    q.setScid(getTestConnectionId(2));
+  });
+  logBoth([](QLogger& q) {
+    q.addPacket(createRegularQuicWritePacket(4, 100, 1000, true), 1200);
+    q.addPacket(createPacketWithAckFrames(), 50);
+    q.addPacket(createPacketWithPaddingFrames(), 1200);
+    q.addPacket(createVersionNegotiationPacket(), 40, true);
+  });
+  logBoth([](QLogger& q) {
+    RegularQuicPacket packet(
+        ShortHeader(ProtectionType::KeyPhaseZero, getTestConnectionId(1), 7));
+    packet.frames.emplace_back(ReadStreamFrame(
+        8, 10, folly::IOBuf::copyBuffer("hello"), false /* fin */));
+    packet.frames.emplace_back(ConnectionCloseFrame(
+        QuicErrorCode(TransportErrorCode::PROTOCOL_VIOLATION),
+        "bad frame",
+        FrameType::STREAM));
+    packet.frames.emplace_back(
+        QuicSimpleFrame(MaxStreamsFrame(100, true /* isBidirectional */)));
+    q.addPacket(packet, 600);
+  });
+  logBoth([](QLogger& q) {
+    q.addConnectionClose("error", "reason", true, false);
+    q.addCongestionMetricUpdate(1000, 20000, "loss", "recovery", "fast");
+    q.addBandwidthEstUpdate(5000, std::chrono::microseconds(300));
+    q.addAppLimitedUpdate();
+    q.addPacingMetricUpdate(10, std::chrono::microseconds(2000));
+    q.addPacingObservation("actual", "expected", "conclusion");
+    q.addAppIdleUpdate("idle", true);
+    q.addPacketDrop(100, "no reason");
+    q.addDatagramReceived(30);
+    q.addLossAlarm(42, 1, 3, "timeout");
+    q.addPacketsLost(40, 2400, 2);
+    q.addTransportStateUpdate("handshake done");
+    q.addPacketBuffered(ProtectionType::Handshake, 300);
+    q.addMetricUpdate(
+        std::chrono::microseconds(10),
+        std::chrono::microseconds(8),
+        std::chrono::microseconds(9),
+        std::chrono::microseconds(1));
+    q.addStreamStateUpdate(4, "closed", std::chrono::milliseconds(20));
+    q.addStreamStateUpdate(8, "open", folly::none);
+    q.addConnectionMigrationUpdate(true);
+    q.addPathValidationEvent(false);
+    q.addPriorityUpdate(4, 3, true);
+    q.addL4sWeightUpdate(0.25, 3, 4);
+    q.addNetworkPathModelUpdate(
+        100,
+        50,
+        2000,
+        std::chrono::microseconds(10),
+        1000,
+        std::chrono::microseconds(20));
+  });
+  logBoth([](QLogger& q) {
+    QLogger::TransportSummaryArgs args;
+    args.totalBytesSent = 1;
+    args.totalBytesRecvd = 2;
+    args.totalCryptoDataRecvd = 10;
+    args.finalPacketLossTimeReorderingThreshDividend = 15;
+    args.usedZeroRtt = true;
+    args.quicVersion = QuicVersion::QUIC_V1;
+    args.dsrPacketCount = 17;
+    args.alpn = "h3";
+    q.addTransportSummary(args);
+  });
+  binaryLogger.reset();
+
+  auto loggers = readBack(sink);
+  ASSERT_EQ(loggers.size(), 1);
+  auto& logger = *loggers[0];
+  EXPECT_EQ(logger.vantagePoint, VantagePoint::Server);
+  EXPECT_EQ(logger.protocolType, "some-protocol");
+  EXPECT_EQ(logger.dcid, getTestConnectionId(1));
+  EXPECT_EQ(logger.scid, getTestConnectionId(2));
+  EXPECT_EQ(
+      folly::toJson(eventsWithoutTime(logger)),
+      folly::toJson(eventsWithoutTime(fileLogger)));
+}
+
+TEST_F(BinaryQLoggerTest, LongStringsAreTruncated) {
+  auto sink = std::make_shared<BinaryQLogSink>(path_);
+  std::string exactChunk(BinaryQLogRecord::kMaxBytes, 'a');
+  std::string tooLong(1000, 'b');
+  {
+    BinaryQLogger q(VantagePoint::Client, kHTTP3ProtocolType, sink);
+    q.addTransportStateUpdate("");
+    q.addTransportStateUpdate(exactChunk);
+    q.addTransportStateUpdate(tooLong);
+  }
+  auto loggers = readBack(sink);
+  ASSERT_EQ(loggers.size(), 1);
+  auto& logs = loggers[0]->logs;
+  ASSERT_EQ(logs.size(), 3);
+  auto update = [&](size_t i) {
+    return static_cast<QLogTransportStateUpdateEvent*>(logs[i].get())->update;
+  };
+  EXPECT_EQ(update(0), "");
+  EXPECT_EQ(update(1), exactChunk);
+  EXPECT_EQ(update(2), tooLong.substr(0, kMaxBinaryQLogStringLen));
+}
+
+TEST_F(BinaryQLoggerTest, FullRingDropsWholeEvents) {
+  // A connection close with two strings takes three records, which never fit
+  // in a ring of two.
+  auto sink = std::make_shared<BinaryQLogSink>(
+      path_, BinaryQLogSink::Options{.ringCapacity = 2});
+  {
+    BinaryQLogger q(VantagePoint::Client, kHTTP3ProtocolType, sink);
+    // Wait for the writer to make room after the connection start event.
+    while (sink->numWrittenRecords() < 2) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    q.addConnectionClose("error", "reason", false, false);
+    q.addDatagramReceived(10);
+  }
+  EXPECT_EQ(sink->numDroppedRecords(), 3);
+  auto loggers = readBack(sink);
+  ASSERT_EQ(loggers.size(), 1);
+  ASSERT_EQ(loggers[0]->logs.size(), 1);
+  EXPECT_EQ(
+      loggers[0]->logs[0]->eventType, QLogEventType::DatagramReceived);
+}
+
+TEST_F(BinaryQLoggerTest, ConnectionsOnManyThreads) {
+  constexpr size_t kNumThreads = 4;
+  constexpr size_t kEventsPerThread = 1000;
+  auto sink = std::make_shared<BinaryQLogSink>(path_);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t] {
+      BinaryQLogger q(VantagePoint::Server, kHTTP3ProtocolType, sink);
+      q.setDcid(getTestConnectionId(t));
+      for (size_t i = 0; i < kEventsPerThread; i++) {
+        q.addPacketsLost(i, 0, 0);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(sink->numDroppedRecords(), 0);
+
+  auto loggers = readBack(sink);
+  ASSERT_EQ(loggers.size(), kNumThreads);
+  for (auto& logger : loggers) {
+    ASSERT_EQ(logger->logs.size(), kEventsPerThread);
+    for (size_t i = 0; i < kEventsPerThread; i++) {
+      auto event = static_cast<QLogPacketsLostEvent*>(logger->logs[i].get());
+      EXPECT_EQ(event->largestLostPacketNum, i);
+    }
+  }
+}
+
+TEST_F(BinaryQLoggerTest, TruncatedFileKeepsCompleteEvents) {
+  auto sink = std::make_shared<BinaryQLogSink>(path_);
+  {
+    BinaryQLogger q(VantagePoint::Client, kHTTP3ProtocolType, sink);
+    q.addDatagramReceived(10);
+    q.addTransportStateUpdate("update");
+  }
+  sink.reset();
+  // Cut the file in the middle of the last event.
+  folly::fs::resize_file(
+      path_, folly::fs::file_size(path_) - sizeof(BinaryQLogRecord) / 2);
+  auto loggers = readBinaryQLog(path_);
+  ASSERT_EQ(loggers.size(), 1);
+  ASSERT_EQ(loggers[0]->logs.size(), 1);
+  EXPECT_EQ(
+      loggers[0]->logs[0]->eventType, QLogEventType::DatagramReceived);
+}
+
+TEST_F(BinaryQLoggerTest, RejectsOtherFiles) {
+  EXPECT_THROW(readBinaryQLog(path_), std::runtime_error);
+}
+
+TEST(BinaryQLogRingTest, WritesAreAllOrNothing) {
+  BinaryQLogRing ring(4);
+  EXPECT_EQ(ring.capacity(), 4);
+  std::array<BinaryQLogRecord, 4> in{};
+  std::array<BinaryQLogRecord, 4> out{};
+  for (size_t i = 0; i < in.size(); i++) {
+    in[i].connId = i;
+  }
+  EXPECT_TRUE(ring.tryWrite(in.data(), 3));
+  EXPECT_FALSE(ring.tryWrite(in.data(), 2));
+  EXPECT_EQ(ring.read(out.data(), 2), 2);
+  EXPECT_EQ(out[0].connId, 0);
+  EXPECT_EQ(out[1].connId, 1);
+
+  // This write wraps around the end of the ring.
+  EXPECT_TRUE(ring.tryWrite(in.data(), 3));
+  EXPECT_EQ(ring.read(out.data(), out.size()), 4);
+  EXPECT_EQ(out[0].connId, 2);
+  EXPECT_EQ(out[1].connId, 0);
+  EXPECT_EQ(out[2].connId, 1);
+  EXPECT_EQ(out[3].connId, 2);
+  EXPECT_TRUE(ring.empty());
+}
+
+} // namespace quic::test
@@ -171,7 +171,7 @@ void markPacketLoss(
             break;
           }
           if (!streamRetransmissionDisabled(conn, *stream)) {
-            stream->insertIntoLossBuffer(std::move(bufferItr->second));
+            stream->insertIntoLossBuffer(std::move(*bufferItr->second));
           }
           if (streamsWithAddedStreamLossForPacket.find(frame.streamId) ==
               streamsWithAddedStreamLossForPacket.end()) {
@@ -218,7 +218,7 @@ void markPacketLoss(
           break;
         }
         DCHECK_EQ(bufferItr->second->offset, frame.offset);
-        cryptoStream->insertIntoLossBuffer(std::move(bufferItr->second));
+        cryptoStream->insertIntoLossBuffer(std::move(*bufferItr->second));
         cryptoStream->retransmissionBuffer.erase(bufferItr);
         break;
       }
@@ -13,7 +13,7 @@ namespace quic {
 
 SocketObserverInterface::WriteEvent::Builder&&
 SocketObserverInterface::WriteEvent::Builder::setOutstandingPackets(
-    const std::deque<OutstandingPacketWrapper>& outstandingPacketsIn) {
+    const OutstandingPacketList& outstandingPacketsIn) {
   maybeOutstandingPacketsRef = outstandingPacketsIn;
   return std::move(*this);
 }
@@ -69,7 +69,7 @@ SocketObserverInterface::WriteEvent::WriteEvent(
 
 SocketObserverInterface::AppLimitedEvent::Builder&&
 SocketObserverInterface::AppLimitedEvent::Builder::setOutstandingPackets(
-    const std::deque<OutstandingPacketWrapper>& outstandingPacketsIn) {
+    const OutstandingPacketList& outstandingPacketsIn) {
   maybeOutstandingPacketsRef = outstandingPacketsIn;
   return std::move(*this);
 }
@@ -224,7 +224,7 @@ void SocketObserverInterface::PacketsWrittenEvent::
 
 SocketObserverInterface::PacketsWrittenEvent::Builder&&
 SocketObserverInterface::PacketsWrittenEvent::Builder::setOutstandingPackets(
-    const std::deque<OutstandingPacketWrapper>& outstandingPacketsIn) {
+    const OutstandingPacketList& outstandingPacketsIn) {
   maybeOutstandingPacketsRef = outstandingPacketsIn;
   return std::move(*this);
 }
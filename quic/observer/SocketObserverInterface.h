@@ -87,13 +87,12 @@ class SocketObserverInterface {
   };
 
   struct WriteEvent {
-    [[nodiscard]] const std::deque<OutstandingPacketWrapper>&
-    getOutstandingPackets() const {
+    [[nodiscard]] const OutstandingPacketList& getOutstandingPackets() const {
       return outstandingPackets;
     }
 
     // Reference to the current list of outstanding packets.
-    const std::deque<OutstandingPacketWrapper>& outstandingPackets;
+    const OutstandingPacketList& outstandingPackets;
 
     // Monotonically increasing number assigned to each write operation.
     const uint64_t writeCount;
@@ -112,8 +111,7 @@ class SocketObserverInterface {
     const Optional<uint64_t> maybeWritableBytes;
 
     struct BuilderFields {
-      Optional<
-          std::reference_wrapper<const std::deque<OutstandingPacketWrapper>>>
+      Optional<std::reference_wrapper<const OutstandingPacketList>>
           maybeOutstandingPacketsRef;
       Optional<uint64_t> maybeWriteCount;
       Optional<TimePoint> maybeLastPacketSentTime;
@@ -124,7 +122,7 @@ class SocketObserverInterface {
 
     struct Builder : public BuilderFields {
       Builder&& setOutstandingPackets(
-          const std::deque<OutstandingPacketWrapper>& outstandingPacketsIn);
+          const OutstandingPacketList& outstandingPacketsIn);
       Builder&& setWriteCount(const uint64_t writeCountIn);
       Builder&& setLastPacketSentTime(const TimePoint& lastPacketSentTimeIn);
       Builder&& setLastPacketSentTime(
@@ -153,7 +151,7 @@ class SocketObserverInterface {
   struct AppLimitedEvent : public WriteEvent {
     struct Builder : public WriteEvent::BuilderFields {
       Builder&& setOutstandingPackets(
-          const std::deque<OutstandingPacketWrapper>& outstandingPacketsIn);
+          const OutstandingPacketList& outstandingPacketsIn);
       Builder&& setWriteCount(const uint64_t writeCountIn);
       Builder&& setLastPacketSentTime(const TimePoint& lastPacketSentTimeIn);
       Builder&& setLastPacketSentTime(
@@ -196,7 +194,7 @@ class SocketObserverInterface {
 
     struct Builder : public BuilderFields {
       Builder&& setOutstandingPackets(
-          const std::deque<OutstandingPacketWrapper>& outstandingPacketsIn);
+          const OutstandingPacketList& outstandingPacketsIn);
       Builder&& setWriteCount(const uint64_t writeCountIn);
       Builder&& setLastPacketSentTime(const TimePoint& lastPacketSentTimeIn);
       Builder&& setLastPacketSentTime(
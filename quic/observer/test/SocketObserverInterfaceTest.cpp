@@ -75,7 +75,7 @@ TEST_F(SocketObserverInterfaceTest, InvokeForEachNewOutstandingPacketOrdered) {
   // no new packets, no old packets
   {
     // create OutstandingPacketWrapper deque
-    std::deque<OutstandingPacketWrapper> outstandingPackets;
+    OutstandingPacketList outstandingPackets;
 
     // build event with writeCount = 10
     const auto event = SocketObserverInterface::PacketsWrittenEvent::Builder()
@@ -105,7 +105,7 @@ TEST_F(SocketObserverInterfaceTest, InvokeForEachNewOutstandingPacketOrdered) {
   // no new packets, has old packets
   {
     // create OutstandingPacketWrapper deque
-    std::deque<OutstandingPacketWrapper> outstandingPackets;
+    OutstandingPacketList outstandingPackets;
     outstandingPackets.emplace_back([]() {
       OutstandingPacketRelevantFields fields;
       fields.maybePnSpace = PacketNumberSpace::AppData;
@@ -144,7 +144,7 @@ TEST_F(SocketObserverInterfaceTest, InvokeForEachNewOutstandingPacketOrdered) {
   // no new ack eliciting packets, no old packets
   {
     // create OutstandingPacketWrapper deque
-    std::deque<OutstandingPacketWrapper> outstandingPackets;
+    OutstandingPacketList outstandingPackets;
 
     // build event with writeCount = 10
     const auto event = SocketObserverInterface::PacketsWrittenEvent::Builder()
@@ -174,7 +174,7 @@ TEST_F(SocketObserverInterfaceTest, InvokeForEachNewOutstandingPacketOrdered) {
   // no new ack eliciting packets, has old packets
   {
     // create OutstandingPacketWrapper deque
-    std::deque<OutstandingPacketWrapper> outstandingPackets;
+    OutstandingPacketList outstandingPackets;
     outstandingPackets.emplace_back([]() {
       OutstandingPacketRelevantFields fields;
       fields.maybePnSpace = PacketNumberSpace::AppData;
@@ -213,7 +213,7 @@ TEST_F(SocketObserverInterfaceTest, InvokeForEachNewOutstandingPacketOrdered) {
   // first packet sent for initial, handshake, app data, single write, ordered
   {
     // create OutstandingPacketWrapper deque
-    std::deque<OutstandingPacketWrapper> outstandingPackets;
+    OutstandingPacketList outstandingPackets;
     outstandingPackets.emplace_back([]() {
       OutstandingPacketRelevantFields fields;
       fields.maybePnSpace = PacketNumberSpace::Initial;
@@ -292,7 +292,7 @@ TEST_F(SocketObserverInterfaceTest, InvokeForEachNewOutstandingPacketOrdered) {
   // first packet sent for initial, handshake, app data, single write, reversed
   {
     // create OutstandingPacketWrapper deque
-    std::deque<OutstandingPacketWrapper> outstandingPackets;
+    OutstandingPacketList outstandingPackets;
     outstandingPackets.emplace_back([]() {
       OutstandingPacketRelevantFields fields;
       fields.maybePnSpace = PacketNumberSpace::AppData;
@@ -372,7 +372,7 @@ TEST_F(SocketObserverInterfaceTest, InvokeForEachNewOutstandingPacketOrdered) {
   // specifically, ordered by packet number, but random on pnspace
   {
     // create OutstandingPacketWrapper deque
-    std::deque<OutstandingPacketWrapper> outstandingPackets;
+    OutstandingPacketList outstandingPackets;
     outstandingPackets.emplace_back([]() {
       OutstandingPacketRelevantFields fields;
       fields.maybePnSpace = PacketNumberSpace::Handshake;
@@ -451,7 +451,7 @@ TEST_F(SocketObserverInterfaceTest, InvokeForEachNewOutstandingPacketOrdered) {
   // first packet for initial, handshake, app data, separate writes, ordered
   {
     // create OutstandingPacketWrapper deque
-    std::deque<OutstandingPacketWrapper> outstandingPackets;
+    OutstandingPacketList outstandingPackets;
     outstandingPackets.emplace_back([]() {
       OutstandingPacketRelevantFields fields;
       fields.maybePnSpace = PacketNumberSpace::Initial;
@@ -516,7 +516,7 @@ TEST_F(SocketObserverInterfaceTest, InvokeForEachNewOutstandingPacketOrdered) {
   // first packet for initial, handshake, app data, separate writes, reversed
   {
     // create OutstandingPacketWrapper deque
-    std::deque<OutstandingPacketWrapper> outstandingPackets;
+    OutstandingPacketList outstandingPackets;
     outstandingPackets.emplace_back([]() {
       OutstandingPacketRelevantFields fields;
       fields.maybePnSpace = PacketNumberSpace::AppData;
@@ -581,7 +581,7 @@ TEST_F(SocketObserverInterfaceTest, InvokeForEachNewOutstandingPacketOrdered) {
   // retransmit initial
   {
     // create OutstandingPacketWrapper deque
-    std::deque<OutstandingPacketWrapper> outstandingPackets;
+    OutstandingPacketList outstandingPackets;
     outstandingPackets.emplace_back([]() {
       OutstandingPacketRelevantFields fields;
       fields.maybePnSpace = PacketNumberSpace::Initial;
@@ -656,7 +656,7 @@ TEST_F(SocketObserverInterfaceTest, InvokeForEachNewOutstandingPacketOrdered) {
   // retransmit all three
   {
     // create OutstandingPacketWrapper deque
-    std::deque<OutstandingPacketWrapper> outstandingPackets;
+    OutstandingPacketList outstandingPackets;
     outstandingPackets.emplace_back([]() {
       OutstandingPacketRelevantFields fields;
       fields.maybePnSpace = PacketNumberSpace::Initial;
@@ -765,7 +765,7 @@ TEST_F(SocketObserverInterfaceTest, InvokeForEachNewOutstandingPacketOrdered) {
   // just app data, single new packet
   {
     // create OutstandingPacketWrapper deque
-    std::deque<OutstandingPacketWrapper> outstandingPackets;
+    OutstandingPacketList outstandingPackets;
     outstandingPackets.emplace_back([]() {
       OutstandingPacketRelevantFields fields;
       fields.maybePnSpace = PacketNumberSpace::AppData;
@@ -810,7 +810,7 @@ TEST_F(SocketObserverInterfaceTest, InvokeForEachNewOutstandingPacketOrdered) {
   // just app data, single new packet, non-ack eliciting written
   {
     // create OutstandingPacketWrapper deque
-    std::deque<OutstandingPacketWrapper> outstandingPackets;
+    OutstandingPacketList outstandingPackets;
     outstandingPackets.emplace_back([]() {
       OutstandingPacketRelevantFields fields;
       fields.maybePnSpace = PacketNumberSpace::AppData;
@@ -855,7 +855,7 @@ TEST_F(SocketObserverInterfaceTest, InvokeForEachNewOutstandingPacketOrdered) {
   // just app data, multiple new packets
   {
     // create OutstandingPacketWrapper deque
-    std::deque<OutstandingPacketWrapper> outstandingPackets;
+    OutstandingPacketList outstandingPackets;
     outstandingPackets.emplace_back([]() {
       OutstandingPacketRelevantFields fields;
       fields.maybePnSpace = PacketNumberSpace::AppData;
@@ -918,7 +918,7 @@ TEST_F(SocketObserverInterfaceTest, InvokeForEachNewOutstandingPacketOrdered) {
   // just app data, multiple new packets, non-ack eliciting written
   {
     // create OutstandingPacketWrapper deque
-    std::deque<OutstandingPacketWrapper> outstandingPackets;
+    OutstandingPacketList outstandingPackets;
     outstandingPackets.emplace_back([]() {
       OutstandingPacketRelevantFields fields;
       fields.maybePnSpace = PacketNumberSpace::AppData;
@@ -981,7 +981,7 @@ TEST_F(SocketObserverInterfaceTest, InvokeForEachNewOutstandingPacketOrdered) {
   // just app data, multiple old packets, multiple new packets
   {
     // create OutstandingPacketWrapper deque
-    std::deque<OutstandingPacketWrapper> outstandingPackets;
+    OutstandingPacketList outstandingPackets;
     outstandingPackets.emplace_back([]() {
       OutstandingPacketRelevantFields fields;
       fields.maybePnSpace = PacketNumberSpace::AppData;
@@ -1064,7 +1064,7 @@ TEST_F(SocketObserverInterfaceTest, InvokeForEachNewOutstandingPacketOrdered) {
   // just app data, multiple old packets, single new packet
   {
     // create OutstandingPacketWrapper deque
-    std::deque<OutstandingPacketWrapper> outstandingPackets;
+    OutstandingPacketList outstandingPackets;
     outstandingPackets.emplace_back([]() {
       OutstandingPacketRelevantFields fields;
       fields.maybePnSpace = PacketNumberSpace::AppData;
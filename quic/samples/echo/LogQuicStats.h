@@ -80,6 +80,14 @@ class LogQuicStats : public quic::QuicTransportStatsCallback {
     VLOG(2) << prefix_ << __func__;
   }
 
+  void onPacketRoutedToOtherWorker() override {
+    VLOG(2) << prefix_ << __func__;
+  }
+
+  void onWorkerPacketRingDrained(size_t numPackets) override {
+    VLOG(2) << prefix_ << __func__ << " numPackets=" << numPackets;
+  }
+
   void onClientInitialReceived(QuicVersion version) override {
     VLOG(2) << prefix_ << __func__ << " version: " << quic::toString(version);
   }
@@ -255,6 +263,10 @@ class LogQuicStats : public quic::QuicTransportStatsCallback {
     VLOG(2) << prefix_ << __func__;
   }
 
+  void onPacerTimerFired() override {
+    VLOG(2) << prefix_ << __func__;
+  }
+
   void onPeerMaxUniStreamsLimitSaturated() override {
     VLOG(2) << prefix_ << __func__;
   }
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/server/ConnectionStatsTable.h>
+
+#include <folly/portability/Asm.h>
+#include <glog/logging.h>
+
+namespace quic {
+
+bool ConnectionStatsRecord::operator==(
+    const ConnectionStatsRecord& other) const {
+  return connectionId == other.connectionId && workerID == other.workerID &&
+      srtt == other.srtt && mrtt == other.mrtt &&
+      cwndBytes == other.cwndBytes && inflightBytes == other.inflightBytes &&
+      totalBytesRetransmitted == other.totalBytesRetransmitted &&
+      rtxCount == other.rtxCount &&
+      pacingRateBytesPerSec == other.pacingRateBytesPerSec &&
+      numStreams == other.numStreams;
+}
+
+Optional<ConnectionStatsTable::SlotId> ConnectionStatsTable::acquireSlot() {
+  SlotId slotId;
+  if (!freeSlots_.empty()) {
+    slotId = freeSlots_.back();
+    freeSlots_.pop_back();
+  } else {
+    slotId = numSlots_.load(std::memory_order_relaxed);
+    auto chunkIndex = slotId / kSlotsPerChunk;
+    if (chunkIndex >= kMaxChunks) {
+      return none;
+    }
+    if (!chunks_[chunkIndex]) {
+      chunks_[chunkIndex] = std::make_unique<Chunk>();
+    }
+    numSlots_.store(slotId + 1, std::memory_order_release);
+  }
+  Fields fields{};
+  fields[0] = nextConnectionId_++;
+  write(getSlot(slotId), fields);
+  numConnections_.fetch_add(1, std::memory_order_relaxed);
+  return slotId;
+}
+
+void ConnectionStatsTable::publish(
+    SlotId slotId,
+    const ConnectionStatsRecord& record) {
+  auto& slot = getSlot(slotId);
+  auto connectionId = slot.fields[0].load(std::memory_order_relaxed);
+  DCHECK_NE(connectionId, 0) << "Publishing to a free slot";
+  write(slot, toFields(connectionId, record));
+}
+
+void ConnectionStatsTable::releaseSlot(SlotId slotId) {
+  write(getSlot(slotId), Fields{});
+  freeSlots_.push_back(slotId);
+  numConnections_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void ConnectionStatsTable::getSnapshot(
+    std::vector<ConnectionStatsRecord>& records) const {
+  auto numSlots = numSlots_.load(std::memory_order_acquire);
+  records.reserve(records.size() + numConnections());
+  for (SlotId slotId = 0; slotId < numSlots; slotId++) {
+    auto fields = read(getSlot(slotId));
+    // A zero connectionId is a free slot.
+    if (fields[0] != 0) {
+      records.push_back(fromFields(fields));
+    }
+  }
+}
+
+ConnectionStatsTable::Fields ConnectionStatsTable::toFields(
+    uint64_t connectionId,
+    const ConnectionStatsRecord& record) {
+  return {
+      connectionId,
+      static_cast<uint64_t>(record.srtt.count()),
+      static_cast<uint64_t>(record.mrtt.count()),
+      record.cwndBytes,
+      record.inflightBytes,
+      record.totalBytesRetransmitted,
+      record.rtxCount,
+      record.pacingRateBytesPerSec,
+      record.numStreams};
+}
+
+ConnectionStatsRecord ConnectionStatsTable::fromFields(const Fields& fields) {
+  ConnectionStatsRecord record;
+  record.connectionId = fields[0];
+  record.srtt = std::chrono::microseconds(fields[1]);
+  record.mrtt = std::chrono::microseconds(fields[2]);
+  record.cwndBytes = fields[3];
+  record.inflightBytes = fields[4];
+  record.totalBytesRetransmitted = fields[5];
+  record.rtxCount = fields[6];
+  record.pacingRateBytesPerSec = fields[7];
+  record.numStreams = fields[8];
+  return record;
+}
+
+ConnectionStatsTable::Slot& ConnectionStatsTable::getSlot(
+    SlotId slotId) const {
+  return chunks_[slotId / kSlotsPerChunk]->slots[slotId % kSlotsPerChunk];
+}
+
+void ConnectionStatsTable::write(Slot& slot, const Fields& fields) {
+  // Only the worker thread writes, so the sequence number can't change under
+  // us.
+  auto sequence = slot.sequence.load(std::memory_order_relaxed);
+  slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (size_t i = 0; i < kNumFields; i++) {
+    slot.fields[i].store(fields[i], std::memory_order_relaxed);
+  }
+  slot.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+ConnectionStatsTable::Fields ConnectionStatsTable::read(const Slot& slot) {
+  Fields fields;
+  while (true) {
+    auto before = slot.sequence.load(std::memory_order_acquire);
+    if (before & 1) {
+      folly::asm_volatile_pause();
+      continue;
+    }
+    for (size_t i = 0; i < kNumFields; i++) {
+      fields[i] = slot.fields[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) == before) {
+      return fields;
+    }
+  }
+}
+
+} // namespace quic
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <quic/QuicConstants.h>
+#include <quic/common/Optional.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace quic {
+
+/**
+ * A fixed-layout summary of a connection's state, cheap enough to be
+ * refreshed by the connection as it runs.
+ */
+struct ConnectionStatsRecord {
+  // Set by the table when the slot is acquired. Unique within the table, so a
+  // reader can tell apart the connections that reused a slot.
+  uint64_t connectionId{0};
+  // Filled in by QuicServer::getAllConnectionsStatsSnapshot().
+  uint8_t workerID{0};
+  std::chrono::microseconds srtt{0us};
+  std::chrono::microseconds mrtt{0us};
+  uint64_t cwndBytes{0};
+  uint64_t inflightBytes{0};
+  uint64_t totalBytesRetransmitted{0};
+  uint64_t rtxCount{0};
+  // 0 if the connection is not paced.
+  uint64_t pacingRateBytesPerSec{0};
+  uint64_t numStreams{0};
+
+  bool operator==(const ConnectionStatsRecord& other) const;
+  bool operator!=(const ConnectionStatsRecord& other) const {
+    return !(*this == other);
+  }
+};
+
+/**
+ * The stats records of the connections of one worker. The worker's thread
+ * acquires, publishes and releases the records, and any other thread can read
+ * them at any time without running on the worker's event base.
+ *
+ * Each slot is a seqlock: the writer makes the sequence number odd while it
+ * updates the record, and a reader retries until it sees the same even
+ * sequence number before and after copying the record. Slots live in chunks
+ * that are allocated on demand and never freed nor moved while the table is
+ * alive.
+ */
+class ConnectionStatsTable {
+ public:
+  using SlotId = uint32_t;
+
+  ConnectionStatsTable() = default;
+
+  ConnectionStatsTable(const ConnectionStatsTable&) = delete;
+  ConnectionStatsTable& operator=(const ConnectionStatsTable&) = delete;
+
+  // Worker thread only. Returns none if the table is full.
+  Optional<SlotId> acquireSlot();
+
+  // Worker thread only. The connectionId and workerID of the record are
+  // ignored.
+  void publish(SlotId slotId, const ConnectionStatsRecord& record);
+
+  // Worker thread only.
+  void releaseSlot(SlotId slotId);
+
+  // Any thread. Appends the records of the connections that hold a slot.
+  void getSnapshot(std::vector<ConnectionStatsRecord>& records) const;
+
+  // Any thread.
+  [[nodiscard]] size_t numConnections() const {
+    return numConnections_.load(std::memory_order_relaxed);
+  }
+
+  static constexpr size_t kSlotsPerChunk = 1024;
+  static constexpr size_t kMaxChunks = 4096;
+
+ private:
+  static constexpr size_t kNumFields = 9;
+  using Fields = std::array<uint64_t, kNumFields>;
+
+  struct Slot {
+    std::atomic<uint64_t> sequence{0};
+    std::array<std::atomic<uint64_t>, kNumFields> fields{};
+  };
+
+  struct Chunk {
+    std::array<Slot, kSlotsPerChunk> slots;
+  };
+
+  static Fields toFields(uint64_t connectionId, const ConnectionStatsRecord&);
+  static ConnectionStatsRecord fromFields(const Fields& fields);
+
+  Slot& getSlot(SlotId slotId) const;
+  void write(Slot& slot, const Fields& fields);
+  static Fields read(const Slot& slot);
+
+  std::array<std::unique_ptr<Chunk>, kMaxChunks> chunks_;
+  // The slots below this have been handed out at least once. Published with
+  // release semantics after their chunk is allocated.
+  std::atomic<SlotId> numSlots_{0};
+  std::atomic<size_t> numConnections_{0};
+
+  // Worker thread only.
+  std::vector<SlotId> freeSlots_;
+  uint64_t nextConnectionId_{1};
+};
+
+} // namespace quic
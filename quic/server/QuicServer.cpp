@@ -30,7 +30,8 @@ FOLLY_GFLAGS_DEFINE_int32(
 namespace {
 using namespace quic;
 // Determine which worker to route to
-// This **MUST** be kept in sync with the BPF program (if supplied)
+// This **MUST** be kept in sync with the BPF program (if supplied), including
+// ReusePortBpfRouter's
 size_t getWorkerToRouteTo(
     const RoutingData& routingData,
     size_t numWorkers,
@@ -225,6 +226,11 @@ void QuicServer::initializeWorkers(bool useDefaultTransport) {
     evbToWorkers_.emplace(
         (*workerEvbs)[i]->getEventBase(), workers_.back().get());
   }
+  if (workerPacketRingCapacity_ > 0) {
+    for (auto& worker : workers_) {
+      worker->initPacketRings(workers_.size(), workerPacketRingCapacity_);
+    }
+  }
 }
 
 std::unique_ptr<QuicServerWorker> QuicServer::newWorkerWithoutSocket() {
@@ -244,6 +250,12 @@ std::unique_ptr<QuicServerWorker> QuicServer::newWorkerWithoutSocket() {
   worker->setProcessId(processId_);
   worker->setHostId(hostId_);
   worker->setConnectionIdVersion(cidVersion_);
+  worker->setFixedLengthConnIdRouting(fixedLengthConnIdRouting_);
+#if FOLLY_HAS_LIBURING
+  if (ioUringSendOptions_) {
+    worker->setIoUringSendOptions(*ioUringSendOptions_);
+  }
+#endif
   if (healthCheckToken_) {
     worker->setHealthCheckToken(*healthCheckToken_);
   }
@@ -268,6 +280,17 @@ void QuicServer::bindWorkersToSocket(const folly::SocketAddress& address) {
   auto numWorkers = workerEvbs->size();
   CHECK(!initialized_);
   boundAddress_ = address;
+#if defined(__linux__) && !defined(ANDROID)
+  if (reusePortBpfRouting_ && numWorkers > 0) {
+    reusePortBpfRouter_ = std::make_unique<ReusePortBpfRouter>(numWorkers);
+    auto initResult = reusePortBpfRouter_->init();
+    if (initResult.hasError()) {
+      LOG(ERROR) << "Routing without reuseport BPF program: "
+                 << initResult.error().what();
+      reusePortBpfRouter_.reset();
+    }
+  }
+#endif
   for (size_t i = 0; i < numWorkers; ++i) {
     auto* workerEvb = (*workerEvbs)[i]->getEventBase();
     workerEvb->runImmediatelyOrRunInEventBaseThreadAndWait(
@@ -314,6 +337,9 @@ void QuicServer::bindWorkersToSocket(const folly::SocketAddress& address) {
               self->boundAddress_ = worker->getAddress();
             }
           }
+#if defined(__linux__) && !defined(ANDROID)
+          self->addWorkerToReusePortBpfRouter(*worker, idx, numWorkers);
+#endif
           if (idx == (numWorkers - 1)) {
             VLOG(4) << "Initialized all workers in the eventbase";
             self->initialized_ = true;
@@ -470,6 +496,38 @@ void QuicServer::routeDataToWorker(
         isForwardedData);
     return;
   }
+  if (workerPtr_) {
+    QUIC_STATS(
+        workerPtr_->getTransportStatsCallback(), onPacketRoutedToOtherWorker);
+  }
+  // Other workers only route from their own thread, which makes them the
+  // single producer of their ring.
+  auto packetRings = worker->getPacketRings();
+  if (packetRings && workerPtr_) {
+    auto result = packetRings->push(
+        workerPtr_->getWorkerId(),
+        WorkerPacketRings::Packet{
+            client,
+            std::move(routingData),
+            std::move(networkData),
+            quicVersion,
+            isForwardedData});
+    if (result == WorkerPacketRings::PushResult::RING_FULL) {
+      QUIC_STATS(
+          workerPtr_->getTransportStatsCallback(),
+          onPacketDropped,
+          PacketDropReason::WORKER_RING_FULL);
+    } else if (result == WorkerPacketRings::PushResult::WAKEUP_NEEDED) {
+      workerEvb->runInEventBaseThread(
+          [server = this->shared_from_this(), w = worker.get()]() {
+            if (server->shutdown_) {
+              return;
+            }
+            w->drainPacketRings();
+          });
+    }
+    return;
+  }
   worker->getEventBase()->runInEventBaseThread([server =
                                                     this->shared_from_this(),
                                                 cl = client,
@@ -590,6 +648,57 @@ void QuicServer::setConnectionIdVersion(
   }
 }
 
+void QuicServer::setFixedLengthConnIdRouting(bool enabled) noexcept {
+  checkRunningInThread(mainThreadId_);
+  CHECK(!initialized_) << kQuicServerNotInitialized << __func__;
+  fixedLengthConnIdRouting_ = enabled;
+}
+
+#if FOLLY_HAS_LIBURING
+void QuicServer::setIoUringSendOptions(
+    const IoUringSendRing::Options& options) noexcept {
+  checkRunningInThread(mainThreadId_);
+  CHECK(!initialized_) << kQuicServerNotInitialized << __func__;
+  ioUringSendOptions_ = options;
+}
+#endif
+
+void QuicServer::setReusePortBpfRouting(bool enabled) noexcept {
+  checkRunningInThread(mainThreadId_);
+  CHECK(!initialized_) << kQuicServerNotInitialized << __func__;
+  reusePortBpfRouting_ = enabled;
+#if !defined(__linux__) || defined(ANDROID)
+  LOG_IF(WARNING, enabled) << "Reuseport BPF routing needs Linux";
+#endif
+}
+
+#if defined(__linux__) && !defined(ANDROID)
+void QuicServer::addWorkerToReusePortBpfRouter(
+    QuicServerWorker& worker,
+    size_t idx,
+    size_t numWorkers) {
+  if (!reusePortBpfRouter_) {
+    return;
+  }
+  auto result = reusePortBpfRouter_->setWorkerSocket(idx, worker.getFD());
+  // Once all the workers are in the map, steer the group with the program.
+  if (!result.hasError() && idx == numWorkers - 1) {
+    result = reusePortBpfRouter_->attach(worker.getFD());
+  }
+  if (result.hasError()) {
+    LOG(ERROR) << "Routing without reuseport BPF program: "
+               << result.error().what();
+    reusePortBpfRouter_.reset();
+  }
+}
+#endif
+
+void QuicServer::setWorkerPacketRingCapacity(uint32_t capacity) noexcept {
+  checkRunningInThread(mainThreadId_);
+  CHECK(!initialized_) << kQuicServerNotInitialized << __func__;
+  workerPacketRingCapacity_ = capacity;
+}
+
 void QuicServer::setTransportSettingsOverrideFn(
     TransportSettingsOverrideFn fn) {
   checkRunningInThread(mainThreadId_);
@@ -754,6 +863,18 @@ void QuicServer::getAllConnectionsStats(
       [&stats](auto worker) mutable { worker->getAllConnectionsStats(stats); });
 }
 
+void QuicServer::getAllConnectionsStatsSnapshot(
+    std::vector<ConnectionStatsRecord>& records) const {
+  CHECK(initialized_) << kQuicServerNotInitialized << __func__;
+  for (const auto& worker : workers_) {
+    auto begin = records.size();
+    worker->getConnectionStatsTable().getSnapshot(records);
+    for (auto i = begin; i < records.size(); i++) {
+      records[i].workerID = worker->getWorkerId();
+    }
+  }
+}
+
 TakeoverProtocolVersion QuicServer::getTakeoverProtocolVersion()
     const noexcept {
   return workers_[0]->getTakeoverProtocolVersion();
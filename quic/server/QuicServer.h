@@ -21,6 +21,7 @@
 #include <quic/server/QuicServerTransportFactory.h>
 #include <quic/server/QuicServerWorker.h>
 #include <quic/server/QuicUDPSocketFactory.h>
+#include <quic/server/ReusePortBpfRouter.h>
 #include <quic/state/QuicConnectionStats.h>
 #include <quic/state/QuicTransportStatsCallback.h>
 
@@ -166,6 +167,44 @@ class QuicServer : public QuicServerWorker::WorkerCallback,
    */
   void setConnectionIdVersion(ConnectionIdVersion cidVersion) noexcept;
 
+  /**
+   * Route short header packets of established connections on the worker that
+   * received them with a fixed-width connection id lookup. Only valid with the
+   * default ConnectionIdAlgo, whose ids are kDefaultConnectionIdSize bytes.
+   * Note that this function must be called before initialize(..)
+   */
+  void setFixedLengthConnIdRouting(bool enabled) noexcept;
+
+#if FOLLY_HAS_LIBURING
+  /**
+   * Send the packets of each worker's connections through one io_uring per
+   * worker, created with the given options, instead of one sendmsg per write.
+   * Applies to the transports created with QuicServerTransport::make().
+   * Workers fall back to sendmsg if io_uring is unavailable.
+   * Note that this function must be called before initialize(..)
+   */
+  void setIoUringSendOptions(const IoUringSendRing::Options& options) noexcept;
+#endif
+
+  /**
+   * Hands packets routed to another worker over bounded lock-free rings, one
+   * per pair of workers, holding up to capacity packets each, instead of
+   * posting one callback per packet to the other worker's event base. Packets
+   * arriving when a ring is full are dropped. 0 disables the rings.
+   * Note that this function must be called before initialize(..)
+   */
+  void setWorkerPacketRingCapacity(uint32_t capacity) noexcept;
+
+  /**
+   * Attaches a reuseport BPF program to the workers' sockets that has the
+   * kernel deliver short header packets straight to the socket of the worker
+   * owning their connection id, instead of hashing them to any worker. Only
+   * valid with the default ConnectionIdAlgo. If the program cannot be loaded,
+   * e.g. for lack of CAP_BPF, the server logs it and runs without. Linux only.
+   * Note that this function must be called before initialize(..)
+   */
+  void setReusePortBpfRouting(bool enabled) noexcept;
+
   /**
    * Get transport settings.
    */
@@ -344,6 +383,16 @@ class QuicServer : public QuicServerWorker::WorkerCallback,
 
   void getAllConnectionsStats(std::vector<QuicConnectionStats>& stats);
 
+  /**
+   * Appends the stats records that the connections of all the workers publish
+   * when TransportSettings::publishConnectionStats is set. Unlike
+   * getAllConnectionsStats(), this doesn't run on the workers, so it can be
+   * called from any thread once the server is initialized, and never stalls
+   * the workers.
+   */
+  void getAllConnectionsStatsSnapshot(
+      std::vector<ConnectionStatsRecord>& records) const;
+
  private:
   explicit QuicServer(TransportSettings transportSettings);
 
@@ -392,6 +441,15 @@ class QuicServer : public QuicServerWorker::WorkerCallback,
 
   void bindWorkersToSocket(const folly::SocketAddress& address);
 
+#if defined(__linux__) && !defined(ANDROID)
+  // Registers the bound socket of the worker at idx with the reuseport BPF
+  // program, and attaches the program once all the workers are registered.
+  void addWorkerToReusePortBpfRouter(
+      QuicServerWorker& worker,
+      size_t idx,
+      size_t numWorkers);
+#endif
+
   std::vector<QuicVersion> supportedVersions_{{
       QuicVersion::MVFST,
       QuicVersion::MVFST_EXPERIMENTAL,
@@ -436,6 +494,15 @@ class QuicServer : public QuicServerWorker::WorkerCallback,
   ProcessId processId_{ProcessId::ZERO};
   uint32_t hostId_{0};
   ConnectionIdVersion cidVersion_{ConnectionIdVersion::V1};
+  bool fixedLengthConnIdRouting_{false};
+#if FOLLY_HAS_LIBURING
+  Optional<IoUringSendRing::Options> ioUringSendOptions_;
+#endif
+  uint32_t workerPacketRingCapacity_{0};
+  bool reusePortBpfRouting_{false};
+#if defined(__linux__) && !defined(ANDROID)
+  std::unique_ptr<ReusePortBpfRouter> reusePortBpfRouter_;
+#endif
   std::function<bool()> rejectNewConnections_{[]() { return false; }};
   std::function<bool(uint16_t)> isBlockListedSrcPort_{
       [](uint16_t) { return false; }};
@@ -17,6 +17,7 @@
 
 #include <quic/common/Optional.h>
 #include <quic/common/TransportKnobs.h>
+#include <quic/common/udpsocket/IoUringQuicAsyncUDPSocket.h>
 #include <algorithm>
 #include <chrono>
 #include <memory>
@@ -98,7 +99,17 @@ QuicServerTransport::Ptr QuicServerTransport::make(
     std::shared_ptr<const fizz::server::FizzServerContext> ctx,
     bool useConnectionEndWithErrorCallback) {
   auto qEvb = std::make_shared<FollyQuicEventBase>(evb);
-  auto qSock = std::make_unique<FollyQuicAsyncUDPSocket>(qEvb, std::move(sock));
+  std::unique_ptr<FollyQuicAsyncUDPSocket> qSock;
+#if FOLLY_HAS_LIBURING
+  // Set up by QuicServerWorker::setIoUringSendOptions().
+  if (auto ring = IoUringSendRing::get(evb)) {
+    qSock = std::make_unique<IoUringQuicAsyncUDPSocket>(
+        qEvb, std::move(sock), std::move(ring));
+  }
+#endif
+  if (!qSock) {
+    qSock = std::make_unique<FollyQuicAsyncUDPSocket>(qEvb, std::move(sock));
+  }
   return std::make_shared<QuicServerTransport>(
       std::move(qEvb),
       std::move(qSock),
@@ -139,6 +150,16 @@ void QuicServerTransport::setTransportStatsCallback(
   }
 }
 
+void QuicServerTransport::setConnectionStatsTable(
+    ConnectionStatsTable* table) noexcept {
+  if (connectionStatsTable_ && connectionStatsSlot_) {
+    connectionStatsTable_->releaseSlot(*connectionStatsSlot_);
+  }
+  connectionStatsSlot_.reset();
+  connectionStatsTable_ = table;
+  publishedConnectionStats_ = ConnectionStatsRecord();
+}
+
 void QuicServerTransport::setConnectionIdAlgo(
     ConnectionIdAlgo* connIdAlgo) noexcept {
   CHECK(connIdAlgo);
@@ -201,6 +222,7 @@ folly::Expected<folly::Unit, QuicError> QuicServerTransport::onReadData(
   maybeIssueConnectionIds();
   maybeNotifyTransportReady();
   maybeUpdateCongestionControllerFromTicket();
+  maybePublishConnectionStats();
 
   return folly::unit;
 }
@@ -272,15 +294,14 @@ void QuicServerTransport::writeData() {
     }
     return;
   }
-  uint64_t packetLimit =
-      (isConnectionPaced(*conn_)
-           ? conn_->pacer->updateAndGetWriteBatchSize(Clock::now())
-           : conn_->transportSettings.writeConnectionDataPacketsLimit);
+  uint64_t packetLimit = updateAndGetWritePacketLimit(*conn_, *socket_);
   // At the end of this function, clear out any probe packets credit we didn't
   // use.
   SCOPE_EXIT {
     conn_->pendingEvents.numProbePackets = {};
+    finishTxTimeSchedule(*conn_);
     maybeInitiateKeyUpdate(*conn_);
+    maybePublishConnectionStats();
   };
   if (conn_->initialWriteCipher) {
     auto res = handleInitialWriteDataCommon(srcConnId, destConnId, packetLimit);
@@ -359,11 +380,14 @@ void QuicServerTransport::closeTransport() {
       handshakeFinishedCb_->onHandshakeUnfinished();
       handshakeFinishedCb_ = nullptr;
     }
+  } else if (conn_->congestionControllerFactory) {
+    conn_->congestionControllerFactory->onConnectionClose(*conn_);
   }
   serverConn_->serverHandshakeLayer->cancel();
   // Clear out pending data.
   serverConn_->pendingZeroRttData.reset();
   serverConn_->pendingOneRttData.reset();
+  setConnectionStatsTable(nullptr);
   onServerClose(*serverConn_);
 }
 
@@ -711,6 +735,14 @@ void QuicServerTransport::setBufAccessor(BufAccessor* bufAccessor) {
   conn_->bufAccessor = bufAccessor;
 }
 
+void QuicServerTransport::setZeroCopyBufferRing(
+    ZeroCopyBufferRing* zeroCopyBufferRing) {
+  CHECK(zeroCopyBufferRing);
+  if (socket_ && socket_->setZeroCopy(true)) {
+    conn_->zeroCopyBufferRing = zeroCopyBufferRing;
+  }
+}
+
 const std::shared_ptr<const folly::AsyncTransportCertificate>
 QuicServerTransport::getPeerCertificate() const {
   const auto handshakeLayer = serverConn_->serverHandshakeLayer;
@@ -1347,6 +1379,39 @@ CipherInfo QuicServerTransport::getOneRttCipherInfo() const {
       conn_->oneRttWriteHeaderCipher->getKey()->clone()};
 }
 
+void QuicServerTransport::maybePublishConnectionStats() {
+  if (!connectionStatsTable_) {
+    return;
+  }
+  if (!connectionStatsSlot_) {
+    connectionStatsSlot_ = connectionStatsTable_->acquireSlot();
+    if (!connectionStatsSlot_) {
+      // The table is full, this connection won't show up in it.
+      connectionStatsTable_ = nullptr;
+      return;
+    }
+  }
+  ConnectionStatsRecord record;
+  record.srtt = conn_->lossState.srtt;
+  record.mrtt = conn_->lossState.mrtt;
+  if (conn_->congestionController) {
+    record.cwndBytes = conn_->congestionController->getCongestionWindow();
+  }
+  record.inflightBytes = conn_->lossState.inflightBytes;
+  record.totalBytesRetransmitted = conn_->lossState.totalBytesRetransmitted;
+  record.rtxCount = conn_->lossState.rtxCount;
+  if (conn_->pacer && conn_->transportSettings.pacingEnabled) {
+    record.pacingRateBytesPerSec = conn_->pacer->getPacingRateBytesPerSec();
+  }
+  if (conn_->streamManager) {
+    record.numStreams = conn_->streamManager->streams().size();
+  }
+  if (record != publishedConnectionStats_) {
+    connectionStatsTable_->publish(*connectionStatsSlot_, record);
+    publishedConnectionStats_ = record;
+  }
+}
+
 void QuicServerTransport::logTimeBasedStats() const {
   if (!conn_ || !conn_->statsCallback) {
     return;
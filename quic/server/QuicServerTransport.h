@@ -16,6 +16,7 @@
 #include <quic/common/events/FollyQuicEventBase.h>
 #include <quic/common/udpsocket/FollyQuicAsyncUDPSocket.h>
 #include <quic/congestion_control/CongestionControllerFactory.h>
+#include <quic/server/ConnectionStatsTable.h>
 #include <quic/server/handshake/ServerTransportParametersExtension.h>
 #include <quic/server/state/ServerConnectionIdRejector.h>
 #include <quic/server/state/ServerStateMachine.h>
@@ -121,6 +122,13 @@ class QuicServerTransport
   virtual void setTransportStatsCallback(
       QuicTransportStatsCallback* statsCallback) noexcept;
 
+  /**
+   * Set the worker's table to keep this connection's stats record in. The
+   * record is refreshed after reads and writes that change it, and removed
+   * when the connection closes. nullptr removes it right away.
+   */
+  void setConnectionStatsTable(ConnectionStatsTable* table) noexcept;
+
   /**
    * Set ConnectionIdAlgo implementation to encode and decode ConnectionId with
    * various info, such as routing related info.
@@ -165,6 +173,13 @@ class QuicServerTransport
 
   virtual void setBufAccessor(BufAccessor* bufAccessor);
 
+  /**
+   * Enables zerocopy writes from the in-place batch writers, using the given
+   * ring, which must track the sends on this transport's socket. Does nothing
+   * if the socket does not support zerocopy.
+   */
+  virtual void setZeroCopyBufferRing(ZeroCopyBufferRing* zeroCopyBufferRing);
+
   const std::shared_ptr<const folly::AsyncTransportCertificate>
   getPeerCertificate() const override;
 
@@ -240,6 +255,7 @@ class QuicServerTransport
   bool hasReadCipher() const;
   void registerAllTransportKnobParamHandlers();
   bool shouldWriteNewSessionTicket();
+  void maybePublishConnectionStats();
 
   folly::Executor* getFollyEventbase() const {
     // TODO (jbeshay): handle nullptr
@@ -268,6 +284,10 @@ class QuicServerTransport
       std::function<void(QuicServerTransport*, TransportKnobParam::Val)>>
       transportKnobParamHandlers_;
   mutable std::optional<QuicEventBaseAsFollyExecutor> eventBaseAsFollyExecutor_;
+  ConnectionStatsTable* connectionStatsTable_{nullptr};
+  Optional<ConnectionStatsTable::SlotId> connectionStatsSlot_;
+  // What was last published, so that unchanged stats are not written again.
+  ConnectionStatsRecord publishedConnectionStats_;
 
   // Container of observers for the socket / transport.
   //
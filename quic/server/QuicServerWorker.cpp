@@ -14,6 +14,7 @@
 #include <quic/QuicConstants.h>
 #include <atomic>
 #include <chrono>
+#include <cstring>
 #include <memory>
 
 #ifdef FOLLY_HAVE_MSG_ERRQUEUE
@@ -23,6 +24,7 @@
 #endif
 
 #include <folly/Conv.h>
+#include <quic/codec/DefaultConnectionIdAlgo.h>
 #include <quic/common/SocketUtil.h>
 #include <quic/congestion_control/Bbr.h>
 #include <quic/congestion_control/Copa.h>
@@ -46,6 +48,16 @@ bool isValidConnIdLength(const quic::ConnectionId& connId) {
   return quic::kMinInitialDestinationConnIdLength <= connId.size() &&
       connId.size() <= quic::kMaxConnectionIdSize;
 }
+
+static_assert(
+    quic::kDefaultConnectionIdSize == sizeof(uint64_t),
+    "Fixed-length routing keys hold the whole connection id");
+
+uint64_t fixedLengthConnIdKey(const uint8_t* data) {
+  uint64_t key;
+  memcpy(&key, data, sizeof(key));
+  return key;
+}
 } // namespace
 
 namespace quic {
@@ -75,6 +87,14 @@ QuicServerWorker::QuicServerWorker(
     bufAccessor_ = std::make_unique<BufAccessor>(
         kDefaultMaxUDPPayload * transportSettings_.maxBatchSize);
     VLOG(10) << "GSO write buf accessor created for ContinuousMemory data path";
+    if (transportSettings_.enableZeroCopyWrites) {
+      zeroCopyBufferRing_ = std::make_unique<ZeroCopyBufferRing>(
+          kDefaultMaxUDPPayload * transportSettings_.maxBatchSize,
+          transportSettings_.zeroCopyWriteBuffers);
+    }
+  }
+  if (transportSettings_.useConnectionSlabAllocator) {
+    slabAllocator_ = SlabAllocator::create();
   }
 }
 
@@ -124,6 +144,14 @@ void QuicServerWorker::bind(
         folly::SocketOptionKey::ApplyPos::POST_BIND);
   }
   socket_->setDFAndTurnOffPMTU();
+  if (zeroCopyBufferRing_) {
+    if (socket_->setZeroCopy(true)) {
+      socket_->setErrMessageCallback(this);
+    } else {
+      LOG(ERROR) << "Zerocopy writes are not supported on this socket";
+      zeroCopyBufferRing_.reset();
+    }
+  }
   if (transportSettings_.numGROBuffers_ > kDefaultNumGROBuffers) {
     socket_->setGRO(true);
     if (socket_->getGRO() > 0) {
@@ -133,6 +161,11 @@ void QuicServerWorker::bind(
   }
   socket_->setTimestamping(SOF_TIMESTAMPING_SOFTWARE);
   socket_->setTXTime({CLOCK_MONOTONIC, /*deadline=*/false});
+  if (transportSettings_.pacingEnabled && transportSettings_.txTimePacing &&
+      socket_->getTXTime().clockid < 0) {
+    LOG(ERROR) << "SO_TXTIME is not supported on this socket, pacing with "
+               << "timers only";
+  }
 
   socket_->setMaxReadsPerEvent(transportSettings_.maxServerRecvPacketsPerLoop);
   VLOG(3) << "Socket max reads per event set to "
@@ -422,6 +455,43 @@ void QuicServerWorker::onDataAvailable(
   }
 }
 
+#if defined(__linux__) && !defined(ANDROID)
+void QuicServerWorker::setXskReceiver(
+    std::unique_ptr<facebook::xdpsocket::XskReceiver> xskReceiver) {
+  CHECK(evb_->isInEventBaseThread());
+  xskReadHandler_.reset();
+  xskReceiver_ = std::move(xskReceiver);
+  if (!xskReceiver_) {
+    return;
+  }
+  xskReadHandler_ = std::make_unique<XskReadHandler>(
+      *this, evb_.get(), xskReceiver_->getFd());
+  xskReadHandler_->registerHandler(
+      folly::EventHandler::READ | folly::EventHandler::PERSIST);
+}
+
+void QuicServerWorker::onXskDataAvailable() noexcept {
+  // The packets of a batch were all waiting in the rx ring, so they share a
+  // receive time.
+  auto packetReceiveTime = Clock::now();
+  largestPacketReceiveTime_ =
+      std::max(largestPacketReceiveTime_, packetReceiveTime);
+  // The fd stays readable while the ring is not empty, so one batch per
+  // wakeup lets the evb interleave other work.
+  xskReceiver_->receive([&](const folly::SocketAddress& client,
+                            const folly::SocketAddress& /* local */,
+                            std::unique_ptr<folly::IOBuf> data,
+                            uint8_t tos) {
+    QUIC_STATS(statsCallback_, onPacketReceived);
+    QUIC_STATS(statsCallback_, onRead, data->length());
+    ReceivedUdpPacket udpPacket(std::move(data));
+    udpPacket.timings.receiveTimePoint = packetReceiveTime;
+    udpPacket.tosValue = tos;
+    handleNetworkData(client, udpPacket);
+  });
+}
+#endif
+
 void QuicServerWorker::handleNetworkData(
     const folly::SocketAddress& client,
     ReceivedUdpPacket& udpPacket,
@@ -460,6 +530,10 @@ void QuicServerWorker::handleNetworkData(
     uint8_t initialByte = cursor.readBE<uint8_t>();
     HeaderForm headerForm = getHeaderForm(initialByte);
     if (headerForm == HeaderForm::Short) {
+      if (fixedLengthConnIdRouting_ &&
+          tryRouteFixedLengthConnId(client, udpPacket)) {
+        return;
+      }
       if (auto maybeParsedShortHeader =
               parseShortHeaderInvariants(initialByte, cursor)) {
         RoutingData routingData(
@@ -670,9 +744,23 @@ QuicServerTransport::Ptr QuicServerWorker::makeTransport(
     const Optional<ConnectionId>& srcConnId,
     const ConnectionId& dstConnId,
     bool validNewToken) {
+  SlabAllocator::ScopedCurrent slabAllocatorScope(slabAllocator_.get());
   // create 'accepting' transport
   auto* evb = getEventBase();
   auto sock = makeSocket(evb);
+  if (sock && transportSettings_.pacingEnabled &&
+      transportSettings_.txTimePacing) {
+    // The transport writes through its own socket object, which only adds the
+    // SCM_TXTIME cmsg once SO_TXTIME has been set on it.
+    sock->setTXTime({CLOCK_MONOTONIC, /*deadline=*/false});
+  }
+  // The ring tracks zerocopy sends on the worker's fd, so it can only be used
+  // by transports writing to that fd.
+  bool sharesWorkerFd =
+      sock && sock->getNetworkSocket() == socket_->getNetworkSocket();
+#if FOLLY_HAS_LIBURING
+  maybeCreateIoUringSendRing();
+#endif
   auto trans =
       transportFactory_->make(evb, std::move(sock), client, quicVersion, ctx_);
   if (trans) {
@@ -680,6 +768,9 @@ QuicServerTransport::Ptr QuicServerWorker::makeTransport(
     if (transportSettings_.dataPathType == DataPathType::ContinuousMemory &&
         bufAccessor_) {
       trans->setBufAccessor(bufAccessor_.get());
+      if (zeroCopyBufferRing_ && sharesWorkerFd) {
+        trans->setZeroCopyBufferRing(zeroCopyBufferRing_.get());
+      }
     }
     trans->setPacingTimer(pacingTimer_);
     trans->setRoutingCallback(this);
@@ -716,6 +807,9 @@ QuicServerTransport::Ptr QuicServerWorker::makeTransport(
                 : "ChainedMemory");
 
     trans->setTransportSettings(transportSettingsCopy);
+    if (transportSettingsCopy.publishConnectionStats) {
+      trans->setConnectionStatsTable(&connectionStatsTable_);
+    }
     trans->setConnectionIdAlgo(connIdAlgo_.get());
     trans->setServerConnectionIdRejector(this);
     if (srcConnId) {
@@ -852,13 +946,13 @@ void QuicServerWorker::dispatchPacketData(
   // helper fn to handle fwd-ing data to the transport
   auto fwdNetworkDataToTransport = [&](QuicServerTransport* transport) {
     DCHECK(transport->getEventBase()->isInEventBaseThread());
-    transport->onNetworkData(client, std::move(networkData));
+    deliverNetworkData(transport, client, std::move(networkData));
     // process pending 0rtt data for this DCID if present
     if (routingData.isInitial && !pending0RttData_.empty()) {
       auto itr = pending0RttData_.find(dstConnId);
       if (itr != pending0RttData_.end()) {
         for (auto& data : itr->second) {
-          transport->onNetworkData(client, std::move(data));
+          deliverNetworkData(transport, client, std::move(data));
         }
         pending0RttData_.erase(itr);
       }
@@ -1203,6 +1297,17 @@ void QuicServerWorker::onReadClosed() noexcept {
   shutdownAllConnections(LocalErrorCode::SHUTTING_DOWN);
 }
 
+void QuicServerWorker::errMessage(const cmsghdr& cmsg) noexcept {
+  if (zeroCopyBufferRing_) {
+    zeroCopyBufferRing_->onErrMessage(cmsg);
+  }
+}
+
+void QuicServerWorker::errMessageError(
+    const folly::AsyncSocketException& ex) noexcept {
+  VLOG(4) << "QuicServer error queue read failed: " << ex.what();
+}
+
 int QuicServerWorker::getTakeoverHandlerSocketFD() {
   CHECK(takeoverCB_);
   return takeoverCB_->getSocketFD();
@@ -1243,6 +1348,150 @@ void QuicServerWorker::setConnectionIdVersion(
   cidVersion_ = cidVersion;
 }
 
+#if FOLLY_HAS_LIBURING
+void QuicServerWorker::setIoUringSendOptions(
+    const IoUringSendRing::Options& options) noexcept {
+  ioUringSendOptions_ = options;
+}
+
+void QuicServerWorker::maybeCreateIoUringSendRing() {
+  if (!ioUringSendOptions_ || ioUringSendRing_) {
+    return;
+  }
+  try {
+    ioUringSendRing_ =
+        IoUringSendRing::getOrCreate(getEventBase(), *ioUringSendOptions_);
+  } catch (const std::exception& ex) {
+    LOG(ERROR) << "Failed to create the io_uring send ring, sending with "
+               << "sendmsg: " << ex.what();
+    ioUringSendOptions_.reset();
+  }
+}
+#endif
+
+void QuicServerWorker::setFixedLengthConnIdRouting(bool enabled) noexcept {
+  fixedLengthConnIdRouting_ = enabled;
+  fixedLengthConnIdMap_.clear();
+  if (!enabled) {
+    return;
+  }
+  for (const auto& [connId, transport] : connectionIdMap_) {
+    addFixedLengthConnId(connId, transport.get());
+  }
+}
+
+bool QuicServerWorker::tryRouteFixedLengthConnId(
+    const folly::SocketAddress& client,
+    ReceivedUdpPacket& udpPacket) noexcept {
+  // Short header: the initial byte, then the dst conn id.
+  const folly::IOBuf* buf = udpPacket.buf.front();
+  if (!buf || buf->length() < sizeof(uint8_t) + kDefaultConnectionIdSize) {
+    return false;
+  }
+  const uint8_t* connIdData = buf->data() + sizeof(uint8_t);
+  auto connIdParams = DefaultConnectionIdAlgo::parseConnectionIdDefault(
+      connIdData, kDefaultConnectionIdSize);
+  // Ids of other workers or processes are routed by the regular path.
+  if (connIdParams.hasError() || connIdParams->workerId != workerId_ ||
+      connIdParams->processId != static_cast<uint8_t>(processId_)) {
+    return false;
+  }
+  auto it = fixedLengthConnIdMap_.find(fixedLengthConnIdKey(connIdData));
+  if (it == fixedLengthConnIdMap_.end()) {
+    return false;
+  }
+  QuicServerTransport* transport = it->second;
+  DCHECK(transport->getEventBase()->isInEventBaseThread());
+  deliverNetworkData(transport, client, NetworkData(std::move(udpPacket)));
+  return true;
+}
+
+void QuicServerWorker::deliverNetworkData(
+    QuicServerTransport* transport,
+    const folly::SocketAddress& client,
+    NetworkData&& networkData) {
+  if (!transportSettings_.batchServerRecvPacketsPerLoop) {
+    SlabAllocator::ScopedCurrent slabAllocatorScope(slabAllocator_.get());
+    transport->onNetworkData(client, std::move(networkData));
+    return;
+  }
+  auto [it, inserted] =
+      receiveBatchIndex_.emplace(transport, receiveBatches_.size());
+  if (!inserted) {
+    auto& batch = receiveBatches_[it->second];
+    if (batch.client == client) {
+      batch.networkData.append(std::move(networkData));
+      return;
+    }
+    // The peer address changed, hand over what came from the old one first
+    // so that the transport sees the packets in order.
+    SlabAllocator::ScopedCurrent slabAllocatorScope(slabAllocator_.get());
+    batch.transport->onNetworkData(batch.client, std::move(batch.networkData));
+    batch.client = client;
+    batch.networkData = std::move(networkData);
+    return;
+  }
+  receiveBatches_.push_back(
+      {transport->shared_from_this(), client, std::move(networkData)});
+  if (!receiveBatchFlusher_.isLoopCallbackScheduled()) {
+    // Runs after the read handlers of this loop, so one batch collects
+    // everything read in it.
+    evb_->runInLoop(&receiveBatchFlusher_);
+  }
+}
+
+void QuicServerWorker::flushReceiveBatches() noexcept {
+  // Delivering can close transports and call back into the worker, so work
+  // off a local copy.
+  auto batches = std::move(receiveBatches_);
+  receiveBatches_.clear();
+  receiveBatchIndex_.clear();
+  SlabAllocator::ScopedCurrent slabAllocatorScope(slabAllocator_.get());
+  for (auto& batch : batches) {
+    batch.transport->onNetworkData(batch.client, std::move(batch.networkData));
+  }
+  // Keep the capacity for the next loop.
+  batches.clear();
+  if (receiveBatches_.empty()) {
+    receiveBatches_.swap(batches);
+  }
+}
+
+void QuicServerWorker::initPacketRings(size_t numWorkers, uint32_t capacity) {
+  packetRings_ = std::make_unique<WorkerPacketRings>(numWorkers, capacity);
+}
+
+WorkerPacketRings* QuicServerWorker::getPacketRings() const noexcept {
+  return packetRings_.get();
+}
+
+void QuicServerWorker::drainPacketRings() noexcept {
+  auto numPackets =
+      packetRings_->drain([this](WorkerPacketRings::Packet&& packet) {
+        dispatchPacketData(
+            packet.client,
+            std::move(packet.routingData),
+            std::move(packet.networkData),
+            packet.quicVersion,
+            packet.isForwardedData);
+      });
+  QUIC_STATS(statsCallback_, onWorkerPacketRingDrained, numPackets);
+}
+
+void QuicServerWorker::addFixedLengthConnId(
+    const ConnectionId& id,
+    QuicServerTransport* transport) {
+  if (id.size() == kDefaultConnectionIdSize) {
+    fixedLengthConnIdMap_.emplace(fixedLengthConnIdKey(id.data()), transport);
+  }
+}
+
+void QuicServerWorker::removeFixedLengthConnId(const ConnectionId& id) {
+  if (id.size() == kDefaultConnectionIdSize) {
+    fixedLengthConnIdMap_.erase(fixedLengthConnIdKey(id.data()));
+  }
+}
+
 void QuicServerWorker::setNewConnectionSocketFactory(
     QuicUDPSocketFactory* factory) {
   socketFactory_ = factory;
@@ -1337,8 +1586,12 @@ void QuicServerWorker::onConnectionIdAvailable(
     LOG(ERROR) << "connectionIdMap_ already has CID=" << id
                << " Is same transport: "
                << (existingTransportPtr == transportPtr);
-  } else if (boundServerTransports_.emplace(transportPtr, weakTransport)
-                 .second) {
+    return;
+  }
+  if (fixedLengthConnIdRouting_) {
+    addFixedLengthConnId(id, transportPtr);
+  }
+  if (boundServerTransports_.emplace(transportPtr, weakTransport).second) {
     if (!isScheduled()) {
       // If we aren't currently running, start the timer.
       evb_->timer().scheduleTimeout(this, timeLoggingSamplingInterval_);
@@ -1355,6 +1608,7 @@ void QuicServerWorker::onConnectionIdRetired(
   } else {
     VLOG(4) << "Retiring CID=" << id << " " << transport;
     connectionIdMap_.erase(it);
+    removeFixedLengthConnId(id);
   }
 }
 
@@ -1416,6 +1670,7 @@ void QuicServerWorker::onConnectionUnbound(
       }
     }
     connectionIdMap_.erase(connId.connId);
+    removeFixedLengthConnId(connId.connId);
     if (incorrectTransportPtr != nullptr) {
       if (boundServerTransports_.find(incorrectTransportPtr) !=
           boundServerTransports_.end()) {
@@ -1448,6 +1703,9 @@ void QuicServerWorker::shutdownAllConnections(LocalErrorCode error) {
   if (socket_) {
     socket_->pauseRead();
   }
+#if defined(__linux__) && !defined(ANDROID)
+  xskReadHandler_.reset();
+#endif
   if (takeoverCB_) {
     takeoverCB_->pause();
   }
@@ -1477,11 +1735,22 @@ void QuicServerWorker::shutdownAllConnections(LocalErrorCode error) {
   boundServerTransports_.clear();
   sourceAddressMap_.clear();
   connectionIdMap_.clear();
+  fixedLengthConnIdMap_.clear();
+  receiveBatchFlusher_.cancelLoopCallback();
+  receiveBatches_.clear();
+  receiveBatchIndex_.clear();
+  if (packetRings_) {
+    // Free the buffers of packets that will never be dispatched.
+    packetRings_->drain([](WorkerPacketRings::Packet&&) {});
+  }
   takeoverPktHandler_.stop();
   if (statsCallback_) {
     statsCallback_.reset();
   }
   socket_.reset();
+#if defined(__linux__) && !defined(ANDROID)
+  xskReceiver_.reset();
+#endif
   takeoverCB_.reset();
   pacingTimer_.reset();
   evb_.reset();
@@ -13,6 +13,7 @@
 #include <folly/container/F14Set.h>
 #include <folly/io/SocketOptionMap.h>
 #include <folly/io/async/AsyncUDPSocket.h>
+#include <folly/io/async/EventHandler.h>
 #include <folly/small_vector.h>
 #include <cstdint>
 #include <type_traits>
@@ -20,21 +21,28 @@
 #include <quic/codec/ConnectionIdAlgo.h>
 #include <quic/codec/QuicConnectionId.h>
 #include <quic/common/BufAccessor.h>
+#include <quic/common/SlabAllocator.h>
+#include <quic/common/ZeroCopyBufferRing.h>
 #include <quic/common/events/HighResQuicTimer.h>
+#include <quic/common/udpsocket/IoUringSendRing.h>
 #include <quic/congestion_control/CongestionControllerFactory.h>
+#include <quic/server/ConnectionStatsTable.h>
 #include <quic/server/QuicServerPacketRouter.h>
 #include <quic/server/QuicServerTransportFactory.h>
 #include <quic/server/QuicUDPSocketFactory.h>
 #include <quic/server/RateLimiter.h>
+#include <quic/server/WorkerPacketRings.h>
 #include <quic/server/state/ServerConnectionIdRejector.h>
 #include <quic/state/QuicConnectionStats.h>
 #include <quic/state/QuicTransportStatsCallback.h>
+#include <quic/xsk/XskReceiver.h>
 
 namespace quic {
 
 class AcceptObserver;
 
 class QuicServerWorker : public FollyAsyncUDPSocketAlias::ReadCallback,
+                         public FollyAsyncUDPSocketAlias::ErrMessageCallback,
                          public QuicServerTransport::RoutingCallback,
                          public QuicServerTransport::HandshakeFinishedCallback,
                          public ServerConnectionIdRejector,
@@ -197,6 +205,16 @@ class QuicServerWorker : public FollyAsyncUDPSocketAlias::ReadCallback,
    */
   void setSocket(std::unique_ptr<FollyAsyncUDPSocketAlias> socket);
 
+#if defined(__linux__) && !defined(ANDROID)
+  /**
+   * Also receive packets from an AF_XDP socket, bypassing the kernel's UDP
+   * stack. The receiver must have been initialized. Replies still go out
+   * through the listening socket. Must be called on the worker's evb.
+   */
+  void setXskReceiver(
+      std::unique_ptr<facebook::xdpsocket::XskReceiver> xskReceiver);
+#endif
+
   /**
    * Sets the socket options
    */
@@ -309,6 +327,43 @@ class QuicServerWorker : public FollyAsyncUDPSocketAlias::ReadCallback,
    */
   void setConnectionIdVersion(ConnectionIdVersion cidVersion) noexcept;
 
+  /**
+   * Routes short header packets to this worker's connections straight off the
+   * packet buffer, without parsing the header or building a ConnectionId.
+   * Only valid if every connection id of this worker is
+   * kDefaultConnectionIdSize bytes long and encoded by DefaultConnectionIdAlgo.
+   * Packets that miss the fast path take the regular route.
+   */
+  void setFixedLengthConnIdRouting(bool enabled) noexcept;
+
+#if FOLLY_HAS_LIBURING
+  /**
+   * Has the transports created with QuicServerTransport::make() send through
+   * the IoUringSendRing of this worker's evb, which is created with options
+   * when the first transport is made.
+   */
+  void setIoUringSendOptions(const IoUringSendRing::Options& options) noexcept;
+
+  // nullptr until a transport has been made, or if io_uring is unavailable.
+  [[nodiscard]] const std::shared_ptr<IoUringSendRing>& getIoUringSendRing()
+      const noexcept {
+    return ioUringSendRing_;
+  }
+#endif
+
+  /**
+   * Creates the rings that numWorkers workers, indexed by worker id, use to
+   * hand this worker the packets routed to it. Must be called before the
+   * workers start.
+   */
+  void initPacketRings(size_t numWorkers, uint32_t capacity);
+
+  // Null unless initPacketRings() was called.
+  WorkerPacketRings* getPacketRings() const noexcept;
+
+  // Dispatches the packets queued on this worker's rings.
+  void drainPacketRings() noexcept;
+
   void setNewConnectionSocketFactory(QuicUDPSocketFactory* factory);
 
   void setTransportFactory(QuicServerTransportFactory* factory);
@@ -424,6 +479,12 @@ class QuicServerWorker : public FollyAsyncUDPSocketAlias::ReadCallback,
 
   void onReadClosed() noexcept override;
 
+  // From ErrMessageCallback. Only installed for zerocopy completions.
+  void errMessage(const cmsghdr& cmsg) noexcept override;
+
+  void errMessageError(
+      const folly::AsyncSocketException& ex) noexcept override;
+
   void dispatchPacketData(
       const folly::SocketAddress& client,
       RoutingData&& routingData,
@@ -517,6 +578,15 @@ class QuicServerWorker : public FollyAsyncUDPSocketAlias::ReadCallback,
 
   void getAllConnectionsStats(std::vector<QuicConnectionStats>& stats);
 
+  /**
+   * The stats records of this worker's connections, kept up to date when
+   * TransportSettings::publishConnectionStats is set. Safe to read from any
+   * thread.
+   */
+  const ConnectionStatsTable& getConnectionStatsTable() const {
+    return connectionStatsTable_;
+  }
+
   void timeoutExpired() noexcept override;
   void logTimeBasedStats();
 
@@ -602,6 +672,33 @@ class QuicServerWorker : public FollyAsyncUDPSocketAlias::ReadCallback,
       Optional<QuicVersion> quicVersion,
       bool isForwardedData = false);
 
+  /**
+   * Hands a short header packet to the transport owning its connection id if
+   * the id is one of this worker's fixed-length ids. Returns false, leaving
+   * the packet untouched, if it needs the regular route.
+   */
+  bool tryRouteFixedLengthConnId(
+      const folly::SocketAddress& client,
+      ReceivedUdpPacket& udpPacket) noexcept;
+
+  /**
+   * Hands networkData to the transport, or adds it to the transport's receive
+   * batch for this loop if batchServerRecvPacketsPerLoop is set.
+   */
+  void deliverNetworkData(
+      QuicServerTransport* transport,
+      const folly::SocketAddress& client,
+      NetworkData&& networkData);
+
+  // Hands every receive batch to its transport.
+  void flushReceiveBatches() noexcept;
+
+  void addFixedLengthConnId(
+      const ConnectionId& id,
+      QuicServerTransport* transport);
+
+  void removeFixedLengthConnId(const ConnectionId& id);
+
   // Create transport and invoke appropriate setters
   QuicServerTransport::Ptr makeTransport(
       QuicVersion quicVersion,
@@ -640,6 +737,45 @@ class QuicServerWorker : public FollyAsyncUDPSocketAlias::ReadCallback,
       ConnectionIdHash>
       pending0RttData_{20};
 
+  // Mirrors connectionIdMap_ for fixed-length routing, keyed by the connection
+  // id bytes loaded as one integer. Only populated when enabled.
+  folly::F14FastMap<uint64_t, QuicServerTransport*> fixedLengthConnIdMap_;
+  bool fixedLengthConnIdRouting_{false};
+
+#if FOLLY_HAS_LIBURING
+  void maybeCreateIoUringSendRing();
+
+  Optional<IoUringSendRing::Options> ioUringSendOptions_;
+  std::shared_ptr<IoUringSendRing> ioUringSendRing_;
+#endif
+
+  // Packets received for a connection during the current evb loop.
+  struct ReceiveBatch {
+    QuicServerTransport::Ptr transport;
+    folly::SocketAddress client;
+    NetworkData networkData;
+  };
+
+  class ReceiveBatchFlusher : public folly::EventBase::LoopCallback {
+   public:
+    explicit ReceiveBatchFlusher(QuicServerWorker& worker) : worker_(worker) {}
+
+    void runLoopCallback() noexcept override {
+      worker_.flushReceiveBatches();
+    }
+
+   private:
+    QuicServerWorker& worker_;
+  };
+
+  std::vector<ReceiveBatch> receiveBatches_;
+  // Index of each transport's batch in receiveBatches_.
+  folly::F14FastMap<QuicServerTransport*, size_t> receiveBatchIndex_;
+  ReceiveBatchFlusher receiveBatchFlusher_{*this};
+
+  // Packets routed to this worker by other workers.
+  std::unique_ptr<WorkerPacketRings> packetRings_;
+
   // Contains every unique transport that is mapped in connectionIdMap_.
   folly::F14FastMap<QuicServerTransport*, std::weak_ptr<QuicServerTransport>>
       boundServerTransports_;
@@ -664,6 +800,7 @@ class QuicServerWorker : public FollyAsyncUDPSocketAlias::ReadCallback,
   // QuicServerWorker maintains ownership of the info stats callback
   std::unique_ptr<QuicTransportStatsCallback> statsCallback_;
   std::chrono::seconds timeLoggingSamplingInterval_{1};
+  ConnectionStatsTable connectionStatsTable_;
 
   // Handle takeover between processes
   std::unique_ptr<TakeoverHandlerCallback> takeoverCB_;
@@ -678,11 +815,42 @@ class QuicServerWorker : public FollyAsyncUDPSocketAlias::ReadCallback,
   // Output buffer to be used for continuous memory GSO write
   std::unique_ptr<BufAccessor> bufAccessor_;
 
+  // Spare output buffers for zerocopy writes. Transports share the worker's
+  // fd, and with it the kernel's zerocopy send counter, so they share a ring.
+  std::unique_ptr<ZeroCopyBufferRing> zeroCopyBufferRing_;
+
+  // Where the connections' fixed objects are allocated from, if
+  // useConnectionSlabAllocator is set. It is current on the worker's thread
+  // while the worker sets a connection up or hands it packets.
+  SlabAllocator::Ptr slabAllocator_;
+
   // Rate limits the creation of new connections for this worker.
   std::unique_ptr<RateLimiter> newConnRateLimiter_;
 
   Optional<std::function<int()>> unfinishedHandshakeLimitFn_;
 
+#if defined(__linux__) && !defined(ANDROID)
+  class XskReadHandler : public folly::EventHandler {
+   public:
+    XskReadHandler(QuicServerWorker& worker, folly::EventBase* evb, int fd)
+        : folly::EventHandler(evb, folly::NetworkSocket::fromFd(fd)),
+          worker_(worker) {}
+
+    void handlerReady(uint16_t /* events */) noexcept override {
+      worker_.onXskDataAvailable();
+    }
+
+   private:
+    QuicServerWorker& worker_;
+  };
+
+  // Handles one batch of packets from the AF_XDP rx ring.
+  void onXskDataAvailable() noexcept;
+
+  std::unique_ptr<facebook::xdpsocket::XskReceiver> xskReceiver_;
+  std::unique_ptr<XskReadHandler> xskReadHandler_;
+#endif
+
   // EventRecvmsgCallback data
   std::unique_ptr<MsgHdr> msgHdr_;
 
@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#if defined(__linux__) && !defined(ANDROID)
+
+#include <quic/server/ReusePortBpfRouter.h>
+
+#include <folly/Conv.h>
+#include <folly/String.h>
+#include <glog/logging.h>
+#include <quic/codec/QuicConnectionId.h>
+#include <quic/codec/Types.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+
+namespace {
+
+// The program's context starts at the UDP header.
+constexpr int32_t kUdpHeaderLen = 8;
+// The initial byte and the DCID bytes up to the worker id of every version
+// are loaded to the stack, at fp - kLoadLen.
+constexpr int32_t kLoadLen = 8;
+// Where the u32 map key is stored on the stack.
+constexpr int16_t kKeyOffset = -kLoadLen - 4;
+
+// Stack offset of the DCID byte at the given index.
+constexpr int16_t dcidOffset(int16_t index) {
+  return -kLoadLen + 1 + index;
+}
+
+bpf_insn makeInsn(
+    uint8_t code,
+    uint8_t dst,
+    uint8_t src,
+    int16_t off,
+    int32_t imm) {
+  bpf_insn insn;
+  memset(&insn, 0, sizeof(insn));
+  insn.code = code;
+  insn.dst_reg = dst;
+  insn.src_reg = src;
+  insn.off = off;
+  insn.imm = imm;
+  return insn;
+}
+
+bpf_insn movReg(uint8_t dst, uint8_t src) {
+  return makeInsn(BPF_ALU64 | BPF_MOV | BPF_X, dst, src, 0, 0);
+}
+
+bpf_insn movImm(uint8_t dst, int32_t imm) {
+  return makeInsn(BPF_ALU64 | BPF_MOV | BPF_K, dst, 0, 0, imm);
+}
+
+bpf_insn aluImm(uint8_t op, uint8_t dst, int32_t imm) {
+  return makeInsn(BPF_ALU64 | op | BPF_K, dst, 0, 0, imm);
+}
+
+bpf_insn aluReg(uint8_t op, uint8_t dst, uint8_t src) {
+  return makeInsn(BPF_ALU64 | op | BPF_X, dst, src, 0, 0);
+}
+
+bpf_insn loadByte(uint8_t dst, uint8_t src, int16_t off) {
+  return makeInsn(BPF_LDX | BPF_MEM | BPF_B, dst, src, off, 0);
+}
+
+bpf_insn storeWord(uint8_t dst, uint8_t src, int16_t off) {
+  return makeInsn(BPF_STX | BPF_MEM | BPF_W, dst, src, off, 0);
+}
+
+// The offset is patched once the jump target is known.
+bpf_insn jumpImm(uint8_t op, uint8_t dst, int32_t imm) {
+  return makeInsn(BPF_JMP | op | BPF_K, dst, 0, 0, imm);
+}
+
+bpf_insn jump() {
+  return makeInsn(BPF_JMP | BPF_JA, 0, 0, 0, 0);
+}
+
+bpf_insn call(int32_t helper) {
+  return makeInsn(BPF_JMP | BPF_CALL, 0, 0, 0, helper);
+}
+
+bpf_insn exitInsn() {
+  return makeInsn(BPF_JMP | BPF_EXIT, 0, 0, 0, 0);
+}
+
+int bpf(int cmd, bpf_attr& attr) {
+  return (int)syscall(__NR_bpf, cmd, &attr, sizeof(attr));
+}
+
+std::runtime_error makeError(const char* what) {
+  return std::runtime_error(folly::to<std::string>(
+      "ReusePortBpfRouter: ", what, ": ", folly::errnoStr(errno)));
+}
+
+} // namespace
+
+namespace quic {
+
+ReusePortBpfRouter::ReusePortBpfRouter(uint32_t numWorkers)
+    : numWorkers_(numWorkers) {
+  CHECK_GT(numWorkers_, 0);
+}
+
+ReusePortBpfRouter::~ReusePortBpfRouter() {
+  // An attached program keeps itself and the map alive.
+  if (progFd_ >= 0) {
+    close(progFd_);
+  }
+  if (mapFd_ >= 0) {
+    close(mapFd_);
+  }
+}
+
+std::vector<bpf_insn> ReusePortBpfRouter::makeProgram(
+    uint32_t numWorkers,
+    int mapFd) {
+  std::vector<bpf_insn> prog;
+  std::vector<size_t> jumpsToPass;
+  std::vector<size_t> jumpsToSelect;
+  auto emit = [&prog](bpf_insn insn) {
+    prog.push_back(insn);
+    return prog.size() - 1;
+  };
+  auto patch = [&prog](size_t jumpIdx) {
+    prog[jumpIdx].off = int16_t(prog.size() - (jumpIdx + 1));
+  };
+
+  emit(movReg(BPF_REG_6, BPF_REG_1));
+  // bpf_skb_load_bytes(ctx, kUdpHeaderLen, fp - kLoadLen, kLoadLen). Fails
+  // for packets too short to carry the worker id.
+  emit(movImm(BPF_REG_2, kUdpHeaderLen));
+  emit(movReg(BPF_REG_3, BPF_REG_10));
+  emit(aluImm(BPF_ADD, BPF_REG_3, -kLoadLen));
+  emit(movImm(BPF_REG_4, kLoadLen));
+  emit(call(BPF_FUNC_skb_load_bytes));
+  jumpsToPass.push_back(emit(jumpImm(BPF_JNE, BPF_REG_0, 0)));
+  emit(loadByte(BPF_REG_2, BPF_REG_10, -kLoadLen));
+  jumpsToPass.push_back(
+      emit(jumpImm(BPF_JSET, BPF_REG_2, quic::kHeaderFormMask)));
+
+  // r3 = worker id, read like DefaultConnectionIdAlgo for the id's version in
+  // its top two bits.
+  emit(loadByte(BPF_REG_2, BPF_REG_10, dcidOffset(0)));
+  emit(aluImm(BPF_RSH, BPF_REG_2, 6));
+  auto notV1 = emit(jumpImm(
+      BPF_JNE, BPF_REG_2, static_cast<int32_t>(ConnectionIdVersion::V1)));
+  emit(loadByte(BPF_REG_3, BPF_REG_10, dcidOffset(2)));
+  emit(aluImm(BPF_LSH, BPF_REG_3, 2));
+  emit(aluImm(BPF_AND, BPF_REG_3, 0xff));
+  emit(loadByte(BPF_REG_4, BPF_REG_10, dcidOffset(3)));
+  emit(aluImm(BPF_RSH, BPF_REG_4, 6));
+  emit(aluReg(BPF_OR, BPF_REG_3, BPF_REG_4));
+  jumpsToSelect.push_back(emit(jump()));
+  patch(notV1);
+  auto notV2 = emit(jumpImm(
+      BPF_JNE, BPF_REG_2, static_cast<int32_t>(ConnectionIdVersion::V2)));
+  emit(loadByte(BPF_REG_3, BPF_REG_10, dcidOffset(4)));
+  jumpsToSelect.push_back(emit(jump()));
+  patch(notV2);
+  jumpsToPass.push_back(emit(jumpImm(
+      BPF_JNE, BPF_REG_2, static_cast<int32_t>(ConnectionIdVersion::V3))));
+  emit(loadByte(BPF_REG_3, BPF_REG_10, dcidOffset(5)));
+
+  // bpf_sk_select_reuseport(ctx, map, &(workerId % numWorkers), 0). If the
+  // worker has no socket the kernel falls back to hashing.
+  for (auto jumpIdx : jumpsToSelect) {
+    patch(jumpIdx);
+  }
+  emit(aluImm(BPF_MOD, BPF_REG_3, static_cast<int32_t>(numWorkers)));
+  emit(storeWord(BPF_REG_10, BPF_REG_3, kKeyOffset));
+  emit(movReg(BPF_REG_1, BPF_REG_6));
+  // A 64-bit immediate load takes two instructions.
+  emit(makeInsn(
+      BPF_LD | BPF_DW | BPF_IMM, BPF_REG_2, BPF_PSEUDO_MAP_FD, 0, mapFd));
+  emit(makeInsn(0, 0, 0, 0, 0));
+  emit(movReg(BPF_REG_3, BPF_REG_10));
+  emit(aluImm(BPF_ADD, BPF_REG_3, kKeyOffset));
+  emit(movImm(BPF_REG_4, 0));
+  emit(call(BPF_FUNC_sk_select_reuseport));
+
+  for (auto jumpIdx : jumpsToPass) {
+    patch(jumpIdx);
+  }
+  emit(movImm(BPF_REG_0, SK_PASS));
+  emit(exitInsn());
+  return prog;
+}
+
+folly::Expected<folly::Unit, std::runtime_error> ReusePortBpfRouter::init() {
+  bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.map_type = BPF_MAP_TYPE_REUSEPORT_SOCKARRAY;
+  attr.key_size = sizeof(uint32_t);
+  attr.value_size = sizeof(uint32_t);
+  attr.max_entries = numWorkers_;
+  mapFd_ = bpf(BPF_MAP_CREATE, attr);
+  if (mapFd_ < 0) {
+    return folly::makeUnexpected(makeError("Failed to create socket map"));
+  }
+
+  auto prog = makeProgram(numWorkers_, mapFd_);
+  static const char kLicense[] = "Dual MIT/GPL";
+  memset(&attr, 0, sizeof(attr));
+  attr.prog_type = BPF_PROG_TYPE_SK_REUSEPORT;
+  attr.insns = (__u64)(uintptr_t)prog.data();
+  attr.insn_cnt = prog.size();
+  attr.license = (__u64)(uintptr_t)kLicense;
+  progFd_ = bpf(BPF_PROG_LOAD, attr);
+  if (progFd_ < 0) {
+    auto error = makeError("Failed to load program");
+    // Load it again for the verifier's reasons.
+    std::vector<char> log(1 << 16);
+    attr.log_level = 1;
+    attr.log_buf = (__u64)(uintptr_t)log.data();
+    attr.log_size = log.size();
+    if (bpf(BPF_PROG_LOAD, attr) < 0 && log[0] != '\0') {
+      LOG(ERROR) << "ReusePortBpfRouter: verifier log:\n" << log.data();
+    }
+    return folly::makeUnexpected(std::move(error));
+  }
+  return folly::unit;
+}
+
+folly::Expected<folly::Unit, std::runtime_error>
+ReusePortBpfRouter::setWorkerSocket(uint32_t workerIdx, int fd) {
+  CHECK_LT(workerIdx, numWorkers_);
+  uint32_t key = workerIdx;
+  uint32_t value = fd;
+  bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.map_fd = mapFd_;
+  attr.key = (__u64)(uintptr_t)&key;
+  attr.value = (__u64)(uintptr_t)&value;
+  attr.flags = BPF_ANY;
+  if (bpf(BPF_MAP_UPDATE_ELEM, attr) < 0) {
+    return folly::makeUnexpected(makeError("Failed to add worker socket"));
+  }
+  return folly::unit;
+}
+
+folly::Expected<folly::Unit, std::runtime_error> ReusePortBpfRouter::attach(
+    int fd) {
+  if (setsockopt(
+          fd,
+          SOL_SOCKET,
+          SO_ATTACH_REUSEPORT_EBPF,
+          &progFd_,
+          sizeof(progFd_)) < 0) {
+    return folly::makeUnexpected(makeError("Failed to attach program"));
+  }
+  return folly::unit;
+}
+
+} // namespace quic
+
+#endif
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#if defined(__linux__) && !defined(ANDROID)
+
+#include <folly/Expected.h>
+#include <linux/bpf.h>
+
+#include <stdexcept>
+#include <vector>
+
+namespace quic {
+
+/**
+ * An SO_ATTACH_REUSEPORT_EBPF program for the SO_REUSEPORT group of the
+ * workers' sockets. It steers each short header packet to the socket of the
+ * worker that owns its destination connection id: the worker id is decoded
+ * from DefaultConnectionIdAlgo's bit layout for the id's version, and the
+ * worker picked the same way QuicServer::routeDataToWorker picks it, so the
+ * packet does not have to be handed over to another worker.
+ *
+ * Long header packets, ids of unknown versions, and packets for workers whose
+ * socket is not registered are left to the kernel's reuseport hash.
+ *
+ * Loading the program needs CAP_BPF (or CAP_SYS_ADMIN).
+ */
+class ReusePortBpfRouter {
+ public:
+  explicit ReusePortBpfRouter(uint32_t numWorkers);
+
+  ~ReusePortBpfRouter();
+
+  ReusePortBpfRouter(const ReusePortBpfRouter&) = delete;
+  ReusePortBpfRouter& operator=(const ReusePortBpfRouter&) = delete;
+
+  // Creates the socket map and loads the program.
+  folly::Expected<folly::Unit, std::runtime_error> init();
+
+  /**
+   * Registers the socket of the worker with the given index. The socket must
+   * already be bound with SO_REUSEPORT.
+   */
+  folly::Expected<folly::Unit, std::runtime_error> setWorkerSocket(
+      uint32_t workerIdx,
+      int fd);
+
+  // Attaches the program to the reuseport group that the socket is in.
+  folly::Expected<folly::Unit, std::runtime_error> attach(int fd);
+
+  /**
+   * The program's instructions, selecting sockets from the
+   * BPF_MAP_TYPE_REUSEPORT_SOCKARRAY map behind mapFd.
+   */
+  static std::vector<bpf_insn> makeProgram(uint32_t numWorkers, int mapFd);
+
+ private:
+  uint32_t numWorkers_;
+  int mapFd_{-1};
+  int progFd_{-1};
+};
+
+} // namespace quic
+
+#endif
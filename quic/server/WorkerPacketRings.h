@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/ProducerConsumerQueue.h>
+#include <folly/SocketAddress.h>
+#include <glog/logging.h>
+#include <quic/common/NetworkData.h>
+#include <quic/common/Optional.h>
+#include <quic/server/QuicServerPacketRouter.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace quic {
+
+/**
+ * The packets that other workers routed to a worker. There is one bounded
+ * lock-free ring per sending worker, so each ring has a single producer and
+ * the receiving worker is the single consumer of all of them.
+ *
+ * Producers only need to wake the consumer up when its rings go from empty to
+ * non-empty. The consumer drains the rings in one batch per wakeup instead of
+ * running one callback per packet.
+ */
+class WorkerPacketRings {
+ public:
+  struct Packet {
+    folly::SocketAddress client;
+    RoutingData routingData;
+    NetworkData networkData;
+    Optional<QuicVersion> quicVersion;
+    bool isForwardedData;
+  };
+
+  enum class PushResult {
+    // The consumer already has a wakeup pending.
+    QUEUED,
+    // The caller must wake the consumer up and have it drain().
+    WAKEUP_NEEDED,
+    // The ring is full, the packet was dropped.
+    RING_FULL,
+  };
+
+  // Each ring holds up to capacity packets.
+  WorkerPacketRings(size_t numProducers, uint32_t capacity) {
+    CHECK_GT(capacity, 0);
+    rings_.reserve(numProducers);
+    for (size_t i = 0; i < numProducers; i++) {
+      // The queue keeps one slot free to tell full from empty.
+      rings_.push_back(std::make_unique<Ring>(capacity + 1));
+    }
+  }
+
+  /**
+   * Adds a packet to the ring of the given producer. Must only be called from
+   * that producer's thread.
+   */
+  PushResult push(size_t producer, Packet&& packet) {
+    CHECK_LT(producer, rings_.size());
+    if (!rings_[producer]->write(std::move(packet))) {
+      return PushResult::RING_FULL;
+    }
+    // Publishes the packet to a consumer that clears the flag afterwards.
+    if (wakeupPending_.exchange(true, std::memory_order_acq_rel)) {
+      return PushResult::QUEUED;
+    }
+    return PushResult::WAKEUP_NEEDED;
+  }
+
+  /**
+   * Calls fn with each packet queued before the call, oldest first per ring,
+   * and returns how many there were. Packets pushed while draining are left
+   * for the next wakeup so that a busy producer cannot starve the consumer's
+   * loop. Must only be called from the consumer's thread.
+   */
+  template <typename Fn>
+  size_t drain(Fn&& fn) {
+    // Any push after this either gets drained below or wakes us up again.
+    wakeupPending_.exchange(false, std::memory_order_acq_rel);
+    size_t numPackets = 0;
+    for (auto& ring : rings_) {
+      auto depth = ring->sizeGuess();
+      for (size_t i = 0; i < depth; i++) {
+        auto packet = ring->frontPtr();
+        if (!packet) {
+          break;
+        }
+        fn(std::move(*packet));
+        ring->popFront();
+        numPackets++;
+      }
+    }
+    return numPackets;
+  }
+
+  [[nodiscard]] size_t numProducers() const {
+    return rings_.size();
+  }
+
+ private:
+  using Ring = folly::ProducerConsumerQueue<Packet>;
+
+  std::vector<std::unique_ptr<Ring>> rings_;
+  std::atomic<bool> wakeupPending_{false};
+};
+
+} // namespace quic
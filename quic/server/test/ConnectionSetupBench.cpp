@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/Benchmark.h>
+#include <gflags/gflags.h>
+#include <quic/common/SlabAllocator.h>
+#include <quic/congestion_control/TokenlessPacer.h>
+#include <quic/fizz/server/handshake/FizzServerQuicHandshakeContext.h>
+#include <quic/server/state/ServerStateMachine.h>
+
+#include <unistd.h>
+#include <fstream>
+#include <iostream>
+
+/**
+ * Sets up and tears down connection state the way a server worker does under
+ * a flood of Initials, with the connections' fixed objects allocated either
+ * from malloc or from the worker's SlabAllocator. One iteration accepts and
+ * closes one connection, so iters/s is the connections per second.
+ *
+ * With --idle_connections the binary instead keeps that many connections
+ * open, reports the resident bytes they take per connection and exits. Run it
+ * once per allocator so that neither run reuses memory the other freed.
+ */
+
+DEFINE_uint32(
+    idle_connections,
+    0,
+    "Open this many connections, report the bytes per connection and exit");
+DEFINE_bool(
+    slab_allocator,
+    false,
+    "Allocate the idle connections from a SlabAllocator");
+
+using namespace quic;
+
+namespace {
+
+std::unique_ptr<QuicServerConnectionState> acceptConnection() {
+  auto conn = std::make_unique<QuicServerConnectionState>(
+      FizzServerQuicHandshakeContext::Builder().build());
+  // The transport adds the pacer when it applies the transport settings.
+  conn->pacer = std::make_unique<TokenlessPacer>(
+      *conn, conn->transportSettings.minCwndInMss);
+  return conn;
+}
+
+void acceptCloseBench(size_t iters, bool useSlabAllocator) {
+  folly::BenchmarkSuspender suspender;
+  auto allocator = useSlabAllocator ? SlabAllocator::create() : nullptr;
+  SlabAllocator::ScopedCurrent scope(allocator.get());
+  suspender.dismiss();
+
+  while (iters--) {
+    auto conn = acceptConnection();
+    folly::doNotOptimizeAway(conn.get());
+  }
+}
+
+size_t residentBytes() {
+  std::ifstream statm("/proc/self/statm");
+  size_t totalPages = 0;
+  size_t residentPages = 0;
+  statm >> totalPages >> residentPages;
+  return residentPages * sysconf(_SC_PAGESIZE);
+}
+
+void reportIdleConnectionBytes() {
+  auto allocator = FLAGS_slab_allocator ? SlabAllocator::create() : nullptr;
+  SlabAllocator::ScopedCurrent scope(allocator.get());
+  std::vector<std::unique_ptr<QuicServerConnectionState>> conns;
+  conns.reserve(FLAGS_idle_connections);
+  auto before = residentBytes();
+  for (uint32_t i = 0; i < FLAGS_idle_connections; i++) {
+    conns.push_back(acceptConnection());
+  }
+  auto after = residentBytes();
+  std::cout << (FLAGS_slab_allocator ? "slab" : "malloc")
+            << ": bytes per idle connection: "
+            << (after - before) / FLAGS_idle_connections << std::endl;
+  if (allocator) {
+    std::cout << "slab bytes in use per connection: "
+              << allocator->bytesInUse() / FLAGS_idle_connections
+              << ", reserved: " << allocator->bytesReserved() << std::endl;
+  }
+}
+
+} // namespace
+
+BENCHMARK_NAMED_PARAM(acceptCloseBench, malloc, false)
+BENCHMARK_RELATIVE_NAMED_PARAM(acceptCloseBench, slab, true)
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (FLAGS_idle_connections > 0) {
+    reportIdleConnectionBytes();
+    return 0;
+  }
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <quic/server/ConnectionStatsTable.h>
+
+#include <thread>
+
+using namespace quic;
+
+namespace {
+
+ConnectionStatsRecord makeRecord(uint64_t value) {
+  ConnectionStatsRecord record;
+  record.srtt = std::chrono::microseconds(value);
+  record.mrtt = std::chrono::microseconds(value);
+  record.cwndBytes = value;
+  record.inflightBytes = value;
+  record.totalBytesRetransmitted = value;
+  record.rtxCount = value;
+  record.pacingRateBytesPerSec = value;
+  record.numStreams = value;
+  return record;
+}
+
+} // namespace
+
+TEST(ConnectionStatsTableTest, PublishAndRelease) {
+  ConnectionStatsTable table;
+  std::vector<ConnectionStatsRecord> records;
+  table.getSnapshot(records);
+  EXPECT_TRUE(records.empty());
+
+  auto slot1 = table.acquireSlot();
+  auto slot2 = table.acquireSlot();
+  ASSERT_TRUE(slot1.has_value());
+  ASSERT_TRUE(slot2.has_value());
+  EXPECT_NE(*slot1, *slot2);
+  EXPECT_EQ(2, table.numConnections());
+  table.publish(*slot1, makeRecord(10));
+  table.publish(*slot2, makeRecord(20));
+
+  table.getSnapshot(records);
+  ASSERT_EQ(2, records.size());
+  EXPECT_NE(records[0].connectionId, records[1].connectionId);
+  auto expected = makeRecord(10);
+  expected.connectionId = records[0].connectionId;
+  EXPECT_EQ(expected, records[0]);
+  EXPECT_EQ(20, records[1].cwndBytes);
+
+  // A released slot is reused under a new connection id.
+  auto oldConnectionId = records[0].connectionId;
+  table.releaseSlot(*slot1);
+  EXPECT_EQ(1, table.numConnections());
+  records.clear();
+  table.getSnapshot(records);
+  ASSERT_EQ(1, records.size());
+  EXPECT_EQ(20, records[0].cwndBytes);
+
+  auto slot3 = table.acquireSlot();
+  ASSERT_TRUE(slot3.has_value());
+  EXPECT_EQ(*slot1, *slot3);
+  records.clear();
+  table.getSnapshot(records);
+  ASSERT_EQ(2, records.size());
+  EXPECT_NE(oldConnectionId, records[0].connectionId);
+  EXPECT_EQ(0, records[0].cwndBytes);
+}
+
+TEST(ConnectionStatsTableTest, ManyChunks) {
+  ConnectionStatsTable table;
+  auto numSlots = ConnectionStatsTable::kSlotsPerChunk * 3 + 1;
+  for (size_t i = 0; i < numSlots; i++) {
+    auto slot = table.acquireSlot();
+    ASSERT_TRUE(slot.has_value());
+    table.publish(*slot, makeRecord(i));
+  }
+  std::vector<ConnectionStatsRecord> records;
+  table.getSnapshot(records);
+  ASSERT_EQ(numSlots, records.size());
+  for (size_t i = 0; i < numSlots; i++) {
+    EXPECT_EQ(i, records[i].numStreams);
+  }
+}
+
+TEST(ConnectionStatsTableTest, ConsistentWhileWriting) {
+  ConnectionStatsTable table;
+  std::vector<ConnectionStatsTable::SlotId> slots;
+  for (int i = 0; i < 8; i++) {
+    slots.push_back(*table.acquireSlot());
+  }
+  std::atomic<bool> done{false};
+  std::thread writer([&] {
+    for (uint64_t value = 1; value < 100000; value++) {
+      for (auto slot : slots) {
+        table.publish(slot, makeRecord(value));
+      }
+    }
+    done = true;
+  });
+  // Every record read must come from a single publish.
+  std::vector<ConnectionStatsRecord> records;
+  while (!done) {
+    records.clear();
+    table.getSnapshot(records);
+    ASSERT_EQ(slots.size(), records.size());
+    for (const auto& record : records) {
+      auto expected = makeRecord(record.cwndBytes);
+      expected.connectionId = record.connectionId;
+      ASSERT_EQ(expected, record);
+    }
+  }
+  writer.join();
+}
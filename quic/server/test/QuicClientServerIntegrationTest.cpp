@@ -10,6 +10,7 @@
 #include <quic/common/events/FollyQuicEventBase.h>
 #include <quic/common/test/TestClientUtils.h>
 #include <quic/common/test/TestUtils.h>
+#include <quic/common/udpsocket/IoUringQuicAsyncUDPSocket.h>
 #include <quic/fizz/client/handshake/FizzClientQuicHandshakeContext.h>
 #include <quic/server/QuicServer.h>
 
@@ -79,13 +80,19 @@ class ServerTransportParameters : public testing::Test {
     server_->setFizzContext(quic::test::createServerCtx());
     server_->setQuicServerTransportFactory(
         std::make_unique<QuicTransportFactory>());
+#if FOLLY_HAS_LIBURING
+    if (ioUringSendOptions_) {
+      server_->setIoUringSendOptions(*ioUringSendOptions_);
+    }
+#endif
     // start server
     server_->start(folly::SocketAddress("::1", 0), 1);
     server_->waitUntilInitialized();
   }
 
   // create new quic client
-  std::shared_ptr<QuicClientTransport> createQuicClient() {
+  std::shared_ptr<QuicClientTransport> createQuicClient(
+      std::unique_ptr<QuicAsyncUDPSocket> sock = nullptr) {
     // server must be already started
     CHECK(server_)
         << "::startServer() must be invoked prior to ::createQuicClient()";
@@ -94,10 +101,11 @@ class ServerTransportParameters : public testing::Test {
             .setFizzClientContext(quic::test::createClientCtx())
             .setCertificateVerifier(createTestCertificateVerifier())
             .build();
+    if (!sock) {
+      sock = std::make_unique<FollyQuicAsyncUDPSocket>(qEvb_);
+    }
     auto client = std::make_shared<QuicClientTransport>(
-        qEvb_,
-        std::make_unique<FollyQuicAsyncUDPSocket>(qEvb_),
-        std::move(fizzClientContext));
+        qEvb_, std::move(sock), std::move(fizzClientContext));
     client->addNewPeerAddress(server_->getAddress());
     client->setHostname("::1");
     client->setSupportedVersions({QuicVersion::MVFST});
@@ -107,6 +115,9 @@ class ServerTransportParameters : public testing::Test {
   std::shared_ptr<QuicClientTransport> client_;
   std::shared_ptr<QuicServer> server_;
   TransportSettings serverTs_{};
+#if FOLLY_HAS_LIBURING
+  Optional<IoUringSendRing::Options> ioUringSendOptions_;
+#endif
   folly::EventBase evb_;
   std::shared_ptr<FollyQuicEventBase> qEvb_;
 };
@@ -244,4 +255,24 @@ TEST_F(ServerTransportParameters, MaxStreamGroupsParam) {
   EXPECT_NE(it, serverTransportParams->parameters.end());
 }
 
+#if FOLLY_HAS_LIBURING
+TEST_F(ServerTransportParameters, HandshakeOverIoUringSockets) {
+  if (!IoUringQuicAsyncUDPSocket::isSupported()) {
+    GTEST_SKIP() << "io_uring is not available";
+  }
+  ioUringSendOptions_ = IoUringSendRing::Options();
+  startServer();
+
+  // both endpoints send through io_uring
+  client_ =
+      createQuicClient(std::make_unique<IoUringQuicAsyncUDPSocket>(qEvb_));
+  clientConnect();
+
+  auto clientConn =
+      dynamic_cast<const QuicClientConnectionState*>(client_->getState());
+  EXPECT_TRUE(
+      clientConn->clientHandshakeLayer->getServerTransportParams().has_value());
+}
+#endif
+
 } // namespace quic::test
@@ -22,6 +22,7 @@
 #include <quic/common/events/FollyQuicEventBase.h>
 #include <quic/common/test/TestUtils.h>
 #include <quic/common/udpsocket/FollyQuicAsyncUDPSocket.h>
+#include <quic/common/udpsocket/IoUringQuicAsyncUDPSocket.h>
 #include <quic/congestion_control/ServerCongestionControllerFactory.h>
 #include <quic/fizz/handshake/FizzCryptoFactory.h>
 #include <quic/server/AcceptObserver.h>
@@ -746,6 +747,147 @@ TEST_F(QuicServerWorkerTest, QuicServerMultipleConnIdsRouting) {
   transport_->QuicServerTransport::setRoutingCallback(nullptr);
 }
 
+TEST_F(QuicServerWorkerTest, FixedLengthConnIdRouting) {
+  EXPECT_CALL(*socketPtr_, address()).WillRepeatedly(ReturnRef(fakeAddress_));
+  // An id of this worker and process.
+  DefaultConnectionIdAlgo connIdAlgo;
+  auto connId = *connIdAlgo.encodeConnectionId(ServerConnectionIdParams(
+      ConnectionIdVersion::V1, hostId_, 1 /* processId */, 42 /* workerId */));
+  createQuicConnection(kClientAddr, connId);
+  transport_->QuicServerTransport::setRoutingCallback(worker_.get());
+  worker_->onConnectionIdAvailable(transport_, connId);
+  // Enabling picks up the ids that are already mapped.
+  worker_->setFixedLengthConnIdRouting(true);
+  auto connId2 = connId;
+  connId2.data()[7] ^= 0x1;
+  worker_->onConnectionIdAvailable(transport_, connId2);
+  worker_->cancelTimeout();
+
+  auto makePacket = [](const ConnectionId& dstConnId) {
+    ShortHeader header(ProtectionType::KeyPhaseZero, dstConnId, 2);
+    RegularQuicPacketBuilder builder(
+        kDefaultUDPSendPacketLen, std::move(header), 0 /* largestAcked */);
+    builder.encodePacketHeader();
+    writeFrame(PingFrame(), builder);
+    return packetToReceivedUdpPacket(std::move(builder).buildPacket());
+  };
+
+  // Both ids reach the transport without going through the router.
+  EXPECT_CALL(*workerCb_, routeDataToWorkerLong(_, _, _, _, _)).Times(0);
+  EXPECT_CALL(*transport_, onNetworkData(kClientAddr, _)).Times(2);
+  for (const auto& id : {connId, connId2}) {
+    auto packet = makePacket(id);
+    worker_->handleNetworkData(kClientAddr, packet);
+  }
+
+  // A retired id falls back to the regular route.
+  worker_->onConnectionIdRetired(*transport_, connId2);
+  EXPECT_CALL(*workerCb_, routeDataToWorkerLong(_, _, _, _, _)).Times(1);
+  EXPECT_CALL(*transport_, onNetworkData(_, _)).Times(0);
+  auto packet = makePacket(connId2);
+  worker_->handleNetworkData(kClientAddr, packet);
+
+  EXPECT_CALL(*transport_, setRoutingCallback(nullptr));
+  worker_->onConnectionUnbound(
+      transport_.get(),
+      std::make_pair(kClientAddr, connId),
+      std::vector<ConnectionIdData>{ConnectionIdData{connId, 0}});
+  transport_->QuicServerTransport::setRoutingCallback(nullptr);
+}
+
+TEST_F(QuicServerWorkerTest, BatchReceivedPacketsPerLoop) {
+  TransportSettings settings;
+  settings.statelessResetTokenSecret = getRandSecret();
+  settings.batchServerRecvPacketsPerLoop = true;
+  initializeWorker(settings);
+  EXPECT_CALL(*socketPtr_, address()).WillRepeatedly(ReturnRef(fakeAddress_));
+  auto connId = getTestConnectionId(hostId_);
+  createQuicConnection(kClientAddr, connId);
+  transport_->QuicServerTransport::setRoutingCallback(worker_.get());
+  worker_->onConnectionIdAvailable(transport_, connId);
+  worker_->cancelTimeout();
+
+  // Nothing reaches the transport until the loop runs, then all the packets
+  // arrive together and in order.
+  std::vector<Buf> payloads;
+  EXPECT_CALL(*transport_, onNetworkData(kClientAddr, _)).Times(0);
+  for (PacketNum num = 1; num <= 3; num++) {
+    ShortHeader header(ProtectionType::KeyPhaseZero, connId, num);
+    RegularQuicPacketBuilder builder(
+        kDefaultUDPSendPacketLen, std::move(header), 0 /* largestAcked */);
+    builder.encodePacketHeader();
+    writeFrame(PingFrame(), builder);
+    auto packet = packetToReceivedUdpPacket(std::move(builder).buildPacket());
+    payloads.push_back(packet.buf.front()->clone());
+    worker_->handleNetworkData(kClientAddr, packet);
+  }
+
+  EXPECT_CALL(*transport_, onNetworkData(kClientAddr, _))
+      .WillOnce(Invoke([&](auto&, const NetworkData& networkData) {
+        ASSERT_EQ(networkData.getPackets().size(), payloads.size());
+        for (size_t i = 0; i < payloads.size(); i++) {
+          EXPECT_TRUE(folly::IOBufEqualTo()(
+              *networkData.getPackets()[i].buf.front(), *payloads[i]));
+        }
+      }));
+  eventbase_.loopOnce();
+
+  EXPECT_CALL(*transport_, setRoutingCallback(nullptr));
+  worker_->onConnectionUnbound(
+      transport_.get(),
+      std::make_pair(kClientAddr, connId),
+      std::vector<ConnectionIdData>{ConnectionIdData{connId, 0}});
+  transport_->QuicServerTransport::setRoutingCallback(nullptr);
+}
+
+TEST_F(QuicServerWorkerTest, DrainPacketRings) {
+  EXPECT_CALL(*socketPtr_, address()).WillRepeatedly(ReturnRef(fakeAddress_));
+  auto connId = getTestConnectionId(hostId_);
+  createQuicConnection(kClientAddr, connId);
+  transport_->QuicServerTransport::setRoutingCallback(worker_.get());
+  worker_->onConnectionIdAvailable(transport_, connId);
+  worker_->cancelTimeout();
+
+  worker_->initPacketRings(2, 2);
+  auto packetRings = worker_->getPacketRings();
+  ASSERT_NE(packetRings, nullptr);
+  auto makePacket = [&]() {
+    return WorkerPacketRings::Packet{
+        kClientAddr,
+        RoutingData(HeaderForm::Short, false, false, connId, none),
+        NetworkData(createData(kDefaultUDPSendPacketLen), Clock::now(), 0),
+        none,
+        false};
+  };
+  // Only the first packet after a drain needs a wakeup.
+  EXPECT_EQ(
+      packetRings->push(1, makePacket()),
+      WorkerPacketRings::PushResult::WAKEUP_NEEDED);
+  EXPECT_EQ(
+      packetRings->push(0, makePacket()),
+      WorkerPacketRings::PushResult::QUEUED);
+  EXPECT_EQ(
+      packetRings->push(1, makePacket()),
+      WorkerPacketRings::PushResult::QUEUED);
+  EXPECT_EQ(
+      packetRings->push(1, makePacket()),
+      WorkerPacketRings::PushResult::RING_FULL);
+
+  EXPECT_CALL(*transport_, onNetworkData(kClientAddr, _)).Times(3);
+  EXPECT_CALL(*quicStats_, onWorkerPacketRingDrained(3));
+  worker_->drainPacketRings();
+  EXPECT_EQ(
+      packetRings->push(0, makePacket()),
+      WorkerPacketRings::PushResult::WAKEUP_NEEDED);
+
+  EXPECT_CALL(*transport_, setRoutingCallback(nullptr));
+  worker_->onConnectionUnbound(
+      transport_.get(),
+      std::make_pair(kClientAddr, connId),
+      std::vector<ConnectionIdData>{ConnectionIdData{connId, 0}});
+  transport_->QuicServerTransport::setRoutingCallback(nullptr);
+}
+
 TEST_F(QuicServerWorkerTest, RetireConnIds) {
   EXPECT_CALL(*socketPtr_, address()).WillRepeatedly(ReturnRef(fakeAddress_));
   auto connId = getTestConnectionId(hostId_);
@@ -1248,6 +1390,124 @@ TEST_F(QuicServerWorkerTest, AssignBufAccessor) {
   EXPECT_CALL(*transport_, setTransportStatsCallback(nullptr)).Times(1);
 }
 
+TEST_F(QuicServerWorkerTest, TxTimePacingEnablesTxTimeOnTransportSocket) {
+  TransportSettings transportSettings;
+  transportSettings.pacingEnabled = true;
+  transportSettings.txTimePacing = true;
+  initializeWorker(transportSettings);
+
+  EXPECT_CALL(*socketPtr_, address()).WillRepeatedly(ReturnRef(fakeAddress_));
+  // Whether the kernel accepts SO_TXTIME depends on the host.
+  folly::AsyncUDPSocket referenceSock(&eventbase_);
+  referenceSock.bind(folly::SocketAddress("127.0.0.1", 0));
+  referenceSock.setTXTime({CLOCK_MONOTONIC, /*deadline=*/false});
+  if (referenceSock.getTXTime().clockid < 0) {
+    GTEST_SKIP() << "SO_TXTIME is not available";
+  }
+
+  auto transportSock = std::make_unique<folly::AsyncUDPSocket>(&eventbase_);
+  transportSock->bind(folly::SocketAddress("127.0.0.1", 0));
+  EXPECT_CALL(*socketFactory_, _make(_, _))
+      .WillOnce(Return(transportSock.release()));
+
+  auto connId = getTestConnectionId(hostId_);
+  expectConnectionCreation(kClientAddr, transport_);
+  auto makeTransport =
+      [&](folly::EventBase*,
+          std::unique_ptr<FollyAsyncUDPSocketAlias>& sock,
+          const folly::SocketAddress&,
+          std::shared_ptr<const fizz::server::FizzServerContext>) noexcept {
+        EXPECT_EQ(CLOCK_MONOTONIC, sock->getTXTime().clockid);
+        // This is what the transport checks before taking the SO_TXTIME
+        // schedule path.
+        FollyQuicAsyncUDPSocket quicSock(qEvb_, *sock);
+        EXPECT_TRUE(quicSock.getTxTime());
+        return transport_;
+      };
+  EXPECT_CALL(*factory_, _make(_, _, _, _)).WillOnce(Invoke(makeTransport));
+  EXPECT_CALL(*transport_, onNetworkData(kClientAddr, _));
+  QuicVersion version = QuicVersion::MVFST;
+  RoutingData routingData(HeaderForm::Long, true, false, connId, connId);
+  auto data = createData(kMinInitialPacketSize + 10);
+  worker_->dispatchPacketData(
+      kClientAddr,
+      std::move(routingData),
+      NetworkData(data->clone(), Clock::now(), 0),
+      version);
+  eventbase_.loopIgnoreKeepAlive();
+
+  // From shutdownAllConnections:
+  EXPECT_CALL(*transport_, setRoutingCallback(nullptr)).Times(1);
+  EXPECT_CALL(*transport_, setTransportStatsCallback(nullptr)).Times(1);
+}
+
+#if FOLLY_HAS_LIBURING
+TEST_F(QuicServerWorkerTest, IoUringSendOptionsPutTransportsOnSharedRing) {
+  if (!IoUringSendRing::isSupported()) {
+    GTEST_SKIP() << "io_uring is not available";
+  }
+  initializeWorker(TransportSettings());
+  worker_->setIoUringSendOptions(IoUringSendRing::Options{.numSlots = 4});
+  EXPECT_EQ(worker_->getIoUringSendRing(), nullptr);
+
+  EXPECT_CALL(*socketPtr_, address()).WillRepeatedly(ReturnRef(fakeAddress_));
+  auto transportSock = std::make_unique<folly::AsyncUDPSocket>(&eventbase_);
+  transportSock->bind(folly::SocketAddress("127.0.0.1", 0));
+  EXPECT_CALL(*socketFactory_, _make(_, _))
+      .WillOnce(Return(transportSock.release()));
+
+  folly::AsyncUDPSocket receiver(&eventbase_);
+  receiver.bind(folly::SocketAddress("127.0.0.1", 0));
+  NiceMock<MockConnectionSetupCallback> connSetupCb;
+  NiceMock<MockConnectionCallback> connCb;
+  QuicServerTransport::Ptr serverTransport;
+
+  auto connId = getTestConnectionId(hostId_);
+  expectConnectionCreation(kClientAddr, transport_);
+  auto makeTransport =
+      [&](folly::EventBase* evb,
+          std::unique_ptr<FollyAsyncUDPSocketAlias>& sock,
+          const folly::SocketAddress&,
+          std::shared_ptr<const fizz::server::FizzServerContext>) noexcept {
+        // The worker sets up the ring before the factory runs, so the
+        // default transport picks it up.
+        EXPECT_NE(worker_->getIoUringSendRing(), nullptr);
+        serverTransport = QuicServerTransport::make(
+            evb, std::move(sock), &connSetupCb, &connCb, createServerCtx());
+        auto* ioUringSock = dynamic_cast<IoUringQuicAsyncUDPSocket*>(
+            serverTransport->getUdpSocket());
+        EXPECT_NE(ioUringSock, nullptr);
+        if (ioUringSock) {
+          EXPECT_EQ(ioUringSock->getSendRing(), worker_->getIoUringSendRing());
+          std::string data("hello");
+          struct iovec vec = {data.data(), data.size()};
+          EXPECT_EQ(ioUringSock->write(receiver.address(), &vec, 1), 5);
+          EXPECT_EQ(ioUringSock->numSendsInFlight(), 1);
+        }
+        return transport_;
+      };
+  EXPECT_CALL(*factory_, _make(_, _, _, _)).WillOnce(Invoke(makeTransport));
+  EXPECT_CALL(*transport_, onNetworkData(kClientAddr, _));
+  QuicVersion version = QuicVersion::MVFST;
+  RoutingData routingData(HeaderForm::Long, true, false, connId, connId);
+  auto data = createData(kMinInitialPacketSize + 10);
+  worker_->dispatchPacketData(
+      kClientAddr,
+      std::move(routingData),
+      NetworkData(data->clone(), Clock::now(), 0),
+      version);
+  eventbase_.loopIgnoreKeepAlive();
+  ASSERT_NE(serverTransport, nullptr);
+  // The send was submitted and reaped at the end of the loop.
+  EXPECT_EQ(worker_->getIoUringSendRing()->numSendsInFlight(), 0);
+  serverTransport->closeNow(none);
+
+  // From shutdownAllConnections:
+  EXPECT_CALL(*transport_, setRoutingCallback(nullptr)).Times(1);
+  EXPECT_CALL(*transport_, setTransportStatsCallback(nullptr)).Times(1);
+}
+#endif
+
 class MockAcceptObserver : public AcceptObserver {
  public:
   MOCK_METHOD(void, accept, (QuicTransportBase* const), (noexcept));
@@ -195,6 +195,33 @@ TEST_F(QuicServerTransportTest, IdleTimerResetOnRecvNewData) {
   EXPECT_CALL(*quicStats_, onQuicStreamClosed());
 }
 
+TEST_F(QuicServerTransportTest, PublishConnectionStats) {
+  ConnectionStatsTable table;
+  server->setConnectionStatsTable(&table);
+  std::vector<ConnectionStatsRecord> records;
+  table.getSnapshot(records);
+  EXPECT_TRUE(records.empty());
+
+  EXPECT_CALL(*quicStats_, onNewQuicStream()).Times(1);
+  StreamId streamId = server->createBidirectionalStream().value();
+  recvEncryptedStream(streamId, *IOBuf::copyBuffer("hello"));
+  table.getSnapshot(records);
+  ASSERT_EQ(1, records.size());
+  EXPECT_EQ(1, records[0].numStreams);
+  EXPECT_EQ(server->getConn().lossState.srtt, records[0].srtt);
+  EXPECT_EQ(
+      server->getConn().congestionController->getCongestionWindow(),
+      records[0].cwndBytes);
+  EXPECT_EQ(
+      server->getConn().lossState.inflightBytes, records[0].inflightBytes);
+
+  server->setConnectionStatsTable(nullptr);
+  records.clear();
+  table.getSnapshot(records);
+  EXPECT_TRUE(records.empty());
+  EXPECT_CALL(*quicStats_, onQuicStreamClosed());
+}
+
 TEST_F(QuicServerTransportTest, IdleTimerNotResetOnDuplicatePacket) {
   EXPECT_CALL(*quicStats_, onNewQuicStream()).Times(1);
   StreamId streamId = server->createBidirectionalStream().value();
@@ -821,10 +848,7 @@ TEST_F(QuicServerTransportTest, RecvRstStreamFrame) {
 
   auto wordsBuf2 = IOBuf::copyBuffer(words.at(2));
   stream->retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(0),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(wordsBuf2), 0, false)));
+      ChainedByteRangeHead(wordsBuf2), 0, false);
   writeDataToQuicStream(*stream, IOBuf::copyBuffer(words.at(3)), false);
   stream->currentWriteOffset = words.at(2).length() + words.at(3).length();
   stream->currentReadOffset = words.at(0).length() + words.at(1).length();
@@ -905,10 +929,7 @@ TEST_F(QuicServerTransportTest, RecvStopSendingFrame) {
       IOBuf::copyBuffer(words.at(1)), words.at(0).length(), false);
   auto wordsBuf2 = IOBuf::copyBuffer(words.at(2));
   stream->retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(0),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(wordsBuf2), 0, false)));
+      ChainedByteRangeHead(wordsBuf2), 0, false);
   stream->writeBuffer.append(IOBuf::copyBuffer(words.at(3)));
   stream->currentWriteOffset = words.at(2).length() + words.at(3).length();
   stream->currentReadOffset = words.at(0).length() + words.at(1).length();
@@ -950,10 +971,7 @@ TEST_F(QuicServerTransportTest, RecvStopSendingFrameAfterCloseStream) {
       IOBuf::copyBuffer(words.at(1)), words.at(0).length(), false);
   auto wordsBuf2 = IOBuf::copyBuffer(words.at(2));
   stream->retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(0),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(wordsBuf2), 0, false)));
+      ChainedByteRangeHead(wordsBuf2), 0, false);
   stream->writeBuffer.append(IOBuf::copyBuffer(words.at(3)));
   stream->currentWriteOffset = words.at(2).length() + words.at(3).length();
   stream->currentReadOffset = words.at(0).length() + words.at(1).length();
@@ -996,10 +1014,7 @@ TEST_F(QuicServerTransportTest, RecvInvalidMaxStreamData) {
       IOBuf::copyBuffer(words.at(1)), words.at(0).length(), false);
   auto wordsBuf2 = IOBuf::copyBuffer(words.at(2));
   stream->retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(0),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(wordsBuf2), 0, false)));
+      ChainedByteRangeHead(wordsBuf2), 0, false);
   stream->writeBuffer.append(IOBuf::copyBuffer(words.at(3)));
   stream->currentWriteOffset = words.at(2).length() + words.at(3).length();
   stream->currentReadOffset = words.at(0).length() + words.at(1).length();
@@ -1039,10 +1054,7 @@ TEST_F(QuicServerTransportTest, RecvStopSendingFrameAfterHalfCloseRemote) {
       IOBuf::copyBuffer(words.at(1)), words.at(0).length(), false);
   auto wordsBuf2 = IOBuf::copyBuffer(words.at(2));
   stream->retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(0),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(wordsBuf2), 0, false)));
+      ChainedByteRangeHead(wordsBuf2), 0, false);
   stream->writeBuffer.append(IOBuf::copyBuffer(words.at(3)));
   stream->currentWriteOffset = words.at(2).length() + words.at(3).length();
   stream->currentReadOffset = words.at(0).length() + words.at(1).length();
@@ -1123,10 +1135,7 @@ TEST_F(QuicServerTransportTest, RecvStopSendingFrameAfterReset) {
       IOBuf::copyBuffer(words.at(1)), words.at(0).length(), false);
   auto wordsBuf2 = IOBuf::copyBuffer(words.at(2));
   stream1->retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(0),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(wordsBuf2), 0, false)));
+      ChainedByteRangeHead(wordsBuf2), 0, false);
   stream1->writeBuffer.append(IOBuf::copyBuffer(words.at(3)));
   stream1->currentWriteOffset = words.at(2).length() + words.at(3).length();
   stream1->currentReadOffset = words.at(0).length() + words.at(1).length();
@@ -1135,10 +1144,7 @@ TEST_F(QuicServerTransportTest, RecvStopSendingFrameAfterReset) {
   stream2->readBuffer.emplace_back(
       IOBuf::copyBuffer(words.at(1)), words.at(0).length(), false);
   stream2->retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(0),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(wordsBuf2), 0, false)));
+      ChainedByteRangeHead(wordsBuf2), 0, false);
   stream2->writeBuffer.append(IOBuf::copyBuffer(words.at(3)));
   stream2->currentWriteOffset = words.at(2).length() + words.at(3).length();
   stream2->currentReadOffset = words.at(0).length() + words.at(1).length();
@@ -4408,7 +4414,7 @@ TEST_F(QuicUnencryptedServerTransportTest, TestSendHandshakeDone) {
  * Returns the number of new token frames (should either be zero or one).
  */
 std::pair<int, std::vector<const NewTokenFrame*>> getNewTokenFrame(
-    const std::deque<OutstandingPacketWrapper>& packets) {
+    const OutstandingPacketList& packets) {
   int numNewTokens = 0;
   std::vector<const NewTokenFrame*> frames;
 
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/server/ReusePortBpfRouter.h>
+
+#include <folly/portability/GTest.h>
+#include <quic/codec/DefaultConnectionIdAlgo.h>
+#include <quic/codec/Types.h>
+
+#if defined(__linux__) && !defined(ANDROID)
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstring>
+
+namespace quic::test {
+
+namespace {
+
+constexpr size_t kNumWorkers = 4;
+constexpr size_t kPacketLen = 64;
+
+int bindReusePortSocket(uint16_t port) {
+  int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+  CHECK_GE(fd, 0);
+  int one = 1;
+  CHECK_EQ(setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)), 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  CHECK_EQ(bind(fd, (sockaddr*)&addr, sizeof(addr)), 0);
+  return fd;
+}
+
+uint16_t localPort(int fd) {
+  sockaddr_in addr{};
+  socklen_t len = sizeof(addr);
+  CHECK_EQ(getsockname(fd, (sockaddr*)&addr, &len), 0);
+  return ntohs(addr.sin_port);
+}
+
+class ReusePortBpfRouterTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    fds_[0] = bindReusePortSocket(0);
+    port_ = localPort(fds_[0]);
+    for (size_t i = 1; i < kNumWorkers; i++) {
+      fds_[i] = bindReusePortSocket(port_);
+    }
+    clientFd_ = socket(AF_INET, SOCK_DGRAM, 0);
+    CHECK_GE(clientFd_, 0);
+  }
+
+  void TearDown() override {
+    for (auto fd : fds_) {
+      close(fd);
+    }
+    close(clientFd_);
+  }
+
+  void send(uint8_t initialByte, const ConnectionId& dstConnId) {
+    std::array<uint8_t, kPacketLen> packet{};
+    packet[0] = initialByte;
+    memcpy(packet.data() + 1, dstConnId.data(), dstConnId.size());
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port_);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(
+        sendto(
+            clientFd_,
+            packet.data(),
+            packet.size(),
+            0,
+            (sockaddr*)&addr,
+            sizeof(addr)),
+        (ssize_t)packet.size());
+  }
+
+  // The index of the socket that the next packet arrives on, or -1.
+  int receive() {
+    std::array<pollfd, kNumWorkers> pfds{};
+    for (size_t i = 0; i < kNumWorkers; i++) {
+      pfds[i].fd = fds_[i];
+      pfds[i].events = POLLIN;
+    }
+    if (poll(pfds.data(), pfds.size(), 1000) <= 0) {
+      return -1;
+    }
+    for (size_t i = 0; i < kNumWorkers; i++) {
+      if (pfds[i].revents & POLLIN) {
+        std::array<uint8_t, kPacketLen> buf;
+        CHECK_EQ(recv(fds_[i], buf.data(), buf.size(), 0), (ssize_t)kPacketLen);
+        return i;
+      }
+    }
+    return -1;
+  }
+
+ protected:
+  std::array<int, kNumWorkers> fds_{};
+  int clientFd_{-1};
+  uint16_t port_{0};
+};
+
+} // namespace
+
+TEST_F(ReusePortBpfRouterTest, SteersShortHeaderToOwningWorker) {
+  ReusePortBpfRouter router(kNumWorkers);
+  if (router.init().hasError()) {
+    GTEST_SKIP() << "Loading the program needs CAP_BPF";
+  }
+  for (size_t i = 0; i < kNumWorkers; i++) {
+    ASSERT_FALSE(router.setWorkerSocket(i, fds_[i]).hasError());
+  }
+  ASSERT_FALSE(router.attach(fds_[0]).hasError());
+
+  DefaultConnectionIdAlgo connIdAlgo;
+  for (auto version :
+       {ConnectionIdVersion::V1,
+        ConnectionIdVersion::V2,
+        ConnectionIdVersion::V3}) {
+    for (uint16_t workerId = 0; workerId < 256; workerId += 7) {
+      auto connId = connIdAlgo.encodeConnectionId(ServerConnectionIdParams(
+          version, 0x1234, 1 /* processId */, workerId));
+      ASSERT_FALSE(connId.hasError());
+      send(ShortHeader::kFixedBitMask, *connId);
+      EXPECT_EQ(receive(), static_cast<int>(workerId % kNumWorkers));
+    }
+  }
+}
+
+TEST_F(ReusePortBpfRouterTest, LongHeaderIsHashed) {
+  ReusePortBpfRouter router(kNumWorkers);
+  if (router.init().hasError()) {
+    GTEST_SKIP() << "Loading the program needs CAP_BPF";
+  }
+  for (size_t i = 0; i < kNumWorkers; i++) {
+    ASSERT_FALSE(router.setWorkerSocket(i, fds_[i]).hasError());
+  }
+  ASSERT_FALSE(router.attach(fds_[0]).hasError());
+
+  auto connId = ConnectionId::createRandom(kDefaultConnectionIdSize);
+  send(kHeaderFormMask | ShortHeader::kFixedBitMask, connId);
+  EXPECT_GE(receive(), 0);
+}
+
+} // namespace quic::test
+
+#endif
@@ -47,7 +47,7 @@ class AckedPacketIterator {
   const quic::ReadAckFrame::Vec& ackBlocks_;
   QuicConnectionStateBase& conn_;
   PacketNumberSpace pnSpace_;
-  std::deque<OutstandingPacketWrapper>::reverse_iterator outstandingsIter_;
+  OutstandingPacketList::reverse_iterator outstandingsIter_;
   quic::ReadAckFrame::Vec::const_iterator ackBlockIter_;
   bool valid_{true};
 };
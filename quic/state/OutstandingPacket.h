@@ -9,6 +9,7 @@
 
 #include <folly/io/SocketOptionMap.h>
 #include <quic/codec/Types.h>
+#include <quic/common/CircularDeque.h>
 #include <quic/state/ClonedPacketIdentifier.h>
 #include <quic/state/LossState.h>
 #include <chrono>
@@ -298,4 +299,9 @@ struct OutstandingPacketWrapper : OutstandingPacket {
     }
   }
 };
+
+// Outstanding packets of a connection, sorted by packet number. Backed by a
+// contiguous ring so that the ACK and loss paths can binary search it and
+// erase acked ranges from either end without per-packet allocations.
+using OutstandingPacketList = CircularDeque<OutstandingPacketWrapper>;
 } // namespace quic
@@ -40,6 +40,11 @@ struct QuicConnectionStats {
   uint64_t totalBytesReceived{0};
   uint64_t totalBytesRetransmitted{0};
   uint32_t version{0};
+  // Whether the connection is compacted while idle, and its estimated bytes
+  // before and after it last was.
+  bool compacted{false};
+  uint64_t bytesBeforeCompaction{0};
+  uint64_t bytesAfterCompaction{0};
 };
 
 } // namespace quic
@@ -11,11 +11,10 @@
 #include <quic/common/TimeUtil.h>
 
 namespace {
-std::deque<quic::OutstandingPacketWrapper>::reverse_iterator
-getPreviousOutstandingPacket(
+quic::OutstandingPacketList::reverse_iterator getPreviousOutstandingPacket(
     quic::QuicConnectionStateBase& conn,
     quic::PacketNumberSpace packetNumberSpace,
-    const std::deque<quic::OutstandingPacketWrapper>::reverse_iterator& from,
+    const quic::OutstandingPacketList::reverse_iterator& from,
     bool includeLost = false,
     bool includeScheduledForDestruction = false) {
   return std::find_if(
@@ -27,6 +26,13 @@ getPreviousOutstandingPacket(
       });
 }
 
+template <typename Container>
+void releaseIfEmpty(Container& container) {
+  if (container.empty()) {
+    Container().swap(container);
+  }
+}
+
 } // namespace
 
 namespace quic {
@@ -266,14 +272,14 @@ void increaseNextPacketNum(
   }
 }
 
-std::deque<OutstandingPacketWrapper>::iterator getFirstOutstandingPacket(
+OutstandingPacketList::iterator getFirstOutstandingPacket(
     QuicConnectionStateBase& conn,
     PacketNumberSpace packetNumberSpace) {
   return getNextOutstandingPacket(
       conn, packetNumberSpace, conn.outstandings.packets.begin());
 }
 
-std::deque<OutstandingPacketWrapper>::reverse_iterator getLastOutstandingPacket(
+OutstandingPacketList::reverse_iterator getLastOutstandingPacket(
     QuicConnectionStateBase& conn,
     PacketNumberSpace packetNumberSpace,
     bool includeLost,
@@ -286,10 +292,10 @@ std::deque<OutstandingPacketWrapper>::reverse_iterator getLastOutstandingPacket(
       includeScheduledForDestruction);
 }
 
-std::deque<OutstandingPacketWrapper>::iterator getNextOutstandingPacket(
+OutstandingPacketList::iterator getNextOutstandingPacket(
     QuicConnectionStateBase& conn,
     PacketNumberSpace packetNumberSpace,
-    std::deque<OutstandingPacketWrapper>::iterator from) {
+    OutstandingPacketList::iterator from) {
   return std::find_if(
       from, conn.outstandings.packets.end(), [=](const auto& op) {
         return !op.declaredLost &&
@@ -475,4 +481,67 @@ bool streamRetransmissionDisabled(
   return noRetransmissions;
 }
 
+uint64_t connectionAllocatedBytes(const QuicConnectionStateBase& conn) {
+  uint64_t bytes = sizeof(QuicConnectionStateBase);
+  // The concrete types are unknown here. Count their allocation when it is
+  // known, and at least the base otherwise.
+  if (conn.congestionController) {
+    bytes += std::max<uint64_t>(
+        conn.congestionController->slabAllocatedBytes(),
+        sizeof(CongestionController));
+  }
+  if (conn.pacer) {
+    bytes +=
+        std::max<uint64_t>(conn.pacer->slabAllocatedBytes(), sizeof(Pacer));
+  }
+  if (conn.streamManager) {
+    bytes += conn.streamManager->allocatedBytes();
+  }
+  if (conn.cryptoState) {
+    bytes += sizeof(QuicCryptoState) +
+        conn.cryptoState->initialStream.allocatedBytes() +
+        conn.cryptoState->handshakeStream.allocatedBytes() +
+        conn.cryptoState->oneRttStream.allocatedBytes();
+  }
+  bytes += conn.outstandings.packets.max_size() *
+          sizeof(OutstandingPacketWrapper) +
+      conn.outstandings.clonedPacketIdentifiers.getAllocatedMemorySize() +
+      conn.pendingEvents.resets.getAllocatedMemorySize() +
+      conn.pendingEvents.frames.capacity() * sizeof(QuicSimpleFrame) +
+      conn.pendingEvents.knobs.capacity() * sizeof(KnobFrame) +
+      conn.lastProcessedAckEvents.capacity() * sizeof(AckEvent) +
+      conn.datagramState.readBuffer.max_size() * sizeof(ReadDatagram) +
+      conn.datagramState.writeBuffer.max_size() * sizeof(BufQueue);
+  return bytes;
+}
+
+void compactIdleConnection(QuicConnectionStateBase& conn) {
+  auto bytesBefore = connectionAllocatedBytes(conn);
+  if (conn.congestionController) {
+    conn.compactedCongestionState =
+        QuicConnectionStateBase::CompactedCongestionState{
+            conn.congestionController->type(),
+            conn.congestionController->getCongestionWindow()};
+    conn.congestionController.reset();
+  }
+  releaseIfEmpty(conn.outstandings.packets);
+  releaseIfEmpty(conn.outstandings.clonedPacketIdentifiers);
+  releaseIfEmpty(conn.pendingEvents.resets);
+  releaseIfEmpty(conn.pendingEvents.frames);
+  releaseIfEmpty(conn.pendingEvents.knobs);
+  releaseIfEmpty(conn.lastProcessedAckEvents);
+  releaseIfEmpty(conn.datagramState.readBuffer);
+  releaseIfEmpty(conn.datagramState.writeBuffer);
+  if (conn.cryptoState) {
+    conn.cryptoState->initialStream.shrinkToFit();
+    conn.cryptoState->handshakeStream.shrinkToFit();
+    conn.cryptoState->oneRttStream.shrinkToFit();
+  }
+  if (conn.streamManager) {
+    conn.streamManager->shrinkToFit();
+  }
+  conn.bytesBeforeCompaction = bytesBefore;
+  conn.bytesAfterCompaction = connectionAllocatedBytes(conn);
+}
+
 } // namespace quic
@@ -71,15 +71,15 @@ uint64_t addPacketToAckState(
     const PacketNum packetNum,
     const ReceivedUdpPacket& udpPacket);
 
-std::deque<OutstandingPacketWrapper>::iterator getNextOutstandingPacket(
+OutstandingPacketList::iterator getNextOutstandingPacket(
     QuicConnectionStateBase& conn,
     PacketNumberSpace packetNumberSpace,
-    std::deque<OutstandingPacketWrapper>::iterator from);
-std::deque<OutstandingPacketWrapper>::iterator getFirstOutstandingPacket(
+    OutstandingPacketList::iterator from);
+OutstandingPacketList::iterator getFirstOutstandingPacket(
     QuicConnectionStateBase& conn,
     PacketNumberSpace packetNumberSpace);
 
-std::deque<OutstandingPacketWrapper>::reverse_iterator getLastOutstandingPacket(
+OutstandingPacketList::reverse_iterator getLastOutstandingPacket(
     QuicConnectionStateBase& conn,
     PacketNumberSpace packetNumberSpace,
     bool includeDeclaredLost = false,
@@ -122,4 +122,19 @@ bool streamRetransmissionDisabled(
     QuicConnectionStateBase& conn,
     const QuicStreamState& stream);
 
+/**
+ * An estimate of the heap bytes held by the connection state, its congestion
+ * controller, pacer and streams, not counting buffered data.
+ */
+uint64_t connectionAllocatedBytes(const QuicConnectionStateBase& conn);
+
+/**
+ * Frees what an idle connection does not need until its next packet: the
+ * storage of its empty containers and its congestion controller, of which only
+ * compactedCongestionState is kept. Records the bytes before and after. The
+ * transport recreates the congestion controller, starting from the compacted
+ * window, before it reads or writes.
+ */
+void compactIdleConnection(QuicConnectionStateBase& conn);
+
 } // namespace quic
@@ -188,11 +188,10 @@ void appendDataToReadBufferCommon(
   StreamBuffer* current = &buffer;
   bool currentAlreadyInserted = false;
   bool done = false;
-  it = std::lower_bound(
-      it,
-      readBuffer.end(),
-      current->offset,
-      [](const StreamBuffer& listValue, uint64_t offset) {
+  // A binary search over the chunks of the buffer and then within one, so
+  // that filling a hole far behind the last received data stays cheap.
+  it = readBuffer.lowerBound(
+      current->offset, [](const StreamBuffer& listValue, uint64_t offset) {
         // First element where the end offset is > start offset of the buffer.
         return (listValue.offset + listValue.data.chainLength()) < offset;
       });
@@ -390,7 +389,7 @@ void peekDataFromQuicStream(
     peekCallback(
         stream.id,
         folly::Range<PeekIterator>(
-            stream.readBuffer.cbegin(), stream.readBuffer.size()));
+            stream.readBuffer.cbegin(), stream.readBuffer.cend()));
   }
 }
 
@@ -55,6 +55,13 @@ static void updateHolBlockedTime(QuicStreamState& stream) {
   stream.holbCount++;
 }
 
+template <typename Container>
+static void releaseIfEmpty(Container& container) {
+  if (container.empty()) {
+    Container().swap(container);
+  }
+}
+
 static bool isStreamUnopened(
     StreamId streamId,
     StreamId nextAcceptableStreamId) {
@@ -131,12 +138,7 @@ bool QuicStreamManager::streamExists(StreamId streamId) {
 }
 
 QuicStreamState* QuicStreamManager::findStream(StreamId streamId) {
-  auto lookup = streams_.find(streamId);
-  if (lookup == streams_.end()) {
-    return nullptr;
-  } else {
-    return &lookup->second;
-  }
+  return streams_.find(streamId);
 }
 
 void QuicStreamManager::setMaxLocalBidirectionalStreams(
@@ -254,16 +256,13 @@ QuicStreamManager::getOrCreateOpenedLocalStream(StreamId streamId) {
       : openBidirectionalLocalStreams_;
   if (openLocalStreams.contains(streamId)) {
     // Open a lazily created stream.
-    auto it = streams_.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(streamId),
-        std::forward_as_tuple(streamId, conn_));
+    auto it = streams_.emplace(streamId, streamId, conn_);
     QUIC_STATS(conn_.statsCallback, onNewQuicStream);
     if (!it.second) {
       throw QuicTransportException(
           "Creating an active stream", TransportErrorCode::STREAM_STATE_ERROR);
     }
-    return &it.first->second;
+    return it.first;
   }
   return nullptr;
 }
@@ -276,9 +275,8 @@ QuicStreamState* QuicStreamManager::getStream(
     updateAppIdleState();
     return stream;
   }
-  auto it = streams_.find(streamId);
-  if (it != streams_.end()) {
-    return &it->second;
+  if (auto existing = streams_.find(streamId)) {
+    return existing;
   }
   auto stream = getOrCreateOpenedLocalStream(streamId);
   auto nextAcceptableStreamId = isUnidirectionalStream(streamId)
@@ -341,12 +339,9 @@ QuicStreamState* FOLLY_NULLABLE QuicStreamManager::instantiatePeerStream(
       newGroupedPeerStreams_.push_back(streamId);
     }
   }
-  auto it = streams_.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(streamId),
-      std::forward_as_tuple(streamId, groupId, conn_));
+  auto it = streams_.emplace(streamId, streamId, groupId, conn_);
   QUIC_STATS(conn_.statsCallback, onNewQuicStream);
-  return &it.first->second;
+  return it.first;
 }
 
 folly::Expected<StreamGroupId, LocalErrorCode>
@@ -422,10 +417,8 @@ QuicStreamState* FOLLY_NULLABLE QuicStreamManager::getOrCreatePeerStream(
     }
   }
 
-  // TODO when we can rely on C++17, this is a good candidate for try_emplace.
-  auto peerStream = streams_.find(streamId);
-  if (peerStream != streams_.end()) {
-    return &peerStream->second;
+  if (auto peerStream = streams_.find(streamId)) {
+    return peerStream;
   }
   auto& openPeerStreams = isUnidirectionalStream(streamId)
       ? openUnidirectionalPeerStreams_
@@ -525,23 +518,20 @@ QuicStreamManager::createStream(
   if (openedResult != LocalErrorCode::NO_ERROR) {
     return folly::makeUnexpected(openedResult);
   }
-  auto it = streams_.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(streamId),
-      std::forward_as_tuple(streamId, streamGroupId, conn_));
+  auto it = streams_.emplace(streamId, streamId, streamGroupId, conn_);
   QUIC_STATS(conn_.statsCallback, onNewQuicStream);
   updateAppIdleState();
-  return &it.first->second;
+  return it.first;
 }
 
 void QuicStreamManager::removeClosedStream(StreamId streamId) {
-  auto it = streams_.find(streamId);
-  if (it == streams_.end()) {
+  auto stream = streams_.find(streamId);
+  if (!stream) {
     VLOG(10) << "Trying to remove already closed stream=" << streamId;
     return;
   }
   VLOG(10) << "Removing closed stream=" << streamId;
-  DCHECK(it->second.inTerminalStates());
+  DCHECK(stream->inTerminalStates());
   if (conn_.pendingEvents.resets.contains(streamId)) {
     // This can happen when we send two reliable resets, one of which is
     // egressed and ACKed.
@@ -554,18 +544,18 @@ void QuicStreamManager::removeClosedStream(StreamId streamId) {
     readableStreams_.erase(streamId);
   }
   peekableStreams_.erase(streamId);
-  removeWritable(it->second);
+  removeWritable(*stream);
   blockedStreams_.erase(streamId);
   deliverableStreams_.erase(streamId);
   txStreams_.erase(streamId);
   windowUpdates_.erase(streamId);
   stopSendingStreams_.erase(streamId);
   flowControlUpdated_.erase(streamId);
-  if (it->second.isControl) {
+  if (stream->isControl) {
     DCHECK_GT(numControlStreams_, 0);
     numControlStreams_--;
   }
-  streams_.erase(it);
+  streams_.erase(streamId);
   QUIC_STATS(conn_.statsCallback, onQuicStreamClosed);
   if (isRemoteStream(nodeType_, streamId)) {
     auto& openPeerStreams = isUnidirectionalStream(streamId)
@@ -724,8 +714,8 @@ bool QuicStreamManager::isAppIdle() const {
 
 void QuicStreamManager::clearOpenStreams() {
   QUIC_STATS_FOR_EACH(
-      streams().cbegin(),
-      streams().cend(),
+      streams().begin(),
+      streams().end(),
       conn_.statsCallback,
       onQuicStreamClosed);
 
@@ -740,4 +730,29 @@ void QuicStreamManager::clearOpenStreams() {
   streams_.clear();
 }
 
+void QuicStreamManager::shrinkToFit() {
+  for (auto stream : streams_) {
+    stream->shrinkToFit();
+  }
+  streams_.shrinkToFit();
+  releaseIfEmpty(newPeerStreams_);
+  releaseIfEmpty(newGroupedPeerStreams_);
+  releaseIfEmpty(newPeerStreamGroups_);
+  releaseIfEmpty(blockedStreams_);
+  releaseIfEmpty(stopSendingStreams_);
+}
+
+size_t QuicStreamManager::allocatedBytes() const {
+  size_t bytes = sizeof(*this) + streams_.allocatedBytes() +
+      newPeerStreams_.capacity() * sizeof(StreamId) +
+      newGroupedPeerStreams_.capacity() * sizeof(StreamId) +
+      newPeerStreamGroups_.getAllocatedMemorySize() +
+      blockedStreams_.getAllocatedMemorySize() +
+      stopSendingStreams_.getAllocatedMemorySize();
+  for (auto stream : streams_) {
+    bytes += stream->allocatedBytes();
+  }
+  return bytes;
+}
+
 } // namespace quic
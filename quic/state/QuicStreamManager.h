@@ -11,6 +11,8 @@
 #include <folly/container/F14Set.h>
 #include <quic/QuicConstants.h>
 #include <quic/codec/Types.h>
+#include <quic/common/SlabAllocator.h>
+#include <quic/state/QuicStreamTable.h>
 #include <quic/state/StreamData.h>
 #include <quic/state/TransportSettings.h>
 #include <numeric>
@@ -79,7 +81,7 @@ class StreamIdSet {
   uint8_t base_;
 };
 
-class QuicStreamManager {
+class QuicStreamManager : public SlabAllocated {
  public:
   QuicStreamManager(
       QuicConnectionStateBase& conn,
@@ -196,21 +198,8 @@ class QuicStreamManager {
     newGroupedPeerStreams_ = std::move(other.newGroupedPeerStreams_);
     blockedStreams_ = std::move(other.blockedStreams_);
     stopSendingStreams_ = std::move(other.stopSendingStreams_);
-    windowUpdates_ = std::move(other.windowUpdates_);
-    flowControlUpdated_ = std::move(other.flowControlUpdated_);
-    lossStreams_ = std::move(other.lossStreams_);
-    lossDSRStreams_ = std::move(other.lossDSRStreams_);
-    readableStreams_ = std::move(other.readableStreams_);
-    unidirectionalReadableStreams_ =
-        std::move(other.unidirectionalReadableStreams_);
-    peekableStreams_ = std::move(other.peekableStreams_);
     writeQueue_ = std::move(other.writeQueue_);
     controlWriteQueue_ = std::move(other.controlWriteQueue_);
-    writableStreams_ = std::move(other.writableStreams_);
-    writableDSRStreams_ = std::move(other.writableDSRStreams_);
-    txStreams_ = std::move(other.txStreams_);
-    deliverableStreams_ = std::move(other.deliverableStreams_);
-    closedStreams_ = std::move(other.closedStreams_);
     isAppIdle_ = other.isAppIdle_;
     maxLocalBidirectionalStreamIdIncreased_ =
         other.maxLocalBidirectionalStreamIdIncreased_;
@@ -221,13 +210,17 @@ class QuicStreamManager {
      * We can't simply std::move the streams as the underlying
      * QuicStreamState(s) hold a reference to the other.conn_.
      */
-    for (auto& pair : other.streams_) {
+    for (auto state : other.streams_) {
       streams_.emplace(
-          std::piecewise_construct,
-          std::forward_as_tuple(pair.first),
-          std::forward_as_tuple(
-              /* migrate state to new conn ref */ conn_,
-              std::move(pair.second)));
+          state->id,
+          /* migrate state to new conn ref */ conn_,
+          std::move(*state));
+    }
+    for (size_t i = 0; i < kNumStreamSetKinds; i++) {
+      auto kind = static_cast<StreamSetKind>(i);
+      for (auto id : other.streams_.set(kind)) {
+        streams_.set(kind).insert(id);
+      }
     }
   }
   /*
@@ -408,9 +401,22 @@ class QuicStreamManager {
    */
   void clearOpenStreams();
 
+  /*
+   * Frees the storage that the stream manager and its streams keep in empty
+   * containers, e.g. when the connection goes idle.
+   */
+  void shrinkToFit();
+
+  /*
+   * An estimate of the heap bytes held by the stream manager and its streams,
+   * not counting buffered data.
+   */
+  [[nodiscard]] size_t allocatedBytes() const;
+
   /*
    * Return a const reference to the underlying container holding the stream
-   * state. Only really useful for iterating.
+   * state. Only really useful for iterating, which yields QuicStreamState
+   * pointers.
    */
   const auto& streams() const {
     return streams_;
@@ -420,8 +426,8 @@ class QuicStreamManager {
    * Call the given function on every currently open stream's state.
    */
   void streamStateForEach(const std::function<void(QuicStreamState&)>& f) {
-    for (auto& s : streams_) {
-      f(s.second);
+    for (auto state : streams_) {
+      f(*state);
     }
   }
 
@@ -1123,8 +1129,8 @@ class QuicStreamManager {
   // Unidirectional stream groups that are opened locally on the connection.
   StreamIdSet openUnidirectionalLocalStreamGroups_;
 
-  // A map of streams that are active.
-  folly::F14FastMap<StreamId, QuicStreamState> streams_;
+  // The streams that are active, along with the per-stream sets below.
+  QuicStreamTable streams_;
 
   // Recently opened peer streams.
   std::vector<StreamId> newPeerStreams_;
@@ -1147,28 +1153,30 @@ class QuicStreamManager {
 
   // Streams that had their stream window change and potentially need a window
   // update sent
-  folly::F14FastSet<StreamId> windowUpdates_;
+  StreamFlagSet& windowUpdates_{streams_.set(StreamSetKind::WindowUpdates)};
 
   // Streams that had their flow control updated
-  folly::F14FastSet<StreamId> flowControlUpdated_;
+  StreamFlagSet& flowControlUpdated_{
+      streams_.set(StreamSetKind::FlowControlUpdated)};
 
   // Streams that have bytes in loss buffer
-  folly::F14FastSet<StreamId> lossStreams_;
+  StreamFlagSet& lossStreams_{streams_.set(StreamSetKind::Loss)};
 
   // DSR Streams that have bytes in loss buff meta
-  folly::F14FastSet<StreamId> lossDSRStreams_;
+  StreamFlagSet& lossDSRStreams_{streams_.set(StreamSetKind::LossDSR)};
 
   // Set of streams that have pending reads
-  folly::F14FastSet<StreamId> readableStreams_;
+  StreamFlagSet& readableStreams_{streams_.set(StreamSetKind::Readable)};
 
   // Set of unidirectional streams that have pending reads.
   // Used separately from readableStreams_ when
   // unidirectionalStreamsReadCallbacksFirst = true to prioritize unidirectional
   // streams read callbacks.
-  folly::F14FastSet<StreamId> unidirectionalReadableStreams_;
+  StreamFlagSet& unidirectionalReadableStreams_{
+      streams_.set(StreamSetKind::UnidirectionalReadable)};
 
   // Set of streams that have pending peeks
-  folly::F14FastSet<StreamId> peekableStreams_;
+  StreamFlagSet& peekableStreams_{streams_.set(StreamSetKind::Peekable)};
 
   // Set of !control streams that have writable data used for frame scheduling
   PriorityQueue writeQueue_;
@@ -1176,17 +1184,17 @@ class QuicStreamManager {
   // Set of control streams that have writable data
   std::set<StreamId> controlWriteQueue_;
 
-  folly::F14FastSet<StreamId> writableStreams_;
-  folly::F14FastSet<StreamId> writableDSRStreams_;
+  StreamFlagSet& writableStreams_{streams_.set(StreamSetKind::Writable)};
+  StreamFlagSet& writableDSRStreams_{streams_.set(StreamSetKind::WritableDSR)};
 
   // Streams that may be able to call TxCallback
-  folly::F14FastSet<StreamId> txStreams_;
+  StreamFlagSet& txStreams_{streams_.set(StreamSetKind::Tx)};
 
   // Streams that may be able to callback DeliveryCallback
-  folly::F14FastSet<StreamId> deliverableStreams_;
+  StreamFlagSet& deliverableStreams_{streams_.set(StreamSetKind::Deliverable)};
 
   // Streams that are closed but we still have state for
-  folly::F14FastSet<StreamId> closedStreams_;
+  StreamFlagSet& closedStreams_{streams_.set(StreamSetKind::Closed)};
 
   // Record whether or not we are app-idle.
   bool isAppIdle_{false};
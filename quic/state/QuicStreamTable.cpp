@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <quic/state/QuicStreamTable.h>
+
+#include <algorithm>
+
+namespace quic {
+
+bool StreamFlagSet::insert(StreamId id) {
+  auto& slot = table_.getOrCreateSlot(id);
+  auto kind = static_cast<size_t>(kind_);
+  uint16_t bit = 1 << kind;
+  if (slot.flags & bit) {
+    return false;
+  }
+  bool wasEmpty = slot.empty();
+  slot.flags |= bit;
+  slot.setPos[kind] = ids_.size();
+  ids_.push_back(id);
+  if (wasEmpty) {
+    table_.slotFilled(id);
+  }
+  return true;
+}
+
+size_t StreamFlagSet::erase(StreamId id) {
+  auto slot = table_.findSlot(id);
+  auto kind = static_cast<size_t>(kind_);
+  if (!slot || !(slot->flags & (1 << kind))) {
+    return 0;
+  }
+  removeAt(slot->setPos[kind]);
+  return 1;
+}
+
+StreamFlagSet::const_iterator StreamFlagSet::erase(const_iterator it) {
+  auto pos = std::distance(ids_.cbegin(), it);
+  removeAt(pos);
+  return ids_.cbegin() + pos;
+}
+
+bool StreamFlagSet::contains(StreamId id) const {
+  auto slot = table_.findSlot(id);
+  return slot && (slot->flags & (1 << static_cast<size_t>(kind_)));
+}
+
+void StreamFlagSet::clear() {
+  auto kind = static_cast<size_t>(kind_);
+  for (auto id : ids_) {
+    auto slot = table_.findSlot(id);
+    DCHECK(slot);
+    slot->flags &= ~(1 << kind);
+    if (slot->empty()) {
+      table_.slotEmptied(id);
+    }
+  }
+  ids_.clear();
+}
+
+void StreamFlagSet::removeAt(size_t pos) {
+  DCHECK_LT(pos, ids_.size());
+  auto kind = static_cast<size_t>(kind_);
+  StreamId id = ids_[pos];
+  if (pos + 1 != ids_.size()) {
+    StreamId moved = ids_.back();
+    ids_[pos] = moved;
+    table_.findSlot(moved)->setPos[kind] = pos;
+  }
+  ids_.pop_back();
+  auto slot = table_.findSlot(id);
+  slot->flags &= ~(1 << kind);
+  if (slot->empty()) {
+    table_.slotEmptied(id);
+  }
+}
+
+QuicStreamTable::QuicStreamTable()
+    : sets_{{
+          {*this, StreamSetKind::WindowUpdates},
+          {*this, StreamSetKind::FlowControlUpdated},
+          {*this, StreamSetKind::Loss},
+          {*this, StreamSetKind::LossDSR},
+          {*this, StreamSetKind::Readable},
+          {*this, StreamSetKind::UnidirectionalReadable},
+          {*this, StreamSetKind::Peekable},
+          {*this, StreamSetKind::Writable},
+          {*this, StreamSetKind::WritableDSR},
+          {*this, StreamSetKind::Tx},
+          {*this, StreamSetKind::Deliverable},
+          {*this, StreamSetKind::Closed},
+      }} {}
+
+QuicStreamTable::~QuicStreamTable() {
+  for (auto state : live_) {
+    state->~QuicStreamState();
+  }
+}
+
+void QuicStreamTable::erase(StreamId id) {
+  auto slot = findSlot(id);
+  if (!slot || !slot->state) {
+    return;
+  }
+  removeLive(*slot);
+  auto state = slot->state;
+  slot->state = nullptr;
+  state->~QuicStreamState();
+  freeState(state);
+  if (slot->empty()) {
+    slotEmptied(id);
+  }
+}
+
+void QuicStreamTable::clear() {
+  // Copy the ids first, erase() reorders live_.
+  std::vector<StreamId> ids;
+  ids.reserve(live_.size());
+  for (auto state : live_) {
+    ids.push_back(state->id);
+  }
+  for (auto id : ids) {
+    erase(id);
+  }
+}
+
+void QuicStreamTable::shrinkToFit() {
+  // Count the free states of each chunk, chunks are few.
+  std::vector<size_t> numFree(slabChunks_.size(), 0);
+  auto chunkIndex = [this](void* storage) -> size_t {
+    auto state = static_cast<StateStorage*>(storage);
+    auto it = std::find_if(
+        slabChunks_.begin(), slabChunks_.end(), [state](const auto& chunk) {
+          return state >= chunk.get() && state < chunk.get() + kSlabChunkSize;
+        });
+    CHECK(it != slabChunks_.end());
+    return it - slabChunks_.begin();
+  };
+  for (auto storage : freeStates_) {
+    numFree[chunkIndex(storage)]++;
+  }
+  std::vector<void*> freeStates;
+  for (auto storage : freeStates_) {
+    if (numFree[chunkIndex(storage)] < kSlabChunkSize) {
+      freeStates.push_back(storage);
+    }
+  }
+  freeStates_ = std::move(freeStates);
+  std::vector<std::unique_ptr<StateStorage[]>> slabChunks;
+  for (size_t i = 0; i < slabChunks_.size(); i++) {
+    if (numFree[i] < kSlabChunkSize) {
+      slabChunks.push_back(std::move(slabChunks_[i]));
+    }
+  }
+  slabChunks_ = std::move(slabChunks);
+  live_.shrink_to_fit();
+  for (auto& set : sets_) {
+    set.ids_.shrink_to_fit();
+  }
+}
+
+size_t QuicStreamTable::allocatedBytes() const {
+  size_t bytes = slabChunks_.size() * kSlabChunkSize * sizeof(StateStorage) +
+      slabChunks_.capacity() * sizeof(std::unique_ptr<StateStorage[]>) +
+      freeStates_.capacity() * sizeof(void*) +
+      live_.capacity() * sizeof(QuicStreamState*);
+  for (const auto& dir : directories_) {
+    for (const auto& page : dir.pages) {
+      bytes += sizeof(page) + (page ? sizeof(Page) : 0);
+    }
+  }
+  for (const auto& set : sets_) {
+    bytes += set.ids_.capacity() * sizeof(StreamId);
+  }
+  return bytes;
+}
+
+QuicStreamTable::Slot& QuicStreamTable::getOrCreateSlot(StreamId id) {
+  auto& dir = directories_[id & 0x3];
+  uint64_t pageIndex = (id >> 2) >> kPageBits;
+  if (dir.pages.empty()) {
+    dir.firstPage = pageIndex;
+    dir.pages.emplace_back();
+  } else if (pageIndex < dir.firstPage) {
+    // Extend the directory towards lower ids. Growing a deque at either end
+    // leaves the existing pages where they are.
+    while (dir.firstPage > pageIndex) {
+      dir.pages.emplace_front();
+      dir.firstPage--;
+    }
+  } else if (pageIndex - dir.firstPage >= dir.pages.size()) {
+    dir.pages.resize(pageIndex - dir.firstPage + 1);
+  }
+  auto& page = dir.pages[pageIndex - dir.firstPage];
+  if (!page) {
+    page = std::make_unique<Page>();
+  }
+  return page->slots[(id >> 2) & (kPageSize - 1)];
+}
+
+void QuicStreamTable::slotFilled(StreamId id) {
+  auto& dir = directories_[id & 0x3];
+  uint64_t pageIndex = (id >> 2) >> kPageBits;
+  dir.pages[pageIndex - dir.firstPage]->numUsed++;
+}
+
+void QuicStreamTable::slotEmptied(StreamId id) {
+  auto& dir = directories_[id & 0x3];
+  uint64_t pageIndex = (id >> 2) >> kPageBits;
+  auto& page = dir.pages[pageIndex - dir.firstPage];
+  DCHECK_GT(page->numUsed, 0);
+  page->numUsed--;
+  freePageIfUnused(id);
+}
+
+void QuicStreamTable::freePageIfUnused(StreamId id) {
+  auto& dir = directories_[id & 0x3];
+  uint64_t pageIndex = (id >> 2) >> kPageBits;
+  auto& page = dir.pages[pageIndex - dir.firstPage];
+  if (!page || page->numUsed > 0) {
+    return;
+  }
+  page.reset();
+  // Trim unused pages from both ends so the directory only spans the ids that
+  // are in use.
+  while (!dir.pages.empty() && !dir.pages.front()) {
+    dir.pages.pop_front();
+    dir.firstPage++;
+  }
+  while (!dir.pages.empty() && !dir.pages.back()) {
+    dir.pages.pop_back();
+  }
+}
+
+void QuicStreamTable::addLive(Slot& slot) {
+  slot.livePos = live_.size();
+  live_.push_back(slot.state);
+}
+
+void QuicStreamTable::removeLive(Slot& slot) {
+  DCHECK_LT(slot.livePos, live_.size());
+  if (slot.livePos + 1 != live_.size()) {
+    auto moved = live_.back();
+    live_[slot.livePos] = moved;
+    findSlot(moved->id)->livePos = slot.livePos;
+  }
+  live_.pop_back();
+  slot.livePos = kNotMember;
+}
+
+void* QuicStreamTable::allocateState() {
+  if (freeStates_.empty()) {
+    slabChunks_.emplace_back(new StateStorage[kSlabChunkSize]);
+    auto chunk = slabChunks_.back().get();
+    freeStates_.reserve(freeStates_.size() + kSlabChunkSize);
+    // Push in reverse so that the chunk is handed out front to back.
+    for (size_t i = kSlabChunkSize; i > 0; i--) {
+      freeStates_.push_back(&chunk[i - 1]);
+    }
+  }
+  auto storage = freeStates_.back();
+  freeStates_.pop_back();
+  return storage;
+}
+
+void QuicStreamTable::freeState(void* storage) {
+  freeStates_.push_back(storage);
+}
+
+} // namespace quic
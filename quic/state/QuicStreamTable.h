@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <quic/codec/Types.h>
+#include <quic/state/StreamData.h>
+
+#include <array>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace quic {
+
+class QuicStreamTable;
+
+/*
+ * The per-stream sets of stream ids the stream manager keeps, e.g. the streams
+ * with data to read or with lost data to retransmit.
+ */
+enum class StreamSetKind : uint8_t {
+  WindowUpdates,
+  FlowControlUpdated,
+  Loss,
+  LossDSR,
+  Readable,
+  UnidirectionalReadable,
+  Peekable,
+  Writable,
+  WritableDSR,
+  Tx,
+  Deliverable,
+  Closed,
+};
+
+constexpr size_t kNumStreamSetKinds =
+    static_cast<size_t>(StreamSetKind::Closed) + 1;
+
+/*
+ * A set of stream ids owned by a QuicStreamTable. Membership is a bit in the
+ * stream's table slot, so lookups and updates index into the table instead of
+ * hashing. The members are also kept in a vector for iteration; erasing one
+ * moves the last member into its place, so iteration order is unspecified, as
+ * it is for the hash sets this replaces.
+ *
+ * Ids do not need to have stream state in the table to be members, e.g. a
+ * closed stream stays in the Closed set after its state is removed.
+ */
+class StreamFlagSet {
+ public:
+  using value_type = StreamId;
+  using const_iterator = std::vector<StreamId>::const_iterator;
+  using iterator = const_iterator;
+
+  StreamFlagSet(const StreamFlagSet&) = delete;
+  StreamFlagSet& operator=(const StreamFlagSet&) = delete;
+
+  /*
+   * Adds the id. Returns false if it was already a member.
+   */
+  bool insert(StreamId id);
+
+  bool emplace(StreamId id) {
+    return insert(id);
+  }
+
+  /*
+   * Removes the id and returns the number of ids removed.
+   */
+  size_t erase(StreamId id);
+
+  /*
+   * Removes the member at it and returns an iterator to the next member to
+   * visit.
+   */
+  const_iterator erase(const_iterator it);
+
+  [[nodiscard]] bool contains(StreamId id) const;
+
+  [[nodiscard]] size_t count(StreamId id) const {
+    return contains(id) ? 1 : 0;
+  }
+
+  [[nodiscard]] size_t size() const {
+    return ids_.size();
+  }
+
+  [[nodiscard]] bool empty() const {
+    return ids_.empty();
+  }
+
+  void clear();
+
+  [[nodiscard]] const_iterator begin() const {
+    return ids_.cbegin();
+  }
+
+  [[nodiscard]] const_iterator end() const {
+    return ids_.cend();
+  }
+
+ private:
+  friend class QuicStreamTable;
+
+  StreamFlagSet(QuicStreamTable& table, StreamSetKind kind)
+      : table_(table), kind_(kind) {}
+
+  void removeAt(size_t pos);
+
+  QuicStreamTable& table_;
+  StreamSetKind kind_;
+  std::vector<StreamId> ids_;
+};
+
+/*
+ * Storage for the stream state of a connection, indexed by stream ordinal
+ * (stream id >> 2) instead of hashing the stream id.
+ *
+ * Each of the four stream types has a directory of pages of kPageSize slots.
+ * A slot holds a pointer to the stream's state, its StreamFlagSet membership
+ * bits and its position in each set. Pages are allocated when a slot in them
+ * is first used and freed when all their slots are empty again, so memory
+ * follows the live streams plus one pointer per kPageSize ids between the
+ * oldest and newest live stream of each type.
+ *
+ * The QuicStreamState objects themselves are allocated from a slab of
+ * fixed-size chunks that is recycled through a free list, and never move while
+ * the stream is in the table.
+ */
+class QuicStreamTable {
+ public:
+  static constexpr size_t kPageBits = 6;
+  static constexpr size_t kPageSize = 1 << kPageBits;
+  static constexpr size_t kSlabChunkSize = 32;
+
+  using const_iterator = std::vector<QuicStreamState*>::const_iterator;
+
+  QuicStreamTable();
+  ~QuicStreamTable();
+
+  QuicStreamTable(const QuicStreamTable&) = delete;
+  QuicStreamTable& operator=(const QuicStreamTable&) = delete;
+
+  /*
+   * Constructs the state for the stream id with the given arguments. Returns
+   * the state and whether it was created, or the existing state and false.
+   */
+  template <typename... Args>
+  std::pair<QuicStreamState*, bool> emplace(StreamId id, Args&&... args) {
+    auto& slot = getOrCreateSlot(id);
+    if (slot.state) {
+      return {slot.state, false};
+    }
+    bool wasEmpty = slot.empty();
+    void* storage = allocateState();
+    try {
+      slot.state = new (storage) QuicStreamState(std::forward<Args>(args)...);
+    } catch (...) {
+      freeState(storage);
+      freePageIfUnused(id);
+      throw;
+    }
+    if (wasEmpty) {
+      slotFilled(id);
+    }
+    addLive(slot);
+    return {slot.state, true};
+  }
+
+  QuicStreamState* FOLLY_NULLABLE find(StreamId id) const {
+    auto slot = findSlot(id);
+    return slot ? slot->state : nullptr;
+  }
+
+  /*
+   * Destroys the state of the stream. Set memberships of the id are kept.
+   */
+  void erase(StreamId id);
+
+  /*
+   * Destroys the state of all streams. Set memberships are kept.
+   */
+  void clear();
+
+  [[nodiscard]] size_t size() const {
+    return live_.size();
+  }
+
+  [[nodiscard]] bool empty() const {
+    return live_.empty();
+  }
+
+  /*
+   * Iterates over pointers to the state of all streams in the table.
+   */
+  [[nodiscard]] const_iterator begin() const {
+    return live_.cbegin();
+  }
+
+  [[nodiscard]] const_iterator end() const {
+    return live_.cend();
+  }
+
+  /*
+   * Frees the state chunks that no stream uses and the spare capacity of the
+   * vectors, e.g. once a connection has gone idle.
+   */
+  void shrinkToFit();
+
+  /*
+   * The heap bytes held by the table, including the state of its streams but
+   * not the buffers the states point to.
+   */
+  [[nodiscard]] size_t allocatedBytes() const;
+
+  StreamFlagSet& set(StreamSetKind kind) {
+    return sets_[static_cast<size_t>(kind)];
+  }
+
+  const StreamFlagSet& set(StreamSetKind kind) const {
+    return sets_[static_cast<size_t>(kind)];
+  }
+
+ private:
+  friend class StreamFlagSet;
+
+  static constexpr uint32_t kNotMember = std::numeric_limits<uint32_t>::max();
+
+  struct Slot {
+    QuicStreamState* state{nullptr};
+    // Bit i is set if the id is in the set of StreamSetKind i.
+    uint16_t flags{0};
+    // Index of the state in live_.
+    uint32_t livePos{kNotMember};
+    // Index of the id in each set it is a member of.
+    std::array<uint32_t, kNumStreamSetKinds> setPos;
+
+    [[nodiscard]] bool empty() const {
+      return !state && flags == 0;
+    }
+  };
+
+  struct Page {
+    std::array<Slot, kPageSize> slots;
+    size_t numUsed{0};
+  };
+
+  // The pages of one stream type, covering ordinals starting at
+  // firstPage << kPageBits. Unused pages in between are null.
+  struct Directory {
+    uint64_t firstPage{0};
+    std::deque<std::unique_ptr<Page>> pages;
+  };
+
+  Slot* FOLLY_NULLABLE findSlot(StreamId id) const {
+    const auto& dir = directories_[id & 0x3];
+    uint64_t pageIndex = (id >> 2) >> kPageBits;
+    if (pageIndex < dir.firstPage ||
+        pageIndex - dir.firstPage >= dir.pages.size()) {
+      return nullptr;
+    }
+    auto& page = dir.pages[pageIndex - dir.firstPage];
+    if (!page) {
+      return nullptr;
+    }
+    return &page->slots[(id >> 2) & (kPageSize - 1)];
+  }
+
+  // Returns the slot for the id, allocating its page if needed. Callers must
+  // call slotFilled() once they make an empty slot non-empty.
+  Slot& getOrCreateSlot(StreamId id);
+
+  void slotFilled(StreamId id);
+
+  // Called once a slot becomes empty. Frees its page if all of the page's
+  // slots are empty.
+  void slotEmptied(StreamId id);
+
+  void freePageIfUnused(StreamId id);
+
+  void addLive(Slot& slot);
+  void removeLive(Slot& slot);
+
+  void* allocateState();
+  void freeState(void* storage);
+
+  std::array<Directory, 4> directories_;
+  std::array<StreamFlagSet, kNumStreamSetKinds> sets_;
+  std::vector<QuicStreamState*> live_;
+
+  struct alignas(QuicStreamState) StateStorage {
+    unsigned char bytes[sizeof(QuicStreamState)];
+  };
+  std::vector<std::unique_ptr<StateStorage[]>> slabChunks_;
+  std::vector<void*> freeStates_;
+};
+
+} // namespace quic
@@ -87,6 +87,14 @@ class QuicTransportStatsCallback {
 
   virtual void onForwardedPacketProcessed() = 0;
 
+  // A worker received a packet for a connection of another worker and handed
+  // it over.
+  virtual void onPacketRoutedToOtherWorker() = 0;
+
+  // The number of packets a worker took off its rings from other workers in
+  // one wakeup, i.e. the depth the rings had built up to.
+  virtual void onWorkerPacketRingDrained(size_t numPackets) = 0;
+
   virtual void onClientInitialReceived(QuicVersion version) = 0;
 
   virtual void onConnectionRateLimited() = 0;
@@ -183,6 +191,9 @@ class QuicTransportStatsCallback {
 
   virtual void onPacerTimerLagged() = 0;
 
+  // The pacing timer woke the transport up to write.
+  virtual void onPacerTimerFired() = 0;
+
   virtual void onPeerMaxUniStreamsLimitSaturated() = 0;
 
   virtual void onPeerMaxBidiStreamsLimitSaturated() = 0;
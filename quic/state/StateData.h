@@ -14,6 +14,8 @@
 #include <quic/codec/Types.h>
 #include <quic/common/BufAccessor.h>
 #include <quic/common/CircularDeque.h>
+#include <quic/common/SlabAllocator.h>
+#include <quic/common/ZeroCopyBufferRing.h>
 #include <quic/congestion_control/CongestionController.h>
 #include <quic/congestion_control/PacketProcessor.h>
 #include <quic/congestion_control/ThrottlingSignalProvider.h>
@@ -46,7 +48,7 @@ namespace quic {
 
 struct OutstandingsInfo {
   // Sent packets which have not been acked. These are sorted by PacketNum.
-  std::deque<OutstandingPacketWrapper> packets;
+  OutstandingPacketList packets;
 
   // All PacketEvents of this connection. If a OutstandingPacketWrapper doesn't
   // have an maybeClonedPacketIdentifier or if it's not in this set, there is no
@@ -153,7 +155,37 @@ class AppLimitedTracker {
   Clock::time_point appLimitedStartTime_{Clock::now()};
 };
 
-struct Pacer {
+/**
+ * How the packets of one paced write are spread out when each of them carries
+ * an SO_TXTIME departure time. The first firstBurstSize packets leave after
+ * startOffset, then a burst of burstSize packets leaves every interval.
+ */
+struct TxTimeSchedule {
+  std::chrono::microseconds startOffset{0us};
+  uint64_t firstBurstSize{0};
+  uint64_t burstSize{0};
+  uint64_t numLaterBursts{0};
+  std::chrono::microseconds interval{0us};
+  // Packets of the write that have been given a departure time so far.
+  uint64_t packetsScheduled{0};
+
+  [[nodiscard]] uint64_t packetLimit() const {
+    return firstBurstSize + burstSize * numLaterBursts;
+  }
+
+  // Departure time of the packetIndex-th packet, relative to the write.
+  [[nodiscard]] std::chrono::microseconds departureOffset(
+      uint64_t packetIndex) const {
+    if (packetIndex < firstBurstSize || burstSize == 0) {
+      return startOffset;
+    }
+    auto burst = std::min(
+        1 + (packetIndex - firstBurstSize) / burstSize, numLaterBursts);
+    return startOffset + interval * burst;
+  }
+};
+
+struct Pacer : public SlabAllocated {
   virtual ~Pacer() = default;
 
   /**
@@ -209,11 +241,38 @@ struct Pacer {
    */
   virtual uint64_t updateAndGetWriteBatchSize(TimePoint currentTime) = 0;
 
+  /**
+   * Like updateAndGetWriteBatchSize(), for a transport that stamps its packets
+   * with SO_TXTIME departure times and leaves the fine-grained pacing to the
+   * qdisc. Returns the bursts of up to horizon worth of pacing intervals, so
+   * that they can all be written now, and the next write is not due before
+   * the last of them departs.
+   */
+  virtual TxTimeSchedule updateAndGetTxTimeSchedule(
+      TimePoint currentTime,
+      std::chrono::microseconds /* horizon */) {
+    TxTimeSchedule schedule;
+    schedule.firstBurstSize = updateAndGetWriteBatchSize(currentTime);
+    return schedule;
+  }
+
+  /**
+   * Called after a write that used a schedule from
+   * updateAndGetTxTimeSchedule(), with its packetsScheduled set to the number
+   * of packets actually written, which may fall short of its packetLimit().
+   */
+  virtual void onTxTimeScheduleWritten(const TxTimeSchedule& /* schedule */) {}
+
   /**
    * Getter API of the most recent write batch size.
    */
   virtual uint64_t getCachedWriteBatchSize() const = 0;
 
+  /**
+   * The current pacing rate, or 0 if writes are not being paced.
+   */
+  [[nodiscard]] virtual uint64_t getPacingRateBytesPerSec() const = 0;
+
   virtual void onPacketSent() = 0;
   virtual void onPacketsLoss() = 0;
 
@@ -242,7 +301,7 @@ struct QuicCryptoStream : public QuicStreamLike {
   ~QuicCryptoStream() override = default;
 };
 
-struct QuicCryptoState {
+struct QuicCryptoState : public SlabAllocated {
   // Stream to exchange the initial cryptographic material.
   QuicCryptoStream initialStream;
 
@@ -304,7 +363,8 @@ struct ReadDatagram {
   BufQueue buf_;
 };
 
-struct QuicConnectionStateBase : public folly::DelayedDestruction {
+struct QuicConnectionStateBase : public folly::DelayedDestruction,
+                                 public SlabAllocated {
   virtual ~QuicConnectionStateBase() override = default;
 
   explicit QuicConnectionStateBase(QuicNodeType type) : nodeType(type) {}
@@ -312,6 +372,10 @@ struct QuicConnectionStateBase : public folly::DelayedDestruction {
   // Accessor to output buffer for continuous memory GSO writes
   BufAccessor* bufAccessor{nullptr};
 
+  // Spare output buffers for zerocopy writes. Set only when zerocopy has been
+  // enabled on the socket.
+  ZeroCopyBufferRing* zeroCopyBufferRing{nullptr};
+
   std::unique_ptr<Handshake> handshakeLayer;
 
   // Crypto stream
@@ -320,6 +384,14 @@ struct QuicConnectionStateBase : public folly::DelayedDestruction {
   // Connection Congestion controller
   std::unique_ptr<CongestionController> congestionController;
 
+  // What is kept of the congestion controller while an idle connection is
+  // compacted, see compactIdleConnection().
+  struct CompactedCongestionState {
+    CongestionControlType type;
+    uint64_t congestionWindowBytes;
+  };
+  Optional<CompactedCongestionState> compactedCongestionState;
+
   std::vector<std::shared_ptr<PacketProcessor>> packetProcessors;
 
   std::shared_ptr<ThrottlingSignalProvider> throttlingSignalProvider;
@@ -327,6 +399,10 @@ struct QuicConnectionStateBase : public folly::DelayedDestruction {
   // Pacer
   std::unique_ptr<Pacer> pacer;
 
+  // Set for the duration of a paced write whose packets carry SO_TXTIME
+  // departure times.
+  Optional<TxTimeSchedule> txTimeSchedule;
+
   // Congestion Controller factory to create specific impl of cc algorithm
   std::shared_ptr<CongestionControllerFactory> congestionControllerFactory;
 
@@ -676,6 +752,11 @@ struct QuicConnectionStateBase : public folly::DelayedDestruction {
   // Number of probe packets that were writableBytesLimited
   uint64_t numProbesWritableBytesLimited{0};
 
+  // Estimated bytes held by the connection before and after it was last
+  // compacted while idle. Zero if it never was.
+  uint64_t bytesBeforeCompaction{0};
+  uint64_t bytesAfterCompaction{0};
+
   struct DatagramState {
     uint32_t maxReadFrameSize{kDefaultMaxDatagramFrameSize};
     uint32_t maxWriteFrameSize{kDefaultMaxDatagramFrameSize};
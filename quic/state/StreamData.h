@@ -11,10 +11,17 @@
 #include <folly/container/F14Set.h>
 #include <quic/QuicConstants.h>
 #include <quic/codec/Types.h>
+#include <quic/common/ChunkedDeque.h>
+#include <quic/common/CircularDeque.h>
 #include <quic/common/SmallCollections.h>
 #include <quic/dsr/DSRPacketizationRequestSender.h>
 #include <quic/state/QuicPriorityQueue.h>
 
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
 namespace quic {
 
 /**
@@ -116,6 +123,224 @@ struct WriteStreamBuffer {
   }
 };
 
+/**
+ * The stream data that has been written to the socket and is not yet acked or
+ * lost, keyed by offset. Each entry is one StreamFrame. It looks up like a map
+ * of offset to WriteStreamBuffer*, but keeps its entries sorted by offset in a
+ * ring and the buffers in chunks that are recycled, so once a stream has
+ * warmed up, writing, acking and losing frames does not allocate.
+ *
+ * A buffer stays at the same address until its entry is erased.
+ */
+class RetransmissionBuffer {
+ public:
+  using value_type = std::pair<uint64_t, WriteStreamBuffer*>;
+  using iterator = CircularDeque<value_type>::iterator;
+  using const_iterator = CircularDeque<value_type>::const_iterator;
+
+  static constexpr size_t kMinChunkSize = 4;
+  static constexpr size_t kMaxChunkSize = 64;
+
+  RetransmissionBuffer() = default;
+
+  RetransmissionBuffer(RetransmissionBuffer&& other) noexcept
+      : entries_(std::move(other.entries_)),
+        chunks_(std::move(other.chunks_)),
+        freeNodes_(std::move(other.freeNodes_)),
+        numNodes_(std::exchange(other.numNodes_, 0)) {}
+
+  RetransmissionBuffer& operator=(RetransmissionBuffer&& other) noexcept {
+    if (this != &other) {
+      clear();
+      entries_ = std::move(other.entries_);
+      chunks_ = std::move(other.chunks_);
+      freeNodes_ = std::move(other.freeNodes_);
+      numNodes_ = std::exchange(other.numNodes_, 0);
+    }
+    return *this;
+  }
+
+  ~RetransmissionBuffer() {
+    clear();
+  }
+
+  /**
+   * Adds the buffer WriteStreamBuffer(args...) at its offset. Like a map, does
+   * nothing and returns false if there already is one at that offset.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(
+      ChainedByteRangeHead&& data,
+      uint64_t offset,
+      Args&&... args) {
+    auto pos = entries_.end();
+    // New data is written at increasing offsets.
+    if (!entries_.empty() && offset <= entries_.back().first) {
+      pos = lowerBound(offset);
+      if (pos != entries_.end() && pos->first == offset) {
+        return {pos, false};
+      }
+    }
+    auto node = new (allocateNode())
+        WriteStreamBuffer(std::move(data), offset, std::forward<Args>(args)...);
+    return {entries_.emplace(pos, offset, node), true};
+  }
+
+  iterator find(uint64_t offset) {
+    auto it = lowerBound(offset);
+    return it != entries_.end() && it->first == offset ? it : entries_.end();
+  }
+
+  const_iterator find(uint64_t offset) const {
+    return const_cast<RetransmissionBuffer*>(this)->find(offset);
+  }
+
+  WriteStreamBuffer* at(uint64_t offset) const {
+    auto it = find(offset);
+    if (it == entries_.end()) {
+      throw std::out_of_range("No retransmission buffer at offset");
+    }
+    return it->second;
+  }
+
+  size_t count(uint64_t offset) const {
+    return find(offset) != entries_.end() ? 1 : 0;
+  }
+
+  iterator erase(const_iterator pos) {
+    freeNode(pos->second);
+    return entries_.erase(pos);
+  }
+
+  size_t erase(uint64_t offset) {
+    auto it = find(offset);
+    if (it == entries_.end()) {
+      return 0;
+    }
+    erase(it);
+    return 1;
+  }
+
+  /**
+   * Erases the buffers at or after offset, and trims the one that straddles
+   * it.
+   */
+  void eraseFrom(uint64_t offset) {
+    auto it = lowerBound(offset);
+    if (it != entries_.begin()) {
+      // Buffers do not overlap, so only the previous one can reach offset.
+      auto prev = std::prev(it);
+      auto& buf = *prev->second;
+      if (buf.offset + buf.data.chainLength() >= offset) {
+        buf.data = buf.data.splitAtMost(size_t(offset - buf.offset));
+      }
+    }
+    while (it != entries_.end()) {
+      freeNode(it->second);
+      it = entries_.erase(it);
+    }
+  }
+
+  void clear() {
+    for (auto& entry : entries_) {
+      freeNode(entry.second);
+    }
+    entries_.clear();
+  }
+
+  [[nodiscard]] size_t size() const {
+    return entries_.size();
+  }
+
+  [[nodiscard]] bool empty() const {
+    return entries_.empty();
+  }
+
+  /**
+   * Frees the ring and the buffer chunks if the buffer is empty. A stream that
+   * has sent a lot of data keeps them otherwise.
+   */
+  void shrinkToFit() {
+    if (!entries_.empty()) {
+      return;
+    }
+    entries_.shrink_to_fit();
+    std::vector<std::unique_ptr<NodeStorage[]>>().swap(chunks_);
+    std::vector<void*>().swap(freeNodes_);
+    numNodes_ = 0;
+  }
+
+  // The heap bytes held by the ring and the buffer chunks.
+  [[nodiscard]] size_t allocatedBytes() const {
+    return entries_.max_size() * sizeof(value_type) +
+        numNodes_ * sizeof(NodeStorage) +
+        freeNodes_.capacity() * sizeof(void*) +
+        chunks_.capacity() * sizeof(std::unique_ptr<NodeStorage[]>);
+  }
+
+  iterator begin() {
+    return entries_.begin();
+  }
+
+  iterator end() {
+    return entries_.end();
+  }
+
+  const_iterator begin() const {
+    return entries_.begin();
+  }
+
+  const_iterator end() const {
+    return entries_.end();
+  }
+
+ private:
+  struct alignas(WriteStreamBuffer) NodeStorage {
+    unsigned char bytes[sizeof(WriteStreamBuffer)];
+  };
+
+  iterator lowerBound(uint64_t offset) {
+    // Acks mostly arrive oldest first.
+    if (entries_.empty() || entries_.front().first >= offset) {
+      return entries_.begin();
+    }
+    return std::lower_bound(
+        entries_.begin(),
+        entries_.end(),
+        offset,
+        [](const value_type& entry, uint64_t key) {
+          return entry.first < key;
+        });
+  }
+
+  void* allocateNode() {
+    if (freeNodes_.empty()) {
+      // Grow with the stream so that short streams stay small.
+      auto chunkSize = std::clamp(numNodes_, kMinChunkSize, kMaxChunkSize);
+      chunks_.emplace_back(new NodeStorage[chunkSize]);
+      auto chunk = chunks_.back().get();
+      freeNodes_.reserve(numNodes_ + chunkSize);
+      for (size_t i = chunkSize; i > 0; i--) {
+        freeNodes_.push_back(&chunk[i - 1]);
+      }
+      numNodes_ += chunkSize;
+    }
+    auto node = freeNodes_.back();
+    freeNodes_.pop_back();
+    return node;
+  }
+
+  void freeNode(WriteStreamBuffer* node) {
+    node->~WriteStreamBuffer();
+    freeNodes_.push_back(node);
+  }
+
+  CircularDeque<value_type> entries_;
+  std::vector<std::unique_ptr<NodeStorage[]>> chunks_;
+  std::vector<void*> freeNodes_;
+  size_t numNodes_{0};
+};
+
 struct QuicStreamLike {
   QuicStreamLike() = default;
 
@@ -124,8 +349,9 @@ struct QuicStreamLike {
   virtual ~QuicStreamLike() = default;
 
   // List of bytes that have been read and buffered. We need to buffer
-  // bytes in case we get bytes out of order.
-  CircularDeque<StreamBuffer> readBuffer;
+  // bytes in case we get bytes out of order. Chunked so that filling holes
+  // in a heavily reordered stream does not shift the whole list.
+  ChunkedDeque<StreamBuffer> readBuffer;
 
   // List of bytes that have been written to the QUIC layer.
   uint64_t writeBufferStartOffset{0};
@@ -136,8 +362,7 @@ struct QuicStreamLike {
   // are currently un-acked. Each one represents one StreamFrame that was
   // written. We need to buffer these because these might be retransmitted in
   // the future. These are associated with the starting offset of the buffer.
-  folly::F14FastMap<uint64_t, std::unique_ptr<WriteStreamBuffer>>
-      retransmissionBuffer;
+  RetransmissionBuffer retransmissionBuffer;
 
   // Tracks intervals which we have received ACKs for. E.g. in the case of all
   // data being acked this would contain one internval from 0 -> the largest
@@ -230,24 +455,28 @@ struct QuicStreamLike {
    * Either insert a new entry into the loss buffer, or merge the buffer with
    * an existing entry.
    */
-  void insertIntoLossBuffer(std::unique_ptr<WriteStreamBuffer> buf) {
+  void insertIntoLossBuffer(WriteStreamBuffer&& buf) {
     // We assume here that we won't try to insert an overlapping buffer, as
     // that should never happen in the loss buffer.
     auto lossItr = std::upper_bound(
         lossBuffer.begin(),
         lossBuffer.end(),
-        buf->offset,
+        buf.offset,
         [](auto offset, const auto& buffer) { return offset < buffer.offset; });
     if (!lossBuffer.empty() && lossItr != lossBuffer.begin() &&
         std::prev(lossItr)->offset + std::prev(lossItr)->data.chainLength() ==
-            buf->offset) {
-      std::prev(lossItr)->data.append(std::move(buf->data));
-      std::prev(lossItr)->eof = buf->eof;
+            buf.offset) {
+      std::prev(lossItr)->data.append(std::move(buf.data));
+      std::prev(lossItr)->eof = buf.eof;
     } else {
-      lossBuffer.emplace(lossItr, std::move(*buf));
+      lossBuffer.emplace(lossItr, std::move(buf));
     }
   }
 
+  void insertIntoLossBuffer(std::unique_ptr<WriteStreamBuffer> buf) {
+    insertIntoLossBuffer(std::move(*buf));
+  }
+
   void removeFromLossBuffer(uint64_t offset, size_t len, bool eof) {
     if (lossBuffer.empty() || len == 0) {
       // Nothing to do.
@@ -286,8 +515,8 @@ struct QuicStreamLike {
           lossBuffer.erase(lossItr);
         }
         if (!splitBuf.empty()) {
-          insertIntoLossBuffer(std::make_unique<WriteStreamBuffer>(
-              std::move(splitBuf), lossStartOffset, false));
+          insertIntoLossBuffer(
+              WriteStreamBuffer(std::move(splitBuf), lossStartOffset, false));
         }
         return;
       }
@@ -312,19 +541,7 @@ struct QuicStreamLike {
   }
 
   void removeFromRetransmissionBufStartingAtOffset(uint64_t startingOffset) {
-    folly::F14FastSet<uint64_t> offsetsToRemove;
-
-    for (auto& [offset, buf] : retransmissionBuffer) {
-      if (offset >= startingOffset) {
-        offsetsToRemove.insert(offset);
-      } else if (offset + buf->data.chainLength() >= startingOffset) {
-        buf->data = buf->data.splitAtMost(size_t(startingOffset - offset));
-      }
-    }
-
-    for (auto offset : offsetsToRemove) {
-      retransmissionBuffer.erase(offset);
-    }
+    retransmissionBuffer.eraseFrom(startingOffset);
   }
 
   void removeFromWriteBufStartingAtOffset(uint64_t startingOffset) {
@@ -365,6 +582,28 @@ struct QuicStreamLike {
     return ackedIntervals.front().start == 0 &&
         ackedIntervals.front().end >= offset;
   }
+
+  /*
+   * Frees the storage of the buffers that are empty, e.g. when the connection
+   * goes idle.
+   */
+  void shrinkToFit() {
+    if (readBuffer.empty()) {
+      readBuffer.shrink_to_fit();
+    }
+    if (lossBuffer.empty()) {
+      lossBuffer.shrink_to_fit();
+    }
+    retransmissionBuffer.shrinkToFit();
+  }
+
+  // The heap bytes held by the containers of the buffers, not counting the
+  // data in them.
+  [[nodiscard]] size_t allocatedBytes() const {
+    return readBuffer.allocatedBytes() +
+        lossBuffer.max_size() * sizeof(WriteStreamBuffer) +
+        retransmissionBuffer.allocatedBytes();
+  }
 };
 
 struct QuicConnectionStateBase;
@@ -207,6 +207,12 @@ struct TransportSettings {
   // than kDefaultPacingTickInterval.
   std::chrono::microseconds pacingTimerResolution{
       kDefaultPacingTimerResolution};
+  // Whether paced writes stamp each GSO batch with an SO_TXTIME departure time
+  // and write txTimePacingHorizon worth of bursts at once, leaving the pacing
+  // within that window to the fq qdisc. Only used with GSO batching, and when
+  // the socket accepts SO_TXTIME.
+  bool txTimePacing{false};
+  std::chrono::microseconds txTimePacingHorizon{kDefaultTxTimePacingHorizon};
   ZeroRttSourceTokenMatchingPolicy zeroRttSourceTokenMatchingPolicy{
       ZeroRttSourceTokenMatchingPolicy::REJECT_IF_NO_EXACT_MATCH};
   // Scale pacing rate for CC, non-empty indicates override via transport knobs
@@ -288,6 +294,12 @@ struct TransportSettings {
   // A temporary type to control DataPath write style. Will be gone after we
   // are done with experiment.
   DataPathType dataPathType{DataPathType::ChainedMemory};
+  // Send with MSG_ZEROCOPY from the ContinuousMemory data path's GSO batch
+  // writers. Each write pins its output buffer until the kernel reports
+  // completion, and zeroCopyWriteBuffers spare buffers let writing continue in
+  // the meantime. Writes are copied as usual when no spare buffer is free.
+  bool enableZeroCopyWrites{false};
+  uint32_t zeroCopyWriteBuffers{kDefaultZeroCopyWriteBuffers};
   // Whether or not we should stop writing a packet after writing a single
   // stream frame to it.
   bool streamFramePerPacket{false};
@@ -331,6 +343,9 @@ struct TransportSettings {
   std::string flowPriming = "";
   // Whether or not to enable WritableBytes limit (server only)
   bool enableWritableBytesLimit{false};
+  // Whether the connection keeps its record in the worker's
+  // ConnectionStatsTable up to date (server only)
+  bool publishConnectionStats{false};
   // Whether or not to remove data from the loss buffer on spurious loss.
   bool removeFromLossBufferOnSpurious{false};
   // If set to true, the users won't get new stream notification until an
@@ -464,6 +479,23 @@ struct TransportSettings {
   // server side.
   uint16_t maxServerRecvPacketsPerLoop{1};
 
+  // Whether the server worker hands all the packets it receives for a
+  // connection in one evb loop to the transport as a single batch, so acks,
+  // loss detection and writes are handled once per batch instead of once per
+  // packet.
+  bool batchServerRecvPacketsPerLoop{false};
+
+  // Whether the server worker allocates the state, stream manager, crypto
+  // state, congestion controller and pacer of its connections from a
+  // SlabAllocator of its own, so that accepting and closing connections
+  // recycles their memory instead of going to malloc.
+  bool useConnectionSlabAllocator{false};
+
+  // After the connection has neither sent nor received a packet for this long,
+  // free its empty containers and its congestion controller until its next
+  // packet. Zero disables compaction.
+  std::chrono::milliseconds compactIdleConnectionAfter{0};
+
   // Support "paused" requests which buffer on the server without streaming back
   // to the client.
   bool disablePausedPriority{false};
@@ -38,9 +38,7 @@ TEST_F(StreamStateFunctionsTests, BasicResetTest) {
 
   std::string retxBufData = "How would I know?";
   Buf retxBuf = folly::IOBuf::copyBuffer(retxBufData);
-  stream.retransmissionBuffer.emplace(
-      34,
-      std::make_unique<WriteStreamBuffer>(ChainedByteRangeHead(retxBuf), 34));
+  stream.retransmissionBuffer.emplace(ChainedByteRangeHead(retxBuf), 34);
   auto currentWriteOffset = stream.currentWriteOffset;
   auto currentReadOffset = stream.currentReadOffset;
   EXPECT_TRUE(stream.writable());
@@ -74,9 +72,7 @@ TEST_F(StreamStateFunctionsTests, BasicReliableResetTest) {
 
   std::string retxBufData = "How would I know?";
   Buf retxBuf = folly::IOBuf::copyBuffer(retxBufData);
-  stream.retransmissionBuffer.emplace(
-      34,
-      std::make_unique<WriteStreamBuffer>(ChainedByteRangeHead(retxBuf), 34));
+  stream.retransmissionBuffer.emplace(ChainedByteRangeHead(retxBuf), 34);
   auto currentWriteOffset = stream.currentWriteOffset;
   auto currentReadOffset = stream.currentReadOffset;
   EXPECT_TRUE(stream.writable());
@@ -436,11 +436,7 @@ TEST_F(QuicResetSentStateTest, ResetSentToClosedTransition3) {
   WriteStreamFrame streamFrame(id, 0, 7, false);
   auto buf = folly::IOBuf::create(7);
   buf->append(7);
-  stream.retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(0),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(buf), 0, false)));
+  stream.retransmissionBuffer.emplace(ChainedByteRangeHead(buf), 0, false);
   sendAckSMHandler(stream, streamFrame);
   EXPECT_EQ(stream.sendState, StreamSendState::Closed);
 }
@@ -457,11 +453,7 @@ TEST_F(QuicResetSentStateTest, ResetSentToClosedTransition4) {
   WriteStreamFrame streamFrame(id, 0, 7, false);
   auto buf = folly::IOBuf::create(7);
   buf->append(7);
-  stream.retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(0),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(buf), 0, false)));
+  stream.retransmissionBuffer.emplace(ChainedByteRangeHead(buf), 0, false);
   sendAckSMHandler(stream, streamFrame);
   EXPECT_EQ(stream.sendState, StreamSendState::ResetSent);
 }
@@ -1010,11 +1002,7 @@ TEST_F(QuicUnidirectionalStreamTest, OpenFinalAckStreamFrame) {
   stream.currentWriteOffset = 2;
   auto buf = folly::IOBuf::create(1);
   buf->append(1);
-  stream.retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(1),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(buf), 1, false)));
+  stream.retransmissionBuffer.emplace(ChainedByteRangeHead(buf), 1, false);
   sendAckSMHandler(stream, streamFrame);
   EXPECT_EQ(stream.sendState, StreamSendState::Closed);
   EXPECT_EQ(stream.recvState, StreamRecvState::Invalid);
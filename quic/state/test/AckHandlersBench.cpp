@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/Benchmark.h>
+#include <quic/common/test/TestUtils.h>
+#include <quic/fizz/server/handshake/FizzServerQuicHandshakeContext.h>
+#include <quic/server/state/ServerStateMachine.h>
+#include <quic/state/AckHandlers.h>
+
+using namespace quic;
+using namespace quic::test;
+
+namespace {
+
+constexpr PacketNum kPacketsAckedPerIteration = 64;
+
+/**
+ * Keeps a connection with a steady number of outstanding AppData packets. Each
+ * ACK removes the oldest packets, which are then replaced with newly sent ones
+ * so that every iteration sees the same amount of outstanding state.
+ */
+class OutstandingPacketsFixture {
+ public:
+  explicit OutstandingPacketsFixture(size_t numOutstanding)
+      : conn_(FizzServerQuicHandshakeContext::Builder().build()),
+        startTime_(Clock::now()) {
+    conn_.congestionController = nullptr;
+    for (size_t i = 0; i < numOutstanding; i++) {
+      sendPacket();
+    }
+  }
+
+  void sendPacket() {
+    auto packetNum = nextPacketNum_++;
+    auto regularPacket = createNewPacket(packetNum, PacketNumberSpace::AppData);
+    regularPacket.frames.emplace_back(WriteStreamFrame(0, packetNum, 1, false));
+    conn_.outstandings.packetCount[PacketNumberSpace::AppData]++;
+    conn_.outstandings.packets.emplace_back(
+        std::move(regularPacket),
+        startTime_ + std::chrono::microseconds(packetNum),
+        1,
+        0,
+        packetNum,
+        packetNum + 1,
+        LossState(),
+        0,
+        OutstandingPacketMetadata::DetailsPerStream());
+  }
+
+  // ACK the oldest kPacketsAckedPerIteration packets using numAckBlocks
+  // adjacent blocks, then send the same number of new packets.
+  void ackOldest(size_t numAckBlocks, folly::BenchmarkSuspender& suspender) {
+    ReadAckFrame ackFrame;
+    auto firstPacketNum = conn_.outstandings.packets.front().packet.header
+                              .getPacketSequenceNum();
+    auto blockSize = kPacketsAckedPerIteration / numAckBlocks;
+    ackFrame.largestAcked = firstPacketNum + kPacketsAckedPerIteration - 1;
+    for (PacketNum end = ackFrame.largestAcked + 1; end > firstPacketNum;
+         end -= blockSize) {
+      ackFrame.ackBlocks.emplace_back(end - blockSize, end - 1);
+    }
+    suspender.dismiss();
+    processAckFrame(
+        conn_,
+        PacketNumberSpace::AppData,
+        ackFrame,
+        [](const auto&) {},
+        [](const auto&, const auto&) {},
+        [](auto&, auto&, bool) {},
+        startTime_ + std::chrono::microseconds(nextPacketNum_));
+    suspender.rehire();
+    for (PacketNum i = 0; i < kPacketsAckedPerIteration; i++) {
+      sendPacket();
+    }
+  }
+
+ private:
+  QuicServerConnectionState conn_;
+  TimePoint startTime_;
+  PacketNum nextPacketNum_{0};
+};
+
+void processAckFrameBench(
+    uint32_t iters,
+    size_t numOutstanding,
+    size_t numAckBlocks) {
+  folly::BenchmarkSuspender suspender;
+  OutstandingPacketsFixture fixture(numOutstanding);
+  while (iters--) {
+    fixture.ackOldest(numAckBlocks, suspender);
+  }
+}
+
+} // namespace
+
+BENCHMARK_NAMED_PARAM(processAckFrameBench, 1k_1block, 1000, 1)
+BENCHMARK_NAMED_PARAM(processAckFrameBench, 1k_16blocks, 1000, 16)
+BENCHMARK_NAMED_PARAM(processAckFrameBench, 10k_1block, 10000, 1)
+BENCHMARK_NAMED_PARAM(processAckFrameBench, 10k_16blocks, 10000, 16)
+BENCHMARK_NAMED_PARAM(processAckFrameBench, 100k_1block, 100000, 1)
+BENCHMARK_NAMED_PARAM(processAckFrameBench, 100k_16blocks, 100000, 16)
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -395,4 +395,41 @@ TEST_F(AckedPacketIteratorTest, ErasureTwoOpIntervals) {
   EXPECT_THAT(expectedOutstandings, ContainerEq(getOutstandings()));
 }
 
+// Outstanding packets: [5000, 7099], stored across the wrap point of the ring
+// Acked blocks: every odd packet in [6000, 7099], plus [5000, 5999]
+TEST_F(AckedPacketIteratorTest, ErasureManyBlocksWrappedOutstandings) {
+  std::vector<PacketNumAndSpace> packets;
+  for (size_t i = 0; i < 5100; i++) {
+    packets.emplace_back(i, PacketNumberSpace::AppData);
+  }
+  addPackets(packets);
+  // Free up the front of the ring storage so that the following appends wrap
+  // around instead of growing the container.
+  for (size_t i = 0; i < 5000; i++) {
+    conn_.outstandings.packets.pop_front();
+    conn_.outstandings.packetCount[PacketNumberSpace::AppData]--;
+  }
+  packets.clear();
+  for (size_t i = 5100; i < 7100; i++) {
+    packets.emplace_back(i, PacketNumberSpace::AppData);
+  }
+  addPackets(packets);
+
+  quic::ReadAckFrame::Vec ackBlocks;
+  for (PacketNum i = 7099; i > 6000; i -= 2) {
+    ackBlocks.emplace_back(i, i);
+  }
+  ackBlocks.emplace_back(5000, 5999);
+  markPacketsScheduledForDestruction(ackBlocks, PacketNumberSpace::AppData);
+  initializeAckedPacketIterator(ackBlocks, PacketNumberSpace::AppData);
+  ackedPacketIterator_->eraseAckedOutstandings();
+
+  std::vector<PacketNumAndSpace> expectedOutstandings;
+  for (size_t i = 6000; i < 7100; i += 2) {
+    expectedOutstandings.emplace_back(i, PacketNumberSpace::AppData);
+  }
+  EXPECT_THAT(expectedOutstandings, ContainerEq(getOutstandings()));
+  EXPECT_EQ(0, conn_.outstandings.scheduledForDestructionCount);
+}
+
 } // namespace quic::test
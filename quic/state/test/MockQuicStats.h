@@ -31,6 +31,8 @@ class MockQuicStats : public QuicTransportStatsCallback {
   MOCK_METHOD(void, onPacketForwarded, ());
   MOCK_METHOD(void, onForwardedPacketReceived, ());
   MOCK_METHOD(void, onForwardedPacketProcessed, ());
+  MOCK_METHOD(void, onPacketRoutedToOtherWorker, ());
+  MOCK_METHOD(void, onWorkerPacketRingDrained, (size_t));
   MOCK_METHOD(void, onClientInitialReceived, (QuicVersion));
   MOCK_METHOD(void, onConnectionRateLimited, ());
   MOCK_METHOD(void, onConnectionWritableBytesLimited, ());
@@ -73,6 +75,7 @@ class MockQuicStats : public QuicTransportStatsCallback {
   MOCK_METHOD(void, onTokenDecryptFailure, ());
   MOCK_METHOD(void, onShortHeaderPadding, (size_t));
   MOCK_METHOD(void, onPacerTimerLagged, ());
+  MOCK_METHOD(void, onPacerTimerFired, ());
   MOCK_METHOD(void, onPeerMaxUniStreamsLimitSaturated, ());
   MOCK_METHOD(void, onPeerMaxBidiStreamsLimitSaturated, ());
   MOCK_METHOD(void, onConnectionIdCreated, (size_t));
@@ -92,7 +92,13 @@ class MockPacer : public Pacer {
       (TimePoint),
       (const));
   MOCK_METHOD(uint64_t, updateAndGetWriteBatchSize, (TimePoint));
+  MOCK_METHOD(
+      TxTimeSchedule,
+      updateAndGetTxTimeSchedule,
+      (TimePoint, std::chrono::microseconds));
+  MOCK_METHOD(void, onTxTimeScheduleWritten, (const TxTimeSchedule&));
   MOCK_METHOD(uint64_t, getCachedWriteBatchSize, (), (const));
+  MOCK_METHOD(uint64_t, getPacingRateBytesPerSec, (), (const));
   MOCK_METHOD(void, setAppLimited, (bool));
   MOCK_METHOD(void, onPacketSent, ());
   MOCK_METHOD(void, onPacketsLoss, ());
@@ -1304,6 +1304,43 @@ TEST_P(QuicStateFunctionsTest, CloseTranportStateChange) {
   EXPECT_TRUE(conn.pendingEvents.closeTransport);
 }
 
+TEST_F(QuicStateFunctionsTest, CompactIdleConnection) {
+  QuicServerConnectionState conn(
+      FizzServerQuicHandshakeContext::Builder().build());
+  auto congestionController =
+      std::make_unique<NiceMock<MockCongestionController>>();
+  ON_CALL(*congestionController, type())
+      .WillByDefault(Return(CongestionControlType::Cubic));
+  ON_CALL(*congestionController, getCongestionWindow())
+      .WillByDefault(Return(12345));
+  conn.congestionController = std::move(congestionController);
+  conn.outstandings.packets.resize(64);
+  conn.lastProcessedAckEvents.reserve(16);
+  conn.pendingEvents.frames.reserve(16);
+  conn.pendingEvents.frames.emplace_back(HandshakeDoneFrame());
+  conn.streamManager->setMaxLocalBidirectionalStreams(
+      kDefaultMaxStreamsBidirectional);
+  auto stream = conn.streamManager->createNextBidirectionalStream().value();
+  stream->lossBuffer.resize(16);
+
+  auto bytesBefore = connectionAllocatedBytes(conn);
+  compactIdleConnection(conn);
+  EXPECT_EQ(conn.congestionController, nullptr);
+  ASSERT_TRUE(conn.compactedCongestionState.has_value());
+  EXPECT_EQ(conn.compactedCongestionState->type, CongestionControlType::Cubic);
+  EXPECT_EQ(conn.compactedCongestionState->congestionWindowBytes, 12345);
+  EXPECT_EQ(conn.outstandings.packets.max_size(), 0);
+  EXPECT_EQ(conn.lastProcessedAckEvents.capacity(), 0);
+  EXPECT_EQ(stream->lossBuffer.max_size(), 0);
+  // Containers that are in use are left alone.
+  EXPECT_EQ(conn.pendingEvents.frames.size(), 1);
+  EXPECT_GE(conn.pendingEvents.frames.capacity(), 16);
+
+  EXPECT_EQ(conn.bytesBeforeCompaction, bytesBefore);
+  EXPECT_EQ(conn.bytesAfterCompaction, connectionAllocatedBytes(conn));
+  EXPECT_LT(conn.bytesAfterCompaction, conn.bytesBeforeCompaction);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     QuicStateFunctionsTests,
     QuicStateFunctionsTest,
@@ -17,6 +17,8 @@
 #include <quic/fizz/server/handshake/FizzServerQuicHandshakeContext.h>
 #include <quic/server/state/ServerStateMachine.h>
 
+#include <random>
+
 using namespace folly;
 using namespace testing;
 
@@ -25,7 +27,7 @@ namespace test {
 
 constexpr uint8_t kStreamIncrement = 0x04;
 
-using PeekIterator = CircularDeque<StreamBuffer>::const_iterator;
+using PeekIterator = ChunkedDeque<StreamBuffer>::const_iterator;
 
 class QuicStreamFunctionsTest : public Test {
  public:
@@ -700,6 +702,46 @@ TEST_P(QuicStreamFunctionsTestBase, TestInsertVariations) {
   EXPECT_TRUE(stream->readBuffer.empty());
 }
 
+TEST_P(QuicStreamFunctionsTestBase, TestReadDataHeavilyReordered) {
+  auto stream = conn.streamManager->createNextBidirectionalStream().value();
+  std::string data;
+  for (size_t i = 0; i < 5000; i++) {
+    data.push_back(static_cast<char>(i * 7 % 251));
+  }
+  auto segment = [&](size_t offset, size_t len) {
+    return StreamBuffer(
+        IOBuf::copyBuffer(data.substr(offset, len)),
+        offset,
+        offset + len == data.size());
+  };
+  // Every other segment first, leaving holes all over the buffer, then the
+  // holes and overlapping retransmissions in random order.
+  constexpr size_t kSegmentLen = 10;
+  std::vector<std::pair<size_t, size_t>> segments;
+  for (size_t offset = 0; offset < data.size(); offset += kSegmentLen) {
+    if ((offset / kSegmentLen) % 2) {
+      appendDataToReadBuffer(*stream, segment(offset, kSegmentLen));
+    } else {
+      segments.emplace_back(offset, kSegmentLen);
+    }
+  }
+  EXPECT_EQ(data.size() / kSegmentLen / 2, stream->readBuffer.size());
+  std::mt19937 rng(0);
+  for (size_t i = 0; i < 100; i++) {
+    segments.emplace_back(rng() % (data.size() - 50), 1 + rng() % 50);
+  }
+  std::shuffle(segments.begin(), segments.end(), rng);
+  for (const auto& [offset, len] : segments) {
+    appendDataToReadBuffer(*stream, segment(offset, len));
+  }
+  EXPECT_EQ(1, stream->readBuffer.size());
+
+  auto readData = readDataFromQuicStream(*stream, 0);
+  EXPECT_EQ(data, readData.first->to<std::string>());
+  EXPECT_TRUE(readData.second);
+  EXPECT_TRUE(stream->readBuffer.empty());
+}
+
 TEST_P(QuicStreamFunctionsTestBase, TestAppendAlreadyReadData) {
   auto stream = conn.streamManager->createNextBidirectionalStream().value();
   auto buf1 = IOBuf::copyBuffer("I just met you and this is crazy");
@@ -2082,9 +2124,7 @@ TEST_P(QuicStreamFunctionsTestBase, AllBytesTillFinAckedStillRetransmitting) {
 
   auto retxBufData = IOBuf::create(10);
   stream.retransmissionBuffer.emplace(
-      0,
-      std::make_unique<WriteStreamBuffer>(
-          ChainedByteRangeHead(retxBufData), 10, false));
+      ChainedByteRangeHead(retxBufData), 10, false);
   EXPECT_FALSE(allBytesTillFinAcked(stream));
 }
 
@@ -2402,7 +2442,7 @@ TEST_P(QuicStreamFunctionsTestBase, WritableList) {
 TEST_P(QuicStreamFunctionsTestBase, AckCryptoStream) {
   auto chlo = IOBuf::copyBuffer("CHLO");
   conn.cryptoState->handshakeStream.retransmissionBuffer.emplace(
-      0, std::make_unique<WriteStreamBuffer>(ChainedByteRangeHead(chlo), 0));
+      ChainedByteRangeHead(chlo), 0);
   processCryptoStreamAck(conn.cryptoState->handshakeStream, 0, chlo->length());
   EXPECT_EQ(conn.cryptoState->handshakeStream.retransmissionBuffer.size(), 0);
 }
@@ -2410,8 +2450,7 @@ TEST_P(QuicStreamFunctionsTestBase, AckCryptoStream) {
 TEST_P(QuicStreamFunctionsTestBase, AckCryptoStreamOffsetLengthMismatch) {
   auto chlo = IOBuf::copyBuffer("CHLO");
   auto& cryptoStream = conn.cryptoState->handshakeStream;
-  cryptoStream.retransmissionBuffer.emplace(
-      0, std::make_unique<WriteStreamBuffer>(ChainedByteRangeHead(chlo), 0));
+  cryptoStream.retransmissionBuffer.emplace(ChainedByteRangeHead(chlo), 0);
   processCryptoStreamAck(cryptoStream, 1, chlo->length());
   EXPECT_EQ(cryptoStream.retransmissionBuffer.size(), 1);
 
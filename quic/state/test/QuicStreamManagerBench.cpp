@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <quic/fizz/server/handshake/FizzServerQuicHandshakeContext.h>
+#include <quic/server/state/ServerStateMachine.h>
+#include <quic/state/QuicStreamManager.h>
+
+#include <algorithm>
+#include <deque>
+
+using namespace quic;
+
+namespace {
+
+constexpr size_t kNumStreams = 10000;
+
+/**
+ * A server connection with kNumStreams open local bidirectional streams.
+ */
+class StreamsFixture {
+ public:
+  StreamsFixture() : conn_(FizzServerQuicHandshakeContext::Builder().build()) {
+    conn_.congestionController = nullptr;
+    conn_.streamManager->setMaxLocalBidirectionalStreams(kMaxMaxStreams);
+    for (size_t i = 0; i < kNumStreams; i++) {
+      ids_.push_back(openStream());
+    }
+  }
+
+  StreamId openStream() {
+    return CHECK_NOTNULL(
+               conn_.streamManager->createNextBidirectionalStream().value())
+        ->id;
+  }
+
+  void closeStream(StreamId id) {
+    auto stream = conn_.streamManager->findStream(id);
+    stream->sendState = StreamSendState::Closed;
+    stream->recvState = StreamRecvState::Closed;
+    conn_.streamManager->removeClosedStream(id);
+  }
+
+  QuicStreamManager& manager() {
+    return *conn_.streamManager;
+  }
+
+  std::vector<StreamId>& ids() {
+    return ids_;
+  }
+
+ private:
+  QuicServerConnectionState conn_;
+  std::vector<StreamId> ids_;
+};
+
+} // namespace
+
+// Looks up every stream in a random order.
+BENCHMARK(FindStream10k, iters) {
+  folly::BenchmarkSuspender suspender;
+  StreamsFixture fixture;
+  auto ids = fixture.ids();
+  std::shuffle(ids.begin(), ids.end(), folly::ThreadLocalPRNG());
+  suspender.dismiss();
+  while (iters--) {
+    for (auto id : ids) {
+      folly::doNotOptimizeAway(fixture.manager().findStream(id));
+    }
+  }
+}
+
+// The per-stream set updates of a write loop: every stream is marked as having
+// transmitted and delivered data and as needing a window update, then the
+// transport consumes the sets and re-evaluates each stream's writability.
+BENCHMARK(UpdateStreamSets10k, iters) {
+  folly::BenchmarkSuspender suspender;
+  StreamsFixture fixture;
+  auto& manager = fixture.manager();
+  suspender.dismiss();
+  while (iters--) {
+    for (auto id : fixture.ids()) {
+      manager.addTx(id);
+      manager.addDeliverable(id);
+      manager.queueWindowUpdate(id);
+    }
+    while (auto id = manager.popTx()) {
+      folly::doNotOptimizeAway(manager.deliverableContains(*id));
+    }
+    while (auto id = manager.popDeliverable()) {
+      manager.removeWindowUpdate(*id);
+      manager.updateWritableStreams(*manager.findStream(*id));
+    }
+  }
+}
+
+// Replaces the oldest stream with a new one, keeping 10k streams open.
+BENCHMARK(OpenCloseStream10k, iters) {
+  folly::BenchmarkSuspender suspender;
+  StreamsFixture fixture;
+  std::deque<StreamId> open(fixture.ids().begin(), fixture.ids().end());
+  suspender.dismiss();
+  while (iters--) {
+    fixture.closeStream(open.front());
+    open.pop_front();
+    open.push_back(fixture.openStream());
+  }
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
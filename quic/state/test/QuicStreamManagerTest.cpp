@@ -783,10 +783,7 @@ TEST_P(QuicStreamManagerTest, TestReliableResetBasic) {
   ChainedByteRangeHead bufWritten1(
       quicStreamState->pendingWrites.splitAtMost(folly::to<size_t>(4)));
   quicStreamState->retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(5),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          std::move(bufWritten1), 5, false)));
+      std::move(bufWritten1), 5, false);
   updateFlowControlOnWriteToSocket(*quicStreamState, 4);
 
   // A frame of length 2 has been written to the wire
@@ -794,15 +791,12 @@ TEST_P(QuicStreamManagerTest, TestReliableResetBasic) {
   ChainedByteRangeHead bufWritten2(
       quicStreamState->pendingWrites.splitAtMost(folly::to<size_t>(2)));
   quicStreamState->retransmissionBuffer.emplace(
-      std::piecewise_construct,
-      std::forward_as_tuple(9),
-      std::forward_as_tuple(std::make_unique<WriteStreamBuffer>(
-          std::move(bufWritten2), 9, false)));
+      std::move(bufWritten2), 9, false);
   updateFlowControlOnWriteToSocket(*quicStreamState, 2);
 
   // The frame of length 4 has been lost
   auto bufferItr = quicStreamState->retransmissionBuffer.find(5);
-  quicStreamState->insertIntoLossBuffer(std::move(bufferItr->second));
+  quicStreamState->insertIntoLossBuffer(std::move(*bufferItr->second));
   quicStreamState->retransmissionBuffer.erase(bufferItr);
 
   // We send a reliable reset with a reliable size of 7
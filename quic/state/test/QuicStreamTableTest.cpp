@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <quic/fizz/server/handshake/FizzServerQuicHandshakeContext.h>
+#include <quic/server/state/ServerStateMachine.h>
+#include <quic/state/QuicStreamTable.h>
+
+#include <algorithm>
+
+using namespace testing;
+
+namespace quic::test {
+
+class QuicStreamTableTest : public Test {
+ public:
+  QuicStreamTableTest()
+      : conn(FizzServerQuicHandshakeContext::Builder().build()) {}
+
+  QuicServerConnectionState conn;
+  QuicStreamTable table;
+};
+
+TEST_F(QuicStreamTableTest, EmplaceFindErase) {
+  EXPECT_TRUE(table.empty());
+  EXPECT_EQ(table.find(0), nullptr);
+
+  // One stream of each type.
+  for (StreamId id = 0; id < 4; id++) {
+    auto result = table.emplace(id, id, conn);
+    EXPECT_TRUE(result.second);
+    EXPECT_EQ(result.first->id, id);
+    EXPECT_EQ(table.find(id), result.first);
+  }
+  EXPECT_EQ(table.size(), 4);
+
+  auto existing = table.find(2);
+  auto result = table.emplace(2, 2, conn);
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(result.first, existing);
+
+  table.erase(2);
+  EXPECT_EQ(table.find(2), nullptr);
+  EXPECT_EQ(table.size(), 3);
+  // Erasing a missing stream is a no-op.
+  table.erase(2);
+  table.erase(1000);
+  EXPECT_EQ(table.size(), 3);
+
+  std::vector<StreamId> ids;
+  for (auto state : table) {
+    ids.push_back(state->id);
+  }
+  std::sort(ids.begin(), ids.end());
+  EXPECT_EQ(ids, std::vector<StreamId>({0, 1, 3}));
+
+  table.clear();
+  EXPECT_TRUE(table.empty());
+  EXPECT_EQ(table.find(0), nullptr);
+}
+
+TEST_F(QuicStreamTableTest, StatesDoNotMove) {
+  auto first = table.emplace(0, 0, conn).first;
+  // Enough streams to allocate many pages and slab chunks.
+  for (StreamId id = 4; id < 4 * 1000; id += 4) {
+    table.emplace(id, id, conn);
+  }
+  EXPECT_EQ(table.find(0), first);
+  EXPECT_EQ(table.size(), 1000);
+
+  // Streams below the first one extend the directory downwards.
+  StreamId high = 4 * 5000;
+  table.emplace(high, high, conn);
+  for (StreamId id = 4; id < 4 * 1000; id += 4) {
+    table.erase(id);
+  }
+  EXPECT_EQ(table.find(0), first);
+  EXPECT_EQ(table.find(high)->id, high);
+  EXPECT_EQ(table.size(), 2);
+}
+
+TEST_F(QuicStreamTableTest, SetMembership) {
+  auto& readable = table.set(StreamSetKind::Readable);
+  auto& closed = table.set(StreamSetKind::Closed);
+  table.emplace(0, 0, conn);
+
+  EXPECT_TRUE(readable.insert(0));
+  EXPECT_FALSE(readable.insert(0));
+  // Ids without state can be members too.
+  EXPECT_TRUE(readable.insert(400));
+  EXPECT_TRUE(readable.contains(0));
+  EXPECT_EQ(readable.count(400), 1);
+  EXPECT_FALSE(readable.contains(4));
+  EXPECT_FALSE(closed.contains(0));
+  EXPECT_EQ(readable.size(), 2);
+
+  EXPECT_EQ(readable.erase(0), 1);
+  EXPECT_EQ(readable.erase(0), 0);
+  EXPECT_FALSE(readable.contains(0));
+  EXPECT_TRUE(readable.contains(400));
+
+  // Membership outlives the stream state.
+  closed.insert(0);
+  table.erase(0);
+  EXPECT_TRUE(closed.contains(0));
+  EXPECT_EQ(table.find(0), nullptr);
+
+  readable.clear();
+  EXPECT_TRUE(readable.empty());
+  EXPECT_FALSE(readable.contains(400));
+  EXPECT_TRUE(closed.contains(0));
+}
+
+TEST_F(QuicStreamTableTest, EraseWhileIterating) {
+  auto& tx = table.set(StreamSetKind::Tx);
+  for (StreamId id = 0; id < 4 * 100; id += 4) {
+    table.emplace(id, id, conn);
+    tx.insert(id);
+  }
+  std::vector<StreamId> visited;
+  auto it = tx.begin();
+  while (it != tx.end()) {
+    visited.push_back(*it);
+    it = tx.erase(it);
+  }
+  EXPECT_TRUE(tx.empty());
+  std::sort(visited.begin(), visited.end());
+  ASSERT_EQ(visited.size(), 100);
+  for (size_t i = 0; i < visited.size(); i++) {
+    EXPECT_EQ(visited[i], 4 * i);
+    EXPECT_FALSE(tx.contains(4 * i));
+    EXPECT_NE(table.find(4 * i), nullptr);
+  }
+}
+
+TEST_F(QuicStreamTableTest, ShrinkToFit) {
+  // Three slab chunks, of which only the first stays in use.
+  auto numStreams = 3 * QuicStreamTable::kSlabChunkSize;
+  for (StreamId id = 0; id < 4 * numStreams; id += 4) {
+    table.emplace(id, id, conn);
+  }
+  auto bytesInUse = table.allocatedBytes();
+  for (StreamId id = 4; id < 4 * numStreams; id += 4) {
+    table.erase(id);
+  }
+  auto kept = table.find(0);
+  ASSERT_NE(kept, nullptr);
+
+  table.shrinkToFit();
+  EXPECT_LT(table.allocatedBytes(), bytesInUse / 2);
+  EXPECT_EQ(table.find(0), kept);
+  EXPECT_EQ(table.size(), 1);
+
+  // The freed chunks are allocated again on demand.
+  for (StreamId id = 4; id < 4 * numStreams; id += 4) {
+    EXPECT_TRUE(table.emplace(id, id, conn).second);
+  }
+  EXPECT_EQ(table.size(), numStreams);
+}
+
+} // namespace quic::test
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/Benchmark.h>
+#include <gflags/gflags.h>
+#include <quic/state/QuicStreamFunctions.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+/**
+ * Reassembles a stream received over a path that reorders and loses frames:
+ * each frame arrives up to a reorder depth of frames late, and a lost frame
+ * is retransmitted about an RTT's worth of frames later, so the read buffer
+ * holds a hole per lost frame in flight. The reader drains whatever is
+ * contiguous after every frame. One iteration receives one 1200 byte frame.
+ */
+
+using namespace quic;
+
+namespace {
+
+constexpr uint64_t kFrameLen = 1200;
+constexpr size_t kRetransmitDelay = 1000;
+
+std::vector<uint64_t> arrivalOrder(
+    size_t numFrames,
+    size_t reorderDepth,
+    size_t lossPerMille) {
+  std::mt19937 rng(0);
+  // The slot each frame arrives in, and its offset.
+  std::vector<std::pair<size_t, uint64_t>> arrivals;
+  arrivals.reserve(numFrames);
+  for (size_t i = 0; i < numFrames; i++) {
+    auto slot = i + rng() % (reorderDepth + 1);
+    if (rng() % 1000 < lossPerMille) {
+      slot += kRetransmitDelay;
+    }
+    arrivals.emplace_back(slot, i * kFrameLen);
+  }
+  std::sort(arrivals.begin(), arrivals.end());
+  std::vector<uint64_t> offsets;
+  offsets.reserve(numFrames);
+  for (const auto& arrival : arrivals) {
+    offsets.push_back(arrival.second);
+  }
+  return offsets;
+}
+
+void reassemblyBench(size_t iters, size_t reorderDepth, size_t lossPerMille) {
+  folly::BenchmarkSuspender suspender;
+  auto data = folly::IOBuf::create(kFrameLen);
+  data->append(kFrameLen);
+  auto offsets = arrivalOrder(iters, reorderDepth, lossPerMille);
+  QuicCryptoStream stream;
+  suspender.dismiss();
+
+  for (auto offset : offsets) {
+    appendDataToReadBuffer(stream, StreamBuffer(data->clone(), offset));
+    folly::doNotOptimizeAway(readDataFromCryptoStream(stream));
+  }
+  CHECK(stream.readBuffer.empty());
+  CHECK_EQ(iters * kFrameLen, stream.currentReadOffset);
+}
+
+} // namespace
+
+BENCHMARK_NAMED_PARAM(reassemblyBench, inOrder, 0, 0)
+BENCHMARK_RELATIVE_NAMED_PARAM(reassemblyBench, reorder32, 32, 0)
+BENCHMARK_RELATIVE_NAMED_PARAM(reassemblyBench, reorder32Loss1pc, 32, 10)
+BENCHMARK_RELATIVE_NAMED_PARAM(reassemblyBench, reorder256Loss5pc, 256, 50)
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -10,6 +10,8 @@
 #include <quic/state/StateData.h>
 #include <quic/state/StreamData.h>
 
+#include <algorithm>
+
 using namespace quic;
 using namespace testing;
 
@@ -112,12 +114,9 @@ TEST(StreamDataTest, RetxBufferRemovalAll) {
   auto buf1 = createBuffer(2);
   auto buf2 = createBuffer(8);
   auto buf3 = createBuffer(3);
-  state.retransmissionBuffer.emplace(
-      1, createWriteStreamBuffer(1, buf1, false));
-  state.retransmissionBuffer.emplace(
-      5, createWriteStreamBuffer(5, buf2, false));
-  state.retransmissionBuffer.emplace(
-      17, createWriteStreamBuffer(17, buf3, false));
+  state.retransmissionBuffer.emplace(ChainedByteRangeHead(buf1), 1, false);
+  state.retransmissionBuffer.emplace(ChainedByteRangeHead(buf2), 5, false);
+  state.retransmissionBuffer.emplace(ChainedByteRangeHead(buf3), 17, false);
 
   state.removeFromRetransmissionBufStartingAtOffset(1);
   EXPECT_EQ(state.retransmissionBuffer.size(), 0);
@@ -129,21 +128,18 @@ TEST(StreamDataTest, RetxBufferRemovalExactMatch) {
   auto buf1 = createBuffer(2);
   auto buf2 = createBuffer(8);
   auto buf3 = createBuffer(3);
-  state.retransmissionBuffer.emplace(
-      1, createWriteStreamBuffer(1, buf1, false));
-  state.retransmissionBuffer.emplace(
-      5, createWriteStreamBuffer(5, buf2, false));
-  state.retransmissionBuffer.emplace(
-      17, createWriteStreamBuffer(17, buf3, false));
+  state.retransmissionBuffer.emplace(ChainedByteRangeHead(buf1), 1, false);
+  state.retransmissionBuffer.emplace(ChainedByteRangeHead(buf2), 5, false);
+  state.retransmissionBuffer.emplace(ChainedByteRangeHead(buf3), 17, false);
 
   state.removeFromRetransmissionBufStartingAtOffset(17);
   EXPECT_EQ(state.retransmissionBuffer.size(), 2);
 
-  EXPECT_EQ(state.retransmissionBuffer[1]->offset, 1);
-  EXPECT_EQ(state.retransmissionBuffer[1]->data.chainLength(), 2);
+  EXPECT_EQ(state.retransmissionBuffer.at(1)->offset, 1);
+  EXPECT_EQ(state.retransmissionBuffer.at(1)->data.chainLength(), 2);
 
-  EXPECT_EQ(state.retransmissionBuffer[5]->offset, 5);
-  EXPECT_EQ(state.retransmissionBuffer[5]->data.chainLength(), 8);
+  EXPECT_EQ(state.retransmissionBuffer.at(5)->offset, 5);
+  EXPECT_EQ(state.retransmissionBuffer.at(5)->data.chainLength(), 8);
 }
 
 TEST(StreamDataTest, RetxBufferRemovalPartialMatch) {
@@ -152,21 +148,18 @@ TEST(StreamDataTest, RetxBufferRemovalPartialMatch) {
   auto buf1 = createBuffer(2);
   auto buf2 = createBuffer(8);
   auto buf3 = createBuffer(3);
-  state.retransmissionBuffer.emplace(
-      1, createWriteStreamBuffer(1, buf1, false));
-  state.retransmissionBuffer.emplace(
-      5, createWriteStreamBuffer(5, buf2, false));
-  state.retransmissionBuffer.emplace(
-      17, createWriteStreamBuffer(17, buf3, false));
+  state.retransmissionBuffer.emplace(ChainedByteRangeHead(buf1), 1, false);
+  state.retransmissionBuffer.emplace(ChainedByteRangeHead(buf2), 5, false);
+  state.retransmissionBuffer.emplace(ChainedByteRangeHead(buf3), 17, false);
 
   state.removeFromRetransmissionBufStartingAtOffset(6);
   EXPECT_EQ(state.retransmissionBuffer.size(), 2);
 
-  EXPECT_EQ(state.retransmissionBuffer[1]->offset, 1);
-  EXPECT_EQ(state.retransmissionBuffer[1]->data.chainLength(), 2);
+  EXPECT_EQ(state.retransmissionBuffer.at(1)->offset, 1);
+  EXPECT_EQ(state.retransmissionBuffer.at(1)->data.chainLength(), 2);
 
-  EXPECT_EQ(state.retransmissionBuffer[5]->offset, 5);
-  EXPECT_EQ(state.retransmissionBuffer[5]->data.chainLength(), 1);
+  EXPECT_EQ(state.retransmissionBuffer.at(5)->offset, 5);
+  EXPECT_EQ(state.retransmissionBuffer.at(5)->data.chainLength(), 1);
 }
 
 TEST(StreamDataTest, RetxBufferRemovalNoMatch) {
@@ -175,24 +168,87 @@ TEST(StreamDataTest, RetxBufferRemovalNoMatch) {
   auto buf1 = createBuffer(2);
   auto buf2 = createBuffer(8);
   auto buf3 = createBuffer(3);
-  state.retransmissionBuffer.emplace(
-      1, createWriteStreamBuffer(1, buf1, false));
-  state.retransmissionBuffer.emplace(
-      5, createWriteStreamBuffer(5, buf2, false));
-  state.retransmissionBuffer.emplace(
-      17, createWriteStreamBuffer(17, buf3, false));
+  state.retransmissionBuffer.emplace(ChainedByteRangeHead(buf1), 1, false);
+  state.retransmissionBuffer.emplace(ChainedByteRangeHead(buf2), 5, false);
+  state.retransmissionBuffer.emplace(ChainedByteRangeHead(buf3), 17, false);
 
   state.removeFromRetransmissionBufStartingAtOffset(20);
   EXPECT_EQ(state.retransmissionBuffer.size(), 3);
 
-  EXPECT_EQ(state.retransmissionBuffer[1]->offset, 1);
-  EXPECT_EQ(state.retransmissionBuffer[1]->data.chainLength(), 2);
-
-  EXPECT_EQ(state.retransmissionBuffer[5]->offset, 5);
-  EXPECT_EQ(state.retransmissionBuffer[5]->data.chainLength(), 8);
-
-  EXPECT_EQ(state.retransmissionBuffer[17]->offset, 17);
-  EXPECT_EQ(state.retransmissionBuffer[17]->data.chainLength(), 3);
+  EXPECT_EQ(state.retransmissionBuffer.at(1)->offset, 1);
+  EXPECT_EQ(state.retransmissionBuffer.at(1)->data.chainLength(), 2);
+
+  EXPECT_EQ(state.retransmissionBuffer.at(5)->offset, 5);
+  EXPECT_EQ(state.retransmissionBuffer.at(5)->data.chainLength(), 8);
+
+  EXPECT_EQ(state.retransmissionBuffer.at(17)->offset, 17);
+  EXPECT_EQ(state.retransmissionBuffer.at(17)->data.chainLength(), 3);
+}
+
+TEST(StreamDataTest, RetxBufferOrderedByOffset) {
+  RetransmissionBuffer retxBuf;
+  auto buf = createBuffer(4);
+  for (uint64_t offset : {8, 0, 16, 4, 12}) {
+    auto result = retxBuf.emplace(ChainedByteRangeHead(buf), offset);
+    EXPECT_TRUE(result.second);
+    EXPECT_EQ(result.first->first, offset);
+    EXPECT_EQ(result.first->second->offset, offset);
+  }
+  auto existing = retxBuf.at(4);
+  auto result = retxBuf.emplace(ChainedByteRangeHead(buf), 4, true);
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(result.first->second, existing);
+  EXPECT_FALSE(existing->eof);
+
+  std::vector<uint64_t> offsets;
+  for (const auto& [offset, writeBuf] : retxBuf) {
+    EXPECT_EQ(offset, writeBuf->offset);
+    offsets.push_back(offset);
+  }
+  EXPECT_EQ(offsets, std::vector<uint64_t>({0, 4, 8, 12, 16}));
+
+  EXPECT_EQ(retxBuf.erase(8), 1);
+  EXPECT_EQ(retxBuf.erase(8), 0);
+  EXPECT_EQ(retxBuf.find(8), retxBuf.end());
+  EXPECT_EQ(retxBuf.count(12), 1);
+  EXPECT_THROW(retxBuf.at(8), std::out_of_range);
+  EXPECT_EQ(retxBuf.size(), 4);
+
+  retxBuf.clear();
+  EXPECT_TRUE(retxBuf.empty());
+  EXPECT_EQ(retxBuf.find(0), retxBuf.end());
+}
+
+TEST(StreamDataTest, RetxBufferReusesNodes) {
+  RetransmissionBuffer retxBuf;
+  auto buf = createBuffer(10);
+  auto first = retxBuf.emplace(ChainedByteRangeHead(buf), 0).first->second;
+  std::vector<WriteStreamBuffer*> nodes;
+  // Enough buffers to allocate several chunks.
+  for (uint64_t offset = 10; offset < 10 * 1000; offset += 10) {
+    nodes.push_back(
+        retxBuf.emplace(ChainedByteRangeHead(buf), offset).first->second);
+  }
+  EXPECT_EQ(retxBuf.at(0), first);
+  EXPECT_EQ(retxBuf.size(), 1000);
+
+  // Ack everything but the first buffer, then send as many again.
+  for (uint64_t offset = 10; offset < 10 * 1000; offset += 10) {
+    retxBuf.erase(retxBuf.find(offset));
+  }
+  std::sort(nodes.begin(), nodes.end());
+  for (uint64_t offset = 10 * 1000; offset < 10 * 1999; offset += 10) {
+    auto node =
+        retxBuf.emplace(ChainedByteRangeHead(buf), offset).first->second;
+    EXPECT_TRUE(std::binary_search(nodes.begin(), nodes.end(), node));
+  }
+  EXPECT_EQ(retxBuf.at(0), first);
+  EXPECT_EQ(retxBuf.size(), 1000);
+
+  RetransmissionBuffer moved(std::move(retxBuf));
+  EXPECT_TRUE(retxBuf.empty());
+  EXPECT_EQ(moved.at(0), first);
+  EXPECT_EQ(moved.size(), 1000);
 }
 
 TEST(StreamDataTest, WriteBufferRemovalAll) {
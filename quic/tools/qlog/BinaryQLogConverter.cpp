@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <glog/logging.h>
+
+#include <folly/init/Init.h>
+#include <folly/portability/GFlags.h>
+
+#include <quic/logging/BinaryQLogReader.h>
+
+/**
+ * Converts a binary qlog file written by BinaryQLogSink into one JSON qlog
+ * file per connection, named after the connection's dcid like the files
+ * FileQLogger writes.
+ */
+
+DEFINE_string(input, "", "Binary qlog file to convert");
+DEFINE_string(output_dir, ".", "Directory to write the JSON qlog files to");
+DEFINE_bool(pretty_json, true, "Pretty print the JSON output");
+
+int main(int argc, char* argv[]) {
+#if FOLLY_HAVE_LIBGFLAGS
+  // Enable glog logging to stderr by default.
+  gflags::SetCommandLineOptionWithMode(
+      "logtostderr", "1", gflags::SET_FLAGS_DEFAULT);
+#endif
+  gflags::ParseCommandLineFlags(&argc, &argv, false);
+  folly::Init init(&argc, &argv);
+
+  if (FLAGS_input.empty()) {
+    LOG(ERROR) << "--input is required";
+    return 1;
+  }
+  std::vector<std::unique_ptr<quic::FileQLogger>> loggers;
+  try {
+    loggers = quic::readBinaryQLog(FLAGS_input);
+  } catch (const std::exception& ex) {
+    LOG(ERROR) << ex.what();
+    return 1;
+  }
+  size_t numWritten = 0;
+  for (auto& logger : loggers) {
+    if (!logger->dcid.has_value() || logger->logs.empty()) {
+      // Nothing to name the file after, or nothing to write.
+      continue;
+    }
+    logger->outputLogsToFile(FLAGS_output_dir, FLAGS_pretty_json);
+    numWritten++;
+  }
+  LOG(INFO) << "Converted " << numWritten << " of " << loggers.size()
+            << " connections";
+  return 0;
+}
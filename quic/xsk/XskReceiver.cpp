@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#if defined(__linux__) && !defined(ANDROID)
+
+#include <folly/String.h>
+#include <quic/xsk/XskReceiver.h>
+#include <quic/xsk/packet_utils.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace facebook::xdpsocket {
+
+XskReceiver::Umem::~Umem() {
+  free_umem(area_, numFrames_, frameSize_);
+}
+
+void XskReceiver::Umem::release() {
+  if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete this;
+  }
+}
+
+void XskReceiver::Umem::releaseFrame(void* buf, void* userData) {
+  auto* umem = static_cast<Umem*>(userData);
+  {
+    std::lock_guard<std::mutex> guard(umem->releasedMutex_);
+    umem->releasedFrames_.push_back(umem->frameIndex(buf));
+  }
+  umem->release();
+}
+
+void XskReceiver::Umem::takeReleasedFrames(std::vector<uint64_t>& frames) {
+  std::lock_guard<std::mutex> guard(releasedMutex_);
+  frames.insert(frames.end(), releasedFrames_.begin(), releasedFrames_.end());
+  releasedFrames_.clear();
+}
+
+XskReceiver::XskReceiver(XskReceiverConfig config)
+    : config_(std::move(config)) {
+  CHECK_GT(config_.numFrames, 0);
+  CHECK_EQ(config_.numFrames & (config_.numFrames - 1), 0)
+      << "The number of frames must be a power of two";
+  CHECK_EQ(config_.frameSize & (config_.frameSize - 1), 0)
+      << "The frame size must be a power of two";
+}
+
+XskReceiver::~XskReceiver() {
+  if (rxMap_) {
+    unmap_rx_ring(rxMap_, &xskOffsets_, config_.numFrames);
+  }
+
+  if (fillMap_) {
+    unmap_fill_ring(fillMap_, &xskOffsets_, config_.numFrames);
+  }
+
+  if (xskMapFd_ >= 0) {
+    close(xskMapFd_);
+  }
+
+  if (xskFd_ >= 0) {
+    close_xsk(xskFd_);
+  }
+
+  // IOBufs that still point into the UMEM keep it mapped.
+  if (umem_) {
+    umem_->release();
+  }
+}
+
+folly::Expected<folly::Unit, std::runtime_error> XskReceiver::init() {
+  auto xdpSocketInitResult = initXdpSocket();
+  if (xdpSocketInitResult.hasError()) {
+    return folly::makeUnexpected(xdpSocketInitResult.error());
+  }
+
+  freeFrames_.reserve(config_.numFrames);
+  for (uint64_t i = config_.numFrames; i > 0; i--) {
+    freeFrames_.push_back(i - 1);
+  }
+  refillFillRing();
+
+  int bind_result = bind_xsk_to_interface(
+      xskFd_,
+      config_.interfaceName.c_str(),
+      config_.queueId,
+      config_.zeroCopyEnabled,
+      config_.useNeedWakeup);
+  if (bind_result < 0) {
+    std::string errorMsg = folly::to<std::string>(
+        "Failed to bind xdp socket: ", folly::errnoStr(errno));
+    return folly::makeUnexpected(std::runtime_error(errorMsg));
+  }
+
+  // The socket has to be bound before it can be added to the XSKMAP.
+  xskMapFd_ = open_pinned_bpf_map(config_.xskMapPath.c_str());
+  if (xskMapFd_ < 0) {
+    std::string errorMsg = folly::to<std::string>(
+        "Failed to open xskmap ",
+        config_.xskMapPath,
+        ": ",
+        folly::errnoStr(errno));
+    return folly::makeUnexpected(std::runtime_error(errorMsg));
+  }
+  if (add_xsk_to_map(xskMapFd_, config_.queueId, xskFd_) < 0) {
+    std::string errorMsg = folly::to<std::string>(
+        "Failed to add xdp socket to xskmap: ", folly::errnoStr(errno));
+    return folly::makeUnexpected(std::runtime_error(errorMsg));
+  }
+
+  return folly::Unit();
+}
+
+folly::Expected<folly::Unit, std::runtime_error>
+XskReceiver::initXdpSocket() {
+  xskFd_ = create_xsk();
+  if (xskFd_ < 0) {
+    return folly::makeUnexpected(
+        std::runtime_error("Failed to create xdp socket"));
+  }
+
+  void* umemArea =
+      create_umem(xskFd_, config_.numFrames, config_.frameSize);
+  if (!umemArea) {
+    return folly::makeUnexpected(std::runtime_error("Failed to create umem"));
+  }
+  umem_ = new Umem(umemArea, config_.numFrames, config_.frameSize);
+
+  // Everything else is cleaned up by the destructor.
+  if (set_fill_ring_size(xskFd_, config_.numFrames) < 0) {
+    return folly::makeUnexpected(
+        std::runtime_error("Failed to set fill ring"));
+  }
+
+  // Binding requires a completion ring even though we never transmit.
+  if (set_completion_ring(xskFd_, 1) < 0) {
+    return folly::makeUnexpected(
+        std::runtime_error("Failed to set completion ring"));
+  }
+
+  if (set_rx_ring(xskFd_, config_.numFrames) < 0) {
+    return folly::makeUnexpected(std::runtime_error("Failed to set rx ring"));
+  }
+
+  if (xsk_get_mmap_offsets(xskFd_, &xskOffsets_) < 0) {
+    return folly::makeUnexpected(
+        std::runtime_error("Failed to get mmap offsets"));
+  }
+
+  fillMap_ = map_fill_ring(xskFd_, &xskOffsets_, config_.numFrames);
+  if (!fillMap_) {
+    return folly::makeUnexpected(
+        std::runtime_error("Failed to map fill ring"));
+  }
+
+  rxMap_ = map_rx_ring(xskFd_, &xskOffsets_, config_.numFrames);
+  if (!rxMap_) {
+    return folly::makeUnexpected(std::runtime_error("Failed to map rx ring"));
+  }
+
+  return folly::Unit();
+}
+
+size_t XskReceiver::receive(PacketCallback callback) {
+  auto* producerPtr = (uint32_t*)((char*)rxMap_ + xskOffsets_.rx.producer);
+  uint32_t rxProducerIndex = __atomic_load_n(producerPtr, __ATOMIC_ACQUIRE);
+  uint32_t numEntries =
+      std::min(rxProducerIndex - rxConsumerIndex_, config_.batchSize);
+  auto* baseDesc = (xdp_desc*)((char*)rxMap_ + xskOffsets_.rx.desc);
+  uint32_t frameSize = umem_->frameSize();
+
+  for (uint32_t i = 0; i < numEntries; i++) {
+    const xdp_desc& desc =
+        baseDesc[(rxConsumerIndex_ + i) & (config_.numFrames - 1)];
+    // In aligned mode the address points to the packet inside its frame,
+    // after the kernel's headroom.
+    uint64_t frameIndex = desc.addr / frameSize;
+    size_t frameOffset = desc.addr % frameSize;
+    uint8_t* frame = umem_->frame(frameIndex);
+
+    ParsedUdpPacket packet;
+    if (!parseUdpPacket(frame + frameOffset, desc.len, packet)) {
+      numDroppedFrames_++;
+      freeFrames_.push_back(frameIndex);
+      continue;
+    }
+    umem_->addRef();
+    auto data = folly::IOBuf::takeOwnership(
+        frame,
+        frameSize,
+        frameOffset + packet.payloadOffset,
+        packet.payloadLength,
+        &Umem::releaseFrame,
+        umem_);
+    callback(packet.src, packet.dst, std::move(data), packet.tos);
+  }
+
+  rxConsumerIndex_ += numEntries;
+  auto* consumerPtr = (uint32_t*)((char*)rxMap_ + xskOffsets_.rx.consumer);
+  __atomic_store_n(consumerPtr, rxConsumerIndex_, __ATOMIC_RELEASE);
+
+  refillFillRing();
+  return numEntries;
+}
+
+void XskReceiver::refillFillRing() {
+  umem_->takeReleasedFrames(freeFrames_);
+
+  auto* consumerPtr = (uint32_t*)((char*)fillMap_ + xskOffsets_.fr.consumer);
+  uint32_t fillConsumerIndex = __atomic_load_n(consumerPtr, __ATOMIC_ACQUIRE);
+  uint32_t numFreeEntries =
+      config_.numFrames - (fillProducerIndex_ - fillConsumerIndex);
+  auto numEntries = std::min<size_t>(numFreeEntries, freeFrames_.size());
+  auto* baseDesc = (uint64_t*)((char*)fillMap_ + xskOffsets_.fr.desc);
+  for (size_t i = 0; i < numEntries; i++) {
+    baseDesc[fillProducerIndex_ & (config_.numFrames - 1)] =
+        freeFrames_.back() * config_.frameSize;
+    freeFrames_.pop_back();
+    fillProducerIndex_++;
+  }
+  if (numEntries > 0) {
+    auto* producerPtr =
+        (uint32_t*)((char*)fillMap_ + xskOffsets_.fr.producer);
+    __atomic_store_n(producerPtr, fillProducerIndex_, __ATOMIC_RELEASE);
+  }
+
+  if (!config_.useNeedWakeup) {
+    return;
+  }
+  auto* fillFlagsPtr = (uint32_t*)((char*)fillMap_ + xskOffsets_.fr.flags);
+  uint32_t flags = __atomic_load_n(fillFlagsPtr, __ATOMIC_ACQUIRE);
+  if (flags & XDP_RING_NEED_WAKEUP) {
+    recvfrom(xskFd_, nullptr, 0, MSG_DONTWAIT, nullptr, nullptr);
+  }
+}
+
+} // namespace facebook::xdpsocket
+
+#endif
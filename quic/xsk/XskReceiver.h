@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#if defined(__linux__) && !defined(ANDROID)
+
+#include <folly/Expected.h>
+#include <folly/Function.h>
+#include <folly/SocketAddress.h>
+#include <folly/io/IOBuf.h>
+#include <quic/xsk/xsk_lib.h>
+
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace facebook::xdpsocket {
+
+struct XskReceiverConfig {
+  // Interface and queue to bind the socket to.
+  std::string interfaceName;
+  uint32_t queueId{0};
+  // Path of the pinned XSKMAP that the interface's XDP program redirects
+  // packets with. The socket is added to it at key queueId.
+  std::string xskMapPath;
+  // Number of UMEM frames, also the size of the fill and rx rings. Must be a
+  // power of two.
+  uint32_t numFrames{4096};
+  // Must be a power of two, large enough for the MTU.
+  uint32_t frameSize{4096};
+  // Max number of packets handled per call to receive().
+  uint32_t batchSize{64};
+  bool zeroCopyEnabled{false};
+  bool useNeedWakeup{true};
+};
+
+/**
+ * Receives UDP packets from an AF_XDP socket, bypassing the kernel's network
+ * stack. An XDP program on the interface must redirect the packets to the
+ * socket through the XSKMAP given in the config.
+ *
+ * Received payloads are handed out as IOBufs pointing into the UMEM frame the
+ * packet arrived in, without copying. The frame is given back to the kernel
+ * through the fill ring once the IOBuf is freed, which may happen on any
+ * thread. Holding on to many IOBufs starves the fill ring and makes the kernel
+ * drop packets.
+ *
+ * Other than the frame release, an XskReceiver must be used from one thread.
+ */
+class XskReceiver {
+ public:
+  using PacketCallback = folly::FunctionRef<void(
+      const folly::SocketAddress& peer,
+      const folly::SocketAddress& local,
+      std::unique_ptr<folly::IOBuf> data,
+      uint8_t tos)>;
+
+  explicit XskReceiver(XskReceiverConfig config);
+
+  ~XskReceiver();
+
+  XskReceiver(const XskReceiver&) = delete;
+  XskReceiver& operator=(const XskReceiver&) = delete;
+
+  folly::Expected<folly::Unit, std::runtime_error> init();
+
+  // The AF_XDP socket. It polls readable when the rx ring has packets.
+  [[nodiscard]] int getFd() const {
+    return xskFd_;
+  }
+
+  /*
+   * Consumes up to batchSize packets from the rx ring and calls the callback
+   * for each UDP packet. Frames that are not UDP are dropped. Returns the
+   * number of frames consumed.
+   */
+  size_t receive(PacketCallback callback);
+
+  [[nodiscard]] uint64_t numDroppedFrames() const {
+    return numDroppedFrames_;
+  }
+
+ private:
+  /*
+   * The UMEM area and the frames released by IOBufs. It is reference counted
+   * by the receiver and the IOBufs pointing into it, so that it outlives
+   * both.
+   */
+  class Umem {
+   public:
+    Umem(void* area, uint32_t numFrames, uint32_t frameSize)
+        : area_(static_cast<uint8_t*>(area)),
+          numFrames_(numFrames),
+          frameSize_(frameSize) {}
+
+    ~Umem();
+
+    uint8_t* frame(uint64_t index) const {
+      return area_ + index * frameSize_;
+    }
+
+    uint64_t frameIndex(const void* addr) const {
+      return (static_cast<const uint8_t*>(addr) - area_) / frameSize_;
+    }
+
+    uint32_t frameSize() const {
+      return frameSize_;
+    }
+
+    void addRef() {
+      refs_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release();
+
+    // IOBuf free function for the frame at buf.
+    static void releaseFrame(void* buf, void* userData);
+
+    // Moves the frames released since the last call into frames.
+    void takeReleasedFrames(std::vector<uint64_t>& frames);
+
+   private:
+    uint8_t* area_;
+    uint32_t numFrames_;
+    uint32_t frameSize_;
+    std::atomic<size_t> refs_{1};
+    std::mutex releasedMutex_;
+    std::vector<uint64_t> releasedFrames_;
+  };
+
+  folly::Expected<folly::Unit, std::runtime_error> initXdpSocket();
+
+  // Puts free frames on the fill ring and wakes up the kernel if it asks for
+  // it.
+  void refillFillRing();
+
+  XskReceiverConfig config_;
+
+  Umem* umem_{nullptr};
+  int xskFd_{-1};
+  int xskMapFd_{-1};
+  void* fillMap_{nullptr};
+  void* rxMap_{nullptr};
+  xdp_mmap_offsets xskOffsets_;
+
+  // We are the producer for the fill ring and the consumer for the rx ring.
+  uint32_t fillProducerIndex_{0};
+  uint32_t rxConsumerIndex_{0};
+
+  // Frames that can be put on the fill ring.
+  std::vector<uint64_t> freeFrames_;
+
+  uint64_t numDroppedFrames_{0};
+};
+
+} // namespace facebook::xdpsocket
+
+#endif
@@ -8,9 +8,14 @@
 #if defined(__linux__) && !defined(ANDROID)
 
 #include <folly/Benchmark.h>
+#include <netinet/in.h>
 #include <netinet/udp.h>
 #include <quic/xsk/packet_utils.h>
 
+#ifndef ETH_P_8021Q
+#define ETH_P_8021Q 0x8100
+#endif
+
 namespace facebook::xdpsocket {
 
 void writeMacHeader(const ethhdr* ethHdr, char*& buffer) {
@@ -158,6 +163,86 @@ void writeChecksum(
   upd_hdr->check = checksum;
 }
 
+bool parseUdpPacket(const uint8_t* frame, size_t len, ParsedUdpPacket& out) {
+  size_t offset = sizeof(ethhdr);
+  if (len < offset) {
+    return false;
+  }
+  uint16_t ethProto;
+  memcpy(&ethProto, frame + ETH_ALEN * 2, sizeof(ethProto));
+  if (ntohs(ethProto) == ETH_P_8021Q) {
+    // Skip the tag, the encapsulated protocol follows it.
+    if (len < offset + 4) {
+      return false;
+    }
+    memcpy(&ethProto, frame + offset + 2, sizeof(ethProto));
+    offset += 4;
+  }
+
+  // Length of the IP packet, from the start of its header.
+  size_t ipLen;
+  if (ntohs(ethProto) == ETH_P_IP) {
+    iphdr ipHdr;
+    if (len < offset + sizeof(ipHdr)) {
+      return false;
+    }
+    memcpy(&ipHdr, frame + offset, sizeof(ipHdr));
+    size_t ipHdrLen = ipHdr.ihl * 4;
+    ipLen = ntohs(ipHdr.tot_len);
+    // Fragments have MF set or a non-zero offset, only DF may be set.
+    bool isFragment = (ntohs(ipHdr.frag_off) & ~0x4000) != 0;
+    if (ipHdr.version != 4 || ipHdrLen < sizeof(ipHdr) || ipLen < ipHdrLen ||
+        len < offset + ipLen || isFragment || ipHdr.protocol != IPPROTO_UDP) {
+      return false;
+    }
+    out.src = folly::SocketAddress(
+        folly::IPAddressV4::fromLong(ipHdr.saddr), 0);
+    out.dst = folly::SocketAddress(
+        folly::IPAddressV4::fromLong(ipHdr.daddr), 0);
+    out.tos = ipHdr.tos;
+    offset += ipHdrLen;
+    ipLen -= ipHdrLen;
+  } else if (ntohs(ethProto) == ETH_P_IPV6) {
+    ipv6hdr ipv6Hdr;
+    if (len < offset + sizeof(ipv6Hdr)) {
+      return false;
+    }
+    memcpy(&ipv6Hdr, frame + offset, sizeof(ipv6Hdr));
+    ipLen = ntohs(ipv6Hdr.payload_len);
+    if (ipv6Hdr.version != 6 || ipv6Hdr.nexthdr != IPPROTO_UDP ||
+        len < offset + sizeof(ipv6Hdr) + ipLen) {
+      return false;
+    }
+    out.src = folly::SocketAddress(
+        folly::IPAddressV6::fromBinary(folly::ByteRange(
+            ipv6Hdr.saddr.s6_addr, sizeof(ipv6Hdr.saddr.s6_addr))),
+        0);
+    out.dst = folly::SocketAddress(
+        folly::IPAddressV6::fromBinary(folly::ByteRange(
+            ipv6Hdr.daddr.s6_addr, sizeof(ipv6Hdr.daddr.s6_addr))),
+        0);
+    out.tos = (ipv6Hdr.priority << 4) | (ipv6Hdr.flow_lbl[0] >> 4);
+    offset += sizeof(ipv6Hdr);
+  } else {
+    return false;
+  }
+
+  udphdr udpHdr;
+  if (ipLen < sizeof(udpHdr)) {
+    return false;
+  }
+  memcpy(&udpHdr, frame + offset, sizeof(udpHdr));
+  size_t udpLen = ntohs(udpHdr.len);
+  if (udpLen < sizeof(udpHdr) || udpLen > ipLen) {
+    return false;
+  }
+  out.src.setPort(ntohs(udpHdr.source));
+  out.dst.setPort(ntohs(udpHdr.dest));
+  out.payloadOffset = offset + sizeof(udpHdr);
+  out.payloadLength = udpLen - sizeof(udpHdr);
+  return true;
+}
+
 } // namespace facebook::xdpsocket
 
 #endif
@@ -10,6 +10,7 @@
 #if defined(__linux__) && !defined(ANDROID)
 
 #include <folly/IPAddress.h>
+#include <folly/SocketAddress.h>
 #include <linux/if_ether.h>
 #include <linux/ip.h>
 #include <linux/ipv6.h>
@@ -49,6 +50,22 @@ void writeChecksum(
     char* packet,
     uint16_t len);
 
+struct ParsedUdpPacket {
+  folly::SocketAddress src;
+  folly::SocketAddress dst;
+  // Offset of the UDP payload from the start of the frame.
+  uint16_t payloadOffset;
+  uint16_t payloadLength;
+  // The TOS byte for IPv4, the traffic class for IPv6.
+  uint8_t tos;
+};
+
+// Strips the Ethernet (optionally 802.1Q tagged), IP and UDP headers of a
+// frame received on an AF_XDP socket. Returns false for anything that is not
+// an unfragmented UDP packet, or whose lengths do not fit in the frame. IPv6
+// extension headers are not supported.
+bool parseUdpPacket(const uint8_t* frame, size_t len, ParsedUdpPacket& out);
+
 } // namespace facebook::xdpsocket
 
 #endif
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#if defined(__linux__) && !defined(ANDROID)
+
+#include <gtest/gtest.h>
+
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <quic/xsk/packet_utils.h>
+
+#include <string>
+#include <vector>
+
+using namespace testing;
+
+namespace facebook::xdpsocket::test {
+
+namespace {
+
+std::vector<uint8_t> makeFrame(
+    const folly::SocketAddress& src,
+    const folly::SocketAddress& dst,
+    const std::string& payload,
+    uint8_t tos = 0,
+    bool vlanTagged = false) {
+  std::vector<uint8_t> frame(2048);
+  char* buffer = reinterpret_cast<char*>(frame.data());
+  bool isV6 = dst.getIPAddress().isV6();
+
+  ethhdr ethHdr = {};
+  ethHdr.h_proto = htons(isV6 ? ETH_P_IPV6 : ETH_P_IP);
+  if (vlanTagged) {
+    ethHdr.h_proto = htons(0x8100);
+    writeMacHeader(&ethHdr, buffer);
+    uint16_t tci = htons(42);
+    uint16_t proto = htons(isV6 ? ETH_P_IPV6 : ETH_P_IP);
+    memcpy(buffer, &tci, sizeof(tci));
+    memcpy(buffer + sizeof(tci), &proto, sizeof(proto));
+    buffer += sizeof(tci) + sizeof(proto);
+  } else {
+    writeMacHeader(&ethHdr, buffer);
+  }
+
+  uint16_t udpLen = sizeof(udphdr) + payload.size();
+  if (isV6) {
+    ipv6hdr ipv6Hdr = {};
+    ipv6Hdr.version = 6;
+    ipv6Hdr.priority = tos >> 4;
+    ipv6Hdr.flow_lbl[0] = (tos & 0xf) << 4;
+    ipv6Hdr.nexthdr = IPPROTO_UDP;
+    ipv6Hdr.hop_limit = 64;
+    writeIpHeader(
+        dst.getIPAddress(), src.getIPAddress(), &ipv6Hdr, udpLen, buffer);
+  } else {
+    iphdr ipHdr = {};
+    ipHdr.version = 4;
+    ipHdr.ihl = 5;
+    ipHdr.tos = tos;
+    ipHdr.frag_off = htons(0x4000);
+    ipHdr.ttl = 64;
+    ipHdr.protocol = IPPROTO_UDP;
+    writeIpHeader(
+        dst.getIPAddress(), src.getIPAddress(), &ipHdr, udpLen, buffer);
+  }
+  writeUdpHeader(src.getPort(), dst.getPort(), 0, udpLen, buffer);
+  writeUdpPayload(payload.data(), payload.size(), buffer);
+  frame.resize(buffer - reinterpret_cast<char*>(frame.data()));
+  return frame;
+}
+
+} // namespace
+
+TEST(PacketUtilsTest, ParseIPv4) {
+  folly::SocketAddress src("10.0.0.1", 1234);
+  folly::SocketAddress dst("10.0.0.2", 443);
+  auto frame = makeFrame(src, dst, "hello", 0xb8);
+
+  ParsedUdpPacket packet;
+  ASSERT_TRUE(parseUdpPacket(frame.data(), frame.size(), packet));
+  EXPECT_EQ(packet.src, src);
+  EXPECT_EQ(packet.dst, dst);
+  EXPECT_EQ(packet.tos, 0xb8);
+  EXPECT_EQ(packet.payloadOffset, frame.size() - 5);
+  EXPECT_EQ(packet.payloadLength, 5);
+  EXPECT_EQ(
+      std::string(
+          reinterpret_cast<const char*>(frame.data()) + packet.payloadOffset,
+          packet.payloadLength),
+      "hello");
+}
+
+TEST(PacketUtilsTest, ParseIPv6) {
+  folly::SocketAddress src("2001:db8::1", 1234);
+  folly::SocketAddress dst("2001:db8::2", 443);
+  auto frame = makeFrame(src, dst, "hello", 0xb8);
+
+  ParsedUdpPacket packet;
+  ASSERT_TRUE(parseUdpPacket(frame.data(), frame.size(), packet));
+  EXPECT_EQ(packet.src, src);
+  EXPECT_EQ(packet.dst, dst);
+  EXPECT_EQ(packet.tos, 0xb8);
+  EXPECT_EQ(packet.payloadOffset, frame.size() - 5);
+  EXPECT_EQ(packet.payloadLength, 5);
+}
+
+TEST(PacketUtilsTest, ParseVlanTagged) {
+  folly::SocketAddress src("10.0.0.1", 1234);
+  folly::SocketAddress dst("10.0.0.2", 443);
+  auto frame = makeFrame(src, dst, "hello", 0, true);
+
+  ParsedUdpPacket packet;
+  ASSERT_TRUE(parseUdpPacket(frame.data(), frame.size(), packet));
+  EXPECT_EQ(packet.src, src);
+  EXPECT_EQ(packet.dst, dst);
+  EXPECT_EQ(packet.payloadOffset, frame.size() - 5);
+}
+
+TEST(PacketUtilsTest, ParseEmptyPayload) {
+  folly::SocketAddress src("10.0.0.1", 1234);
+  folly::SocketAddress dst("10.0.0.2", 443);
+  auto frame = makeFrame(src, dst, "");
+
+  ParsedUdpPacket packet;
+  ASSERT_TRUE(parseUdpPacket(frame.data(), frame.size(), packet));
+  EXPECT_EQ(packet.payloadLength, 0);
+}
+
+TEST(PacketUtilsTest, RejectTruncated) {
+  folly::SocketAddress src("10.0.0.1", 1234);
+  folly::SocketAddress dst("10.0.0.2", 443);
+  auto frame = makeFrame(src, dst, "hello");
+
+  ParsedUdpPacket packet;
+  for (size_t len = 0; len < frame.size(); len++) {
+    EXPECT_FALSE(parseUdpPacket(frame.data(), len, packet)) << len;
+  }
+}
+
+TEST(PacketUtilsTest, RejectNonUdp) {
+  folly::SocketAddress src("10.0.0.1", 1234);
+  folly::SocketAddress dst("10.0.0.2", 443);
+  auto frame = makeFrame(src, dst, "hello");
+  ParsedUdpPacket packet;
+
+  auto tcp = frame;
+  tcp[sizeof(ethhdr) + offsetof(iphdr, protocol)] = IPPROTO_TCP;
+  EXPECT_FALSE(parseUdpPacket(tcp.data(), tcp.size(), packet));
+
+  auto arp = frame;
+  uint16_t proto = htons(ETH_P_ARP);
+  memcpy(arp.data() + ETH_ALEN * 2, &proto, sizeof(proto));
+  EXPECT_FALSE(parseUdpPacket(arp.data(), arp.size(), packet));
+}
+
+TEST(PacketUtilsTest, RejectFragment) {
+  folly::SocketAddress src("10.0.0.1", 1234);
+  folly::SocketAddress dst("10.0.0.2", 443);
+  auto frame = makeFrame(src, dst, "hello");
+  ParsedUdpPacket packet;
+
+  // More fragments.
+  uint16_t fragOff = htons(0x2000);
+  memcpy(
+      frame.data() + sizeof(ethhdr) + offsetof(iphdr, frag_off),
+      &fragOff,
+      sizeof(fragOff));
+  EXPECT_FALSE(parseUdpPacket(frame.data(), frame.size(), packet));
+}
+
+TEST(PacketUtilsTest, RejectBadUdpLength) {
+  folly::SocketAddress src("10.0.0.1", 1234);
+  folly::SocketAddress dst("10.0.0.2", 443);
+  auto frame = makeFrame(src, dst, "hello");
+  ParsedUdpPacket packet;
+  auto udpLenOffset = sizeof(ethhdr) + sizeof(iphdr) + offsetof(udphdr, len);
+
+  // Longer than the IP packet.
+  uint16_t udpLen = htons(sizeof(udphdr) + 6);
+  memcpy(frame.data() + udpLenOffset, &udpLen, sizeof(udpLen));
+  EXPECT_FALSE(parseUdpPacket(frame.data(), frame.size(), packet));
+
+  // Shorter than the UDP header.
+  udpLen = htons(sizeof(udphdr) - 1);
+  memcpy(frame.data() + udpLenOffset, &udpLen, sizeof(udpLen));
+  EXPECT_FALSE(parseUdpPacket(frame.data(), frame.size(), packet));
+}
+
+} // namespace facebook::xdpsocket::test
+
+#endif
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#if defined(__linux__) && !defined(ANDROID)
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <folly/Conv.h>
+#include <folly/String.h>
+#include <quic/xsk/XskReceiver.h>
+
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace testing;
+
+namespace facebook::xdpsocket::test {
+
+// Runs against the veth pair set up by setup_veth.sh. Skipped unless the
+// environment variables below point at it.
+class XskReceiverTest : public Test {
+ public:
+  void SetUp() override {
+    auto iface = getenv("MVFST_XSK_TEST_IFACE");
+    auto xskMap = getenv("MVFST_XSK_TEST_XSKMAP");
+    auto netns = getenv("MVFST_XSK_TEST_NETNS");
+    if (!iface || !xskMap || !netns) {
+      GTEST_SKIP() << "Run setup_veth.sh and set MVFST_XSK_TEST_IFACE, "
+                   << "MVFST_XSK_TEST_XSKMAP and MVFST_XSK_TEST_NETNS";
+    }
+    netns_ = netns;
+
+    XskReceiverConfig config;
+    config.interfaceName = iface;
+    config.xskMapPath = xskMap;
+    config.numFrames = kNumFrames;
+    config.batchSize = 16;
+    receiver_ = std::make_unique<XskReceiver>(std::move(config));
+    auto result = receiver_->init();
+    ASSERT_FALSE(result.hasError()) << result.error().what();
+  }
+
+  // Sends the payloads from the peer's network namespace.
+  void sendFromPeer(const std::vector<std::string>& payloads) {
+    std::string error;
+    std::thread sender([&] {
+      auto nsPath = folly::to<std::string>("/var/run/netns/", netns_);
+      int nsFd = open(nsPath.c_str(), O_RDONLY);
+      if (nsFd < 0 || setns(nsFd, CLONE_NEWNET) < 0) {
+        error = folly::to<std::string>(
+            "Failed to enter ", nsPath, ": ", folly::errnoStr(errno));
+        return;
+      }
+      close(nsFd);
+      int fd = socket(AF_INET, SOCK_DGRAM, 0);
+      auto peer = getPeerAddress();
+      auto local = getLocalAddress();
+      sockaddr_storage addr;
+      peer.getAddress(&addr);
+      bind(fd, (sockaddr*)&addr, peer.getActualSize());
+      local.getAddress(&addr);
+      for (const auto& payload : payloads) {
+        sendto(
+            fd,
+            payload.data(),
+            payload.size(),
+            0,
+            (sockaddr*)&addr,
+            local.getActualSize());
+      }
+      close(fd);
+    });
+    sender.join();
+    ASSERT_TRUE(error.empty()) << error;
+  }
+
+  // Receives until count packets arrived or a receive times out.
+  void receive(size_t count) {
+    while (received_.size() < count) {
+      pollfd pfd = {receiver_->getFd(), POLLIN, 0};
+      if (poll(&pfd, 1, 1000) <= 0) {
+        return;
+      }
+      receiver_->receive([&](const folly::SocketAddress& peer,
+                             const folly::SocketAddress& local,
+                             std::unique_ptr<folly::IOBuf> data,
+                             uint8_t /* tos */) {
+        EXPECT_EQ(peer, getPeerAddress());
+        EXPECT_EQ(local, getLocalAddress());
+        received_.push_back(std::move(data));
+      });
+    }
+  }
+
+  static folly::SocketAddress getPeerAddress() {
+    return folly::SocketAddress("10.77.0.1", 4433);
+  }
+
+  static folly::SocketAddress getLocalAddress() {
+    return folly::SocketAddress("10.77.0.2", 443);
+  }
+
+  static constexpr uint32_t kNumFrames = 64;
+
+  std::string netns_;
+  std::unique_ptr<XskReceiver> receiver_;
+  std::vector<std::unique_ptr<folly::IOBuf>> received_;
+};
+
+TEST_F(XskReceiverTest, ReceivePayloads) {
+  std::vector<std::string> payloads;
+  for (size_t i = 0; i < 10; i++) {
+    payloads.push_back(folly::to<std::string>("packet ", i));
+  }
+  sendFromPeer(payloads);
+  receive(payloads.size());
+
+  ASSERT_EQ(received_.size(), payloads.size());
+  for (size_t i = 0; i < payloads.size(); i++) {
+    EXPECT_EQ(received_[i]->to<std::string>(), payloads[i]);
+  }
+}
+
+TEST_F(XskReceiverTest, FramesAreRecycled) {
+  // Many more packets than frames, released on another thread.
+  for (size_t round = 0; round < 8; round++) {
+    std::vector<std::string> payloads(kNumFrames / 2, std::string(100, 'a'));
+    sendFromPeer(payloads);
+    receive(payloads.size());
+    ASSERT_EQ(received_.size(), payloads.size()) << "round " << round;
+    std::thread([bufs = std::move(received_)]() mutable {
+      bufs.clear();
+    }).join();
+    received_.clear();
+  }
+}
+
+TEST_F(XskReceiverTest, BuffersOutliveReceiver) {
+  sendFromPeer({"hello"});
+  receive(1);
+  ASSERT_EQ(received_.size(), 1);
+  receiver_.reset();
+  EXPECT_EQ(received_[0]->to<std::string>(), "hello");
+}
+
+} // namespace facebook::xdpsocket::test
+
+#endif
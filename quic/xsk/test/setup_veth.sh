@@ -0,0 +1,67 @@
+#!/bin/bash
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+#
+# This source code is licensed under the MIT license found in the
+# LICENSE file in the root directory of this source tree.
+
+# Sets up the environment for XskReceiverTest: a veth pair with one end in a
+# network namespace, and an XDP program on the other end that redirects to a
+# pinned XSKMAP. Needs root, clang, and bpftool.
+#
+#   sudo quic/xsk/test/setup_veth.sh up
+#   sudo MVFST_XSK_TEST_IFACE=veth-xsk \
+#     MVFST_XSK_TEST_XSKMAP=/sys/fs/bpf/mvfst_xsks_map \
+#     MVFST_XSK_TEST_NETNS=mvfst-xsk XskReceiverTest
+#   sudo quic/xsk/test/setup_veth.sh down
+
+set -euo pipefail
+
+NETNS=mvfst-xsk
+IFACE=veth-xsk
+PEER=veth-peer
+IFACE_ADDR=10.77.0.2
+PEER_ADDR=10.77.0.1
+PIN_DIR=/sys/fs/bpf/mvfst_xsk
+XSKMAP_PIN=/sys/fs/bpf/mvfst_xsks_map
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+
+up() {
+  ip netns add "$NETNS"
+  ip link add "$IFACE" type veth peer name "$PEER"
+  ip link set "$PEER" netns "$NETNS"
+  ip addr add "$IFACE_ADDR/24" dev "$IFACE"
+  ip link set "$IFACE" up
+  ip -n "$NETNS" addr add "$PEER_ADDR/24" dev "$PEER"
+  ip -n "$NETNS" link set "$PEER" up
+  # Packets to the AF_XDP socket never reach the kernel, so it can't answer
+  # ARP for them.
+  local mac
+  mac=$(cat "/sys/class/net/$IFACE/address")
+  ip -n "$NETNS" neigh add "$IFACE_ADDR" lladdr "$mac" dev "$PEER"
+
+  local obj
+  obj=$(mktemp --suffix=.o)
+  clang -O2 -g -target bpf -c "$SCRIPT_DIR/xsk_redirect.bpf.c" -o "$obj"
+  bpftool prog loadall "$obj" "$PIN_DIR" type xdp \
+    pinmaps "$PIN_DIR/maps"
+  rm -f "$obj"
+  mv "$PIN_DIR/maps/xsks_map" "$XSKMAP_PIN"
+  # veth only supports zero copy with native XDP on both ends, so use generic
+  # XDP and copy mode.
+  ip link set dev "$IFACE" xdpgeneric pinned "$PIN_DIR/xsk_redirect"
+}
+
+down() {
+  ip link del "$IFACE" 2>/dev/null || true
+  ip netns del "$NETNS" 2>/dev/null || true
+  rm -rf "$PIN_DIR" "$XSKMAP_PIN"
+}
+
+case "${1:-}" in
+  up) up ;;
+  down) down ;;
+  *)
+    echo "usage: $0 up|down" >&2
+    exit 1
+    ;;
+esac
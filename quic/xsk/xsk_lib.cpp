@@ -7,10 +7,12 @@
 
 #if defined(__linux__) && !defined(ANDROID)
 
+#include <linux/bpf.h>
 #include <net/if.h>
 #include <quic/xsk/xsk_lib.h>
 #include <sys/mman.h>
 #include <sys/socket.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 #include <cstring>
 
@@ -97,6 +99,18 @@ int set_tx_ring(int xsk_fd, __u32 num_frames) {
   return err;
 }
 
+int set_fill_ring_size(int xsk_fd, __u32 num_frames) {
+  int err = setsockopt(
+      xsk_fd, SOL_XDP, XDP_UMEM_FILL_RING, &num_frames, sizeof(num_frames));
+  return err;
+}
+
+int set_rx_ring(int xsk_fd, __u32 num_frames) {
+  int err =
+      setsockopt(xsk_fd, SOL_XDP, XDP_RX_RING, &num_frames, sizeof(num_frames));
+  return err;
+}
+
 int xsk_get_mmap_offsets(int xsk_fd, struct xdp_mmap_offsets* off) {
   socklen_t optlen;
   int err;
@@ -159,15 +173,75 @@ int unmap_tx_ring(
   return munmap(tx_ring, off->tx.desc + num_frames * sizeof(struct xdp_desc));
 }
 
+void* map_fill_ring(
+    int xsk_fd,
+    struct xdp_mmap_offsets* off,
+    __u32 num_frames) {
+  void* map = mmap(
+      nullptr,
+      off->fr.desc + num_frames * sizeof(__u64),
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE,
+      xsk_fd,
+      XDP_UMEM_PGOFF_FILL_RING);
+  if (map == MAP_FAILED) {
+    return nullptr;
+  }
+
+  return map;
+}
+
+int unmap_fill_ring(
+    void* fill_ring,
+    struct xdp_mmap_offsets* off,
+    __u32 num_frames) {
+  return munmap(fill_ring, off->fr.desc + num_frames * sizeof(__u64));
+}
+
+void* map_rx_ring(int xsk_fd, struct xdp_mmap_offsets* off, __u32 num_frames) {
+  void* map = mmap(
+      nullptr,
+      off->rx.desc + num_frames * sizeof(struct xdp_desc),
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE,
+      xsk_fd,
+      XDP_PGOFF_RX_RING);
+  if (map == MAP_FAILED) {
+    return nullptr;
+  }
+
+  return map;
+}
+
+int unmap_rx_ring(
+    void* rx_ring,
+    struct xdp_mmap_offsets* off,
+    __u32 num_frames) {
+  return munmap(rx_ring, off->rx.desc + num_frames * sizeof(struct xdp_desc));
+}
+
 int bind_xsk(
     int xsk_fd,
     int queue_id,
     bool zeroCopyEnabled,
     bool useNeedWakeup) {
+  return bind_xsk_to_interface(
+      xsk_fd, "eth0", queue_id, zeroCopyEnabled, useNeedWakeup);
+}
+
+int bind_xsk_to_interface(
+    int xsk_fd,
+    const char* ifname,
+    int queue_id,
+    bool zeroCopyEnabled,
+    bool useNeedWakeup) {
   struct sockaddr_xdp sxdp = {};
   sxdp.sxdp_family = AF_XDP;
-  sxdp.sxdp_ifindex = if_nametoindex("eth0");
+  sxdp.sxdp_ifindex = if_nametoindex(ifname);
   sxdp.sxdp_queue_id = queue_id;
+  if (sxdp.sxdp_ifindex == 0) {
+    return -1;
+  }
 
   if (zeroCopyEnabled) {
     sxdp.sxdp_flags |= XDP_ZEROCOPY;
@@ -199,4 +273,31 @@ int bind_xsk_shared_umem(int xsk_fd, int queue_id, int sharedXskFd) {
   return 0;
 }
 
+int open_pinned_bpf_map(const char* path) {
+  union bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.pathname = (__u64)(uintptr_t)path;
+  int fd = (int)syscall(__NR_bpf, BPF_OBJ_GET, &attr, sizeof(attr));
+  if (fd < 0) {
+    return -1;
+  }
+  return fd;
+}
+
+int add_xsk_to_map(int xsk_map_fd, int queue_id, int xsk_fd) {
+  __u32 key = queue_id;
+  __u32 value = xsk_fd;
+  union bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.map_fd = xsk_map_fd;
+  attr.key = (__u64)(uintptr_t)&key;
+  attr.value = (__u64)(uintptr_t)&value;
+  attr.flags = BPF_ANY;
+  int err = (int)syscall(__NR_bpf, BPF_MAP_UPDATE_ELEM, &attr, sizeof(attr));
+  if (err) {
+    return -1;
+  }
+  return 0;
+}
+
 #endif
@@ -36,6 +36,13 @@ int set_fill_ring(int xsk_fd);
 // Returns 0 on success, negative value on failure
 int set_tx_ring(int xsk_fd, __u32 num_frames);
 
+// Sets the size of the fill ring, for sockets that receive packets.
+// Returns 0 on success, negative value on failure
+int set_fill_ring_size(int xsk_fd, __u32 num_frames);
+
+// Returns 0 on success, negative value on failure
+int set_rx_ring(int xsk_fd, __u32 num_frames);
+
 // Returns 0 on success, negative value on failure
 int xsk_get_mmap_offsets(int fd, struct xdp_mmap_offsets* off);
 
@@ -60,6 +67,24 @@ int unmap_tx_ring(
     struct xdp_mmap_offsets* off,
     __u32 num_frames);
 
+// Returns fill ring on success, nullptr on failure
+void* map_fill_ring(int xsk_fd, struct xdp_mmap_offsets* off, __u32 num_frames);
+
+// Returns 0 on success, negative value on failure
+int unmap_fill_ring(
+    void* fill_ring,
+    struct xdp_mmap_offsets* off,
+    __u32 num_frames);
+
+// Returns rx ring on success, nullptr on failure
+void* map_rx_ring(int xsk_fd, struct xdp_mmap_offsets* off, __u32 num_frames);
+
+// Returns 0 on success, negative value on failure
+int unmap_rx_ring(
+    void* rx_ring,
+    struct xdp_mmap_offsets* off,
+    __u32 num_frames);
+
 // Returns 0 on success, negative value on failure
 int bind_xsk(
     int xsk_fd,
@@ -67,6 +92,25 @@ int bind_xsk(
     bool zeroCopyEnabled,
     bool useNeedWakeup);
 
+// Same as bind_xsk, for the given interface instead of eth0.
+// Returns 0 on success, negative value on failure
+int bind_xsk_to_interface(
+    int xsk_fd,
+    const char* ifname,
+    int queue_id,
+    bool zeroCopyEnabled,
+    bool useNeedWakeup);
+
 int bind_xsk_shared_umem(int xsk_fd, int queue_id, int sharedXskFd);
 
+// Opens the BPF map pinned at path, e.g. the XSKMAP of an XDP program that
+// redirects packets to AF_XDP sockets.
+// Returns descriptor on success, negative value on failure
+int open_pinned_bpf_map(const char* path);
+
+// Adds the socket to an XSKMAP at key queue_id, so that packets the XDP
+// program redirects on that queue are delivered to the socket's rx ring.
+// Returns 0 on success, negative value on failure
+int add_xsk_to_map(int xsk_map_fd, int queue_id, int xsk_fd);
+
 #endif